@@ -0,0 +1,193 @@
+#include "AsyncTask.h"
+#include "RenderThread.h"
+
+IOThreads* IOThreads::Instance()
+{
+	static IOThreads* ioThreads = new IOThreads;
+	return ioThreads;
+}
+
+IOThreads::IOThreads()
+{
+	m_isStopping = false;
+
+	for (GLuint i = 0; i < TOTAL_THREADS; i++)
+	{
+		m_threads.emplace_back(&IOThreads::Run, this);
+	}
+}
+
+/// <summary>
+/// resumes the coroutines posted before, then ends the threads. 
+/// Called on the main thread before the application ends, once nothing awaits the I/O threads any more
+/// </summary>
+void IOThreads::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+
+	m_condition.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+
+	m_threads.clear();
+}
+
+/// <summary>
+/// queues a coroutine to be resumed on one of the I/O threads, from any thread
+/// </summary>
+void IOThreads::Post(std::coroutine_handle<> handle)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_handles.push_back(handle);
+	}
+
+	m_condition.notify_one();
+}
+
+void IOThreads::Run()
+{
+	while (true)
+	{
+		std::coroutine_handle<> handle;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_isStopping || !m_handles.empty(); });
+
+			if (m_handles.empty())
+			{
+				break;
+			}
+
+			handle = m_handles.front();
+			m_handles.pop_front();
+		}
+
+		handle.resume();
+	}
+}
+
+MainThread::MainThread()
+{
+	m_threadID = std::this_thread::get_id();
+}
+
+/// <summary>
+/// the main thread is the one first asking for it, which is the frame loop's before any coroutine starts
+/// </summary>
+MainThread* MainThread::Instance()
+{
+	static MainThread* mainThread = new MainThread;
+	return mainThread;
+}
+
+bool MainThread::IsCurrent() const
+{
+	return std::this_thread::get_id() == m_threadID;
+}
+
+/// <summary>
+/// queues a coroutine to be resumed on the main thread, from any thread
+/// </summary>
+void MainThread::Post(std::coroutine_handle<> handle)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_handles.push_back(handle);
+}
+
+/// <summary>
+/// resumes a coroutine on the main thread once the GPU has passed a fence, made on the main context or a context sharing with it. 
+/// Called from any thread
+/// </summary>
+void MainThread::WaitForFence(GLsync fence, std::coroutine_handle<> handle)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_fenceWaits.push_back({ fence, handle });
+}
+
+/// <summary>
+/// resumes the coroutines moved to the main thread, and those whose fences the GPU has passed. 
+/// The fences are only polled, so the frame loop never waits for the GPU here. Called once per frame by the frame loop
+/// </summary>
+/// <returns>returns false if there was nothing to resume</returns>
+bool MainThread::RunPending()
+{
+	std::vector<std::coroutine_handle<>> handles;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		handles.swap(m_handles);
+
+		for (size_t i = 0; i < m_fenceWaits.size();)
+		{
+			GLenum status = glClientWaitSync(m_fenceWaits[i].fence, 0, 0);
+
+			//a failed wait resumes the coroutine too, which would otherwise wait forever
+			if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED)
+			{
+				glDeleteSync(m_fenceWaits[i].fence);
+				handles.push_back(m_fenceWaits[i].handle);
+				m_fenceWaits.erase(m_fenceWaits.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	//the coroutines resumed may queue more, which wait for the next call
+	for (std::coroutine_handle<> handle : handles)
+	{
+		handle.resume();
+	}
+
+	return !handles.empty();
+}
+
+void WorkerAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+	TaskScheduler::Instance()->Submit([handle]() { handle.resume(); }, priority);
+}
+
+void IOAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+	IOThreads::Instance()->Post(handle);
+}
+
+void FenceAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+	RenderThread::Instance()->WaitForFence(fence, handle);
+}
+
+WorkerAwaiter ResumeOnWorker(TaskPriority priority)
+{
+	return { priority };
+}
+
+IOAwaiter ResumeOnIO()
+{
+	return {};
+}
+
+MainThreadAwaiter ResumeOnMainThread()
+{
+	return {};
+}
+
+NextFrameAwaiter ResumeOnNextFrame()
+{
+	return {};
+}
+
+FenceAwaiter WaitForFence(GLsync fence)
+{
+	return { fence };
+}
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "gl.h"
+#include "TaskScheduler.h"
+
+//the part of a coroutine's promise that does not depend on its result
+struct AsyncPromiseBase
+{
+	//resumes the coroutine awaiting this one, or returns to whoever resumed it last
+	struct FinalAwaiter
+	{
+		bool await_ready() const noexcept { return false; }
+		void await_resume() const noexcept {}
+
+		template<typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+		{
+			//the frame may be destroyed as soon as it is marked done, so nothing of it is read after
+			std::coroutine_handle<> continuation = handle.promise().continuation;
+			handle.promise().isDone = true;
+			return continuation ? continuation : std::noop_coroutine();
+		}
+	};
+
+	std::suspend_always initial_suspend() const noexcept { return {}; }
+	FinalAwaiter final_suspend() const noexcept { return {}; }
+	void unhandled_exception() const noexcept { std::terminate(); }
+
+	std::coroutine_handle<> continuation;
+	std::atomic<bool> isDone{ false };
+};
+
+template<typename T>
+struct AsyncPromise;
+
+//a coroutine that starts when it is awaited or started, and hands its result to the coroutine awaiting it. 
+//It moves between the threads of the application with the awaiters below, such as reading a file on an I/O thread, 
+//decoding it on the workers and uploading it on the UI thread, written as a single function instead of a chain of callbacks. 
+//A coroutine that was started has to be done before it is destroyed
+template<typename T = void>
+class AsyncTask
+{
+
+public:
+
+	using promise_type = AsyncPromise<T>;
+
+	AsyncTask() = default;
+	explicit AsyncTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+	AsyncTask(AsyncTask&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+	AsyncTask(const AsyncTask&) = delete;
+	AsyncTask& operator=(const AsyncTask&) = delete;
+
+	AsyncTask& operator=(AsyncTask&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Destroy();
+			m_handle = std::exchange(other.m_handle, nullptr);
+		}
+
+		return *this;
+	}
+
+	~AsyncTask()
+	{
+		Destroy();
+	}
+
+	/// <summary>
+	/// runs the coroutine on the calling thread up to the first point where it moves to another thread or waits
+	/// </summary>
+	void Start()
+	{
+		m_handle.resume();
+	}
+
+	/// <summary>
+	/// whether the coroutine has returned. A coroutine that was never created counts as done
+	/// </summary>
+	bool IsDone() const
+	{
+		return !m_handle || m_handle.promise().isDone;
+	}
+
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	//the awaited coroutine starts at once on the awaiting thread, and resumes the awaiting one when it returns
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaitingHandle) noexcept
+	{
+		m_handle.promise().continuation = awaitingHandle;
+		return m_handle;
+	}
+
+	T await_resume()
+	{
+		if constexpr (!std::is_void_v<T>)
+		{
+			return std::move(*m_handle.promise().result);
+		}
+	}
+
+private:
+
+	void Destroy()
+	{
+		if (m_handle)
+		{
+			m_handle.destroy();
+			m_handle = nullptr;
+		}
+	}
+
+	std::coroutine_handle<promise_type> m_handle;
+
+};
+
+template<typename T>
+struct AsyncPromise : AsyncPromiseBase
+{
+	AsyncTask<T> get_return_object() { return AsyncTask<T>(std::coroutine_handle<AsyncPromise>::from_promise(*this)); }
+	void return_value(T value) { result = std::move(value); }
+
+	std::optional<T> result;
+};
+
+template<>
+struct AsyncPromise<void> : AsyncPromiseBase
+{
+	AsyncTask<void> get_return_object() { return AsyncTask<void>(std::coroutine_handle<AsyncPromise>::from_promise(*this)); }
+	void return_void() const noexcept {}
+};
+
+//the thread that runs the frame loop and the GUI, and builds the frames the render thread draws. 
+//It only holds the OpenGL context before the render thread starts and after it stops. 
+//Coroutines that move here are resumed by the frame loop, between frames
+class MainThread
+{
+
+public:
+
+	static MainThread* Instance();
+
+	bool IsCurrent() const;
+	void Post(std::coroutine_handle<> handle);
+	void WaitForFence(GLsync fence, std::coroutine_handle<> handle);
+	bool RunPending();
+
+private:
+
+	struct FenceWait
+	{
+		GLsync fence;
+		std::coroutine_handle<> handle;
+	};
+
+	MainThread();
+	MainThread(const MainThread&);
+
+	std::thread::id m_threadID;
+	std::mutex m_mutex;
+	std::vector<std::coroutine_handle<>> m_handles;
+	std::vector<FenceWait> m_fenceWaits; //the fences are polled and deleted on the main thread
+
+};
+
+//the threads coroutines move to for I/O, as reads and writes of files mostly wait for the disk and would hold up the workers. 
+//Started when first needed, and stopped by the main thread before the application ends
+class IOThreads
+{
+
+public:
+
+	static IOThreads* Instance();
+
+	void Stop();
+	void Post(std::coroutine_handle<> handle);
+
+private:
+
+	static const GLuint TOTAL_THREADS = 2;
+
+	IOThreads();
+	IOThreads(const IOThreads&);
+
+	void Run();
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<std::coroutine_handle<>> m_handles;
+	bool m_isStopping;
+
+};
+
+//moves the coroutine to a task of the task scheduler, for work that keeps a core busy
+struct WorkerAwaiter
+{
+	TaskPriority priority;
+
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) const;
+	void await_resume() const noexcept {}
+};
+
+//moves the coroutine to an I/O thread, for reads and writes that mostly wait for the disk
+struct IOAwaiter
+{
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) const;
+	void await_resume() const noexcept {}
+};
+
+//moves the coroutine to the main thread, or goes on at once if it is there already
+struct MainThreadAwaiter
+{
+	bool await_ready() const noexcept { return MainThread::Instance()->IsCurrent(); }
+	void await_suspend(std::coroutine_handle<> handle) const { MainThread::Instance()->Post(handle); }
+	void await_resume() const noexcept {}
+};
+
+//moves the coroutine to the main thread, where it goes on in the next frame even if it is there already, 
+//for work spread over frames
+struct NextFrameAwaiter
+{
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) const { MainThread::Instance()->Post(handle); }
+	void await_resume() const noexcept {}
+};
+
+//resumes the coroutine once the GPU has passed the fence, which is deleted then, on the thread the screen's context 
+//is current on: the render thread while it runs, the main thread otherwise. Awaited on whichever thread made the fence
+struct FenceAwaiter
+{
+	GLsync fence;
+
+	bool await_ready() const noexcept { return !fence; }
+	void await_suspend(std::coroutine_handle<> handle) const;
+	void await_resume() const noexcept {}
+};
+
+WorkerAwaiter ResumeOnWorker(TaskPriority priority);
+IOAwaiter ResumeOnIO();
+MainThreadAwaiter ResumeOnMainThread();
+NextFrameAwaiter ResumeOnNextFrame();
+FenceAwaiter WaitForFence(GLsync fence);
\ No newline at end of file
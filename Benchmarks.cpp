@@ -0,0 +1,1222 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "Benchmarks.h"
+#include "BlurCache.h"
+#include "BoundingVolumeHierarchy.h"
+#include "Camera.h"
+#include "ColorConversion.h"
+#include "Convolution.h"
+#include "EffectCache.h"
+#include "FrameBudget.h"
+#include "PaddedBuffer.h"
+#include "Parallel.h"
+#include "PreviewResolution.h"
+#include "PyramidBlur.h"
+#include "Quad.h"
+#include "Scene.h"
+#include "Screen.h"
+#include "TaskScheduler.h"
+#include "Texture.h"
+#include "Timer.h"
+#include "UploadThread.h"
+
+//the largest blur the properties window offers the exact gaussian blur for, which the blur benchmarks go up to
+static const GLfloat MAX_EXACT_BLUR_PERCENT = 5.0f;
+
+/// <summary>
+/// measures building, refitting and querying a bounding volume hierarchy over 100k randomly placed quads
+/// </summary>
+/// <param name="camera">the camera whose frustum and mouse rays are queried</param>
+/// <param name="viewWidth">width of the view the mouse rays are cast through, in pixels</param>
+/// <param name="viewHeight">height of the view the mouse rays are cast through, in pixels</param>
+static void RunBVHBenchmark(const Camera& camera, GLsizei viewWidth, GLsizei viewHeight)
+{
+	const GLuint totalQuads = 100000;
+	const GLuint totalRays = 10000;
+
+	std::vector<BoundingVolumeHierarchy::AABB> bounds(totalQuads);
+	auto randomBounds = [](BoundingVolumeHierarchy::AABB& quadBounds)
+	{
+		glm::vec3 center(rand() % 2000 / 100.0f - 10.0f, rand() % 2000 / 100.0f - 10.0f, rand() % 2000 / 100.0f - 15.0f);
+		quadBounds = { center - glm::vec3(0.05f), center + glm::vec3(0.05f) };
+	};
+
+	for (BoundingVolumeHierarchy::AABB& quadBounds : bounds)
+	{
+		randomBounds(quadBounds);
+	}
+
+	BoundingVolumeHierarchy bvh;
+	Timer timer;
+	bvh.Build(bounds);
+	std::cout << "BVH benchmark: build " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+
+	//refit after moving 1% of the quads, then after moving all of them
+	std::vector<GLuint> dirtyQuads;
+	for (GLuint i = 0; i < totalQuads; i += 100)
+	{
+		randomBounds(bounds[i]);
+		dirtyQuads.push_back(i);
+	}
+
+	timer.Start();
+	bvh.Refit(dirtyQuads, bounds);
+	std::cout << "BVH benchmark: refit of " << dirtyQuads.size() << " quads " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+
+	dirtyQuads.clear();
+	for (GLuint i = 0; i < totalQuads; i++)
+	{
+		randomBounds(bounds[i]);
+		dirtyQuads.push_back(i);
+	}
+
+	timer.Start();
+	bvh.Refit(dirtyQuads, bounds);
+	std::cout << "BVH benchmark: refit of " << dirtyQuads.size() << " quads " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+
+	bvh.Build(bounds);
+
+	std::vector<GLuint> visibleQuads;
+	timer.Start();
+	bvh.QueryFrustum(camera.GetProjection() * camera.GetView(), visibleQuads);
+	std::cout << "BVH benchmark: frustum query " << timer.GetElapsedMilliseconds() << " ms, " 
+		      << visibleQuads.size() << " quads visible" << std::endl;
+
+	GLuint totalHits = 0;
+	timer.Start();
+	for (GLuint i = 0; i < totalRays; i++)
+	{
+		glm::vec3 origin;
+		glm::vec3 direction;
+		camera.GetRay(rand() % viewWidth, rand() % viewHeight, origin, direction);
+
+		//the bounds themselves count as hits, so only the traversal is measured
+		if (bvh.Raycast(origin, direction, [](GLuint, GLfloat& distance) { distance = 0.0f; return true; }) != -1)
+		{
+			totalHits++;
+		}
+	}
+	std::cout << "BVH benchmark: " << totalRays << " ray picks " << timer.GetElapsedMilliseconds() << " ms, " 
+		      << totalHits << " hits" << std::endl;
+}
+
+/// <summary>
+/// measures loading a 16-bit image and applying the effects in the 8-bit and the linear float working formats, 
+/// and the throughput of the conversions between sRGB and linear light
+/// </summary>
+static void RunColorBenchmark()
+{
+	const Texture::WorkingFormat workingFormats[] = { Texture::WorkingFormat::Gamma8, Texture::WorkingFormat::LinearFloat };
+	const char* workingFormatNames[] = { "8-bit", "linear float" };
+
+	for (int i = 0; i < 2; i++)
+	{
+		Texture texture;
+		texture.SetWorkingFormat(workingFormats[i]);
+
+		Timer timer;
+
+		if (!texture.Load("Textures/Crate_1.png"))
+		{
+			return;
+		}
+
+		double loadTime = timer.GetElapsedMilliseconds();
+
+		timer.Start();
+		texture.Blur(0.05f, false);
+		double blurTime = timer.GetElapsedMilliseconds();
+
+		timer.Start();
+		texture.Invert();
+		double invertTime = timer.GetElapsedMilliseconds();
+
+		timer.Start();
+		texture.Reload();
+		glFinish();
+		double uploadTime = timer.GetElapsedMilliseconds();
+
+		texture.Unload();
+
+		std::cout << "Color benchmark: " << workingFormatNames[i] << " load " << loadTime << " ms, blur " << blurTime 
+			      << " ms, invert " << invertTime << " ms, upload " << uploadTime << " ms" << std::endl;
+	}
+
+	const size_t totalPixels = 4096 * 4096;
+	std::vector<Uint8> pixels(totalPixels * 4);
+	std::vector<Uint16> pixels16(totalPixels * 4);
+	std::vector<GLfloat> linearPixels(totalPixels * 4);
+
+	for (size_t i = 0; i < pixels.size(); i++)
+	{
+		pixels[i] = static_cast<Uint8>(rand());
+	}
+
+	auto reportThroughput = [totalPixels](const char* conversion, const Timer& timer)
+	{
+		std::cout << "Color benchmark: " << conversion << " " << totalPixels / timer.GetElapsedMilliseconds() / 1000.0 
+			      << " Mpixels/s" << std::endl;
+	};
+
+	Timer timer;
+	ConvertSrgb8ToLinear(pixels.data(), 4, linearPixels.data(), totalPixels);
+	reportThroughput("8-bit to linear", timer);
+
+	timer.Start();
+	ConvertLinearToSrgb8(linearPixels.data(), pixels.data(), 4, totalPixels);
+	reportThroughput("linear to 8-bit", timer);
+
+	timer.Start();
+	ConvertLinearToSrgb16(linearPixels.data(), pixels16.data(), 4, totalPixels);
+	reportThroughput("linear to 16-bit", timer);
+
+	//the exact curve, one channel at a time, for comparison
+	timer.Start();
+	for (size_t i = 0; i < linearPixels.size(); i++)
+	{
+		pixels16[i] = static_cast<Uint16>(LinearToSrgb(linearPixels[i]) * 65535.0f + 0.5f);
+	}
+	reportThroughput("linear to 16-bit without SIMD", timer);
+}
+
+/// <summary>
+/// measures building the summed-area table of an image and box blurs of a small and a large radius through it, 
+/// against the gaussian blur of the large radius
+/// </summary>
+static void RunSummedAreaTableBenchmark()
+{
+	Texture texture;
+
+	if (!texture.Load("Textures/Crate_1.png"))
+	{
+		return;
+	}
+
+	Timer timer;
+	texture.GetSummedAreaTable();
+	double buildTime = timer.GetElapsedMilliseconds();
+
+	timer.Start();
+	texture.BoxBlur(0.005f, false);
+	double smallBlurTime = timer.GetElapsedMilliseconds();
+
+	timer.Start();
+	texture.BoxBlur(0.05f, false);
+	double largeBlurTime = timer.GetElapsedMilliseconds();
+
+	timer.Start();
+	texture.Blur(0.05f, false);
+	double gaussianBlurTime = timer.GetElapsedMilliseconds();
+
+	texture.Unload();
+
+	std::cout << "Summed-area table benchmark: build " << buildTime << " ms, box blur 0.5% " << smallBlurTime 
+		      << " ms, box blur 5% " << largeBlurTime << " ms, gaussian blur 5% " << gaussianBlurTime << " ms" << std::endl;
+}
+
+/// <summary>
+/// drags the gaussian blur slider up and down in small steps, once blurring the last result by the difference 
+/// where it can and once blurring the source at every step, and reports the time per step of each 
+/// and the largest difference between their results
+/// </summary>
+static void RunBlurDragBenchmark()
+{
+	const GLfloat minBlurFactor = 0.01f;
+	const GLfloat maxBlurFactor = 0.05f;
+	const GLfloat blurStep = 0.001f;
+	const int totalSteps = static_cast<int>((maxBlurFactor - minBlurFactor) / blurStep + 0.5f);
+
+	Texture incrementalTexture;
+	Texture sourceTexture;
+	sourceTexture.SetIncrementalBlur(false);
+
+	if (!incrementalTexture.Load("Textures/Crate_1.png") || !sourceTexture.Load("Textures/Crate_1.png"))
+	{
+		return;
+	}
+
+	for (int direction = 0; direction < 2; direction++)
+	{
+		double incrementalTime = 0.0;
+		double sourceTime = 0.0;
+		double maxIncrementalTime = 0.0;
+		double maxSourceTime = 0.0;
+		int totalIncrementalSteps = 0;
+		GLfloat maxDifference = 0.0f;
+
+		for (int step = 0; step <= totalSteps; step++)
+		{
+			GLfloat blurFactor = (direction == 0) ? minBlurFactor + step * blurStep : maxBlurFactor - step * blurStep;
+
+			Timer timer;
+			incrementalTexture.Blur(blurFactor, false);
+			double time = timer.GetElapsedMilliseconds();
+			incrementalTime += time;
+			maxIncrementalTime = std::max(maxIncrementalTime, time);
+			totalIncrementalSteps += incrementalTexture.IsLastBlurIncremental() ? 1 : 0;
+
+			timer.Start();
+			sourceTexture.Blur(blurFactor, false);
+			time = timer.GetElapsedMilliseconds();
+			sourceTime += time;
+			maxSourceTime = std::max(maxSourceTime, time);
+
+			const std::vector<GLfloat>& incrementalPixels = incrementalTexture.GetLinearPixelsWithEffects();
+			const std::vector<GLfloat>& sourcePixels = sourceTexture.GetLinearPixelsWithEffects();
+
+			for (size_t i = 0; i < incrementalPixels.size(); i++)
+			{
+				maxDifference = std::max(maxDifference, std::abs(incrementalPixels[i] - sourcePixels[i]));
+			}
+		}
+
+		std::cout << "Blur drag benchmark: " << ((direction == 0) ? "up" : "down") << " " << totalSteps + 1 << " steps, " 
+			      << "incremental " << incrementalTime / (totalSteps + 1) << " ms per step (max " << maxIncrementalTime << " ms, " 
+			      << totalIncrementalSteps << " steps from the last result), from source " << sourceTime / (totalSteps + 1) 
+			      << " ms per step (max " << maxSourceTime << " ms), max difference " << maxDifference << std::endl;
+	}
+
+	incrementalTexture.Unload();
+	sourceTexture.Unload();
+}
+
+/// <summary>
+/// drags the gaussian blur slider up in steps and back down, pausing after each step while the blur cache computes 
+/// the steps next to it, and reports the hit rate and the time per step taken from the cache and computed. 
+/// A fast drag without pauses then reports the time per step when the speculative work is cancelled by every step
+/// </summary>
+static void RunBlurCacheBenchmark()
+{
+	const Texture::WorkingFormat workingFormats[] = { Texture::WorkingFormat::Gamma8, Texture::WorkingFormat::LinearFloat };
+	const char* workingFormatNames[] = { "8-bit", "linear float" };
+	const GLfloat maxBlurFactor = MAX_EXACT_BLUR_PERCENT / 100;
+	const GLfloat blurStep = 0.002f;
+	const int totalStepsUp = 10;
+	const int totalStepsDown = 5;
+
+	for (int i = 0; i < 2; i++)
+	{
+		Texture texture;
+		texture.SetWorkingFormat(workingFormats[i]);
+
+		if (!texture.Load("Textures/Crate_1.png"))
+		{
+			return;
+		}
+
+		BlurCache blurCache(texture);
+		double hitTime = 0.0;
+		double missTime = 0.0;
+
+		//the steps Quad::Blur takes, timed
+		auto blur = [&](GLfloat blurFactor)
+		{
+			Timer timer;
+			blurCache.OnInput(blurFactor);
+			std::shared_ptr<const Texture::BlurResult> blurResult = blurCache.Find(blurFactor);
+
+			if (blurResult)
+			{
+				texture.ApplyBlur(*blurResult, false);
+			}
+			else
+			{
+				texture.Blur(blurFactor, false);
+			}
+
+			texture.Reload();
+			glFinish();
+			return timer.GetElapsedMilliseconds();
+		};
+
+		GLfloat blurFactor = 0.01f;
+
+		for (int step = 0; step <= totalStepsUp + totalStepsDown; step++)
+		{
+			BlurCache::Statistics statistics = blurCache.GetStatistics();
+			double time = blur(blurFactor);
+			((blurCache.GetStatistics().totalHits > statistics.totalHits) ? hitTime : missTime) += time;
+
+			//the pause after the step, in which the slider is idle
+			blurCache.Speculate(maxBlurFactor);
+			blurCache.WaitForSpeculation();
+
+			blurFactor += (step < totalStepsUp) ? blurStep : -blurStep;
+		}
+
+		BlurCache::Statistics statistics = blurCache.GetStatistics();
+		GLuint totalSpeculated = statistics.totalSpeculated;
+
+		//the fast drag starts anew, away from the blurs computed in the pauses
+		blurCache.Reset();
+		blurFactor = 0.01f;
+		Timer timer;
+
+		for (int step = 0; step < totalStepsUp; step++)
+		{
+			blurFactor += blurStep;
+			blur(blurFactor);
+			blurCache.Speculate(maxBlurFactor);
+		}
+
+		double fastDragTime = timer.GetElapsedMilliseconds();
+		BlurCache::Statistics fastDragStatistics = blurCache.GetStatistics();
+
+		std::cout << "Blur cache benchmark: " << workingFormatNames[i] << " " << statistics.totalHits << " hits " 
+			      << ((statistics.totalHits > 0) ? hitTime / statistics.totalHits : 0.0) << " ms per step, " 
+			      << statistics.totalMisses << " misses " << ((statistics.totalMisses > 0) ? missTime / statistics.totalMisses : 0.0) 
+			      << " ms per step, hit rate " << statistics.GetHitRate() * 100.0f << "%, " << totalSpeculated << " blurs computed ahead, " 
+			      << statistics.totalEvicted << " evicted, " << statistics.memoryUsed / (1024 * 1024) << " MB, fast drag " 
+			      << fastDragTime / totalStepsUp << " ms per step, " << fastDragStatistics.totalHits - statistics.totalHits << " hits, " 
+			      << fastDragStatistics.totalCancelled - statistics.totalCancelled << " blurs cancelled" << std::endl;
+
+		blurCache.Reset();
+		texture.Unload();
+	}
+}
+
+/// <summary>
+/// blurs an image in a directory of its own, once computing the blur and storing it in the effect cache, 
+/// and once as a new session would, reading it back, and checks both give the same pixels. 
+/// Blurs of more sizes than the size limit holds then report the evictions, which keep the cache within the limit
+/// </summary>
+static void RunEffectCacheBenchmark()
+{
+	const Texture::WorkingFormat workingFormats[] = { Texture::WorkingFormat::Gamma8, Texture::WorkingFormat::LinearFloat };
+	const char* workingFormatNames[] = { "8-bit", "linear float" };
+	const GLfloat blurFactor = MAX_EXACT_BLUR_PERCENT / 100;
+
+	EffectCache* effectCache = EffectCache::Instance();
+	Uint64 maxSize = effectCache->GetMaxSize();
+	std::string directory = effectCache->GetDirectory();
+
+	char* cachePath = SDL_GetPrefPath("QuadInSpace", "EffectCacheBenchmark");
+	if (!cachePath)
+	{
+		return;
+	}
+
+	effectCache->SetDirectory(cachePath);
+	SDL_free(cachePath);
+	effectCache->SetEnabled(true);
+
+	for (int i = 0; i < 2; i++)
+	{
+		effectCache->Clear();
+
+		Texture computedTexture;
+		Texture cachedTexture;
+		computedTexture.SetWorkingFormat(workingFormats[i]);
+		cachedTexture.SetWorkingFormat(workingFormats[i]);
+
+		//incremental blurs are not stored, as they differ slightly from the blur of the source
+		computedTexture.SetIncrementalBlur(false);
+
+		if (!computedTexture.Load("Textures/Crate_1.png") || !cachedTexture.Load("Textures/Crate_1.png"))
+		{
+			return;
+		}
+
+		EffectCache::Statistics statistics = effectCache->GetStatistics();
+
+		Timer timer;
+		computedTexture.Blur(blurFactor, true);
+		double computedTime = timer.GetElapsedMilliseconds();
+
+		timer.Start();
+		cachedTexture.Blur(blurFactor, true);
+		double cachedTime = timer.GetElapsedMilliseconds();
+
+		EffectCache::Statistics cachedStatistics = effectCache->GetStatistics();
+
+		bool isSame = (workingFormats[i] == Texture::WorkingFormat::LinearFloat) ? 
+			          computedTexture.GetLinearPixelsWithEffects() == cachedTexture.GetLinearPixelsWithEffects() : 
+			          std::equal(computedTexture.GetPixelsWithEffects(), computedTexture.GetPixelsWithEffects() + 
+			                     computedTexture.GetWidth() * computedTexture.GetHeight() * computedTexture.GetBytesPerPixel(), 
+			                     cachedTexture.GetPixelsWithEffects());
+
+		//a limit of four and a half results, which the stores of the next sizes go over
+		Uint64 evictionMaxSize = cachedStatistics.size * 9 / 2;
+		effectCache->SetMaxSize(evictionMaxSize);
+
+		for (int step = 1; step <= 4; step++)
+		{
+			computedTexture.Blur(blurFactor + step * 0.004f, false);
+		}
+
+		EffectCache::Statistics evictedStatistics = effectCache->GetStatistics();
+		effectCache->SetMaxSize(maxSize);
+
+		std::cout << "Effect cache benchmark: " << workingFormatNames[i] << " computed and stored " << computedTime << " ms, read back " 
+			      << cachedTime << " ms, " << cachedStatistics.totalHits - statistics.totalHits << " hits, " 
+			      << cachedStatistics.totalStores - statistics.totalStores << " stores, " << (isSame ? "same" : "different") << " pixels, " 
+			      << evictedStatistics.totalEvictions - cachedStatistics.totalEvictions << " evicted to stay within " 
+			      << evictedStatistics.size / (1024.0 * 1024.0) << " MB of " << evictionMaxSize / (1024.0 * 1024.0) << " MB" << std::endl;
+
+		computedTexture.Unload();
+		cachedTexture.Unload();
+	}
+
+	effectCache->Clear();
+	effectCache->SetDirectory(directory);
+}
+
+/// <summary>
+/// compares the inner loop of a blur along the rows that checks every tap against the edges of the image with the loop 
+/// of HorizontalBlur, which reads rows padded with the pixels beyond their edges and sums a whole row per tap, 
+/// on the same 8-bit pixels at several radii. The exact blur is then applied with every edge mode, 
+/// and the brightness of the pixels along the edges compared with the image's
+/// </summary>
+static void RunPaddedBlurBenchmark()
+{
+	const GLsizei width = 2048;
+	const GLsizei height = 256;
+	const GLsizei depth = 4;
+	const GLsizei radii[] = { 4, 16, 64 };
+	const size_t rowSize = static_cast<size_t>(width) * depth;
+
+	std::vector<Uint8> pixels(rowSize * height);
+	std::vector<GLfloat> result(rowSize * height);
+
+	for (Uint8& value : pixels)
+	{
+		value = static_cast<Uint8>(rand() % 256);
+	}
+
+	for (GLsizei radius : radii)
+	{
+		std::vector<GLfloat> kernel(2 * radius + 1);
+		GLfloat sum = 0.0f;
+
+		for (GLsizei k = -radius; k <= radius; k++)
+		{
+			kernel[k + radius] = std::exp(-(k * k) / (2.0f * (radius * .3f) * (radius * .3f)));
+			sum += kernel[k + radius];
+		}
+
+		for (GLfloat& weight : kernel)
+		{
+			weight /= sum;
+		}
+
+		//every tap checked against the edges, as the blur was written before
+		Timer timer;
+
+		for (GLsizei i = 0; i < height; i++)
+		{
+			for (GLsizei j = 0; j < width; j++)
+			{
+				GLfloat red = 0.0f;
+				GLfloat green = 0.0f;
+				GLfloat blue = 0.0f;
+
+				for (GLsizei k = -radius; k <= radius; k++)
+				{
+					if (j + k >= 0 && j + k < width)
+					{
+						const Uint8* tap = &pixels[i * rowSize + (j + k) * depth];
+						red += kernel[k + radius] * tap[0];
+						green += kernel[k + radius] * tap[1];
+						blue += kernel[k + radius] * tap[2];
+					}
+				}
+
+				result[i * rowSize + j * depth] = red;
+				result[i * rowSize + j * depth + 1] = green;
+				result[i * rowSize + j * depth + 2] = blue;
+			}
+		}
+
+		double checkedTime = timer.GetElapsedMilliseconds();
+		size_t sampleIndex = (height / 2) * rowSize + (width / 2) * depth;
+		GLfloat checkedSample = result[sampleIndex];
+
+		//the padded rows of HorizontalBlur, where all channels are summed as one row of values
+		timer.Start();
+
+		PaddedBuffer<GLfloat> paddedRow;
+		paddedRow.Create(width, 1, depth, radius, 0);
+
+		for (GLsizei i = 0; i < height; i++)
+		{
+			paddedRow.SetRows(&pixels[i * rowSize], 0, 1, EdgeMode::Clamp);
+
+			const GLfloat* firstTap = paddedRow.GetRow(0) - radius * depth;
+			GLfloat* row = &result[i * rowSize];
+			std::fill_n(row, rowSize, 0.0f);
+
+			for (GLsizei k = 0; k <= 2 * radius; k++)
+			{
+				GLfloat weight = kernel[k];
+				const GLfloat* tapRow = firstTap + k * depth;
+
+				for (size_t x = 0; x < rowSize; x++)
+				{
+					row[x] += weight * tapRow[x];
+				}
+			}
+		}
+
+		double paddedTime = timer.GetElapsedMilliseconds();
+		double totalTaps = static_cast<double>(width) * height * (2 * radius + 1);
+
+		std::cout << "Padded blur benchmark: radius " << radius << ", bounds checked " << totalTaps / checkedTime / 1000.0 
+			      << " Mtaps/s, padded " << totalTaps / paddedTime / 1000.0 << " Mtaps/s (" << checkedTime / paddedTime 
+			      << "x), difference inside " << std::abs(result[sampleIndex] - checkedSample) << std::endl;
+	}
+
+	Texture texture;
+	texture.SetWorkingFormat(Texture::WorkingFormat::Gamma8);
+
+	if (!texture.Load("Textures/Crate_1.png"))
+	{
+		return;
+	}
+
+	//the mean of the colors of the pixels along the edges of the image
+	auto getEdgeMean = [&texture](const Uint8* edgePixels)
+	{
+		double sum = 0.0;
+		GLuint totalValues = 0;
+
+		for (GLsizei i = 0; i < texture.GetHeight(); i++)
+		{
+			for (GLsizei j = 0; j < texture.GetWidth(); j++)
+			{
+				if (i > 0 && i < texture.GetHeight() - 1 && j > 0 && j < texture.GetWidth() - 1)
+				{
+					continue;
+				}
+
+				for (int channel = 0; channel < 3; channel++)
+				{
+					sum += edgePixels[(i * texture.GetWidth() + j) * texture.GetBytesPerPixel() + channel];
+					totalValues++;
+				}
+			}
+		}
+
+		return sum / totalValues;
+	};
+
+	double sourceMean = getEdgeMean(texture.GetPixelsWithEffects());
+
+	for (int i = 0; i <= static_cast<int>(EdgeMode::Zero); i++)
+	{
+		texture.SetEdgeMode(static_cast<EdgeMode>(i));
+
+		Timer timer;
+		texture.Blur(MAX_EXACT_BLUR_PERCENT / 100, false);
+		double blurTime = timer.GetElapsedMilliseconds();
+
+		std::cout << "Padded blur benchmark: " << GetEdgeModeName(static_cast<EdgeMode>(i)) << " edges, exact 8-bit blur " << blurTime << " ms, edge brightness " 
+			      << getEdgeMean(texture.GetPixelsWithEffects()) / sourceMean * 100.0 << "% of the image's" << std::endl;
+	}
+
+	texture.Unload();
+}
+
+/// <summary>
+/// compares the pyramid blur on the CPU and the GPU with the exact gaussian blur of HorizontalBlur and VerticalBlur 
+/// at several sizes, in time and in the peak signal to noise ratio of the 8-bit results, and with the same gaussian in floats. 
+/// The edges, where the float gaussian leaves out the taps beyond them and the other blurs repeat the edge pixels, 
+/// are left out of the comparison
+/// </summary>
+static void RunPyramidBlurBenchmark()
+{
+	const GLfloat blurFactors[] = { 0.01f, 0.05f, 0.2f };
+
+	Texture texture;
+	texture.SetWorkingFormat(Texture::WorkingFormat::Gamma8);
+
+	if (!texture.Load("Textures/Crate_1.png"))
+	{
+		return;
+	}
+
+	GLsizei width = texture.GetWidth();
+	GLsizei height = texture.GetHeight();
+	Uint8 depth = texture.GetBytesPerPixel();
+	size_t totalPixels = static_cast<size_t>(width) * height;
+
+	std::vector<GLfloat> pixels(totalPixels * 4, 1.0f);
+
+	for (size_t i = 0; i < totalPixels * depth; i++)
+	{
+		pixels[i / depth * 4 + i % depth] = texture.GetPixelsWithEffects()[i];
+	}
+
+	for (GLfloat blurFactor : blurFactors)
+	{
+		GLsizei radius = GLsizei(blurFactor * width / 2);
+		GLsizei margin = radius;
+
+		//peak signal to noise ratio of the 8-bit pixels with effects against RGBA float pixels, inside the margin
+		auto measurePsnr = [&](const std::vector<GLfloat>& reference)
+		{
+			double squaredErrorSum = 0.0;
+			size_t totalValues = 0;
+
+			for (GLsizei y = margin; y < height - margin; y++)
+			{
+				for (GLsizei x = margin; x < width - margin; x++)
+				{
+					for (Uint8 channel = 0; channel < std::min(depth, Uint8(3)); channel++)
+					{
+						size_t index = static_cast<size_t>(y) * width + x;
+						double error = texture.GetPixelsWithEffects()[index * depth + channel] - reference[index * 4 + channel];
+
+						squaredErrorSum += error * error;
+						totalValues++;
+					}
+				}
+			}
+
+			double meanSquaredError = squaredErrorSum / std::max(totalValues, size_t(1));
+			return (meanSquaredError > 0.0) ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+		};
+
+		std::vector<GLfloat> gaussianPixels(pixels.size());
+		Convolution::Instance()->Apply(pixels.data(), gaussianPixels.data(), width, height, Kernel::CreateGaussian(radius, radius * .3f));
+
+		Timer timer;
+		texture.Blur(blurFactor, false);
+		double exactTime = timer.GetElapsedMilliseconds();
+
+		std::vector<GLfloat> exactPixels(pixels.size());
+
+		for (size_t i = 0; i < totalPixels * depth; i++)
+		{
+			exactPixels[i / depth * 4 + i % depth] = texture.GetPixelsWithEffects()[i];
+		}
+
+		std::cout << "Pyramid blur benchmark: " << blurFactor * 100.0f << "%, exact " << exactTime 
+			      << " ms (PSNR against float gaussian " << measurePsnr(gaussianPixels) << " dB)";
+
+		for (bool isOnGpu : { false, true })
+		{
+			timer.Start();
+			texture.BlurWithPyramid(blurFactor, false, isOnGpu);
+			double pyramidTime = timer.GetElapsedMilliseconds();
+
+			std::cout << ", " << (isOnGpu ? "GPU" : "CPU") << " pyramid " << pyramidTime << " ms (PSNR against exact " 
+				      << measurePsnr(exactPixels) << " dB, against float gaussian " << measurePsnr(gaussianPixels) << " dB)";
+		}
+
+		std::cout << std::endl;
+	}
+
+	texture.Unload();
+}
+
+/// <summary>
+/// convolves an image with kernels of several shapes and sizes by each method, reporting the time of each, 
+/// the largest difference from the direct method and whether the automatic choice was the fastest
+/// </summary>
+static void RunConvolutionBenchmark()
+{
+	const GLsizei width = 1024;
+	const GLsizei height = 1024;
+	const Convolution::Method methods[] = { Convolution::Method::Direct, Convolution::Method::Separable, Convolution::Method::FFT };
+
+	struct BenchmarkKernel
+	{
+		const char* name;
+		Kernel kernel;
+	};
+
+	const BenchmarkKernel kernels[] = 
+	{
+		{ "gaussian 7", Kernel::CreateGaussian(3, 1.0f) },
+		{ "gaussian 41", Kernel::CreateGaussian(20, 6.0f) },
+		{ "motion blur 41", Kernel::CreateMotionBlur(41, 30.0f) },
+		{ "lens blur 11", Kernel::CreateDisc(5) },
+		{ "lens blur 41", Kernel::CreateDisc(20) },
+		{ "sharpen 7", Kernel::CreateSharpen(3, 1.0f) }
+	};
+
+	std::vector<GLfloat> pixels(static_cast<size_t>(width) * height * 4);
+	std::vector<GLfloat> directResult(pixels.size());
+	std::vector<GLfloat> result(pixels.size());
+
+	for (GLfloat& value : pixels)
+	{
+		value = static_cast<GLfloat>(rand()) / RAND_MAX;
+	}
+
+	for (const BenchmarkKernel& benchmarkKernel : kernels)
+	{
+		std::cout << "Convolution benchmark: " << benchmarkKernel.name;
+
+		double fastestTime = 0.0;
+		Convolution::Method fastestMethod = Convolution::Method::Direct;
+
+		for (Convolution::Method method : methods)
+		{
+			Convolution::Instance()->Apply(pixels.data(), method == Convolution::Method::Direct ? directResult.data() : result.data(), 
+				                           width, height, benchmarkKernel.kernel, method);
+			Convolution::Stats stats = Convolution::Instance()->GetLastStats();
+
+			//methods that do not apply fall back to the direct one
+			if (stats.method != method)
+			{
+				continue;
+			}
+
+			GLfloat maxDifference = 0.0f;
+
+			for (size_t i = 0; method != Convolution::Method::Direct && i < result.size(); i++)
+			{
+				maxDifference = std::max(maxDifference, std::abs(result[i] - directResult[i]));
+			}
+
+			std::cout << ", " << Convolution::GetMethodName(method) << " " << stats.milliseconds << " ms";
+
+			if (method != Convolution::Method::Direct)
+			{
+				std::cout << " (max difference " << maxDifference << ")";
+			}
+
+			if (fastestTime == 0.0 || stats.milliseconds < fastestTime)
+			{
+				fastestTime = stats.milliseconds;
+				fastestMethod = method;
+			}
+		}
+
+		Convolution::Instance()->Apply(pixels.data(), result.data(), width, height, benchmarkKernel.kernel);
+		Convolution::Method automaticMethod = Convolution::Instance()->GetLastStats().method;
+
+		std::cout << ", automatic picked " << Convolution::GetMethodName(automaticMethod) 
+			      << (automaticMethod == fastestMethod ? " (fastest)" : " (not the fastest)") << std::endl;
+	}
+}
+
+/// <summary>
+/// times a parallel loop on idle workers and on workers busy with queued background and speculative tasks, 
+/// and checks that task graphs run in the order of their dependencies and that cancelled tasks are dropped
+/// </summary>
+static void RunTaskSchedulerBenchmark()
+{
+	TaskScheduler* scheduler = TaskScheduler::Instance();
+	const GLuint totalItems = 64;
+	const double itemMilliseconds = 0.5;
+	const double lowerTaskMilliseconds = 20.0;
+	const GLuint totalGraphs = 200;
+	const GLuint totalCancelledTasks = 100;
+
+	//keeps a core busy for the given time, as the effects do
+	auto spin = [](double milliseconds)
+	{
+		Timer timer;
+
+		while (timer.GetElapsedMilliseconds() < milliseconds)
+		{
+		}
+	};
+
+	auto runParallelFor = [&]()
+	{
+		Timer timer;
+		scheduler->ParallelFor(totalItems, [&](GLuint first, GLuint last)
+		{
+			for (GLuint item = first; item < last; item++)
+			{
+				spin(itemMilliseconds);
+			}
+		}, TaskPriority::Interactive);
+		return timer.GetElapsedMilliseconds();
+	};
+
+	double idleTime = runParallelFor();
+
+	//more saves and speculation queued than there are threads, each taking longer than the whole loop
+	std::vector<TaskHandle> lowerTasks;
+	GLuint totalLowerTasks = 4 * (scheduler->GetTotalWorkers() + 1);
+
+	for (GLuint i = 0; i < totalLowerTasks; i++)
+	{
+		TaskPriority priority = (i % 2 == 0) ? TaskPriority::Background : TaskPriority::Speculative;
+		lowerTasks.push_back(scheduler->Submit([&]() { spin(lowerTaskMilliseconds); }, priority));
+	}
+
+	double busyTime = runParallelFor();
+	GLuint totalLowerTasksDone = static_cast<GLuint>(std::count_if(lowerTasks.begin(), lowerTasks.end(), [](const TaskHandle& task)
+	{
+		return task->IsDone();
+	}));
+
+	scheduler->Wait(lowerTasks);
+
+	std::cout << "Task scheduler benchmark: parallel loop " << idleTime << " ms on idle workers, " << busyTime << " ms with " 
+		      << totalLowerTasks << " background and speculative tasks queued, " << totalLowerTasksDone << " of which finished first" << std::endl;
+
+	//diamonds of tasks: both middle tasks see the first one done, and the last one sees both middle ones done
+	GLuint totalOutOfOrder = 0;
+	Timer timer;
+
+	for (GLuint i = 0; i < totalGraphs; i++)
+	{
+		std::atomic<GLuint> totalDone{ 0 };
+		std::atomic<bool> isOutOfOrder{ false };
+
+		TaskHandle first = scheduler->Submit([&]() { totalDone++; }, TaskPriority::Background);
+
+		auto middle = [&]()
+		{
+			isOutOfOrder = isOutOfOrder || totalDone == 0;
+			totalDone++;
+		};
+
+		TaskHandle left = scheduler->Submit(middle, TaskPriority::Background, { first });
+		TaskHandle right = scheduler->Submit(middle, TaskPriority::Background, { first });
+		TaskHandle last = scheduler->Submit([&]() { isOutOfOrder = isOutOfOrder || totalDone != 3; }, TaskPriority::Background, { left, right });
+
+		scheduler->Wait(last);
+		totalOutOfOrder += isOutOfOrder ? 1 : 0;
+	}
+
+	double graphTime = timer.GetElapsedMilliseconds();
+
+	//most of these are still queued when the token is cancelled
+	CancellationToken token;
+	std::atomic<GLuint> totalStarted{ 0 };
+	std::vector<TaskHandle> tasks;
+	Uint32 totalCancelledBefore = scheduler->GetTotalCancelledTasks();
+
+	for (GLuint i = 0; i < totalCancelledTasks; i++)
+	{
+		tasks.push_back(scheduler->Submit([&]() { totalStarted++; spin(0.1); }, TaskPriority::Speculative, {}, token));
+	}
+
+	token.Cancel();
+	scheduler->Wait(tasks);
+
+	std::cout << "Task scheduler benchmark: " << totalGraphs << " task graphs in " << graphTime << " ms, " << totalOutOfOrder 
+		      << " out of order, " << scheduler->GetTotalCancelledTasks() - totalCancelledBefore << " of " << totalCancelledTasks 
+		      << " cancelled tasks dropped, " << totalStarted << " started" << std::endl;
+
+	std::vector<TaskScheduler::WorkerStatistics> statistics = scheduler->GetWorkerStatistics();
+
+	for (size_t i = 0; i < statistics.size(); i++)
+	{
+		std::cout << "Task scheduler benchmark: " << ((i < scheduler->GetTotalWorkers()) ? "worker " + std::to_string(i + 1) : "waiting threads") 
+			      << " busy " << statistics[i].busyMilliseconds << " ms, " << statistics[i].totalTasks << " tasks, " 
+			      << statistics[i].totalStolenTasks << " stolen" << std::endl;
+	}
+}
+
+/// <summary>
+/// loads an image and blurs it once on the main thread, as before the asset pipeline, and through the pipeline 
+/// while the frame loop keeps running, uploading on the upload thread and on the main thread, 
+/// and reports the total time of each and the longest the frame loop was held up
+/// </summary>
+static void RunAssetPipelineBenchmark()
+{
+	const std::string filename = "Textures/Crate_1.png";
+	const GLfloat blurPercent = 3.0f;
+
+	Timer timer;
+	Texture texture;
+
+	if (!texture.Load(filename))
+	{
+		return;
+	}
+
+	texture.Blur(blurPercent / 100, false);
+	texture.Reload();
+	glFinish();
+	double blockingTime = timer.GetElapsedMilliseconds();
+	texture.Unload();
+
+	std::cout << "Asset pipeline benchmark: load and blur " << blurPercent << "% on the main thread " << blockingTime << " ms" << std::endl;
+
+	bool isUploadThreadRunning = UploadThread::Instance()->IsRunning();
+
+	//the blur of the quad runs on the workers at full resolution, like the one on the main thread
+	FrameBudget frameBudget;
+	frameBudget.SetSlicing(false);
+	PreviewResolution previewResolution(frameBudget);
+	previewResolution.SetAdaptive(false);
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		//the second pass uploads through the buffer on the main thread, as without a shared context
+		if (pass == 1)
+		{
+			UploadThread::Instance()->Stop();
+		}
+		else if (!UploadThread::Instance()->IsRunning())
+		{
+			continue;
+		}
+
+		Quad quad(frameBudget, previewResolution);
+		int totalFrames = 0;
+		double maxFrameTime = 0.0;
+
+		timer.Start();
+		quad.LoadNewTexture(filename);
+		quad.Blur(blurPercent, false);
+
+		//a frame of the loop only resumes the steps that are due on the main thread
+		while (quad.IsBusy())
+		{
+			Timer frameTimer;
+			MainThread::Instance()->RunPending();
+			maxFrameTime = std::max(maxFrameTime, frameTimer.GetElapsedMilliseconds());
+			totalFrames++;
+			SDL_Delay(1);
+		}
+
+		glFinish();
+		double pipelineTime = timer.GetElapsedMilliseconds();
+
+		std::cout << "Asset pipeline benchmark: through the pipeline, uploaded on the " << ((pass == 0) ? "upload" : "main") 
+			      << " thread, " << pipelineTime << " ms over " << totalFrames << " frames, longest frame " << maxFrameTime << " ms" << std::endl;
+	}
+
+	if (isUploadThreadRunning)
+	{
+		UploadThread::Instance()->Start();
+	}
+}
+
+/// <summary>
+/// blurs an image on the workers, then time-sliced on the main thread within budgets of a few milliseconds, 
+/// while the frame loop keeps running, and reports the total time of each, the frames it took and the longest frame
+/// </summary>
+static void RunTimeSlicingBenchmark()
+{
+	const std::string filename = "Textures/Crate_1.png";
+	const GLfloat blurPercent = 3.0f;
+	const double budgets[] = { 0.0, 4.0, 8.0 }; //none runs the blur on the workers
+
+	for (double budget : budgets)
+	{
+		FrameBudget frameBudget;
+		PreviewResolution previewResolution(frameBudget);
+		previewResolution.SetAdaptive(false);
+
+		Quad quad(frameBudget, previewResolution);
+		quad.LoadNewTexture(filename);
+		quad.Finish();
+
+		//the budget is fixed, as the frames of the benchmark are not held to the display's rate
+		frameBudget.SetSlicing(budget > 0.0);
+		frameBudget.SetAdaptive(false);
+		frameBudget.SetMaxMilliseconds(budget);
+
+		int totalFrames = 0;
+		double maxFrameTime = 0.0;
+
+		Timer timer;
+		quad.Blur(blurPercent, false);
+
+		while (quad.IsBusy())
+		{
+			Timer frameTimer;
+			frameBudget.BeginFrame();
+			MainThread::Instance()->RunPending();
+			maxFrameTime = std::max(maxFrameTime, frameTimer.GetElapsedMilliseconds());
+			totalFrames++;
+			SDL_Delay(1);
+		}
+
+		glFinish();
+		double blurTime = timer.GetElapsedMilliseconds();
+
+		if (budget > 0.0)
+		{
+			std::cout << "Time slicing benchmark: blur " << blurPercent << "% time-sliced within " << budget << " ms per frame ";
+		}
+		else
+		{
+			std::cout << "Time slicing benchmark: blur " << blurPercent << "% on the workers ";
+		}
+
+		std::cout << blurTime << " ms over " << totalFrames << " frames, longest frame " << maxFrameTime << " ms" << std::endl;
+	}
+}
+
+/// <summary>
+/// drags the gaussian blur slider at the rate of a hand on the mouse, at full resolution and with adaptive previews, 
+/// and reports the longest frame of the drag, the time from its end until the blur is shown at full resolution, 
+/// and the preview scale chosen. The target latency is short, as the test image is small
+/// </summary>
+static void RunPreviewBenchmark()
+{
+	const std::string filename = "Textures/Crate_1.png";
+	const GLfloat minBlurPercent = 1.0f;
+	const GLfloat blurStep = 0.25f;
+	const int totalSteps = 12;
+	const double stepMilliseconds = 33.0;
+	const double targetLatency = 5.0;
+	const double settleTime = 100.0;
+
+	for (int i = 0; i < 2; i++)
+	{
+		//the blurs run on the workers, so only the previews change the frames
+		FrameBudget frameBudget;
+		frameBudget.SetSlicing(false);
+		PreviewResolution previewResolution(frameBudget);
+		previewResolution.SetTargetLatencyMilliseconds(targetLatency);
+		previewResolution.SetSettleMilliseconds(settleTime);
+
+		Quad quad(frameBudget, previewResolution);
+		quad.LoadNewTexture(filename);
+		quad.Finish();
+
+		previewResolution.SetAdaptive(i == 1);
+
+		double maxFrameTime = 0.0;
+		auto runFrame = [&quad, &maxFrameTime, &frameBudget, &previewResolution]()
+		{
+			Timer frameTimer;
+			frameBudget.BeginFrame();
+			previewResolution.BeginFrame(quad.IsBusy());
+			MainThread::Instance()->RunPending();
+			maxFrameTime = std::max(maxFrameTime, frameTimer.GetElapsedMilliseconds());
+			SDL_Delay(1);
+		};
+
+		for (int step = 0; step < totalSteps; step++)
+		{
+			Timer stepTimer;
+			quad.Blur(minBlurPercent + step * blurStep, false);
+
+			while (stepTimer.GetElapsedMilliseconds() < stepMilliseconds)
+			{
+				runFrame();
+			}
+		}
+
+		Timer settleTimer;
+
+		while (quad.IsBusy())
+		{
+			runFrame();
+		}
+
+		glFinish();
+
+		std::cout << "Preview benchmark: drag of " << totalSteps << " steps " << ((i == 1) ? "with adaptive previews" : "at full resolution") 
+			      << ", longest frame " << maxFrameTime << " ms, full resolution shown " << settleTimer.GetElapsedMilliseconds() 
+			      << " ms after the drag, preview scale 1/" << previewResolution.GetScaleFactor() << std::endl;
+	}
+}
+
+/// <summary>
+/// fills a scene with walls of 1k, 10k and 100k quads, renders each wall for a few seconds with vsync off 
+/// and reports the average frame rate. Clicking a quad during the test reports its index.
+/// </summary>
+/// <param name="camera">the camera the scene is viewed with</param>
+/// <returns>returns false if the window was closed during the test</returns>
+static bool RunStressTest(const Camera& camera)
+{
+	const GLuint totalQuads[] = { 1000, 10000, 100000 };
+	const double testDuration = 3000.0;
+
+	SDL_GL_SetSwapInterval(0);
+
+	Scene scene;
+	GLint textureIndex = scene.LoadTexture("Textures/Crate_1.png");
+
+	if (textureIndex == -1)
+	{
+		return true;
+	}
+
+	bool isWindowOpen = true;
+
+	for (GLuint total : totalQuads)
+	{
+		//lay out the quads as a square wall that fills the view
+		GLuint columns = static_cast<GLuint>(std::ceil(std::sqrt(static_cast<float>(total))));
+		GLfloat size = 2.0f / columns;
+
+		scene.Clear();
+		for (GLuint i = 0; i < total; i++)
+		{
+			glm::vec3 position(-1.0f + size * (i % columns + 0.5f), 1.0f - size * (i / columns + 0.5f), 0.0f);
+			scene.AddQuad(textureIndex, position, glm::vec3(0.0f), glm::vec3(size * 0.9f, size * 0.9f, 1.0f));
+		}
+
+		Timer timer;
+		int totalFrames = 0;
+		bool wasLeftButtonDown = false;
+
+		while (isWindowOpen && timer.GetElapsedMilliseconds() < testDuration)
+		{
+			Screen::Instance()->ClearScreen();
+
+			SDL_Event event;
+			if (SDL_PollEvent(&event) && event.type == SDL_QUIT)
+			{
+				isWindowOpen = false;
+			}
+
+			int mouseX;
+			int mouseY;
+			bool isLeftButtonDown = (SDL_GetMouseState(&mouseX, &mouseY) & SDL_BUTTON(SDL_BUTTON_LEFT)) != 0;
+			if (isLeftButtonDown && !wasLeftButtonDown)
+			{
+				std::cout << "Stress test: picked quad " << scene.Pick(camera, mouseX, mouseY) << std::endl;
+			}
+			wasLeftButtonDown = isLeftButtonDown;
+
+			scene.Update(camera);
+			scene.Render();
+
+			Screen::Instance()->Present();
+			totalFrames++;
+		}
+
+		std::cout << "Stress test: " << total << " quads, " << scene.GetTotalVisibleQuads() << " visible, "
+			      << totalFrames * 1000.0 / timer.GetElapsedMilliseconds() << " FPS" << std::endl;
+	}
+
+	SDL_GL_SetSwapInterval(1);
+
+	return isWindowOpen;
+}
+
+/// <summary>
+/// runs the stress test and every benchmark in turn. The benchmarks time the effects themselves at full resolution, 
+/// not the results of a previous run read back from the disk, so the effect cache is turned off meanwhile. 
+/// The quads of the benchmarks have frame budgets and preview resolutions of their own, set for what each one times
+/// </summary>
+/// <param name="camera">the camera the scene is viewed with</param>
+/// <param name="viewWidth">width of the view of the camera, in pixels</param>
+/// <param name="viewHeight">height of the view of the camera, in pixels</param>
+/// <returns>returns false if the window was closed during the stress test</returns>
+bool RunBenchmarks(const Camera& camera, GLsizei viewWidth, GLsizei viewHeight)
+{
+	bool isEffectCacheEnabled = EffectCache::Instance()->IsEnabled();
+	EffectCache::Instance()->SetEnabled(false);
+
+	bool isWindowOpen = RunStressTest(camera);
+	RunBVHBenchmark(camera, viewWidth, viewHeight);
+	RunColorBenchmark();
+	RunConvolutionBenchmark();
+	RunTaskSchedulerBenchmark();
+	RunAssetPipelineBenchmark();
+	RunSummedAreaTableBenchmark();
+	RunPyramidBlurBenchmark();
+	RunPaddedBlurBenchmark();
+	RunBlurDragBenchmark();
+	RunBlurCacheBenchmark();
+	RunEffectCacheBenchmark();
+	RunTimeSlicingBenchmark();
+	RunPreviewBenchmark();
+
+	EffectCache::Instance()->SetEnabled(isEffectCacheEnabled);
+
+	return isWindowOpen;
+}
\ No newline at end of file
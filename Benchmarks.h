@@ -0,0 +1,9 @@
+#pragma once
+
+#include "gl.h"
+
+class Camera;
+
+//the stress test and the benchmarks run by '--stress', which print what they measure to the console. 
+//They load their test images from Textures in the working directory
+bool RunBenchmarks(const Camera& camera, GLsizei viewWidth, GLsizei viewHeight);
\ No newline at end of file
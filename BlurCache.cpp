@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "BlurCache.h"
+
+//the memory the blurs computed ahead of time may take, about 16 blurs of a 2048 x 2048 image in linear light
+static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+//the slider steps computed ahead of time, in the direction of the last drag and against it
+static const GLuint TOTAL_STEPS_AHEAD = 4;
+static const GLuint TOTAL_STEPS_BEHIND = 2;
+
+GLfloat BlurCache::Statistics::GetHitRate() const
+{
+	GLuint totalLookups = totalHits + totalMisses;
+	return (totalLookups > 0) ? static_cast<GLfloat>(totalHits) / totalLookups : 0.0f;
+}
+
+BlurCache::BlurCache(const Texture& texture) : m_texture(texture)
+{
+	m_statistics.memoryBudget = DEFAULT_MEMORY_BUDGET;
+
+	m_blurFactor = 0.0f;
+	m_dragStep = 0.0f;
+	m_dragDirection = 1.0f;
+	m_isSpeculated = false;
+}
+
+BlurCache::~BlurCache()
+{
+	Cancel();
+	WaitForSpeculation();
+}
+
+/// <summary>
+/// drops the cached blurs and the speculative work, waiting for the jobs already started to stop. 
+/// Called before the loaded image or the working format of the texture change, as the jobs read them
+/// </summary>
+void BlurCache::Reset()
+{
+	Cancel();
+	WaitForSpeculation();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_entries.clear();
+	m_statistics.memoryUsed = 0;
+
+	m_blurFactor = 0.0f;
+	m_dragStep = 0.0f;
+	m_dragDirection = 1.0f;
+	m_isSpeculated = false;
+}
+
+void BlurCache::SetMemoryBudget(size_t memoryBudget)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statistics.memoryBudget = memoryBudget;
+	Evict();
+}
+
+/// <summary>
+/// cancels the speculative work for real input asking for a blur, and follows the direction the slider is dragged in
+/// </summary>
+void BlurCache::OnInput(GLfloat blurFactor)
+{
+	Cancel();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	GLfloat change = blurFactor - m_blurFactor;
+
+	if (change != 0.0f)
+	{
+		m_dragStep = std::abs(change);
+		m_dragDirection = (change > 0.0f) ? 1.0f : -1.0f;
+	}
+
+	m_blurFactor = blurFactor;
+	m_isSpeculated = false;
+}
+
+/// <summary>
+/// finds the blur for a blur factor among the blurs computed ahead of time
+/// </summary>
+/// <returns>returns nullptr if it was not computed, or if the blur leaves the image as it is</returns>
+std::shared_ptr<const Texture::BlurResult> BlurCache::Find(GLfloat blurFactor)
+{
+	Key key = GetKey(blurFactor);
+
+	if (key.first == 0 || key.second == 0)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto entry = m_entries.find(key);
+
+	if (entry == m_entries.end())
+	{
+		m_statistics.totalMisses++;
+		return nullptr;
+	}
+
+	m_statistics.totalHits++;
+	return entry->second;
+}
+
+/// <summary>
+/// whether the blur for a blur factor was computed ahead of time, without counting a hit or a miss
+/// </summary>
+bool BlurCache::Contains(GLfloat blurFactor) const
+{
+	Key key = GetKey(blurFactor);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_entries.find(key) != m_entries.end();
+}
+
+/// <summary>
+/// queues the blurs for the slider steps next to the last blur asked for, once after each input. 
+/// A step is the last change of the slider, or the smallest change that changes the blur if it was smaller. 
+/// The steps ahead in the drag direction come first, and no more are queued than the memory budget holds at once
+/// </summary>
+void BlurCache::Speculate(GLfloat maxBlurFactor)
+{
+	if (!m_texture.IsLoaded())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_isSpeculated)
+	{
+		return;
+	}
+
+	m_isSpeculated = true;
+	RemoveDoneJobs();
+
+	GLsizei width = m_texture.GetWidth();
+	GLsizei height = m_texture.GetHeight();
+	size_t totalPixels = static_cast<size_t>(width) * height;
+	size_t entrySize = (m_texture.GetWorkingFormat() == Texture::WorkingFormat::LinearFloat) ? 
+		               totalPixels * 4 * sizeof(GLfloat) : totalPixels * m_texture.GetBytesPerPixel();
+	size_t maxEntries = m_statistics.memoryBudget / std::max(entrySize, size_t(1));
+
+	//a step smaller than this one leaves both radii as they are
+	GLfloat step = std::max(m_dragStep, 2.0f / std::max(width, height));
+
+	//the first steps ahead and the first step behind come before the further ones
+	const GLfloat steps[] = { 1.0f, 2.0f, -1.0f, 3.0f, 4.0f, -2.0f };
+	static_assert(sizeof(steps) / sizeof(steps[0]) == TOTAL_STEPS_AHEAD + TOTAL_STEPS_BEHIND, "the steps must match their totals");
+
+	Key currentKey = GetKey(m_blurFactor);
+	CancellationToken token = m_token;
+
+	for (GLfloat totalSteps : steps)
+	{
+		GLfloat blurFactor = m_blurFactor + totalSteps * step * m_dragDirection;
+
+		if (blurFactor < 0.0f || blurFactor > maxBlurFactor)
+		{
+			continue;
+		}
+
+		Key key = GetKey(blurFactor);
+		bool isPending = std::any_of(m_jobs.begin(), m_jobs.end(), [&key](const Job& job) { return job.key == key; });
+
+		if (key.first == 0 || key.second == 0 || key == currentKey || isPending || m_entries.count(key) > 0)
+		{
+			continue;
+		}
+
+		//the cached blurs further away make room for these ones when they are done
+		if (m_jobs.size() >= maxEntries)
+		{
+			break;
+		}
+
+		TaskHandle task = TaskScheduler::Instance()->Submit([this, key, token]() { Compute(key, token); }, 
+			                                                TaskPriority::Speculative, {}, token);
+		m_jobs.push_back({ key, task });
+	}
+}
+
+/// <summary>
+/// waits until the queued blurs are computed or cancelled
+/// </summary>
+void BlurCache::WaitForSpeculation()
+{
+	std::vector<TaskHandle> tasks;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (const Job& job : m_jobs)
+		{
+			tasks.push_back(job.task);
+		}
+	}
+
+	TaskScheduler::Instance()->Wait(tasks);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	RemoveDoneJobs();
+}
+
+BlurCache::Statistics BlurCache::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	Statistics statistics = m_statistics;
+	statistics.totalEntries = static_cast<GLuint>(m_entries.size());
+
+	//jobs dropped before they started are counted when they are removed
+	statistics.totalCancelled += static_cast<GLuint>(std::count_if(m_jobs.begin(), m_jobs.end(), [](const Job& job)
+	{
+		return job.task->IsDone() && job.task->IsCancelled();
+	}));
+
+	return statistics;
+}
+
+/// <summary>
+/// runs as a speculative task, computing one blur. The blur checks the token before each row, 
+/// so real input stops it within a row
+/// </summary>
+void BlurCache::Compute(const Key& key, const CancellationToken& token)
+{
+	auto result = std::make_shared<Texture::BlurResult>();
+	bool isDone = m_texture.ComputeBlur(key.first, key.second, *result, [&token]() { return token.IsCancelled(); });
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	//a finished blur is kept even when input came meanwhile, as the image it was computed from is still loaded
+	if (isDone)
+	{
+		m_statistics.memoryUsed += result->GetSize();
+		m_statistics.totalSpeculated++;
+		m_entries[key] = result;
+		Evict();
+	}
+	else
+	{
+		m_statistics.totalCancelled++;
+	}
+}
+
+/// <summary>
+/// forgets the jobs that are done, counting those dropped before they started. Called with the mutex held
+/// </summary>
+void BlurCache::RemoveDoneJobs()
+{
+	auto firstDone = std::stable_partition(m_jobs.begin(), m_jobs.end(), [](const Job& job) { return !job.task->IsDone(); });
+
+	m_statistics.totalCancelled += static_cast<GLuint>(std::count_if(firstDone, m_jobs.end(), [](const Job& job)
+	{
+		return job.task->IsCancelled();
+	}));
+
+	m_jobs.erase(firstDone, m_jobs.end());
+}
+
+/// <summary>
+/// cancels the queued jobs and the ones running
+/// </summary>
+void BlurCache::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_token.Cancel();
+	m_token = CancellationToken();
+}
+
+/// <summary>
+/// drops the blurs furthest from the last one asked for until the cache is within its memory budget. 
+/// Called with the mutex held
+/// </summary>
+void BlurCache::Evict()
+{
+	while (m_statistics.memoryUsed > m_statistics.memoryBudget && !m_entries.empty())
+	{
+		auto furthestEntry = std::max_element(m_entries.begin(), m_entries.end(), [this](const auto& first, const auto& second)
+		{
+			return GetDistance(first.first) < GetDistance(second.first);
+		});
+
+		m_statistics.memoryUsed -= furthestEntry->second->GetSize();
+		m_statistics.totalEvicted++;
+		m_entries.erase(furthestEntry);
+	}
+}
+
+BlurCache::Key BlurCache::GetKey(GLfloat blurFactor) const
+{
+	Key key;
+	m_texture.GetBlurRadii(blurFactor, key.first, key.second);
+	return key;
+}
+
+/// <summary>
+/// how many radii a blur is from the last one asked for
+/// </summary>
+GLsizei BlurCache::GetDistance(const Key& key) const
+{
+	Key currentKey = GetKey(m_blurFactor);
+	return std::abs(key.first - currentKey.first) + std::abs(key.second - currentKey.second);
+}
\ No newline at end of file
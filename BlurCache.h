@@ -0,0 +1,83 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "gl.h"
+#include "TaskScheduler.h"
+#include "Texture.h"
+
+//blurs of the texture for the slider values next to the current one, computed as speculative tasks while the slider is idle, 
+//so that the next steps of a drag show at once. The blurs ahead in the direction of the last drag come first, 
+//and the cache is held to a memory budget. Real input cancels the speculative work at once, 
+//as the blur it asks for is computed on all cores
+class BlurCache
+{
+
+public:
+
+	struct Statistics
+	{
+		GLuint totalHits = 0;
+		GLuint totalMisses = 0;
+		GLuint totalSpeculated = 0; //blurs computed ahead of time
+		GLuint totalCancelled = 0; //speculative blurs dropped by real input before they were done
+		GLuint totalEvicted = 0; //blurs computed ahead of time and dropped to stay within the memory budget
+		GLuint totalEntries = 0;
+		size_t memoryUsed = 0;
+		size_t memoryBudget = 0;
+
+		GLfloat GetHitRate() const;
+	};
+
+	BlurCache(const Texture& texture);
+	~BlurCache();
+
+	void Reset();
+	void SetMemoryBudget(size_t memoryBudget);
+
+	void OnInput(GLfloat blurFactor);
+	std::shared_ptr<const Texture::BlurResult> Find(GLfloat blurFactor);
+	bool Contains(GLfloat blurFactor) const;
+	void Speculate(GLfloat maxBlurFactor);
+	void WaitForSpeculation();
+
+	Statistics GetStatistics() const;
+
+private:
+
+	using Key = std::pair<GLsizei, GLsizei>; //the radii of the blur along the rows and the columns
+
+	struct Job
+	{
+		Key key;
+		TaskHandle task;
+	};
+
+	BlurCache(const BlurCache&);
+	BlurCache& operator=(const BlurCache&);
+
+	void Compute(const Key& key, const CancellationToken& token);
+	void RemoveDoneJobs();
+	void Cancel();
+	void Evict();
+	Key GetKey(GLfloat blurFactor) const;
+	GLsizei GetDistance(const Key& key) const;
+
+	const Texture& m_texture;
+
+	mutable std::mutex m_mutex;
+	std::vector<Job> m_jobs; //queued or running
+	CancellationToken m_token; //cancelled by real input, which cancels every job queued or started before it
+
+	std::map<Key, std::shared_ptr<const Texture::BlurResult>> m_entries;
+	Statistics m_statistics;
+
+	GLfloat m_blurFactor; //the last blur factor asked for by real input
+	GLfloat m_dragStep; //the change of the blur factor on the last input
+	GLfloat m_dragDirection;
+	bool m_isSpeculated; //the blurs next to the last one asked for were queued
+
+};
\ No newline at end of file
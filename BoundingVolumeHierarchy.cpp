@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <limits>
+#include "BoundingVolumeHierarchy.h"
+
+//items per leaf. Small leaves keep culling precise, while the tree stays shallow enough for fast refits
+static const GLuint MAX_LEAF_ITEMS = 4;
+
+static BoundingVolumeHierarchy::AABB Union(const BoundingVolumeHierarchy::AABB& a, const BoundingVolumeHierarchy::AABB& b)
+{
+	return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+{
+}
+
+/// <summary>
+/// builds the tree from scratch by splitting the items at the median of their centers along the longest axis
+/// </summary>
+/// <param name="bounds">world space bounds of each item</param>
+void BoundingVolumeHierarchy::Build(const std::vector<AABB>& bounds)
+{
+	GLuint totalItems = static_cast<GLuint>(bounds.size());
+
+	m_nodes.clear();
+	m_nodes.reserve(totalItems / MAX_LEAF_ITEMS * 2 + 1);
+	m_items.resize(totalItems);
+	m_itemLeaves.resize(totalItems);
+
+	std::vector<glm::vec3> centers(totalItems);
+	for (GLuint i = 0; i < totalItems; i++)
+	{
+		m_items[i] = i;
+		centers[i] = (bounds[i].min + bounds[i].max) * 0.5f;
+	}
+
+	if (totalItems > 0)
+	{
+		BuildNode(0, totalItems, -1, bounds, centers);
+	}
+}
+
+/// <summary>
+/// updates the bounds of the leaves holding the given items, and of their ancestors. 
+/// Climbing stops as soon as a node's bounds are unchanged, so moving a few items costs only a few nodes.
+/// </summary>
+/// <param name="dirtyItems">items whose bounds changed since the last build or refit</param>
+/// <param name="bounds">world space bounds of each item</param>
+void BoundingVolumeHierarchy::Refit(const std::vector<GLuint>& dirtyItems, const std::vector<AABB>& bounds)
+{
+	for (GLuint item : dirtyItems)
+	{
+		GLint nodeIndex = m_itemLeaves[item];
+
+		while (nodeIndex != -1 && FitNode(nodeIndex, bounds))
+		{
+			nodeIndex = m_nodes[nodeIndex].parent;
+		}
+	}
+}
+
+/// <summary>
+/// collects the items whose bounds are at least partly inside the view frustum
+/// </summary>
+/// <param name="viewProjection">projection matrix multiplied by the view matrix of the camera</param>
+/// <param name="visibleItems">receives the indices of the visible items</param>
+void BoundingVolumeHierarchy::QueryFrustum(const glm::mat4& viewProjection, std::vector<GLuint>& visibleItems) const
+{
+	visibleItems.clear();
+
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	//the six frustum planes, extracted from the rows of the view projection matrix
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+	{
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	glm::vec4 planes[6] = { rows[3] + rows[0], rows[3] - rows[0],
+		                    rows[3] + rows[1], rows[3] - rows[1],
+		                    rows[3] + rows[2], rows[3] - rows[2] };
+
+	std::vector<GLint> stack;
+	stack.push_back(0);
+
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+
+		bool isOutside = false;
+		bool isInside = true;
+
+		for (const glm::vec4& plane : planes)
+		{
+			//the corners of the box furthest along and furthest against the plane normal
+			glm::vec3 positiveCorner(plane.x > 0.0f ? node.bounds.max.x : node.bounds.min.x,
+				                     plane.y > 0.0f ? node.bounds.max.y : node.bounds.min.y,
+				                     plane.z > 0.0f ? node.bounds.max.z : node.bounds.min.z);
+			glm::vec3 negativeCorner(plane.x > 0.0f ? node.bounds.min.x : node.bounds.max.x,
+				                     plane.y > 0.0f ? node.bounds.min.y : node.bounds.max.y,
+				                     plane.z > 0.0f ? node.bounds.min.z : node.bounds.max.z);
+
+			if (glm::dot(glm::vec3(plane), positiveCorner) + plane.w < 0.0f)
+			{
+				isOutside = true;
+				break;
+			}
+
+			if (glm::dot(glm::vec3(plane), negativeCorner) + plane.w < 0.0f)
+			{
+				isInside = false;
+			}
+		}
+
+		if (isOutside)
+		{
+			continue;
+		}
+
+		//a node that is completely inside the frustum contributes all of its items without visiting its children
+		if (isInside || node.left == -1)
+		{
+			visibleItems.insert(visibleItems.end(), 
+				m_items.begin() + node.firstItem, m_items.begin() + node.firstItem + node.totalItems);
+		}
+		else
+		{
+			stack.push_back(node.right);
+			stack.push_back(node.left);
+		}
+	}
+}
+
+/// <summary>
+/// finds the closest item hit by a ray. Only items whose bounds the ray passes through are given to the ray test.
+/// </summary>
+/// <param name="origin">start of the ray in world space</param>
+/// <param name="direction">direction of the ray in world space</param>
+/// <param name="rayTest">exact intersection test of the ray with a single item</param>
+/// <returns>index of the closest item hit, or -1 if no item was hit</returns>
+GLint BoundingVolumeHierarchy::Raycast(const glm::vec3& origin, const glm::vec3& direction, const RayTest& rayTest) const
+{
+	GLint closestItem = -1;
+	GLfloat closestDistance = std::numeric_limits<GLfloat>::max();
+
+	if (m_nodes.empty())
+	{
+		return closestItem;
+	}
+
+	glm::vec3 inverseDirection = 1.0f / direction;
+
+	//distance along the ray at which it enters the box, or a negative value if it misses the box
+	auto entryDistance = [&](const AABB& bounds)
+	{
+		glm::vec3 t1 = (bounds.min - origin) * inverseDirection;
+		glm::vec3 t2 = (bounds.max - origin) * inverseDirection;
+		glm::vec3 tNear = glm::min(t1, t2);
+		glm::vec3 tFar = glm::max(t1, t2);
+
+		GLfloat entry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+		GLfloat exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+
+		return (entry <= exit) ? entry : -1.0f;
+	};
+
+	std::vector<GLint> stack;
+	stack.push_back(0);
+
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+
+		GLfloat entry = entryDistance(node.bounds);
+
+		if (entry < 0.0f || entry > closestDistance)
+		{
+			continue;
+		}
+
+		if (node.left == -1)
+		{
+			for (GLuint i = node.firstItem; i < node.firstItem + node.totalItems; i++)
+			{
+				GLfloat distance;
+				if (rayTest(m_items[i], distance) && distance < closestDistance)
+				{
+					closestDistance = distance;
+					closestItem = m_items[i];
+				}
+			}
+		}
+		else
+		{
+			//visit the nearer child first, so that the further one can often be skipped
+			GLfloat leftEntry = entryDistance(m_nodes[node.left].bounds);
+			GLfloat rightEntry = entryDistance(m_nodes[node.right].bounds);
+
+			if (leftEntry >= 0.0f && rightEntry >= 0.0f && rightEntry < leftEntry)
+			{
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+			else
+			{
+				stack.push_back(node.right);
+				stack.push_back(node.left);
+			}
+		}
+	}
+
+	return closestItem;
+}
+
+GLuint BoundingVolumeHierarchy::GetTotalItems() const
+{
+	return static_cast<GLuint>(m_items.size());
+}
+
+GLint BoundingVolumeHierarchy::BuildNode(GLuint firstItem, GLuint totalItems, GLint parent,
+	const std::vector<AABB>& bounds, const std::vector<glm::vec3>& centers)
+{
+	GLint nodeIndex = static_cast<GLint>(m_nodes.size());
+	m_nodes.push_back({ bounds[m_items[firstItem]], -1, -1, parent, firstItem, totalItems });
+
+	if (totalItems <= MAX_LEAF_ITEMS)
+	{
+		for (GLuint i = firstItem; i < firstItem + totalItems; i++)
+		{
+			m_itemLeaves[m_items[i]] = nodeIndex;
+		}
+
+		FitNode(nodeIndex, bounds);
+		return nodeIndex;
+	}
+
+	//split along the axis in which the item centers are spread the most
+	glm::vec3 centerMin = centers[m_items[firstItem]];
+	glm::vec3 centerMax = centerMin;
+	for (GLuint i = firstItem; i < firstItem + totalItems; i++)
+	{
+		centerMin = glm::min(centerMin, centers[m_items[i]]);
+		centerMax = glm::max(centerMax, centers[m_items[i]]);
+	}
+
+	glm::vec3 extent = centerMax - centerMin;
+	int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+
+	GLuint half = totalItems / 2;
+	std::nth_element(m_items.begin() + firstItem, m_items.begin() + firstItem + half, m_items.begin() + firstItem + totalItems,
+		[&](GLuint a, GLuint b) { return centers[a][axis] < centers[b][axis]; });
+
+	//m_nodes may reallocate while building the children, so the node is only accessed by index
+	GLint left = BuildNode(firstItem, half, nodeIndex, bounds, centers);
+	GLint right = BuildNode(firstItem + half, totalItems - half, nodeIndex, bounds, centers);
+
+	m_nodes[nodeIndex].left = left;
+	m_nodes[nodeIndex].right = right;
+	FitNode(nodeIndex, bounds);
+
+	return nodeIndex;
+}
+
+/// <summary>
+/// recomputes the bounds of a node from its items (leaves) or its children (inner nodes)
+/// </summary>
+/// <returns>true if the bounds of the node changed</returns>
+bool BoundingVolumeHierarchy::FitNode(GLint nodeIndex, const std::vector<AABB>& bounds)
+{
+	Node& node = m_nodes[nodeIndex];
+	AABB fitted;
+
+	if (node.left == -1)
+	{
+		fitted = bounds[m_items[node.firstItem]];
+		for (GLuint i = node.firstItem + 1; i < node.firstItem + node.totalItems; i++)
+		{
+			fitted = Union(fitted, bounds[m_items[i]]);
+		}
+	}
+	else
+	{
+		fitted = Union(m_nodes[node.left].bounds, m_nodes[node.right].bounds);
+	}
+
+	bool isChanged = (fitted.min != node.bounds.min || fitted.max != node.bounds.max);
+	node.bounds = fitted;
+
+	return isChanged;
+}
\ No newline at end of file
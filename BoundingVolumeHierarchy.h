@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <glm.hpp>
+#include "gl.h"
+
+//a tree of axis aligned bounding boxes over a set of items (e.g. the quads of a Scene), 
+//used for frustum culling and ray picking without visiting every item
+class BoundingVolumeHierarchy
+{
+
+public:
+
+	struct AABB
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	//decides whether the ray hits an item, and if it does, sets the distance along the ray to the hit
+	using RayTest = std::function<bool(GLuint item, GLfloat& distance)>;
+
+	BoundingVolumeHierarchy();
+
+	void Build(const std::vector<AABB>& bounds);
+	void Refit(const std::vector<GLuint>& dirtyItems, const std::vector<AABB>& bounds);
+
+	void QueryFrustum(const glm::mat4& viewProjection, std::vector<GLuint>& visibleItems) const;
+	GLint Raycast(const glm::vec3& origin, const glm::vec3& direction, const RayTest& rayTest) const;
+
+	GLuint GetTotalItems() const;
+
+private:
+
+	struct Node
+	{
+		AABB bounds;
+		GLint left;
+		GLint right;
+		GLint parent;
+		GLuint firstItem; //every node covers a contiguous range of m_items
+		GLuint totalItems;
+	};
+
+	GLint BuildNode(GLuint firstItem, GLuint totalItems, GLint parent, 
+		const std::vector<AABB>& bounds, const std::vector<glm::vec3>& centers);
+	bool FitNode(GLint nodeIndex, const std::vector<AABB>& bounds);
+
+	std::vector<Node> m_nodes;
+	std::vector<GLuint> m_items; //item indices, ordered so that the items of each leaf are consecutive
+	std::vector<GLint> m_itemLeaves; //the leaf node holding each item
+
+};
\ No newline at end of file
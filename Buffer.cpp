@@ -1,106 +1,82 @@
 #include "Buffer.h"
-#include "Shader.h"
+#include "GLState.h"
 
 Buffer::Buffer()
 {
 	m_VAO = 0;
 	m_EBO = 0;
-	m_vertexVBO = 0;
-	m_colorVBO = 0;
-	m_textureVBO = 0;
+	m_VBO = 0;
+	m_instanceVBO = 0;
 	m_totalVertices = 0;
 	m_hasEBO = false;
 }
 
-void Buffer::CreateBuffer(GLuint totalVertices, bool hasEBO)
+void Buffer::CreateBuffer(GLuint totalVertices, bool hasEBO, bool hasInstanceVBO)
 {
-	glGenBuffers(1, &m_vertexVBO);
-	glGenBuffers(1, &m_colorVBO);
-	glGenBuffers(1, &m_textureVBO);
+	glCreateBuffers(1, &m_VBO);
 
-	glGenVertexArrays(1, &m_VAO);
+	glCreateVertexArrays(1, &m_VAO);
 
 	if (hasEBO)
 	{
-		glGenBuffers(1, &m_EBO);
+		glCreateBuffers(1, &m_EBO);
 		m_hasEBO = hasEBO;
 	}
 
+	if (hasInstanceVBO)
+	{
+		glCreateBuffers(1, &m_instanceVBO);
+	}
+
 	m_totalVertices = totalVertices;
 }
 
+/// <summary>
+/// fills the index buffer. Data filled once gets immutable storage, which lets the driver place it optimally
+/// </summary>
 void Buffer::FillEBO(const GLuint* data, GLsizeiptr bufferSize, FillType fill)
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, bufferSize, data, static_cast<GLenum>(fill));
+	if (fill == FillType::Once)
+	{
+		glNamedBufferStorage(m_EBO, bufferSize, data, 0);
+	}
+	else
+	{
+		glNamedBufferData(m_EBO, bufferSize, data, static_cast<GLenum>(fill));
+	}
 }
 
-void Buffer::FillVBO(VBOType vboType, GLfloat* data, GLsizeiptr bufferSize, FillType fillType)
+/// <summary>
+/// fills a vertex buffer with interleaved vertices, or with per-instance data. 
+/// Data filled once gets immutable storage, while ongoing data can be refilled with a different size.
+/// </summary>
+void Buffer::FillVBO(VBOType vboType, const void* data, GLsizeiptr bufferSize, FillType fillType)
 {
-	glBindVertexArray(m_VAO);
-
-		if (vboType == VBOType::VertexBuffer)
-		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO);
-		}
-
-		else if (vboType == VBOType::ColorBuffer)
-		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_colorVBO);
-		}
-		else
-		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_textureVBO);
-		}
+	GLuint VBO = (vboType == VBOType::VertexBuffer) ? m_VBO : m_instanceVBO;
 
-		glBufferData(GL_ARRAY_BUFFER, bufferSize, data, static_cast<GLenum>(fillType));
-
-	glBindVertexArray(0);
+	if (fillType == FillType::Once)
+	{
+		glNamedBufferStorage(VBO, bufferSize, data, 0);
+	}
+	else
+	{
+		glNamedBufferData(VBO, bufferSize, data, static_cast<GLenum>(fillType));
+	}
 }
 
 void Buffer::LinkEBO()
 {
-	glBindVertexArray(m_VAO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-	glBindVertexArray(0);
-}
-
-void Buffer::LinkVBO(const std::string& attribute, VBOType vboType, ComponentType componentType, DataType dataType)
-{
-	
-	GLuint shaderProgramID = Shader::Instance()->GetShaderProgramID();
-
-	GLint ID = glGetAttribLocation(shaderProgramID, attribute.c_str());
-
-	glBindVertexArray(m_VAO);
-
-		if (vboType == VBOType::VertexBuffer)
-		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO);
-		}
-		else if (vboType == VBOType::ColorBuffer)
-		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_colorVBO);
-		}
-		else
-		{
-			glBindBuffer(GL_ARRAY_BUFFER, m_textureVBO);
-		}
-
-		glVertexAttribPointer(ID, static_cast<GLint>(componentType), GL_FLOAT, GL_FALSE, 0, nullptr);
-		glEnableVertexAttribArray(ID);
-
-	glBindVertexArray(0);
-
+	glVertexArrayElementBuffer(m_VAO, m_EBO);
 }
 
 /// <summary>
-/// sends the vertices, colors and UV coordinates to the graphics pipeline 
+/// sends the vertices and UV coordinates to the graphics pipeline. 
+/// The vertex array stays bound afterwards, so drawing the same mesh again does not rebind it
 /// </summary>
 /// <param name="drawType"></param>
 void Buffer::Render(DrawType drawType)
 {
-	glBindVertexArray(m_VAO);
+	GLState::Instance()->BindVertexArray(m_VAO);
 
 	if (m_hasEBO)
 	{
@@ -112,15 +88,39 @@ void Buffer::Render(DrawType drawType)
 	{
 		glDrawArrays(static_cast<GLenum>(drawType), 0, m_totalVertices);
 	}
+}
 
-	glBindVertexArray(0);
+/// <summary>
+/// draws the mesh once for each instance in a single draw call
+/// </summary>
+/// <param name="drawType"></param>
+/// <param name="totalInstances">number of instances to draw</param>
+/// <param name="baseInstance">index of the first instance in the instance buffer</param>
+void Buffer::RenderInstanced(DrawType drawType, GLsizei totalInstances, GLuint baseInstance)
+{
+	GLState::Instance()->BindVertexArray(m_VAO);
+
+	if (m_hasEBO)
+	{
+		glDrawElementsInstancedBaseInstance(static_cast<GLenum>(drawType),
+			m_totalVertices, GL_UNSIGNED_INT, nullptr, totalInstances, baseInstance);
+	}
+
+	else
+	{
+		glDrawArraysInstancedBaseInstance(static_cast<GLenum>(drawType), 0, m_totalVertices, totalInstances, baseInstance);
+	}
 }
 
 void Buffer::DestroyBuffer()
 {
-	glDeleteBuffers(1, &m_vertexVBO);
-	glDeleteBuffers(1, &m_colorVBO);
-	glDeleteBuffers(1, &m_textureVBO);
+	GLState::Instance()->InvalidateBuffer(m_VBO);
+	GLState::Instance()->InvalidateBuffer(m_instanceVBO);
+	GLState::Instance()->InvalidateBuffer(m_EBO);
+	GLState::Instance()->InvalidateVertexArray(m_VAO);
+
+	glDeleteBuffers(1, &m_VBO);
+	glDeleteBuffers(1, &m_instanceVBO);
 	glDeleteVertexArrays(1, &m_VAO);
 	glDeleteBuffers(1, &m_EBO);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <string>
 #include "gl.h"
+#include "VertexLayout.h"
 
 class Buffer
 {
@@ -11,17 +12,7 @@ public:
 	enum class VBOType 
 	{ 
 		VertexBuffer, 
-		ColorBuffer, 
-		TextureBuffer 
-	};
-	
-	enum class ComponentType 
-	{ 
-		XY = 2, 
-		XYZ = 3, 
-		RGB = 3, 
-		RGBA = 4, 
-		UV = 2 
+		InstanceBuffer
 	};
 
 	enum class FillType 
@@ -30,13 +21,6 @@ public:
 		Ongoing = GL_DYNAMIC_DRAW 
 	};
 
-	enum class DataType 
-	{ 
-		IntData = GL_INT, 
-		FloatData = GL_FLOAT, 
-		UnsignedInt = GL_UNSIGNED_INT 
-	};
-
 	enum class DrawType 
 	{ 
 		Points = GL_POINTS, 
@@ -46,34 +30,56 @@ public:
 
 	Buffer();
 
-	void CreateBuffer(GLuint totalVertices, bool hasEBO = false);
+	void CreateBuffer(GLuint totalVertices, bool hasEBO = false, bool hasInstanceVBO = false);
 	
 	void FillEBO(const GLuint* data,
 		GLsizeiptr bufferSize, FillType fill = FillType::Once);
 	void FillVBO(VBOType vboType, 
-		         GLfloat* data, 
+		         const void* data, 
 		         GLsizeiptr bufferSize, 
 		         FillType fillType);
 
 	void LinkEBO();
-	void LinkVBO(const std::string& attribute, 
-		         VBOType vboType,
-		         ComponentType componentType, 
-		         DataType dataType);
+	template <typename Layout>
+	void LinkVBO(VBOType vboType);
 
 	void Render(DrawType drawType);
+	void RenderInstanced(DrawType drawType, GLsizei totalInstances, GLuint baseInstance = 0);
 
 	void DestroyBuffer();
 
 private:
 
+	//binding points of the vertex array object that the buffers are attached to
+	static const GLuint VERTEX_BINDING = 0;
+	static const GLuint INSTANCE_BINDING = 1;
+
 	bool m_hasEBO;
 
 	GLuint m_VAO;
 	GLuint m_EBO;
-	GLuint m_vertexVBO;
-	GLuint m_colorVBO;
-	GLuint m_textureVBO;
+	GLuint m_VBO;
+	GLuint m_instanceVBO;
 	GLuint m_totalVertices;
 
-};
\ No newline at end of file
+};
+
+/// <summary>
+/// attaches a vertex buffer to the vertex array object, with the attribute locations, offsets and stride 
+/// of the given VertexLayout. The attributes of an instance buffer advance once per instance.
+/// </summary>
+template <typename Layout>
+void Buffer::LinkVBO(VBOType vboType)
+{
+	if (vboType == VBOType::VertexBuffer)
+	{
+		glVertexArrayVertexBuffer(m_VAO, VERTEX_BINDING, m_VBO, 0, Layout::STRIDE);
+		Layout::Apply(m_VAO, VERTEX_BINDING);
+	}
+	else
+	{
+		glVertexArrayVertexBuffer(m_VAO, INSTANCE_BINDING, m_instanceVBO, 0, Layout::STRIDE);
+		glVertexArrayBindingDivisor(m_VAO, INSTANCE_BINDING, 1);
+		Layout::Apply(m_VAO, INSTANCE_BINDING);
+	}
+}
\ No newline at end of file
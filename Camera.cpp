@@ -1,11 +1,13 @@
-#include <gtc\matrix_transform.hpp>
+#include <gtc/matrix_transform.hpp>
 #include "Camera.h"
+#include "GLState.h"
 #include "Shader.h"
 
 Camera::Camera()
 {
 	m_view = glm::mat4(1.0f);
 	m_proj = glm::mat4(1.0f);
+	m_viewport = glm::ivec4(0);
 
 	m_position = glm::vec3(0.0f,0.0f,2.0f);
 	m_direction = glm::vec3(0.0f, 0.0f, -1.0f);
@@ -37,5 +39,37 @@ void Camera::Set3DView()
 /// <param name="height">height of viewport</param>
 void Camera::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
 {
-	glViewport(x, y, width, height);
+	m_viewport = glm::ivec4(x, y, width, height);
+	GLState::Instance()->SetViewport(x, y, width, height);
+}
+
+const glm::mat4& Camera::GetView() const
+{
+	return m_view;
+}
+
+const glm::mat4& Camera::GetProjection() const
+{
+	return m_proj;
+}
+
+/// <summary>
+/// computes the ray in world space that passes through the given mouse position, used for picking objects
+/// </summary>
+/// <param name="mouseX">mouse position in pixels, relative to the left of the viewport</param>
+/// <param name="mouseY">mouse position in pixels, relative to the top of the viewport</param>
+/// <param name="origin">receives the point where the ray starts, on the near plane</param>
+/// <param name="direction">receives the normalized direction of the ray</param>
+void Camera::GetRay(int mouseX, int mouseY, glm::vec3& origin, glm::vec3& direction) const
+{
+	GLfloat x = 2.0f * mouseX / m_viewport.z - 1.0f;
+	GLfloat y = 1.0f - 2.0f * mouseY / m_viewport.w;
+
+	glm::mat4 inverseViewProjection = glm::inverse(m_proj * m_view);
+
+	glm::vec4 nearPoint = inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+
+	origin = glm::vec3(nearPoint) / nearPoint.w;
+	direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
 }
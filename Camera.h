@@ -13,10 +13,16 @@ public:
 	void Set3DView();
 	void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
 
+	const glm::mat4& GetView() const;
+	const glm::mat4& GetProjection() const;
+
+	void GetRay(int mouseX, int mouseY, glm::vec3& origin, glm::vec3& direction) const;
+
 protected:
 
 	glm::mat4 m_view;
 	glm::mat4 m_proj;
+	glm::ivec4 m_viewport;
 
 	glm::vec3 m_position;
 	glm::vec3 m_direction;
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "ColorConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLOR_CONVERSION_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+//the sRGB curve is linear below these values, in linear light and gamma encoded
+static const GLfloat LINEAR_THRESHOLD = 0.0031308f;
+static const GLfloat SRGB_THRESHOLD = 0.04045f;
+
+GLfloat SrgbToLinear(GLfloat value)
+{
+	value = std::clamp(value, 0.0f, 1.0f);
+	return (value <= SRGB_THRESHOLD) ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+GLfloat LinearToSrgb(GLfloat value)
+{
+	value = std::clamp(value, 0.0f, 1.0f);
+	return (value <= LINEAR_THRESHOLD) ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+/// <summary>
+/// the linear value of every gamma encoded value of the given bit depth
+/// </summary>
+static std::vector<GLfloat> CreateDecodingTable(Uint32 totalValues)
+{
+	std::vector<GLfloat> table(totalValues);
+
+	for (Uint32 i = 0; i < totalValues; i++)
+	{
+		table[i] = static_cast<GLfloat>(SrgbToLinear(static_cast<GLfloat>(static_cast<double>(i) / (totalValues - 1))));
+	}
+
+	return table;
+}
+
+template <typename T>
+static void ConvertSrgbToLinear(const T* pixels, Uint32 channels, GLfloat* linearPixels, size_t totalPixels, const std::vector<GLfloat>& table)
+{
+	const GLfloat alphaScale = 1.0f / (table.size() - 1);
+
+	for (size_t i = 0; i < totalPixels; i++, pixels += channels, linearPixels += 4)
+	{
+		//gray pixels spread their value over the three colors
+		bool isGray = (channels < 3);
+
+		linearPixels[0] = table[pixels[0]];
+		linearPixels[1] = table[pixels[isGray ? 0 : 1]];
+		linearPixels[2] = table[pixels[isGray ? 0 : 2]];
+		linearPixels[3] = (channels == 2 || channels == 4) ? pixels[channels - 1] * alphaScale : 1.0f;
+	}
+}
+
+void ConvertSrgb8ToLinear(const Uint8* pixels, Uint32 channels, GLfloat* linearPixels, size_t totalPixels)
+{
+	static const std::vector<GLfloat> table = CreateDecodingTable(256);
+	ConvertSrgbToLinear(pixels, channels, linearPixels, totalPixels, table);
+}
+
+void ConvertSrgb16ToLinear(const Uint16* pixels, Uint32 channels, GLfloat* linearPixels, size_t totalPixels)
+{
+	static const std::vector<GLfloat> table = CreateDecodingTable(65536);
+	ConvertSrgbToLinear(pixels, channels, linearPixels, totalPixels, table);
+}
+
+#ifdef COLOR_CONVERSION_USE_SSE2
+
+static __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// <summary>
+/// log2 of four positive, normal values. The mantissa is centered on 1, where a short odd series of 
+/// (m - 1) / (m + 1) is accurate to about 1e-8
+/// </summary>
+static __m128 Log2(__m128 x)
+{
+	__m128i bits = _mm_castps_si128(x);
+	__m128i exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+	__m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+	//mantissas above sqrt(2) are halved, and their exponent raised by one (the mask reads as -1)
+	__m128 isHigh = _mm_cmpgt_ps(mantissa, _mm_set1_ps(1.41421356f));
+	mantissa = Select(isHigh, _mm_mul_ps(mantissa, _mm_set1_ps(0.5f)), mantissa);
+	exponent = _mm_sub_epi32(exponent, _mm_castps_si128(isHigh));
+
+	__m128 t = _mm_div_ps(_mm_sub_ps(mantissa, _mm_set1_ps(1.0f)), _mm_add_ps(mantissa, _mm_set1_ps(1.0f)));
+	__m128 t2 = _mm_mul_ps(t, t);
+
+	//2 / ln(2) * (t + t^3 / 3 + t^5 / 5 + t^7 / 7 + t^9 / 9)
+	__m128 series = _mm_add_ps(_mm_set1_ps(0.41219858f), _mm_mul_ps(t2, _mm_set1_ps(0.32059889f)));
+	series = _mm_add_ps(_mm_set1_ps(0.57707802f), _mm_mul_ps(t2, series));
+	series = _mm_add_ps(_mm_set1_ps(0.96179669f), _mm_mul_ps(t2, series));
+	series = _mm_add_ps(_mm_set1_ps(2.88539008f), _mm_mul_ps(t2, series));
+
+	return _mm_add_ps(_mm_cvtepi32_ps(exponent), _mm_mul_ps(t, series));
+}
+
+/// <summary>
+/// 2 to the power of four values between -126 and 0. The fraction is rounded to [-0.5, 0.5], 
+/// where a taylor series of degree 6 is accurate to about 1e-7
+/// </summary>
+static __m128 Exp2(__m128 x)
+{
+	__m128i integer = _mm_cvtps_epi32(x);
+	__m128 fraction = _mm_mul_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(integer)), _mm_set1_ps(0.69314718f));
+
+	__m128 series = _mm_add_ps(_mm_set1_ps(1.0f / 120.0f), _mm_mul_ps(fraction, _mm_set1_ps(1.0f / 720.0f)));
+	series = _mm_add_ps(_mm_set1_ps(1.0f / 24.0f), _mm_mul_ps(fraction, series));
+	series = _mm_add_ps(_mm_set1_ps(1.0f / 6.0f), _mm_mul_ps(fraction, series));
+	series = _mm_add_ps(_mm_set1_ps(0.5f), _mm_mul_ps(fraction, series));
+	series = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(fraction, series));
+	series = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(fraction, series));
+
+	__m128 power = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(integer, _mm_set1_epi32(127)), 23));
+
+	return _mm_mul_ps(series, power);
+}
+
+/// <summary>
+/// encodes the colors of an RGBA pixel in linear light, and clamps its alpha to [0, 1]
+/// </summary>
+static __m128 LinearToSrgb(__m128 pixel)
+{
+	pixel = _mm_min_ps(_mm_max_ps(pixel, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+	__m128 threshold = _mm_set1_ps(LINEAR_THRESHOLD);
+	__m128 power = Exp2(_mm_mul_ps(Log2(_mm_max_ps(pixel, threshold)), _mm_set1_ps(1.0f / 2.4f)));
+	__m128 curve = _mm_sub_ps(_mm_mul_ps(power, _mm_set1_ps(1.055f)), _mm_set1_ps(0.055f));
+	__m128 line = _mm_mul_ps(pixel, _mm_set1_ps(12.92f));
+
+	__m128 srgb = Select(_mm_cmpgt_ps(pixel, threshold), curve, line);
+
+	return Select(_mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0)), pixel, srgb);
+}
+
+/// <summary>
+/// decodes the colors of a gamma encoded RGBA pixel into linear light, and clamps its alpha to [0, 1]
+/// </summary>
+static __m128 SrgbToLinear(__m128 pixel)
+{
+	pixel = _mm_min_ps(_mm_max_ps(pixel, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+	__m128 threshold = _mm_set1_ps(SRGB_THRESHOLD);
+	__m128 base = _mm_mul_ps(_mm_add_ps(_mm_max_ps(pixel, threshold), _mm_set1_ps(0.055f)), _mm_set1_ps(1.0f / 1.055f));
+	__m128 curve = Exp2(_mm_mul_ps(Log2(base), _mm_set1_ps(2.4f)));
+	__m128 line = _mm_mul_ps(pixel, _mm_set1_ps(1.0f / 12.92f));
+
+	__m128 linear = Select(_mm_cmpgt_ps(pixel, threshold), curve, line);
+
+	return Select(_mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0)), pixel, linear);
+}
+
+void ConvertLinearToSrgb8(const GLfloat* linearPixels, Uint8* pixels, Uint32 channels, size_t totalPixels)
+{
+	for (size_t i = 0; i < totalPixels; i++, linearPixels += 4, pixels += channels)
+	{
+		__m128i values = _mm_cvtps_epi32(_mm_mul_ps(LinearToSrgb(_mm_loadu_ps(linearPixels)), _mm_set1_ps(255.0f)));
+		values = _mm_packus_epi16(_mm_packs_epi32(values, values), values);
+
+		Uint32 packedValues = static_cast<Uint32>(_mm_cvtsi128_si32(values));
+		std::memcpy(pixels, &packedValues, channels);
+	}
+}
+
+void ConvertLinearToSrgb16(const GLfloat* linearPixels, Uint16* pixels, Uint32 channels, size_t totalPixels)
+{
+	for (size_t i = 0; i < totalPixels; i++, linearPixels += 4, pixels += channels)
+	{
+		__m128i values = _mm_cvtps_epi32(_mm_mul_ps(LinearToSrgb(_mm_loadu_ps(linearPixels)), _mm_set1_ps(65535.0f)));
+
+		//SSE2 only packs to signed 16-bit values, so the values are moved into their range and back
+		values = _mm_packs_epi32(_mm_sub_epi32(values, _mm_set1_epi32(32768)), values);
+		values = _mm_xor_si128(values, _mm_set1_epi16(-32768));
+
+		Uint16 packedValues[8];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(packedValues), values);
+		std::memcpy(pixels, packedValues, channels * sizeof(Uint16));
+	}
+}
+
+void InvertSrgb(GLfloat* linearPixels, size_t totalPixels)
+{
+	//alpha is decoded and encoded unchanged, so only the colors are inverted
+	const __m128 white = _mm_set_ps(0.0f, 1.0f, 1.0f, 1.0f);
+	const __m128 sign = _mm_set_ps(1.0f, -1.0f, -1.0f, -1.0f);
+
+	for (size_t i = 0; i < totalPixels; i++, linearPixels += 4)
+	{
+		__m128 srgb = LinearToSrgb(_mm_loadu_ps(linearPixels));
+		_mm_storeu_ps(linearPixels, SrgbToLinear(_mm_add_ps(white, _mm_mul_ps(srgb, sign))));
+	}
+}
+
+#else
+
+void ConvertLinearToSrgb8(const GLfloat* linearPixels, Uint8* pixels, Uint32 channels, size_t totalPixels)
+{
+	for (size_t i = 0; i < totalPixels; i++, linearPixels += 4, pixels += channels)
+	{
+		for (Uint32 channel = 0; channel < channels; channel++)
+		{
+			GLfloat value = (channel == 3) ? std::clamp(linearPixels[3], 0.0f, 1.0f) : LinearToSrgb(linearPixels[channel]);
+			pixels[channel] = static_cast<Uint8>(std::lround(value * 255.0f));
+		}
+	}
+}
+
+void ConvertLinearToSrgb16(const GLfloat* linearPixels, Uint16* pixels, Uint32 channels, size_t totalPixels)
+{
+	for (size_t i = 0; i < totalPixels; i++, linearPixels += 4, pixels += channels)
+	{
+		for (Uint32 channel = 0; channel < channels; channel++)
+		{
+			GLfloat value = (channel == 3) ? std::clamp(linearPixels[3], 0.0f, 1.0f) : LinearToSrgb(linearPixels[channel]);
+			pixels[channel] = static_cast<Uint16>(std::lround(value * 65535.0f));
+		}
+	}
+}
+
+void InvertSrgb(GLfloat* linearPixels, size_t totalPixels)
+{
+	for (size_t i = 0; i < totalPixels; i++, linearPixels += 4)
+	{
+		for (Uint32 channel = 0; channel < 3; channel++)
+		{
+			linearPixels[channel] = SrgbToLinear(1.0f - LinearToSrgb(linearPixels[channel]));
+		}
+	}
+}
+
+#endif
\ No newline at end of file
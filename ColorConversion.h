@@ -0,0 +1,24 @@
+#pragma once
+
+#include <SDL.h>
+#include "gl.h"
+
+//conversions between gamma encoded sRGB colors, as stored in image files, and linear light, in which effects are computed.
+//Pixels in linear light are RGBA floats. Alpha is never gamma encoded, so it is only rescaled.
+//Decoding goes through tables of every 8-bit and 16-bit value, encoding evaluates the sRGB curve with SSE2 
+//four channels at a time, accurate to well below a 16-bit step.
+
+//the exact sRGB curves for a single channel in [0, 1], used where speed does not matter
+GLfloat SrgbToLinear(GLfloat value);
+GLfloat LinearToSrgb(GLfloat value);
+
+//decodes pixels of 1 (gray), 2 (gray and alpha), 3 (RGB) or 4 (RGBA) channels into RGBA pixels in linear light
+void ConvertSrgb8ToLinear(const Uint8* pixels, Uint32 channels, GLfloat* linearPixels, size_t totalPixels);
+void ConvertSrgb16ToLinear(const Uint16* pixels, Uint32 channels, GLfloat* linearPixels, size_t totalPixels);
+
+//encodes RGBA pixels in linear light into pixels of 3 (RGB) or 4 (RGBA) channels, rounding to the nearest value
+void ConvertLinearToSrgb8(const GLfloat* linearPixels, Uint8* pixels, Uint32 channels, size_t totalPixels);
+void ConvertLinearToSrgb16(const GLfloat* linearPixels, Uint16* pixels, Uint32 channels, size_t totalPixels);
+
+//inverts the gamma encoded colors of RGBA pixels in linear light, which looks the same as inverting the 8-bit image
+void InvertSrgb(GLfloat* linearPixels, size_t totalPixels);
\ No newline at end of file
@@ -0,0 +1,577 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include "Convolution.h"
+#include "Parallel.h"
+#include "Timer.h"
+
+using Complex = std::complex<GLfloat>;
+
+//cost of the work of each method relative to a multiply-add of an RGBA pixel in the direct method, as measured
+static const double SEPARABLE_PASS_COST = 1.0;
+static const double FFT_BUTTERFLY_COST = 1.1;
+static const double FFT_PIXEL_COST = 4.0;
+
+static const GLsizei MIN_TILE_SIZE = 16;
+static const GLsizei MAX_TILE_SIZE = 1024;
+
+//share of a kernel's energy outside its leading singular value, below which the kernel counts as separable
+static const double SEPARABLE_TOLERANCE = 1e-6;
+static const GLuint MAX_POWER_ITERATIONS = 50;
+
+/// <summary>
+/// a radix-2 fast fourier transform of a power of two size
+/// </summary>
+class FourierTransform
+{
+
+public:
+
+	FourierTransform(GLsizei size)
+	{
+		m_size = size;
+		m_twiddles.resize(size / 2);
+		m_reversedIndices.resize(size);
+
+		for (GLsizei i = 0; i < size / 2; i++)
+		{
+			double angle = -2.0 * 3.14159265358979323846 * i / size;
+			m_twiddles[i] = Complex(static_cast<GLfloat>(std::cos(angle)), static_cast<GLfloat>(std::sin(angle)));
+		}
+
+		GLsizei totalBits = 0;
+
+		while ((1 << totalBits) < size)
+		{
+			totalBits++;
+		}
+
+		for (GLsizei i = 0; i < size; i++)
+		{
+			GLsizei reversed = 0;
+
+			for (GLsizei bit = 0; bit < totalBits; bit++)
+			{
+				reversed |= ((i >> bit) & 1) << (totalBits - 1 - bit);
+			}
+
+			m_reversedIndices[i] = reversed;
+		}
+	}
+
+	/// <summary>
+	/// transforms a sequence in place. The inverse transform is not scaled by 1 / size
+	/// </summary>
+	void Transform(Complex* data, bool isInverse) const
+	{
+		for (GLsizei i = 0; i < m_size; i++)
+		{
+			if (i < m_reversedIndices[i])
+			{
+				std::swap(data[i], data[m_reversedIndices[i]]);
+			}
+		}
+
+		GLfloat sign = isInverse ? -1.0f : 1.0f;
+
+		for (GLsizei length = 2; length <= m_size; length <<= 1)
+		{
+			GLsizei half = length / 2;
+			GLsizei step = m_size / length;
+
+			for (GLsizei start = 0; start < m_size; start += length)
+			{
+				for (GLsizei i = 0; i < half; i++)
+				{
+					//complex products are written out, which spares the checks for infinities of std::complex
+					GLfloat twiddleReal = m_twiddles[i * step].real();
+					GLfloat twiddleImaginary = sign * m_twiddles[i * step].imag();
+
+					Complex& a = data[start + i];
+					Complex& b = data[start + i + half];
+
+					GLfloat real = b.real() * twiddleReal - b.imag() * twiddleImaginary;
+					GLfloat imaginary = b.real() * twiddleImaginary + b.imag() * twiddleReal;
+
+					b = Complex(a.real() - real, a.imag() - imaginary);
+					a = Complex(a.real() + real, a.imag() + imaginary);
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// transforms a square of size x size values in place, rows first. The forward transform leaves the result transposed, 
+	/// which the inverse transform of a transposed square undoes, so the spectrum never needs to be turned back
+	/// </summary>
+	void Transform2D(Complex* data, bool isInverse) const
+	{
+		const GLsizei BLOCK_SIZE = 16;
+
+		for (GLsizei row = 0; row < m_size; row++)
+		{
+			Transform(data + row * m_size, isInverse);
+		}
+
+		for (GLsizei blockRow = 0; blockRow < m_size; blockRow += BLOCK_SIZE)
+		{
+			for (GLsizei blockColumn = blockRow; blockColumn < m_size; blockColumn += BLOCK_SIZE)
+			{
+				for (GLsizei row = blockRow; row < std::min(blockRow + BLOCK_SIZE, m_size); row++)
+				{
+					for (GLsizei column = std::max(blockColumn, row + 1); column < std::min(blockColumn + BLOCK_SIZE, m_size); column++)
+					{
+						std::swap(data[row * m_size + column], data[column * m_size + row]);
+					}
+				}
+			}
+		}
+
+		for (GLsizei row = 0; row < m_size; row++)
+		{
+			Transform(data + row * m_size, isInverse);
+		}
+	}
+
+private:
+
+	GLsizei m_size;
+	std::vector<Complex> m_twiddles;
+	std::vector<GLsizei> m_reversedIndices;
+
+};
+
+Convolution* Convolution::Instance()
+{
+	static Convolution* convolution = new Convolution;
+	return convolution;
+}
+
+Convolution::Convolution()
+{
+	m_totalThreads = GetTotalParallelThreads();
+	m_lastStats = { Method::Automatic, 0, 0, 0, 0, 0.0, -1.0, -1.0, -1.0 };
+}
+
+/// <summary>
+/// convolves RGBA pixels in any format with a kernel, with the method that is cheapest for them, unless one is given
+/// </summary>
+/// <param name="pixels">the RGBA pixels of the image, row by row</param>
+/// <param name="result">the RGBA pixels of the convolved image, which may not be the same as the pixels</param>
+/// <param name="method">the method to use, or Automatic for the cheapest one</param>
+void Convolution::Apply(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& kernel, Method method)
+{
+	Timer timer;
+
+	Kernel column(1, kernel.GetHeight());
+	Kernel row(kernel.GetWidth(), 1);
+	bool isSeparable = FindSeparableFactors(kernel, column, row);
+	double totalPixels = static_cast<double>(width) * height;
+
+	Stats stats = { Method::Automatic, kernel.GetWidth(), kernel.GetHeight(), 0, m_totalThreads, 0.0, -1.0, -1.0, -1.0 };
+	stats.directCost = totalPixels * kernel.GetTotalNonZeroWeights() / 1e6;
+	stats.separableCost = isSeparable ? totalPixels * (column.GetTotalNonZeroWeights() + row.GetTotalNonZeroWeights() + 
+		                                                2.0 * SEPARABLE_PASS_COST) / 1e6 : -1.0;
+	stats.tileSize = FindBestTileSize(width, height, kernel, stats.fftCost);
+
+	if (method == Method::Automatic)
+	{
+		method = Method::Direct;
+		double cost = stats.directCost;
+
+		if (stats.separableCost >= 0.0 && stats.separableCost < cost)
+		{
+			method = Method::Separable;
+			cost = stats.separableCost;
+		}
+
+		if (stats.fftCost >= 0.0 && stats.fftCost < cost)
+		{
+			method = Method::FFT;
+		}
+	}
+
+	if ((method == Method::Separable && !isSeparable) || (method == Method::FFT && stats.tileSize == 0))
+	{
+		method = Method::Direct;
+	}
+
+	switch (method)
+	{
+	case Method::Separable:
+		ApplySeparable(pixels, result, width, height, column, row);
+		break;
+	case Method::FFT:
+		ApplyFFT(pixels, result, width, height, kernel, stats.tileSize);
+		break;
+	default:
+		ApplyDirect(pixels, result, width, height, kernel);
+		break;
+	}
+
+	stats.method = method;
+	stats.milliseconds = timer.GetElapsedMilliseconds();
+
+	if (method != Method::FFT)
+	{
+		stats.tileSize = 0;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_lastStats = stats;
+}
+
+Convolution::Stats Convolution::GetLastStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_lastStats;
+}
+
+const char* Convolution::GetMethodName(Method method)
+{
+	switch (method)
+	{
+	case Method::Direct:
+		return "direct";
+	case Method::Separable:
+		return "separable";
+	case Method::FFT:
+		return "FFT tiles";
+	default:
+		return "automatic";
+	}
+}
+
+/// <summary>
+/// finds the column and the row whose product is the kernel, if there are any. The leading singular value of the kernel 
+/// and its singular vectors are found by power iteration; the kernel is the product of them, and so has rank 1, 
+/// if that singular value carries all of the kernel's energy
+/// </summary>
+/// <returns>returns false if the kernel is not separable</returns>
+bool Convolution::FindSeparableFactors(const Kernel& kernel, Kernel& column, Kernel& row) const
+{
+	GLsizei width = kernel.GetWidth();
+	GLsizei height = kernel.GetHeight();
+
+	double energy = 0.0;
+	double maxRowEnergy = -1.0;
+	std::vector<double> rightVector(width, 0.0);
+	std::vector<double> leftVector(height, 0.0);
+
+	//the iteration starts from the row with the most energy, which is never orthogonal to the leading singular vector
+	for (GLsizei y = 0; y < height; y++)
+	{
+		double rowEnergy = 0.0;
+
+		for (GLsizei x = 0; x < width; x++)
+		{
+			rowEnergy += static_cast<double>(kernel.GetWeight(x, y)) * kernel.GetWeight(x, y);
+		}
+
+		energy += rowEnergy;
+
+		if (rowEnergy > maxRowEnergy)
+		{
+			maxRowEnergy = rowEnergy;
+
+			for (GLsizei x = 0; x < width; x++)
+			{
+				rightVector[x] = kernel.GetWeight(x, y);
+			}
+		}
+	}
+
+	if (energy == 0.0)
+	{
+		return false;
+	}
+
+	double singularValue = 0.0;
+
+	for (GLuint iteration = 0; iteration < MAX_POWER_ITERATIONS; iteration++)
+	{
+		double leftLength = 0.0;
+
+		for (GLsizei y = 0; y < height; y++)
+		{
+			leftVector[y] = 0.0;
+
+			for (GLsizei x = 0; x < width; x++)
+			{
+				leftVector[y] += kernel.GetWeight(x, y) * rightVector[x];
+			}
+
+			leftLength += leftVector[y] * leftVector[y];
+		}
+
+		leftLength = std::sqrt(leftLength);
+
+		if (leftLength == 0.0)
+		{
+			return false;
+		}
+
+		for (double& value : leftVector)
+		{
+			value /= leftLength;
+		}
+
+		double rightLength = 0.0;
+
+		for (GLsizei x = 0; x < width; x++)
+		{
+			rightVector[x] = 0.0;
+
+			for (GLsizei y = 0; y < height; y++)
+			{
+				rightVector[x] += kernel.GetWeight(x, y) * leftVector[y];
+			}
+
+			rightLength += rightVector[x] * rightVector[x];
+		}
+
+		rightLength = std::sqrt(rightLength);
+
+		for (double& value : rightVector)
+		{
+			value /= rightLength;
+		}
+
+		bool isConverged = std::abs(rightLength - singularValue) <= 1e-12 * rightLength;
+		singularValue = rightLength;
+
+		if (isConverged)
+		{
+			break;
+		}
+	}
+
+	//the energy of a matrix is the sum of its squared singular values
+	if (energy - singularValue * singularValue > SEPARABLE_TOLERANCE * energy)
+	{
+		return false;
+	}
+
+	double scale = std::sqrt(singularValue);
+
+	for (GLsizei y = 0; y < height; y++)
+	{
+		column.SetWeight(0, y, static_cast<GLfloat>(leftVector[y] * scale));
+	}
+
+	for (GLsizei x = 0; x < width; x++)
+	{
+		row.SetWeight(x, 0, static_cast<GLfloat>(rightVector[x] * scale));
+	}
+
+	return true;
+}
+
+/// <summary>
+/// the tile size at which the FFT method costs the least. Each tile computes a block of (size - kernel size + 1) results 
+/// from four forward and four inverse transforms of its rows and columns, two channels per complex transform
+/// </summary>
+/// <param name="cost">the estimated cost at that tile size, or -1 if the kernel is too large for any tile</param>
+/// <returns>returns the tile size, or 0 if the kernel is too large for any tile</returns>
+GLsizei Convolution::FindBestTileSize(GLsizei width, GLsizei height, const Kernel& kernel, double& cost) const
+{
+	GLsizei bestTileSize = 0;
+	cost = -1.0;
+
+	for (GLsizei tileSize = MIN_TILE_SIZE; tileSize <= MAX_TILE_SIZE; tileSize *= 2)
+	{
+		GLsizei blockWidth = tileSize - kernel.GetWidth() + 1;
+		GLsizei blockHeight = tileSize - kernel.GetHeight() + 1;
+
+		if (blockWidth <= 0 || blockHeight <= 0)
+		{
+			continue;
+		}
+
+		double totalTiles = static_cast<double>((width + blockWidth - 1) / blockWidth) * ((height + blockHeight - 1) / blockHeight);
+		double tilePixels = static_cast<double>(tileSize) * tileSize;
+		double tileCost = 4.0 * tilePixels * std::log2(tileSize) * FFT_BUTTERFLY_COST + tilePixels * FFT_PIXEL_COST;
+		double tilesCost = totalTiles * tileCost / 1e6;
+
+		if (cost < 0.0 || tilesCost < cost)
+		{
+			cost = tilesCost;
+			bestTileSize = tileSize;
+		}
+
+		//larger tiles than the image only add work
+		if (blockWidth >= width && blockHeight >= height)
+		{
+			break;
+		}
+	}
+
+	return bestTileSize;
+}
+
+/// <summary>
+/// sums the pixels under the kernel's weights. Each weight scales a whole row of pixels at once, 
+/// which runs along memory and skips the zero weights of sparse kernels such as motion blurs
+/// </summary>
+void Convolution::ApplyDirect(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& kernel)
+{
+	GLsizei kernelWidth = kernel.GetWidth();
+	GLsizei kernelHeight = kernel.GetHeight();
+	size_t rowSize = static_cast<size_t>(width) * 4;
+
+	ParallelFor(height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			GLfloat* resultRow = result + y * rowSize;
+			std::fill(resultRow, resultRow + rowSize, 0.0f);
+
+			for (GLsizei j = 0; j < kernelHeight; j++)
+			{
+				GLsizei sourceY = y + j - kernelHeight / 2;
+
+				if (sourceY < 0 || sourceY >= height)
+				{
+					continue;
+				}
+
+				const GLfloat* sourceRow = pixels + sourceY * rowSize;
+
+				for (GLsizei i = 0; i < kernelWidth; i++)
+				{
+					GLfloat weight = kernel.GetWeight(i, j);
+
+					if (weight == 0.0f)
+					{
+						continue;
+					}
+
+					//only the pixels whose tap lies inside the image
+					GLsizei offset = i - kernelWidth / 2;
+					ptrdiff_t sourceOffset = static_cast<ptrdiff_t>(offset) * 4;
+					size_t firstValue = static_cast<size_t>(std::max(0, -offset)) * 4;
+					size_t lastValue = static_cast<size_t>(std::max(0, std::min(width, width - offset))) * 4;
+
+					for (size_t value = firstValue; value < lastValue; value++)
+					{
+						resultRow[value] += weight * sourceRow[value + sourceOffset];
+					}
+				}
+			}
+		}
+	});
+}
+
+/// <summary>
+/// convolves the rows with the row factor of the kernel, then the columns of the result with its column factor
+/// </summary>
+void Convolution::ApplySeparable(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& column, const Kernel& row)
+{
+	std::vector<GLfloat> rowResult(static_cast<size_t>(width) * height * 4);
+
+	ApplyDirect(pixels, rowResult.data(), width, height, row);
+	ApplyDirect(rowResult.data(), result, width, height, column);
+}
+
+/// <summary>
+/// convolves the image tile by tile through the fourier domain, where the convolution is a product (overlap-save). 
+/// Each tile transforms the window of the image its block of results depends on, so the tiles write separate blocks 
+/// and run in parallel. Red and green, and blue and alpha, share one complex transform as its real and imaginary parts
+/// </summary>
+void Convolution::ApplyFFT(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& kernel, GLsizei tileSize)
+{
+	GLsizei kernelWidth = kernel.GetWidth();
+	GLsizei kernelHeight = kernel.GetHeight();
+	GLsizei blockWidth = tileSize - kernelWidth + 1;
+	GLsizei blockHeight = tileSize - kernelHeight + 1;
+	GLsizei totalTilesX = (width + blockWidth - 1) / blockWidth;
+	GLsizei totalTilesY = (height + blockHeight - 1) / blockHeight;
+	size_t tilePixels = static_cast<size_t>(tileSize) * tileSize;
+
+	FourierTransform transform(tileSize);
+
+	//the transform convolves, which weights the pixels with the kernel turned around, so the kernel is turned beforehand. 
+	//The spectrum also carries the scale of the inverse transform
+	std::vector<Complex> spectrum(tilePixels, Complex(0.0f, 0.0f));
+	GLfloat scale = 1.0f / tilePixels;
+
+	for (GLsizei y = 0; y < kernelHeight; y++)
+	{
+		for (GLsizei x = 0; x < kernelWidth; x++)
+		{
+			spectrum[y * tileSize + x] = Complex(kernel.GetWeight(kernelWidth - 1 - x, kernelHeight - 1 - y) * scale, 0.0f);
+		}
+	}
+
+	transform.Transform2D(spectrum.data(), false);
+
+	ParallelFor(totalTilesX * totalTilesY, [&](GLuint first, GLuint last)
+	{
+		std::vector<Complex> redGreen(tilePixels);
+		std::vector<Complex> blueAlpha(tilePixels);
+
+		for (GLuint tile = first; tile < last; tile++)
+		{
+			GLsizei blockX = (tile % totalTilesX) * blockWidth;
+			GLsizei blockY = (tile / totalTilesX) * blockHeight;
+			GLsizei windowX = blockX - kernelWidth / 2;
+			GLsizei windowY = blockY - kernelHeight / 2;
+
+			for (GLsizei y = 0; y < tileSize; y++)
+			{
+				GLsizei sourceY = windowY + y;
+
+				for (GLsizei x = 0; x < tileSize; x++)
+				{
+					GLsizei sourceX = windowX + x;
+					size_t index = static_cast<size_t>(y) * tileSize + x;
+
+					if (sourceX < 0 || sourceX >= width || sourceY < 0 || sourceY >= height)
+					{
+						redGreen[index] = Complex(0.0f, 0.0f);
+						blueAlpha[index] = Complex(0.0f, 0.0f);
+						continue;
+					}
+
+					const GLfloat* pixel = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+					redGreen[index] = Complex(pixel[0], pixel[1]);
+					blueAlpha[index] = Complex(pixel[2], pixel[3]);
+				}
+			}
+
+			transform.Transform2D(redGreen.data(), false);
+			transform.Transform2D(blueAlpha.data(), false);
+
+			for (size_t i = 0; i < tilePixels; i++)
+			{
+				GLfloat real = spectrum[i].real();
+				GLfloat imaginary = spectrum[i].imag();
+
+				redGreen[i] = Complex(redGreen[i].real() * real - redGreen[i].imag() * imaginary, 
+					                  redGreen[i].real() * imaginary + redGreen[i].imag() * real);
+				blueAlpha[i] = Complex(blueAlpha[i].real() * real - blueAlpha[i].imag() * imaginary, 
+					                   blueAlpha[i].real() * imaginary + blueAlpha[i].imag() * real);
+			}
+
+			transform.Transform2D(redGreen.data(), true);
+			transform.Transform2D(blueAlpha.data(), true);
+
+			//the first kernel size - 1 rows and columns wrapped around the tile, the rest are the block's results
+			for (GLsizei y = kernelHeight - 1; y < tileSize && blockY + y - (kernelHeight - 1) < height; y++)
+			{
+				GLsizei resultY = blockY + y - (kernelHeight - 1);
+
+				for (GLsizei x = kernelWidth - 1; x < tileSize && blockX + x - (kernelWidth - 1) < width; x++)
+				{
+					size_t index = static_cast<size_t>(y) * tileSize + x;
+					GLfloat* pixel = result + (static_cast<size_t>(resultY) * width + blockX + x - (kernelWidth - 1)) * 4;
+
+					pixel[0] = redGreen[index].real();
+					pixel[1] = redGreen[index].imag();
+					pixel[2] = blueAlpha[index].real();
+					pixel[3] = blueAlpha[index].imag();
+				}
+			}
+		}
+	});
+}
\ No newline at end of file
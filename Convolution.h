@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include "gl.h"
+#include "Kernel.h"
+
+//convolves RGBA float images with any kernel, picking the cheapest of three methods for each kernel and image:
+//direct summing of the kernel's weights, two one-dimensional passes for kernels that are the product of a column and a row 
+//(rank 1, found by a singular value decomposition), or fast fourier transforms of overlapping tiles for large kernels.
+//The work is spread over all cores. Pixels beyond the edges of the image count as zero, as in the blur effect.
+class Convolution
+{
+
+public:
+
+	enum class Method
+	{
+		Automatic,
+		Direct,
+		Separable,
+		FFT
+	};
+
+	//how the last convolution was computed, shown in the profiler overlay
+	struct Stats
+	{
+		Method method;
+		GLsizei kernelWidth;
+		GLsizei kernelHeight;
+		GLsizei tileSize;
+		GLuint totalThreads;
+		double milliseconds;
+
+		//estimated cost of each method, in millions of multiply-adds of an RGBA pixel. Negative where a method does not apply
+		double directCost;
+		double separableCost;
+		double fftCost;
+	};
+
+	static Convolution* Instance();
+
+	void Apply(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& kernel, 
+		       Method method = Method::Automatic);
+
+	Stats GetLastStats() const;
+
+	static const char* GetMethodName(Method method);
+
+private:
+
+	Convolution();
+	Convolution(const Convolution&);
+
+	bool FindSeparableFactors(const Kernel& kernel, Kernel& column, Kernel& row) const;
+	GLsizei FindBestTileSize(GLsizei width, GLsizei height, const Kernel& kernel, double& cost) const;
+
+	void ApplyDirect(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& kernel);
+	void ApplySeparable(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& column, const Kernel& row);
+	void ApplyFFT(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, const Kernel& kernel, GLsizei tileSize);
+
+	GLuint m_totalThreads;
+
+	//written by the thread that ran the last convolution and read by the profiler overlay
+	mutable std::mutex m_mutex;
+	Stats m_lastStats;
+
+};
\ No newline at end of file
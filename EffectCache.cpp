@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "EffectCache.h"
+#include "Hash.h"
+
+//a gigabyte holds about sixty blurs of a 2048 x 2048 image in linear light
+static const Uint64 DEFAULT_MAX_SIZE = 1024ULL * 1024 * 1024;
+
+//once the cache is over its size limit, eviction deletes files until it is this share of the limit, 
+//so that the next few stores do not each delete a file
+static const double EVICTION_TARGET = 0.9;
+
+//temporary files older than this were left by an instance that stopped while writing them
+static const std::chrono::hours STALE_TEMPORARY_FILE_AGE(1);
+
+static const char FILE_MAGIC[4] = { 'Q', 'E', 'F', 'C' };
+static const Uint32 FILE_VERSION = 1;
+
+static const char* FILE_EXTENSION = ".effect";
+static const char* TEMPORARY_FILE_EXTENSION = ".tmp";
+
+struct EffectFileHeader
+{
+	char magic[4];
+	Uint32 version;
+	Uint64 key;
+	Uint64 dataSize;
+	Uint64 dataHash;
+};
+
+/// <summary>
+/// the cache lives until the application ends, by when the workers that store effects in it have stopped
+/// </summary>
+EffectCache* EffectCache::Instance()
+{
+	static EffectCache effectCache;
+	return &effectCache;
+}
+
+EffectCache::EffectCache()
+{
+	m_isEnabled = true;
+	m_maxSize = DEFAULT_MAX_SIZE;
+
+	char* cachePath = SDL_GetPrefPath("QuadInSpace", "EffectCache");
+	if (cachePath)
+	{
+		m_directory = cachePath;
+		SDL_free(cachePath);
+	}
+}
+
+/// <summary>
+/// the key of an effect result, a hash of the hash of the source pixels and of the effect parameters. 
+/// The parameters name the effect, its version and everything its result depends on, such as the working format
+/// </summary>
+Uint64 EffectCache::GetKey(Uint64 sourceHash, const std::string& parameters)
+{
+	return Hash64(parameters.data(), parameters.size(), sourceHash);
+}
+
+/// <summary>
+/// reads the result stored for a key, and marks it as the most recently used
+/// </summary>
+/// <returns>returns false if there is no result for the key, or if its file is damaged</returns>
+bool EffectCache::Load(Uint64 key, std::vector<Uint8>& data)
+{
+	std::string filename;
+	Uint64 maxSize;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_isEnabled)
+		{
+			return false;
+		}
+
+		filename = GetFilename(m_directory, key);
+		maxSize = m_maxSize;
+	}
+
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_statistics.totalMisses++;
+		return false;
+	}
+
+	EffectFileHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	bool isValid = file && std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 && 
+		           header.version == FILE_VERSION && header.key == key && header.dataSize <= maxSize;
+
+	if (isValid)
+	{
+		data.resize(static_cast<size_t>(header.dataSize));
+		file.read(reinterpret_cast<char*>(data.data()), data.size());
+		isValid = file && Hash64(data.data(), data.size()) == header.dataHash;
+	}
+
+	file.close();
+	std::error_code error;
+
+	if (!isValid)
+	{
+		std::cout << "Damaged effect cache file removed: " << filename << std::endl;
+		std::filesystem::remove(filename, error);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_statistics.totalMisses++;
+		return false;
+	}
+
+	//the time of the last use is the modification time, which every instance sees
+	std::filesystem::last_write_time(filename, std::filesystem::file_time_type::clock::now(), error);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statistics.totalHits++;
+	return true;
+}
+
+/// <summary>
+/// stores the result for a key, then evicts the least recently used results if the cache is over its size limit. 
+/// Results larger than a quarter of the limit are not stored, as they would push out too many others
+/// </summary>
+/// <returns>returns false if the result was not stored</returns>
+bool EffectCache::Store(Uint64 key, const void* data, size_t size)
+{
+	std::string directory;
+	Uint64 maxSize;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_isEnabled || m_directory.empty() || size > m_maxSize / 4)
+		{
+			return false;
+		}
+
+		directory = m_directory;
+		maxSize = m_maxSize;
+	}
+
+	std::string filename = GetFilename(directory, key);
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	//the temporary name is unique to the thread and the time, so instances storing the same result do not collide
+	Uint64 uniqueValues[2] = { std::hash<std::thread::id>()(std::this_thread::get_id()), 
+		                       static_cast<Uint64>(std::chrono::steady_clock::now().time_since_epoch().count()) };
+	std::stringstream temporaryFilename;
+	temporaryFilename << filename << "." << std::hex << Hash64(uniqueValues, sizeof(uniqueValues)) << TEMPORARY_FILE_EXTENSION;
+
+	EffectFileHeader header;
+	std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+	header.version = FILE_VERSION;
+	header.key = key;
+	header.dataSize = size;
+	header.dataHash = Hash64(data, size);
+
+	std::ofstream file(temporaryFilename.str(), std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(static_cast<const char*>(data), size);
+	file.close();
+
+	if (!file)
+	{
+		std::cout << "Error writing effect cache file: " << temporaryFilename.str() << std::endl;
+		std::filesystem::remove(temporaryFilename.str(), error);
+		return false;
+	}
+
+	//fails when another instance is reading the file, which then holds the same result
+	std::filesystem::rename(temporaryFilename.str(), filename, error);
+
+	if (error)
+	{
+		std::filesystem::remove(temporaryFilename.str(), error);
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_statistics.totalStores++;
+	}
+
+	Evict(directory, maxSize);
+
+	return true;
+}
+
+/// <summary>
+/// deletes every result in the cache
+/// </summary>
+void EffectCache::Clear()
+{
+	std::error_code error;
+
+	for (const auto& entry : std::filesystem::directory_iterator(GetDirectory(), error))
+	{
+		if (entry.path().extension() == FILE_EXTENSION)
+		{
+			std::filesystem::remove(entry.path(), error);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statistics.size = 0;
+}
+
+void EffectCache::SetEnabled(bool isEnabled)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_isEnabled = isEnabled;
+}
+
+bool EffectCache::IsEnabled() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_isEnabled;
+}
+
+void EffectCache::SetDirectory(const std::string& directory)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_directory = directory;
+}
+
+std::string EffectCache::GetDirectory() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_directory;
+}
+
+void EffectCache::SetMaxSize(Uint64 maxSize)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_maxSize = maxSize;
+}
+
+Uint64 EffectCache::GetMaxSize() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_maxSize;
+}
+
+EffectCache::Statistics EffectCache::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_statistics;
+}
+
+std::string EffectCache::GetFilename(const std::string& directory, Uint64 key)
+{
+	std::stringstream filename;
+	filename << std::hex << key << FILE_EXTENSION;
+	return (std::filesystem::path(directory) / filename.str()).string();
+}
+
+/// <summary>
+/// deletes the least recently used results until the cache is within its size limit, along with the temporary files 
+/// left by instances that stopped while writing. Files other instances delete or hold open meanwhile are skipped. 
+/// Walks the directory without holding the mutex, which it only takes to update the statistics
+/// </summary>
+void EffectCache::Evict(const std::string& directory, Uint64 maxSize)
+{
+	struct CacheFile
+	{
+		std::filesystem::path path;
+		Uint64 size;
+		std::filesystem::file_time_type lastUseTime;
+	};
+
+	std::vector<CacheFile> files;
+	Uint64 totalSize = 0;
+	auto now = std::filesystem::file_time_type::clock::now();
+	std::error_code error;
+
+	for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+	{
+		std::error_code entryError;
+		CacheFile file = { entry.path(), entry.file_size(entryError), entry.last_write_time(entryError) };
+
+		if (entryError)
+		{
+			continue;
+		}
+
+		if (file.path.extension() == TEMPORARY_FILE_EXTENSION && now - file.lastUseTime > STALE_TEMPORARY_FILE_AGE)
+		{
+			std::filesystem::remove(file.path, entryError);
+		}
+		else if (file.path.extension() == FILE_EXTENSION)
+		{
+			files.push_back(file);
+			totalSize += file.size;
+		}
+	}
+
+	Uint32 totalEvictions = 0;
+
+	if (totalSize > maxSize)
+	{
+		std::sort(files.begin(), files.end(), [](const CacheFile& first, const CacheFile& second)
+		{
+			return first.lastUseTime < second.lastUseTime;
+		});
+
+		for (const CacheFile& file : files)
+		{
+			if (totalSize <= maxSize * EVICTION_TARGET)
+			{
+				break;
+			}
+
+			if (std::filesystem::remove(file.path, error))
+			{
+				totalSize -= file.size;
+				totalEvictions++;
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statistics.totalEvictions += totalEvictions;
+	m_statistics.size = totalSize;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+//a cache of effect results on disk, shared by every instance of the application and kept across sessions. 
+//A result is found by the hash of the source pixels and of the effect parameters, so the same effect on the same image 
+//is computed once, whatever file the image was loaded from. Results are stored uncompressed, which reads and writes 
+//as fast as the disk allows, with a hash of their data that rejects files cut short by a crash. 
+//Files are written under a temporary name and renamed into place, so other instances never read half a file, 
+//and the least recently used files are deleted once the cache grows over its size limit
+class EffectCache
+{
+
+public:
+
+	struct Statistics
+	{
+		Uint32 totalHits = 0;
+		Uint32 totalMisses = 0;
+		Uint32 totalStores = 0;
+		Uint32 totalEvictions = 0;
+		Uint64 size = 0; //of the files in the cache when it was last stored to, including those of other instances
+	};
+
+	static EffectCache* Instance();
+
+	static Uint64 GetKey(Uint64 sourceHash, const std::string& parameters);
+
+	bool Load(Uint64 key, std::vector<Uint8>& data);
+	bool Store(Uint64 key, const void* data, size_t size);
+	void Clear();
+
+	void SetEnabled(bool isEnabled);
+	bool IsEnabled() const;
+	void SetDirectory(const std::string& directory);
+	std::string GetDirectory() const;
+	void SetMaxSize(Uint64 maxSize);
+	Uint64 GetMaxSize() const;
+
+	Statistics GetStatistics() const;
+
+private:
+
+	EffectCache();
+	EffectCache(const EffectCache&);
+
+	static std::string GetFilename(const std::string& directory, Uint64 key);
+	void Evict(const std::string& directory, Uint64 maxSize);
+
+	//guards the settings and the statistics, which the UI thread reads every frame, but not the files: 
+	//effects computed away from the UI thread read and write them without holding it
+	mutable std::mutex m_mutex;
+
+	bool m_isEnabled;
+	std::string m_directory;
+	Uint64 m_maxSize;
+	Statistics m_statistics;
+
+};
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "FileDialog.h"
+#include <cstring>
 #include <string>
 
+#if defined(_WIN32)
+
 HRESULT OpenFileDialog(char* filename)
 {
 	IFileOpenDialog* pFileOpen;
@@ -74,6 +77,20 @@ HRESULT SaveFileDialog(char* filename)
 	return hr;
 }
 
+#else
+
+HRESULT OpenFileDialog(char*)
+{
+	return -1;
+}
+
+HRESULT SaveFileDialog(char*)
+{
+	return -1;
+}
+
+#endif
+
 bool AcceptibleFormat(const char* filename)
 {
 	bool isacceptible = true;
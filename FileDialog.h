@@ -1,5 +1,13 @@
 #pragma once
+
+//the dialogs are windows dialogs. Elsewhere they fail as if cancelled, so images are only loaded and saved
+//through the command line there
+#if defined(_WIN32)
 #include <shobjidl.h> 
+#else
+typedef long HRESULT;
+#define MAX_PATH 260
+#endif
 
 //opens a windows dialog for choosing a file from the file system
 HRESULT OpenFileDialog(char* filename);
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include "FrameBudget.h"
+#include "Parallel.h"
+
+//the budget of each frame until it is set
+static const double DEFAULT_MAX_MILLISECONDS = 8.0;
+
+//the budget never shrinks below this, so effects still finish while frames run long for other reasons
+static const double MIN_MILLISECONDS = 1.0;
+
+//a display at 60 hz
+static const double DEFAULT_TARGET_FRAME_MILLISECONDS = 1000.0 / 60.0;
+
+//frames this share over the target shrink the budget by the factor, frames within the target grow it by the step
+static const double FRAME_TIME_TOLERANCE = 0.1;
+static const double SHRINK_FACTOR = 0.75;
+static const double GROW_MILLISECONDS = 0.25;
+
+//with this few threads, the workers take the core the UI thread would need, so effects are time-sliced by default
+static const GLuint MAX_SLICING_THREADS = 2;
+
+FrameBudget::FrameBudget()
+{
+	m_isSlicing = GetTotalParallelThreads() <= MAX_SLICING_THREADS;
+	m_maxMilliseconds = DEFAULT_MAX_MILLISECONDS;
+	m_isAdaptive = true;
+	m_targetFrameMilliseconds = DEFAULT_TARGET_FRAME_MILLISECONDS;
+
+	m_milliseconds = m_maxMilliseconds;
+	m_usedMilliseconds = 0.0;
+	m_lastFrameMilliseconds = 0.0;
+	m_lastUsedMilliseconds = 0.0;
+	m_isFrameTimed = false;
+}
+
+/// <summary>
+/// starts the budget of a new frame, adapting it to the time the last frame took. 
+/// Only frames that ran effects shrink it, as the others would run as long without them
+/// </summary>
+void FrameBudget::BeginFrame()
+{
+	if (m_isFrameTimed)
+	{
+		m_lastFrameMilliseconds = m_frameTimer.GetElapsedMilliseconds();
+		m_lastUsedMilliseconds = m_usedMilliseconds;
+
+		if (!m_isAdaptive)
+		{
+			m_milliseconds = m_maxMilliseconds;
+		}
+		else if (m_lastFrameMilliseconds > m_targetFrameMilliseconds * (1.0 + FRAME_TIME_TOLERANCE))
+		{
+			if (m_usedMilliseconds > 0.0)
+			{
+				m_milliseconds = std::max(m_milliseconds * SHRINK_FACTOR, std::min(MIN_MILLISECONDS, m_maxMilliseconds));
+			}
+		}
+		else if (m_lastFrameMilliseconds <= m_targetFrameMilliseconds)
+		{
+			m_milliseconds = std::min(m_milliseconds + GROW_MILLISECONDS, m_maxMilliseconds);
+		}
+	}
+
+	m_frameTimer.Start();
+	m_isFrameTimed = true;
+	m_usedMilliseconds = 0.0;
+}
+
+/// <summary>
+/// counts time spent on time-sliced effects against the budget of this frame
+/// </summary>
+void FrameBudget::Use(double milliseconds)
+{
+	m_usedMilliseconds += milliseconds;
+}
+
+/// <summary>
+/// the time left of the budget of this frame, which is negative once it is overrun
+/// </summary>
+double FrameBudget::GetRemainingMilliseconds() const
+{
+	return m_milliseconds - m_usedMilliseconds;
+}
+
+/// <summary>
+/// sets whether effects run time-sliced on the main thread, from the next effect on
+/// </summary>
+void FrameBudget::SetSlicing(bool isSlicing)
+{
+	m_isSlicing = isSlicing;
+}
+
+bool FrameBudget::IsSlicing() const
+{
+	return m_isSlicing;
+}
+
+/// <summary>
+/// sets the budget of each frame, which the adaptive budget stays under
+/// </summary>
+void FrameBudget::SetMaxMilliseconds(double maxMilliseconds)
+{
+	m_maxMilliseconds = std::max(maxMilliseconds, 0.0);
+	m_milliseconds = m_isAdaptive ? std::min(m_milliseconds, m_maxMilliseconds) : m_maxMilliseconds;
+}
+
+double FrameBudget::GetMaxMilliseconds() const
+{
+	return m_maxMilliseconds;
+}
+
+/// <summary>
+/// sets whether the budget adapts to the frame time, or is always the maximum
+/// </summary>
+void FrameBudget::SetAdaptive(bool isAdaptive)
+{
+	m_isAdaptive = isAdaptive;
+	m_milliseconds = m_maxMilliseconds;
+}
+
+bool FrameBudget::IsAdaptive() const
+{
+	return m_isAdaptive;
+}
+
+/// <summary>
+/// sets the frame time the adaptive budget keeps the frames to, usually the refresh interval of the display
+/// </summary>
+void FrameBudget::SetTargetFrameMilliseconds(double targetFrameMilliseconds)
+{
+	m_targetFrameMilliseconds = targetFrameMilliseconds;
+}
+
+double FrameBudget::GetTargetFrameMilliseconds() const
+{
+	return m_targetFrameMilliseconds;
+}
+
+/// <summary>
+/// the budget of this frame
+/// </summary>
+double FrameBudget::GetMilliseconds() const
+{
+	return m_milliseconds;
+}
+
+double FrameBudget::GetLastFrameMilliseconds() const
+{
+	return m_lastFrameMilliseconds;
+}
+
+/// <summary>
+/// the time time-sliced effects took in the last frame, which may overrun the budget by a row
+/// </summary>
+double FrameBudget::GetLastUsedMilliseconds() const
+{
+	return m_lastUsedMilliseconds;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Timer.h"
+
+//the time the main loop may spend on time-sliced effects each frame. The budget adapts to the measured frame time: 
+//it shrinks quickly while frames run over the target frame time and grows slowly back to its maximum while they keep to it, 
+//so the effects take what the frames can spare without the frame rate swinging. 
+//Owned by the frame loop, which passes it to what runs effects time-sliced. Used on the main thread only
+class FrameBudget
+{
+
+public:
+
+	FrameBudget();
+
+	void BeginFrame();
+	void Use(double milliseconds);
+	double GetRemainingMilliseconds() const;
+
+	void SetSlicing(bool isSlicing);
+	bool IsSlicing() const;
+	void SetMaxMilliseconds(double maxMilliseconds);
+	double GetMaxMilliseconds() const;
+	void SetAdaptive(bool isAdaptive);
+	bool IsAdaptive() const;
+	void SetTargetFrameMilliseconds(double targetFrameMilliseconds);
+	double GetTargetFrameMilliseconds() const;
+
+	double GetMilliseconds() const;
+	double GetLastFrameMilliseconds() const;
+	double GetLastUsedMilliseconds() const;
+
+private:
+
+	FrameBudget(const FrameBudget&);
+
+	bool m_isSlicing; //effects run time-sliced on the main thread, instead of on the workers
+	double m_maxMilliseconds;
+	bool m_isAdaptive;
+	double m_targetFrameMilliseconds;
+
+	double m_milliseconds; //the budget of this frame
+	double m_usedMilliseconds; //of the budget of this frame
+	double m_lastFrameMilliseconds;
+	double m_lastUsedMilliseconds;
+
+	Timer m_frameTimer;
+	bool m_isFrameTimed; //a frame was begun before, so the timer measures a whole frame
+
+};
\ No newline at end of file
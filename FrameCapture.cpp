@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "FrameCapture.h"
+#include "GLState.h"
+#include "PngWriter.h"
+#include "QoiWriter.h"
+#include "Timer.h"
+
+//frames are read as RGBA, the format drivers read back without conversion, and written without alpha
+static const GLsizei BYTES_PER_PIXEL = 4;
+static const Uint32 OUTPUT_CHANNELS = 3;
+
+//BT.601 studio range conversion, the range y4m readers assume unless told otherwise
+static Uint8 GetLuma(int red, int green, int blue)
+{
+	return static_cast<Uint8>(((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16);
+}
+
+static Uint8 GetBlueChroma(int red, int green, int blue)
+{
+	return static_cast<Uint8>(((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+}
+
+static Uint8 GetRedChroma(int red, int green, int blue)
+{
+	return static_cast<Uint8>(((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+}
+
+FrameCapture::FrameCapture()
+{
+	m_isCapturing = false;
+	m_isDroppingFrames = true;
+	m_format = Format::PngSequence;
+
+	m_x = 0;
+	m_y = 0;
+	m_width = 0;
+	m_height = 0;
+
+	for (PendingFrame& pendingFrame : m_pendingFrames)
+	{
+		pendingFrame = { 0, nullptr };
+	}
+
+	m_totalReadFrames = 0;
+	m_totalCapturedFrames = 0;
+	m_totalWrittenFrames = 0;
+	m_totalDroppedFrames = 0;
+	m_captureMilliseconds = 0.0;
+
+	m_totalFrameBuffers = 0;
+	m_isWriteFailed = false;
+}
+
+FrameCapture::~FrameCapture()
+{
+	Stop();
+}
+
+/// <summary>
+/// starts recording the given part of the framebuffer. The format follows the extension of the file: 
+/// '.qoi' and '.png' write one numbered image per frame next to the file, '.y4m' writes a single video stream 
+/// to the file, which may also be a named pipe read by a video encoder
+/// </summary>
+/// <param name="x">left of the recorded rectangle, in pixels from the left of the framebuffer</param>
+/// <param name="y">bottom of the recorded rectangle, in pixels from the bottom of the framebuffer</param>
+/// <param name="framesPerSecond">the frame rate stored in videos</param>
+/// <returns>returns false if the capture could not be started</returns>
+bool FrameCapture::Start(const std::string& filename, GLint x, GLint y, GLsizei width, GLsizei height, GLuint framesPerSecond)
+{
+	Stop();
+
+	m_format = GetFormat(filename);
+
+	//y4m videos store the color at half resolution, which needs an even size
+	if (m_format == Format::Y4M)
+	{
+		width &= ~1;
+		height &= ~1;
+	}
+
+	if (width <= 0 || height <= 0)
+	{
+		std::cout << "Error: nothing to capture" << std::endl;
+		return false;
+	}
+
+	if (m_format == Format::Y4M)
+	{
+		m_videoFile.open(filename, std::ios::binary);
+
+		if (!m_videoFile)
+		{
+			std::cout << "Error creating video file: " << filename << std::endl;
+			return false;
+		}
+
+		m_videoFile << "YUV4MPEG2 W" << width << " H" << height << " F" << framesPerSecond << ":1 Ip A1:1 C420jpeg\n";
+		m_planes.resize(static_cast<size_t>(width) * height * 3 / 2);
+	}
+
+	m_filename = filename;
+	m_x = x;
+	m_y = y;
+	m_width = width;
+	m_height = height;
+
+	GLsizeiptr pixelBufferSize = static_cast<GLsizeiptr>(width) * height * BYTES_PER_PIXEL;
+
+	for (PendingFrame& pendingFrame : m_pendingFrames)
+	{
+		glCreateBuffers(1, &pendingFrame.pixelBuffer);
+		glNamedBufferStorage(pendingFrame.pixelBuffer, pixelBufferSize, nullptr, GL_MAP_READ_BIT | GL_CLIENT_STORAGE_BIT);
+		pendingFrame.fence = nullptr;
+	}
+
+	m_totalReadFrames = 0;
+	m_totalCapturedFrames = 0;
+	m_totalWrittenFrames = 0;
+	m_totalDroppedFrames = 0;
+	m_captureMilliseconds = 0.0;
+
+	m_totalFrameBuffers = 0;
+	m_isWriteFailed = false;
+	m_isCapturing = true;
+
+	return true;
+}
+
+/// <summary>
+/// starts reading the frame rendered so far, and hands the frame read a few frames ago to a writer task. 
+/// Call after rendering and before presenting the frame
+/// </summary>
+void FrameCapture::CaptureFrame()
+{
+	if (!m_isCapturing)
+	{
+		return;
+	}
+
+	Timer timer;
+
+	//the pixel buffer is reused, so the frame read into it TOTAL_PIXEL_BUFFERS frames ago has to be collected first
+	PendingFrame& pendingFrame = m_pendingFrames[m_totalReadFrames % TOTAL_PIXEL_BUFFERS];
+
+	if (pendingFrame.fence)
+	{
+		CollectFrame(pendingFrame, !m_isDroppingFrames);
+	}
+
+	GLState::Instance()->BindBuffer(GL_PIXEL_PACK_BUFFER, pendingFrame.pixelBuffer);
+	glReadPixels(m_x, m_y, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	pendingFrame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	//reads into client memory elsewhere must not land in the pixel buffer
+	GLState::Instance()->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	m_totalReadFrames++;
+	m_captureMilliseconds = timer.GetElapsedMilliseconds();
+}
+
+/// <summary>
+/// collects the frames still being read, waits for the writer tasks to write all frames and ends the capture
+/// </summary>
+void FrameCapture::Stop()
+{
+	if (!m_isCapturing)
+	{
+		return;
+	}
+
+	//oldest first. None of these are dropped, as the render loop no longer needs to keep up
+	for (GLuint i = 0; i < TOTAL_PIXEL_BUFFERS; i++)
+	{
+		PendingFrame& pendingFrame = m_pendingFrames[(m_totalReadFrames + i) % TOTAL_PIXEL_BUFFERS];
+
+		if (pendingFrame.fence)
+		{
+			CollectFrame(pendingFrame, true);
+		}
+	}
+
+	TaskScheduler::Instance()->Wait(m_writeTasks);
+	m_writeTasks.clear();
+
+	for (PendingFrame& pendingFrame : m_pendingFrames)
+	{
+		GLState::Instance()->InvalidateBuffer(pendingFrame.pixelBuffer);
+		glDeleteBuffers(1, &pendingFrame.pixelBuffer);
+		pendingFrame.pixelBuffer = 0;
+	}
+
+	if (m_videoFile.is_open())
+	{
+		m_videoFile.close();
+	}
+
+	m_freePixels.clear();
+	m_totalFrameBuffers = 0;
+	m_planes.clear();
+	m_planes.shrink_to_fit();
+
+	m_isCapturing = false;
+
+	std::cout << "Capture: " << m_totalWrittenFrames << " of " << m_totalCapturedFrames << " frames written to " << m_filename 
+		      << ", " << m_totalDroppedFrames << " dropped" << std::endl;
+}
+
+/// <summary>
+/// sets whether frames are dropped when the writer tasks fall behind, which keeps the render loop at its rate, 
+/// or whether the render loop waits for them, which keeps every frame
+/// </summary>
+void FrameCapture::SetDroppingFrames(bool isDroppingFrames)
+{
+	m_isDroppingFrames = isDroppingFrames;
+}
+
+bool FrameCapture::IsCapturing() const
+{
+	return m_isCapturing;
+}
+
+/// <summary>
+/// number of frames handed to the writer tasks since the capture started
+/// </summary>
+GLuint FrameCapture::GetTotalCapturedFrames() const
+{
+	return m_totalCapturedFrames;
+}
+
+/// <summary>
+/// number of frames left out because the writer tasks fell too far behind
+/// </summary>
+GLuint FrameCapture::GetTotalDroppedFrames() const
+{
+	return m_totalDroppedFrames;
+}
+
+/// <summary>
+/// time the render loop spent capturing the last frame
+/// </summary>
+double FrameCapture::GetCaptureMilliseconds() const
+{
+	return m_captureMilliseconds;
+}
+
+/// <summary>
+/// the format written to a file, chosen by its extension. Files without a known extension get a png sequence
+/// </summary>
+FrameCapture::Format FrameCapture::GetFormat(const std::string& filename)
+{
+	std::string extension = filename.substr(std::min(filename.rfind('.'), filename.size()));
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	if (extension == ".y4m")
+	{
+		return Format::Y4M;
+	}
+
+	if (extension == ".qoi")
+	{
+		return Format::QoiSequence;
+	}
+
+	return Format::PngSequence;
+}
+
+/// <summary>
+/// copies a frame read earlier out of its pixel buffer and submits a task writing it. 
+/// When all frame storage is queued or being written, the frame is dropped, or when blocking, waits for the writers
+/// </summary>
+void FrameCapture::CollectFrame(PendingFrame& pendingFrame, bool isBlocking)
+{
+	while (glClientWaitSync(pendingFrame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+	{
+	}
+
+	glDeleteSync(pendingFrame.fence);
+	pendingFrame.fence = nullptr;
+
+	std::vector<Uint8> pixels;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (isBlocking)
+		{
+			m_condition.wait(lock, [this]() { return !m_freePixels.empty() || m_totalFrameBuffers < MAX_QUEUED_FRAMES; });
+		}
+
+		if (!m_freePixels.empty())
+		{
+			pixels = std::move(m_freePixels.back());
+			m_freePixels.pop_back();
+		}
+		else if (m_totalFrameBuffers < MAX_QUEUED_FRAMES)
+		{
+			m_totalFrameBuffers++;
+		}
+		else
+		{
+			m_totalDroppedFrames++;
+			return;
+		}
+	}
+
+	size_t frameSize = static_cast<size_t>(m_width) * m_height * BYTES_PER_PIXEL;
+	pixels.resize(frameSize);
+
+	auto mappedPixels = static_cast<const Uint8*>(glMapNamedBufferRange(pendingFrame.pixelBuffer, 0, frameSize, GL_MAP_READ_BIT));
+
+	if (!mappedPixels)
+	{
+		std::cout << "Error reading back a captured frame" << std::endl;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_freePixels.push_back(std::move(pixels));
+		return;
+	}
+
+	std::copy_n(mappedPixels, frameSize, pixels.begin());
+	glUnmapNamedBuffer(pendingFrame.pixelBuffer);
+
+	auto frame = std::make_shared<Frame>();
+	frame->index = m_totalCapturedFrames++;
+	frame->pixels = std::move(pixels);
+
+	//frames of a video depend on the order they are written in, images of a sequence do not
+	std::vector<TaskHandle> dependencies;
+
+	if (m_format == Format::Y4M && !m_writeTasks.empty())
+	{
+		dependencies.push_back(m_writeTasks.back());
+	}
+
+	m_writeTasks.erase(std::remove_if(m_writeTasks.begin(), m_writeTasks.end(), [](const TaskHandle& task) { return task->IsDone(); }), 
+		               m_writeTasks.end());
+	m_writeTasks.push_back(TaskScheduler::Instance()->Submit([this, frame]() { WriteFrame(*frame); }, TaskPriority::Background, dependencies));
+}
+
+/// <summary>
+/// runs as a background task: encodes a frame and hands its pixel storage back. 
+/// After a failed write the remaining frames are no longer written
+/// </summary>
+void FrameCapture::WriteFrame(Frame& frame)
+{
+	bool isWriteFailed = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		isWriteFailed = m_isWriteFailed;
+	}
+
+	bool isWritten = false;
+
+	if (!isWriteFailed)
+	{
+		isWritten = (m_format == Format::Y4M) ? WriteVideoFrame(frame) : WriteImage(frame);
+
+		if (!isWritten)
+		{
+			std::cout << "Error writing captured frame " << frame.index << std::endl;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_freePixels.push_back(std::move(frame.pixels));
+
+		if (isWritten)
+		{
+			m_totalWrittenFrames++;
+		}
+		else
+		{
+			m_isWriteFailed = true;
+		}
+	}
+
+	m_condition.notify_all();
+}
+
+/// <summary>
+/// writes a frame as the next image of the sequence, numbered after the name of the capture file
+/// </summary>
+bool FrameCapture::WriteImage(const Frame& frame)
+{
+	size_t extensionStart = m_filename.rfind('.');
+	std::string extension = (extensionStart != std::string::npos) ? m_filename.substr(extensionStart) : ".png";
+
+	std::ostringstream filename;
+	filename << m_filename.substr(0, extensionStart) << "_" << std::setw(5) << std::setfill('0') << frame.index << extension;
+
+	size_t pitch = static_cast<size_t>(m_width) * BYTES_PER_PIXEL;
+	std::vector<Uint8> outputRow(static_cast<size_t>(m_width) * OUTPUT_CHANNELS);
+
+	auto write = [&](auto& writer)
+	{
+		if (!writer.Open(filename.str(), m_width, m_height, OUTPUT_CHANNELS))
+		{
+			return false;
+		}
+
+		//OpenGL returns the bottom row first
+		for (GLsizei row = 0; row < m_height; row++)
+		{
+			const Uint8* pixel = &frame.pixels[(m_height - 1 - row) * pitch];
+
+			for (GLsizei column = 0; column < m_width; column++, pixel += BYTES_PER_PIXEL)
+			{
+				std::copy_n(pixel, OUTPUT_CHANNELS, &outputRow[column * OUTPUT_CHANNELS]);
+			}
+
+			if (!writer.WriteRows(outputRow.data(), 1, outputRow.size()))
+			{
+				return false;
+			}
+		}
+
+		return writer.Close();
+	};
+
+	if (m_format == Format::QoiSequence)
+	{
+		QoiWriter writer;
+		return write(writer);
+	}
+
+	PngWriter writer;
+	return write(writer);
+}
+
+/// <summary>
+/// appends a frame to the y4m video. Each 2x2 block of pixels shares the average of their colors
+/// </summary>
+bool FrameCapture::WriteVideoFrame(const Frame& frame)
+{
+	size_t pitch = static_cast<size_t>(m_width) * BYTES_PER_PIXEL;
+	size_t totalPixels = static_cast<size_t>(m_width) * m_height;
+
+	Uint8* luma = m_planes.data();
+	Uint8* blueChroma = luma + totalPixels;
+	Uint8* redChroma = blueChroma + totalPixels / 4;
+
+	for (GLsizei row = 0; row < m_height; row += 2)
+	{
+		//the image row below in the video is the row above in OpenGL
+		const Uint8* top = &frame.pixels[(m_height - 1 - row) * pitch];
+		const Uint8* bottom = top - pitch;
+
+		Uint8* topLuma = luma + row * m_width;
+		Uint8* bottomLuma = topLuma + m_width;
+
+		for (GLsizei column = 0; column < m_width; column += 2, top += 2 * BYTES_PER_PIXEL, bottom += 2 * BYTES_PER_PIXEL)
+		{
+			topLuma[column] = GetLuma(top[0], top[1], top[2]);
+			topLuma[column + 1] = GetLuma(top[4], top[5], top[6]);
+			bottomLuma[column] = GetLuma(bottom[0], bottom[1], bottom[2]);
+			bottomLuma[column + 1] = GetLuma(bottom[4], bottom[5], bottom[6]);
+
+			int red = (top[0] + top[4] + bottom[0] + bottom[4] + 2) >> 2;
+			int green = (top[1] + top[5] + bottom[1] + bottom[5] + 2) >> 2;
+			int blue = (top[2] + top[6] + bottom[2] + bottom[6] + 2) >> 2;
+
+			*blueChroma++ = GetBlueChroma(red, green, blue);
+			*redChroma++ = GetRedChroma(red, green, blue);
+		}
+	}
+
+	m_videoFile << "FRAME\n";
+	m_videoFile.write(reinterpret_cast<const char*>(m_planes.data()), m_planes.size());
+
+	//pipes are read as the video is written
+	m_videoFile.flush();
+
+	return m_videoFile.good();
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "gl.h"
+#include "TaskScheduler.h"
+
+//records the frames presented on screen as a png or qoi image sequence, or as a y4m video that can be piped to an encoder.
+//Each frame is read into one of a ring of pixel buffers without waiting for the GPU, and collected a few frames later 
+//when the transfer has long finished. The images are converted and encoded by background tasks, so capturing costs 
+//the render loop little more than a copy of the frame. Images of a sequence are encoded in parallel, 
+//while each video frame waits for the task of the frame before it.
+class FrameCapture
+{
+
+public:
+
+	enum class Format
+	{
+		PngSequence,
+		QoiSequence,
+		Y4M
+	};
+
+	FrameCapture();
+	~FrameCapture();
+
+	bool Start(const std::string& filename, GLint x, GLint y, GLsizei width, GLsizei height, GLuint framesPerSecond);
+	void CaptureFrame();
+	void SetDroppingFrames(bool isDroppingFrames);
+	void Stop();
+
+	bool IsCapturing() const;
+
+	GLuint GetTotalCapturedFrames() const;
+	GLuint GetTotalDroppedFrames() const;
+	double GetCaptureMilliseconds() const;
+
+	static Format GetFormat(const std::string& filename);
+
+private:
+
+	struct PendingFrame
+	{
+		GLuint pixelBuffer;
+		GLsync fence;
+	};
+
+	struct Frame
+	{
+		GLuint index;
+		std::vector<Uint8> pixels;
+	};
+
+	FrameCapture(const FrameCapture&);
+
+	void CollectFrame(PendingFrame& pendingFrame, bool isBlocking);
+
+	void WriteFrame(Frame& frame);
+	bool WriteImage(const Frame& frame);
+	bool WriteVideoFrame(const Frame& frame);
+
+	static const GLuint TOTAL_PIXEL_BUFFERS = 3;
+	static const GLuint MAX_QUEUED_FRAMES = 8;
+
+	//read by the main thread while the render thread captures
+	std::atomic<bool> m_isCapturing;
+	bool m_isDroppingFrames;
+	Format m_format;
+	std::string m_filename;
+
+	GLint m_x;
+	GLint m_y;
+	GLsizei m_width;
+	GLsizei m_height;
+
+	PendingFrame m_pendingFrames[TOTAL_PIXEL_BUFFERS];
+	GLuint m_totalReadFrames;
+	std::atomic<GLuint> m_totalCapturedFrames;
+	GLuint m_totalWrittenFrames;
+	std::atomic<GLuint> m_totalDroppedFrames;
+	std::atomic<double> m_captureMilliseconds;
+
+	//the tasks writing frames, and the pixel storage of frames already written
+	std::vector<TaskHandle> m_writeTasks;
+	std::vector<std::vector<Uint8>> m_freePixels;
+	GLuint m_totalFrameBuffers;
+	bool m_isWriteFailed;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+
+	std::ofstream m_videoFile;
+	std::vector<Uint8> m_planes;
+
+};
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <type_traits>
+#include "GLProfiler.h"
+
+GLProfiler::Counter* GLProfiler::s_counters = nullptr;
+std::atomic<bool> GLProfiler::s_isTiming{ false };
+
+//adds the ticks spent in a driver call to the function's counter once the call returns
+struct GLProfilerTickScope
+{
+	GLProfilerTickScope(std::atomic<Uint64>& totalTicks) : totalTicks(totalTicks), startTicks(SDL_GetPerformanceCounter()) {}
+	~GLProfilerTickScope() { totalTicks.fetch_add(SDL_GetPerformanceCounter() - startTicks, std::memory_order_relaxed); }
+
+	std::atomic<Uint64>& totalTicks;
+	Uint64 startTicks;
+};
+
+//a function with the exact signature of a glad function pointer, which counts the call and forwards it to the driver.
+//One is instantiated per entry point, as the pointer's address is a template argument.
+template <auto* Pointer, typename Proc>
+struct GLProfilerHook;
+
+template <auto* Pointer, typename R, typename... Args>
+struct GLProfilerHook<Pointer, R (GLAD_API_PTR*)(Args...)>
+{
+	static inline R (GLAD_API_PTR* s_driverFunction)(Args...) = nullptr;
+	static inline size_t s_index = 0;
+
+	static R GLAD_API_PTR Call(Args... args)
+	{
+		GLProfiler::Counter& counter = GLProfiler::s_counters[s_index];
+		counter.totalCalls.fetch_add(1, std::memory_order_relaxed);
+
+		if (!GLProfiler::s_isTiming.load(std::memory_order_relaxed))
+		{
+			return s_driverFunction(args...);
+		}
+
+		GLProfilerTickScope tickScope(counter.totalTicks);
+		return s_driverFunction(args...);
+	}
+};
+
+GLProfiler* GLProfiler::Instance()
+{
+	static GLProfiler* glProfiler = new GLProfiler;
+	return glProfiler;
+}
+
+GLProfiler::GLProfiler()
+{
+	m_isInstalled = false;
+}
+
+/// <summary>
+/// wraps every entry point loaded by glad with a counting wrapper. 
+/// Has to be called after glad has loaded OpenGL, from the thread owning the context, before any other thread issues GL calls
+/// </summary>
+/// <returns>returns false if the profiler was already installed</returns>
+bool GLProfiler::Install()
+{
+	if (m_isInstalled)
+	{
+		return false;
+	}
+
+#define GL_PROFILER_FUNCTION(name) Hook<&glad_##name>(#name);
+#include "GLProfilerFunctions.h"
+#undef GL_PROFILER_FUNCTION
+
+	//no GL call can happen while installing, so the counters only need to exist before the first wrapped call
+	m_counters = std::make_unique<Counter[]>(m_names.size());
+	s_counters = m_counters.get();
+
+	m_isInstalled = true;
+	return true;
+}
+
+bool GLProfiler::IsInstalled() const
+{
+	return m_isInstalled;
+}
+
+/// <summary>
+/// turns measuring the time spent inside each driver call on or off. Timing costs two counter reads per call
+/// </summary>
+void GLProfiler::SetTiming(bool isTiming)
+{
+	s_isTiming = isTiming;
+}
+
+bool GLProfiler::IsTiming() const
+{
+	return s_isTiming;
+}
+
+/// <summary>
+/// collects the calls of the frame that just ended, sorted by the number of calls, and starts counting a new frame
+/// </summary>
+void GLProfiler::BeginFrame()
+{
+	m_frameStats.clear();
+
+	if (!m_isInstalled)
+	{
+		return;
+	}
+
+	double ticksPerMillisecond = SDL_GetPerformanceFrequency() / 1000.0;
+
+	for (size_t i = 0; i < m_names.size(); i++)
+	{
+		GLuint totalCalls = m_counters[i].totalCalls.exchange(0, std::memory_order_relaxed);
+		Uint64 totalTicks = m_counters[i].totalTicks.exchange(0, std::memory_order_relaxed);
+
+		if (totalCalls > 0)
+		{
+			m_frameStats.push_back({ m_names[i], totalCalls, totalTicks / ticksPerMillisecond });
+		}
+	}
+
+	std::sort(m_frameStats.begin(), m_frameStats.end(), [](const FunctionStats& a, const FunctionStats& b)
+		{
+			return a.totalCalls > b.totalCalls;
+		});
+}
+
+GLuint GLProfiler::GetTotalFrameCalls() const
+{
+	GLuint totalCalls = 0;
+
+	for (const FunctionStats& stats : m_frameStats)
+	{
+		totalCalls += stats.totalCalls;
+	}
+
+	return totalCalls;
+}
+
+double GLProfiler::GetTotalFrameMilliseconds() const
+{
+	double milliseconds = 0.0;
+
+	for (const FunctionStats& stats : m_frameStats)
+	{
+		milliseconds += stats.milliseconds;
+	}
+
+	return milliseconds;
+}
+
+/// <summary>
+/// the functions called during the last frame, most called first
+/// </summary>
+const std::vector<GLProfiler::FunctionStats>& GLProfiler::GetFrameStats() const
+{
+	return m_frameStats;
+}
+
+/// <summary>
+/// swaps a glad function pointer for its counting wrapper. 
+/// Entry points the driver did not provide stay null, so calling them fails the same way as without the profiler
+/// </summary>
+template <auto* Pointer>
+void GLProfiler::Hook(const char* name)
+{
+	using ProfilerHook = GLProfilerHook<Pointer, std::remove_pointer_t<decltype(Pointer)>>;
+
+	if (*Pointer == nullptr)
+	{
+		return;
+	}
+
+	ProfilerHook::s_driverFunction = *Pointer;
+	ProfilerHook::s_index = m_names.size();
+	m_names.push_back(name);
+
+	*Pointer = &ProfilerHook::Call;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "gl.h"
+
+//optional instrumentation of the glad loader. Installing the profiler swaps every loaded glad function pointer 
+//for a wrapper that counts the calls made to it and, while timing is on, the time spent inside the driver.
+//The counts are collected per frame, so hot spots such as per-frame uniform lookups show up in the profiler overlay.
+class GLProfiler
+{
+
+public:
+
+	struct FunctionStats
+	{
+		std::string name;
+		GLuint totalCalls;
+		double milliseconds;
+	};
+
+	static GLProfiler* Instance();
+
+	bool Install();
+	bool IsInstalled() const;
+
+	void SetTiming(bool isTiming);
+	bool IsTiming() const;
+
+	void BeginFrame();
+
+	GLuint GetTotalFrameCalls() const;
+	double GetTotalFrameMilliseconds() const;
+	const std::vector<FunctionStats>& GetFrameStats() const;
+
+private:
+
+	struct Counter
+	{
+		std::atomic<GLuint> totalCalls;
+		std::atomic<Uint64> totalTicks;
+	};
+
+	template <auto* Pointer, typename Proc> friend struct GLProfilerHook;
+
+	GLProfiler();
+	GLProfiler(const GLProfiler&);
+
+	template <auto* Pointer> void Hook(const char* name);
+
+	static Counter* s_counters;
+	static std::atomic<bool> s_isTiming;
+
+	bool m_isInstalled;
+
+	std::vector<std::string> m_names;
+	std::unique_ptr<Counter[]> m_counters;
+	std::vector<FunctionStats> m_frameStats;
+
+};
\ No newline at end of file
@@ -0,0 +1,1052 @@
+//every OpenGL entry point declared by the glad loader in gl.h, as GL_PROFILER_FUNCTION(name) entries.
+//Define GL_PROFILER_FUNCTION before including this file. The list follows gl.h, so regenerate it whenever gl.h is:
+//grep -o 'PROC glad_gl[A-Za-z0-9_]*;' gl.h | sed 's/PROC glad_\(.*\);/GL_PROFILER_FUNCTION(\1)/'
+
+GL_PROFILER_FUNCTION(glAccum)
+GL_PROFILER_FUNCTION(glActiveShaderProgram)
+GL_PROFILER_FUNCTION(glActiveTexture)
+GL_PROFILER_FUNCTION(glAlphaFunc)
+GL_PROFILER_FUNCTION(glAreTexturesResident)
+GL_PROFILER_FUNCTION(glArrayElement)
+GL_PROFILER_FUNCTION(glAttachShader)
+GL_PROFILER_FUNCTION(glBegin)
+GL_PROFILER_FUNCTION(glBeginConditionalRender)
+GL_PROFILER_FUNCTION(glBeginQuery)
+GL_PROFILER_FUNCTION(glBeginQueryIndexed)
+GL_PROFILER_FUNCTION(glBeginTransformFeedback)
+GL_PROFILER_FUNCTION(glBindAttribLocation)
+GL_PROFILER_FUNCTION(glBindBuffer)
+GL_PROFILER_FUNCTION(glBindBufferBase)
+GL_PROFILER_FUNCTION(glBindBufferRange)
+GL_PROFILER_FUNCTION(glBindBuffersBase)
+GL_PROFILER_FUNCTION(glBindBuffersRange)
+GL_PROFILER_FUNCTION(glBindFragDataLocation)
+GL_PROFILER_FUNCTION(glBindFragDataLocationIndexed)
+GL_PROFILER_FUNCTION(glBindFramebuffer)
+GL_PROFILER_FUNCTION(glBindImageTexture)
+GL_PROFILER_FUNCTION(glBindImageTextures)
+GL_PROFILER_FUNCTION(glBindProgramPipeline)
+GL_PROFILER_FUNCTION(glBindRenderbuffer)
+GL_PROFILER_FUNCTION(glBindSampler)
+GL_PROFILER_FUNCTION(glBindSamplers)
+GL_PROFILER_FUNCTION(glBindTexture)
+GL_PROFILER_FUNCTION(glBindTextureUnit)
+GL_PROFILER_FUNCTION(glBindTextures)
+GL_PROFILER_FUNCTION(glBindTransformFeedback)
+GL_PROFILER_FUNCTION(glBindVertexArray)
+GL_PROFILER_FUNCTION(glBindVertexBuffer)
+GL_PROFILER_FUNCTION(glBindVertexBuffers)
+GL_PROFILER_FUNCTION(glBitmap)
+GL_PROFILER_FUNCTION(glBlendColor)
+GL_PROFILER_FUNCTION(glBlendEquation)
+GL_PROFILER_FUNCTION(glBlendEquationSeparate)
+GL_PROFILER_FUNCTION(glBlendEquationSeparatei)
+GL_PROFILER_FUNCTION(glBlendEquationi)
+GL_PROFILER_FUNCTION(glBlendFunc)
+GL_PROFILER_FUNCTION(glBlendFuncSeparate)
+GL_PROFILER_FUNCTION(glBlendFuncSeparatei)
+GL_PROFILER_FUNCTION(glBlendFunci)
+GL_PROFILER_FUNCTION(glBlitFramebuffer)
+GL_PROFILER_FUNCTION(glBlitNamedFramebuffer)
+GL_PROFILER_FUNCTION(glBufferData)
+GL_PROFILER_FUNCTION(glBufferStorage)
+GL_PROFILER_FUNCTION(glBufferSubData)
+GL_PROFILER_FUNCTION(glCallList)
+GL_PROFILER_FUNCTION(glCallLists)
+GL_PROFILER_FUNCTION(glCheckFramebufferStatus)
+GL_PROFILER_FUNCTION(glCheckNamedFramebufferStatus)
+GL_PROFILER_FUNCTION(glClampColor)
+GL_PROFILER_FUNCTION(glClear)
+GL_PROFILER_FUNCTION(glClearAccum)
+GL_PROFILER_FUNCTION(glClearBufferData)
+GL_PROFILER_FUNCTION(glClearBufferSubData)
+GL_PROFILER_FUNCTION(glClearBufferfi)
+GL_PROFILER_FUNCTION(glClearBufferfv)
+GL_PROFILER_FUNCTION(glClearBufferiv)
+GL_PROFILER_FUNCTION(glClearBufferuiv)
+GL_PROFILER_FUNCTION(glClearColor)
+GL_PROFILER_FUNCTION(glClearDepth)
+GL_PROFILER_FUNCTION(glClearDepthf)
+GL_PROFILER_FUNCTION(glClearIndex)
+GL_PROFILER_FUNCTION(glClearNamedBufferData)
+GL_PROFILER_FUNCTION(glClearNamedBufferSubData)
+GL_PROFILER_FUNCTION(glClearNamedFramebufferfi)
+GL_PROFILER_FUNCTION(glClearNamedFramebufferfv)
+GL_PROFILER_FUNCTION(glClearNamedFramebufferiv)
+GL_PROFILER_FUNCTION(glClearNamedFramebufferuiv)
+GL_PROFILER_FUNCTION(glClearStencil)
+GL_PROFILER_FUNCTION(glClearTexImage)
+GL_PROFILER_FUNCTION(glClearTexSubImage)
+GL_PROFILER_FUNCTION(glClientActiveTexture)
+GL_PROFILER_FUNCTION(glClientWaitSync)
+GL_PROFILER_FUNCTION(glClipControl)
+GL_PROFILER_FUNCTION(glClipPlane)
+GL_PROFILER_FUNCTION(glColor3b)
+GL_PROFILER_FUNCTION(glColor3bv)
+GL_PROFILER_FUNCTION(glColor3d)
+GL_PROFILER_FUNCTION(glColor3dv)
+GL_PROFILER_FUNCTION(glColor3f)
+GL_PROFILER_FUNCTION(glColor3fv)
+GL_PROFILER_FUNCTION(glColor3i)
+GL_PROFILER_FUNCTION(glColor3iv)
+GL_PROFILER_FUNCTION(glColor3s)
+GL_PROFILER_FUNCTION(glColor3sv)
+GL_PROFILER_FUNCTION(glColor3ub)
+GL_PROFILER_FUNCTION(glColor3ubv)
+GL_PROFILER_FUNCTION(glColor3ui)
+GL_PROFILER_FUNCTION(glColor3uiv)
+GL_PROFILER_FUNCTION(glColor3us)
+GL_PROFILER_FUNCTION(glColor3usv)
+GL_PROFILER_FUNCTION(glColor4b)
+GL_PROFILER_FUNCTION(glColor4bv)
+GL_PROFILER_FUNCTION(glColor4d)
+GL_PROFILER_FUNCTION(glColor4dv)
+GL_PROFILER_FUNCTION(glColor4f)
+GL_PROFILER_FUNCTION(glColor4fv)
+GL_PROFILER_FUNCTION(glColor4i)
+GL_PROFILER_FUNCTION(glColor4iv)
+GL_PROFILER_FUNCTION(glColor4s)
+GL_PROFILER_FUNCTION(glColor4sv)
+GL_PROFILER_FUNCTION(glColor4ub)
+GL_PROFILER_FUNCTION(glColor4ubv)
+GL_PROFILER_FUNCTION(glColor4ui)
+GL_PROFILER_FUNCTION(glColor4uiv)
+GL_PROFILER_FUNCTION(glColor4us)
+GL_PROFILER_FUNCTION(glColor4usv)
+GL_PROFILER_FUNCTION(glColorMask)
+GL_PROFILER_FUNCTION(glColorMaski)
+GL_PROFILER_FUNCTION(glColorMaterial)
+GL_PROFILER_FUNCTION(glColorP3ui)
+GL_PROFILER_FUNCTION(glColorP3uiv)
+GL_PROFILER_FUNCTION(glColorP4ui)
+GL_PROFILER_FUNCTION(glColorP4uiv)
+GL_PROFILER_FUNCTION(glColorPointer)
+GL_PROFILER_FUNCTION(glCompileShader)
+GL_PROFILER_FUNCTION(glCompressedTexImage1D)
+GL_PROFILER_FUNCTION(glCompressedTexImage2D)
+GL_PROFILER_FUNCTION(glCompressedTexImage3D)
+GL_PROFILER_FUNCTION(glCompressedTexSubImage1D)
+GL_PROFILER_FUNCTION(glCompressedTexSubImage2D)
+GL_PROFILER_FUNCTION(glCompressedTexSubImage3D)
+GL_PROFILER_FUNCTION(glCompressedTextureSubImage1D)
+GL_PROFILER_FUNCTION(glCompressedTextureSubImage2D)
+GL_PROFILER_FUNCTION(glCompressedTextureSubImage3D)
+GL_PROFILER_FUNCTION(glCopyBufferSubData)
+GL_PROFILER_FUNCTION(glCopyImageSubData)
+GL_PROFILER_FUNCTION(glCopyNamedBufferSubData)
+GL_PROFILER_FUNCTION(glCopyPixels)
+GL_PROFILER_FUNCTION(glCopyTexImage1D)
+GL_PROFILER_FUNCTION(glCopyTexImage2D)
+GL_PROFILER_FUNCTION(glCopyTexSubImage1D)
+GL_PROFILER_FUNCTION(glCopyTexSubImage2D)
+GL_PROFILER_FUNCTION(glCopyTexSubImage3D)
+GL_PROFILER_FUNCTION(glCopyTextureSubImage1D)
+GL_PROFILER_FUNCTION(glCopyTextureSubImage2D)
+GL_PROFILER_FUNCTION(glCopyTextureSubImage3D)
+GL_PROFILER_FUNCTION(glCreateBuffers)
+GL_PROFILER_FUNCTION(glCreateFramebuffers)
+GL_PROFILER_FUNCTION(glCreateProgram)
+GL_PROFILER_FUNCTION(glCreateProgramPipelines)
+GL_PROFILER_FUNCTION(glCreateQueries)
+GL_PROFILER_FUNCTION(glCreateRenderbuffers)
+GL_PROFILER_FUNCTION(glCreateSamplers)
+GL_PROFILER_FUNCTION(glCreateShader)
+GL_PROFILER_FUNCTION(glCreateShaderProgramv)
+GL_PROFILER_FUNCTION(glCreateTextures)
+GL_PROFILER_FUNCTION(glCreateTransformFeedbacks)
+GL_PROFILER_FUNCTION(glCreateVertexArrays)
+GL_PROFILER_FUNCTION(glCullFace)
+GL_PROFILER_FUNCTION(glDebugMessageCallback)
+GL_PROFILER_FUNCTION(glDebugMessageControl)
+GL_PROFILER_FUNCTION(glDebugMessageInsert)
+GL_PROFILER_FUNCTION(glDeleteBuffers)
+GL_PROFILER_FUNCTION(glDeleteFramebuffers)
+GL_PROFILER_FUNCTION(glDeleteLists)
+GL_PROFILER_FUNCTION(glDeleteProgram)
+GL_PROFILER_FUNCTION(glDeleteProgramPipelines)
+GL_PROFILER_FUNCTION(glDeleteQueries)
+GL_PROFILER_FUNCTION(glDeleteRenderbuffers)
+GL_PROFILER_FUNCTION(glDeleteSamplers)
+GL_PROFILER_FUNCTION(glDeleteShader)
+GL_PROFILER_FUNCTION(glDeleteSync)
+GL_PROFILER_FUNCTION(glDeleteTextures)
+GL_PROFILER_FUNCTION(glDeleteTransformFeedbacks)
+GL_PROFILER_FUNCTION(glDeleteVertexArrays)
+GL_PROFILER_FUNCTION(glDepthFunc)
+GL_PROFILER_FUNCTION(glDepthMask)
+GL_PROFILER_FUNCTION(glDepthRange)
+GL_PROFILER_FUNCTION(glDepthRangeArrayv)
+GL_PROFILER_FUNCTION(glDepthRangeIndexed)
+GL_PROFILER_FUNCTION(glDepthRangef)
+GL_PROFILER_FUNCTION(glDetachShader)
+GL_PROFILER_FUNCTION(glDisable)
+GL_PROFILER_FUNCTION(glDisableClientState)
+GL_PROFILER_FUNCTION(glDisableVertexArrayAttrib)
+GL_PROFILER_FUNCTION(glDisableVertexAttribArray)
+GL_PROFILER_FUNCTION(glDisablei)
+GL_PROFILER_FUNCTION(glDispatchCompute)
+GL_PROFILER_FUNCTION(glDispatchComputeIndirect)
+GL_PROFILER_FUNCTION(glDrawArrays)
+GL_PROFILER_FUNCTION(glDrawArraysIndirect)
+GL_PROFILER_FUNCTION(glDrawArraysInstanced)
+GL_PROFILER_FUNCTION(glDrawArraysInstancedBaseInstance)
+GL_PROFILER_FUNCTION(glDrawBuffer)
+GL_PROFILER_FUNCTION(glDrawBuffers)
+GL_PROFILER_FUNCTION(glDrawElements)
+GL_PROFILER_FUNCTION(glDrawElementsBaseVertex)
+GL_PROFILER_FUNCTION(glDrawElementsIndirect)
+GL_PROFILER_FUNCTION(glDrawElementsInstanced)
+GL_PROFILER_FUNCTION(glDrawElementsInstancedBaseInstance)
+GL_PROFILER_FUNCTION(glDrawElementsInstancedBaseVertex)
+GL_PROFILER_FUNCTION(glDrawElementsInstancedBaseVertexBaseInstance)
+GL_PROFILER_FUNCTION(glDrawPixels)
+GL_PROFILER_FUNCTION(glDrawRangeElements)
+GL_PROFILER_FUNCTION(glDrawRangeElementsBaseVertex)
+GL_PROFILER_FUNCTION(glDrawTransformFeedback)
+GL_PROFILER_FUNCTION(glDrawTransformFeedbackInstanced)
+GL_PROFILER_FUNCTION(glDrawTransformFeedbackStream)
+GL_PROFILER_FUNCTION(glDrawTransformFeedbackStreamInstanced)
+GL_PROFILER_FUNCTION(glEdgeFlag)
+GL_PROFILER_FUNCTION(glEdgeFlagPointer)
+GL_PROFILER_FUNCTION(glEdgeFlagv)
+GL_PROFILER_FUNCTION(glEnable)
+GL_PROFILER_FUNCTION(glEnableClientState)
+GL_PROFILER_FUNCTION(glEnableVertexArrayAttrib)
+GL_PROFILER_FUNCTION(glEnableVertexAttribArray)
+GL_PROFILER_FUNCTION(glEnablei)
+GL_PROFILER_FUNCTION(glEnd)
+GL_PROFILER_FUNCTION(glEndConditionalRender)
+GL_PROFILER_FUNCTION(glEndList)
+GL_PROFILER_FUNCTION(glEndQuery)
+GL_PROFILER_FUNCTION(glEndQueryIndexed)
+GL_PROFILER_FUNCTION(glEndTransformFeedback)
+GL_PROFILER_FUNCTION(glEvalCoord1d)
+GL_PROFILER_FUNCTION(glEvalCoord1dv)
+GL_PROFILER_FUNCTION(glEvalCoord1f)
+GL_PROFILER_FUNCTION(glEvalCoord1fv)
+GL_PROFILER_FUNCTION(glEvalCoord2d)
+GL_PROFILER_FUNCTION(glEvalCoord2dv)
+GL_PROFILER_FUNCTION(glEvalCoord2f)
+GL_PROFILER_FUNCTION(glEvalCoord2fv)
+GL_PROFILER_FUNCTION(glEvalMesh1)
+GL_PROFILER_FUNCTION(glEvalMesh2)
+GL_PROFILER_FUNCTION(glEvalPoint1)
+GL_PROFILER_FUNCTION(glEvalPoint2)
+GL_PROFILER_FUNCTION(glFeedbackBuffer)
+GL_PROFILER_FUNCTION(glFenceSync)
+GL_PROFILER_FUNCTION(glFinish)
+GL_PROFILER_FUNCTION(glFlush)
+GL_PROFILER_FUNCTION(glFlushMappedBufferRange)
+GL_PROFILER_FUNCTION(glFlushMappedNamedBufferRange)
+GL_PROFILER_FUNCTION(glFogCoordPointer)
+GL_PROFILER_FUNCTION(glFogCoordd)
+GL_PROFILER_FUNCTION(glFogCoorddv)
+GL_PROFILER_FUNCTION(glFogCoordf)
+GL_PROFILER_FUNCTION(glFogCoordfv)
+GL_PROFILER_FUNCTION(glFogf)
+GL_PROFILER_FUNCTION(glFogfv)
+GL_PROFILER_FUNCTION(glFogi)
+GL_PROFILER_FUNCTION(glFogiv)
+GL_PROFILER_FUNCTION(glFramebufferParameteri)
+GL_PROFILER_FUNCTION(glFramebufferRenderbuffer)
+GL_PROFILER_FUNCTION(glFramebufferTexture)
+GL_PROFILER_FUNCTION(glFramebufferTexture1D)
+GL_PROFILER_FUNCTION(glFramebufferTexture2D)
+GL_PROFILER_FUNCTION(glFramebufferTexture3D)
+GL_PROFILER_FUNCTION(glFramebufferTextureLayer)
+GL_PROFILER_FUNCTION(glFrontFace)
+GL_PROFILER_FUNCTION(glFrustum)
+GL_PROFILER_FUNCTION(glGenBuffers)
+GL_PROFILER_FUNCTION(glGenFramebuffers)
+GL_PROFILER_FUNCTION(glGenLists)
+GL_PROFILER_FUNCTION(glGenProgramPipelines)
+GL_PROFILER_FUNCTION(glGenQueries)
+GL_PROFILER_FUNCTION(glGenRenderbuffers)
+GL_PROFILER_FUNCTION(glGenSamplers)
+GL_PROFILER_FUNCTION(glGenTextures)
+GL_PROFILER_FUNCTION(glGenTransformFeedbacks)
+GL_PROFILER_FUNCTION(glGenVertexArrays)
+GL_PROFILER_FUNCTION(glGenerateMipmap)
+GL_PROFILER_FUNCTION(glGenerateTextureMipmap)
+GL_PROFILER_FUNCTION(glGetActiveAtomicCounterBufferiv)
+GL_PROFILER_FUNCTION(glGetActiveAttrib)
+GL_PROFILER_FUNCTION(glGetActiveSubroutineName)
+GL_PROFILER_FUNCTION(glGetActiveSubroutineUniformName)
+GL_PROFILER_FUNCTION(glGetActiveSubroutineUniformiv)
+GL_PROFILER_FUNCTION(glGetActiveUniform)
+GL_PROFILER_FUNCTION(glGetActiveUniformBlockName)
+GL_PROFILER_FUNCTION(glGetActiveUniformBlockiv)
+GL_PROFILER_FUNCTION(glGetActiveUniformName)
+GL_PROFILER_FUNCTION(glGetActiveUniformsiv)
+GL_PROFILER_FUNCTION(glGetAttachedShaders)
+GL_PROFILER_FUNCTION(glGetAttribLocation)
+GL_PROFILER_FUNCTION(glGetBooleani_v)
+GL_PROFILER_FUNCTION(glGetBooleanv)
+GL_PROFILER_FUNCTION(glGetBufferParameteri64v)
+GL_PROFILER_FUNCTION(glGetBufferParameteriv)
+GL_PROFILER_FUNCTION(glGetBufferPointerv)
+GL_PROFILER_FUNCTION(glGetBufferSubData)
+GL_PROFILER_FUNCTION(glGetClipPlane)
+GL_PROFILER_FUNCTION(glGetCompressedTexImage)
+GL_PROFILER_FUNCTION(glGetCompressedTextureImage)
+GL_PROFILER_FUNCTION(glGetCompressedTextureSubImage)
+GL_PROFILER_FUNCTION(glGetDebugMessageLog)
+GL_PROFILER_FUNCTION(glGetDoublei_v)
+GL_PROFILER_FUNCTION(glGetDoublev)
+GL_PROFILER_FUNCTION(glGetError)
+GL_PROFILER_FUNCTION(glGetFloati_v)
+GL_PROFILER_FUNCTION(glGetFloatv)
+GL_PROFILER_FUNCTION(glGetFragDataIndex)
+GL_PROFILER_FUNCTION(glGetFragDataLocation)
+GL_PROFILER_FUNCTION(glGetFramebufferAttachmentParameteriv)
+GL_PROFILER_FUNCTION(glGetFramebufferParameteriv)
+GL_PROFILER_FUNCTION(glGetGraphicsResetStatus)
+GL_PROFILER_FUNCTION(glGetInteger64i_v)
+GL_PROFILER_FUNCTION(glGetInteger64v)
+GL_PROFILER_FUNCTION(glGetIntegeri_v)
+GL_PROFILER_FUNCTION(glGetIntegerv)
+GL_PROFILER_FUNCTION(glGetInternalformati64v)
+GL_PROFILER_FUNCTION(glGetInternalformativ)
+GL_PROFILER_FUNCTION(glGetLightfv)
+GL_PROFILER_FUNCTION(glGetLightiv)
+GL_PROFILER_FUNCTION(glGetMapdv)
+GL_PROFILER_FUNCTION(glGetMapfv)
+GL_PROFILER_FUNCTION(glGetMapiv)
+GL_PROFILER_FUNCTION(glGetMaterialfv)
+GL_PROFILER_FUNCTION(glGetMaterialiv)
+GL_PROFILER_FUNCTION(glGetMultisamplefv)
+GL_PROFILER_FUNCTION(glGetNamedBufferParameteri64v)
+GL_PROFILER_FUNCTION(glGetNamedBufferParameteriv)
+GL_PROFILER_FUNCTION(glGetNamedBufferPointerv)
+GL_PROFILER_FUNCTION(glGetNamedBufferSubData)
+GL_PROFILER_FUNCTION(glGetNamedFramebufferAttachmentParameteriv)
+GL_PROFILER_FUNCTION(glGetNamedFramebufferParameteriv)
+GL_PROFILER_FUNCTION(glGetNamedRenderbufferParameteriv)
+GL_PROFILER_FUNCTION(glGetObjectLabel)
+GL_PROFILER_FUNCTION(glGetObjectPtrLabel)
+GL_PROFILER_FUNCTION(glGetPixelMapfv)
+GL_PROFILER_FUNCTION(glGetPixelMapuiv)
+GL_PROFILER_FUNCTION(glGetPixelMapusv)
+GL_PROFILER_FUNCTION(glGetPointerv)
+GL_PROFILER_FUNCTION(glGetPolygonStipple)
+GL_PROFILER_FUNCTION(glGetProgramBinary)
+GL_PROFILER_FUNCTION(glGetProgramInfoLog)
+GL_PROFILER_FUNCTION(glGetProgramInterfaceiv)
+GL_PROFILER_FUNCTION(glGetProgramPipelineInfoLog)
+GL_PROFILER_FUNCTION(glGetProgramPipelineiv)
+GL_PROFILER_FUNCTION(glGetProgramResourceIndex)
+GL_PROFILER_FUNCTION(glGetProgramResourceLocation)
+GL_PROFILER_FUNCTION(glGetProgramResourceLocationIndex)
+GL_PROFILER_FUNCTION(glGetProgramResourceName)
+GL_PROFILER_FUNCTION(glGetProgramResourceiv)
+GL_PROFILER_FUNCTION(glGetProgramStageiv)
+GL_PROFILER_FUNCTION(glGetProgramiv)
+GL_PROFILER_FUNCTION(glGetQueryBufferObjecti64v)
+GL_PROFILER_FUNCTION(glGetQueryBufferObjectiv)
+GL_PROFILER_FUNCTION(glGetQueryBufferObjectui64v)
+GL_PROFILER_FUNCTION(glGetQueryBufferObjectuiv)
+GL_PROFILER_FUNCTION(glGetQueryIndexediv)
+GL_PROFILER_FUNCTION(glGetQueryObjecti64v)
+GL_PROFILER_FUNCTION(glGetQueryObjectiv)
+GL_PROFILER_FUNCTION(glGetQueryObjectui64v)
+GL_PROFILER_FUNCTION(glGetQueryObjectuiv)
+GL_PROFILER_FUNCTION(glGetQueryiv)
+GL_PROFILER_FUNCTION(glGetRenderbufferParameteriv)
+GL_PROFILER_FUNCTION(glGetSamplerParameterIiv)
+GL_PROFILER_FUNCTION(glGetSamplerParameterIuiv)
+GL_PROFILER_FUNCTION(glGetSamplerParameterfv)
+GL_PROFILER_FUNCTION(glGetSamplerParameteriv)
+GL_PROFILER_FUNCTION(glGetShaderInfoLog)
+GL_PROFILER_FUNCTION(glGetShaderPrecisionFormat)
+GL_PROFILER_FUNCTION(glGetShaderSource)
+GL_PROFILER_FUNCTION(glGetShaderiv)
+GL_PROFILER_FUNCTION(glGetString)
+GL_PROFILER_FUNCTION(glGetStringi)
+GL_PROFILER_FUNCTION(glGetSubroutineIndex)
+GL_PROFILER_FUNCTION(glGetSubroutineUniformLocation)
+GL_PROFILER_FUNCTION(glGetSynciv)
+GL_PROFILER_FUNCTION(glGetTexEnvfv)
+GL_PROFILER_FUNCTION(glGetTexEnviv)
+GL_PROFILER_FUNCTION(glGetTexGendv)
+GL_PROFILER_FUNCTION(glGetTexGenfv)
+GL_PROFILER_FUNCTION(glGetTexGeniv)
+GL_PROFILER_FUNCTION(glGetTexImage)
+GL_PROFILER_FUNCTION(glGetTexLevelParameterfv)
+GL_PROFILER_FUNCTION(glGetTexLevelParameteriv)
+GL_PROFILER_FUNCTION(glGetTexParameterIiv)
+GL_PROFILER_FUNCTION(glGetTexParameterIuiv)
+GL_PROFILER_FUNCTION(glGetTexParameterfv)
+GL_PROFILER_FUNCTION(glGetTexParameteriv)
+GL_PROFILER_FUNCTION(glGetTextureImage)
+GL_PROFILER_FUNCTION(glGetTextureLevelParameterfv)
+GL_PROFILER_FUNCTION(glGetTextureLevelParameteriv)
+GL_PROFILER_FUNCTION(glGetTextureParameterIiv)
+GL_PROFILER_FUNCTION(glGetTextureParameterIuiv)
+GL_PROFILER_FUNCTION(glGetTextureParameterfv)
+GL_PROFILER_FUNCTION(glGetTextureParameteriv)
+GL_PROFILER_FUNCTION(glGetTextureSubImage)
+GL_PROFILER_FUNCTION(glGetTransformFeedbackVarying)
+GL_PROFILER_FUNCTION(glGetTransformFeedbacki64_v)
+GL_PROFILER_FUNCTION(glGetTransformFeedbacki_v)
+GL_PROFILER_FUNCTION(glGetTransformFeedbackiv)
+GL_PROFILER_FUNCTION(glGetUniformBlockIndex)
+GL_PROFILER_FUNCTION(glGetUniformIndices)
+GL_PROFILER_FUNCTION(glGetUniformLocation)
+GL_PROFILER_FUNCTION(glGetUniformSubroutineuiv)
+GL_PROFILER_FUNCTION(glGetUniformdv)
+GL_PROFILER_FUNCTION(glGetUniformfv)
+GL_PROFILER_FUNCTION(glGetUniformiv)
+GL_PROFILER_FUNCTION(glGetUniformuiv)
+GL_PROFILER_FUNCTION(glGetVertexArrayIndexed64iv)
+GL_PROFILER_FUNCTION(glGetVertexArrayIndexediv)
+GL_PROFILER_FUNCTION(glGetVertexArrayiv)
+GL_PROFILER_FUNCTION(glGetVertexAttribIiv)
+GL_PROFILER_FUNCTION(glGetVertexAttribIuiv)
+GL_PROFILER_FUNCTION(glGetVertexAttribLdv)
+GL_PROFILER_FUNCTION(glGetVertexAttribPointerv)
+GL_PROFILER_FUNCTION(glGetVertexAttribdv)
+GL_PROFILER_FUNCTION(glGetVertexAttribfv)
+GL_PROFILER_FUNCTION(glGetVertexAttribiv)
+GL_PROFILER_FUNCTION(glGetnColorTable)
+GL_PROFILER_FUNCTION(glGetnCompressedTexImage)
+GL_PROFILER_FUNCTION(glGetnConvolutionFilter)
+GL_PROFILER_FUNCTION(glGetnHistogram)
+GL_PROFILER_FUNCTION(glGetnMapdv)
+GL_PROFILER_FUNCTION(glGetnMapfv)
+GL_PROFILER_FUNCTION(glGetnMapiv)
+GL_PROFILER_FUNCTION(glGetnMinmax)
+GL_PROFILER_FUNCTION(glGetnPixelMapfv)
+GL_PROFILER_FUNCTION(glGetnPixelMapuiv)
+GL_PROFILER_FUNCTION(glGetnPixelMapusv)
+GL_PROFILER_FUNCTION(glGetnPolygonStipple)
+GL_PROFILER_FUNCTION(glGetnSeparableFilter)
+GL_PROFILER_FUNCTION(glGetnTexImage)
+GL_PROFILER_FUNCTION(glGetnUniformdv)
+GL_PROFILER_FUNCTION(glGetnUniformfv)
+GL_PROFILER_FUNCTION(glGetnUniformiv)
+GL_PROFILER_FUNCTION(glGetnUniformuiv)
+GL_PROFILER_FUNCTION(glHint)
+GL_PROFILER_FUNCTION(glIndexMask)
+GL_PROFILER_FUNCTION(glIndexPointer)
+GL_PROFILER_FUNCTION(glIndexd)
+GL_PROFILER_FUNCTION(glIndexdv)
+GL_PROFILER_FUNCTION(glIndexf)
+GL_PROFILER_FUNCTION(glIndexfv)
+GL_PROFILER_FUNCTION(glIndexi)
+GL_PROFILER_FUNCTION(glIndexiv)
+GL_PROFILER_FUNCTION(glIndexs)
+GL_PROFILER_FUNCTION(glIndexsv)
+GL_PROFILER_FUNCTION(glIndexub)
+GL_PROFILER_FUNCTION(glIndexubv)
+GL_PROFILER_FUNCTION(glInitNames)
+GL_PROFILER_FUNCTION(glInterleavedArrays)
+GL_PROFILER_FUNCTION(glInvalidateBufferData)
+GL_PROFILER_FUNCTION(glInvalidateBufferSubData)
+GL_PROFILER_FUNCTION(glInvalidateFramebuffer)
+GL_PROFILER_FUNCTION(glInvalidateNamedFramebufferData)
+GL_PROFILER_FUNCTION(glInvalidateNamedFramebufferSubData)
+GL_PROFILER_FUNCTION(glInvalidateSubFramebuffer)
+GL_PROFILER_FUNCTION(glInvalidateTexImage)
+GL_PROFILER_FUNCTION(glInvalidateTexSubImage)
+GL_PROFILER_FUNCTION(glIsBuffer)
+GL_PROFILER_FUNCTION(glIsEnabled)
+GL_PROFILER_FUNCTION(glIsEnabledi)
+GL_PROFILER_FUNCTION(glIsFramebuffer)
+GL_PROFILER_FUNCTION(glIsList)
+GL_PROFILER_FUNCTION(glIsProgram)
+GL_PROFILER_FUNCTION(glIsProgramPipeline)
+GL_PROFILER_FUNCTION(glIsQuery)
+GL_PROFILER_FUNCTION(glIsRenderbuffer)
+GL_PROFILER_FUNCTION(glIsSampler)
+GL_PROFILER_FUNCTION(glIsShader)
+GL_PROFILER_FUNCTION(glIsSync)
+GL_PROFILER_FUNCTION(glIsTexture)
+GL_PROFILER_FUNCTION(glIsTransformFeedback)
+GL_PROFILER_FUNCTION(glIsVertexArray)
+GL_PROFILER_FUNCTION(glLightModelf)
+GL_PROFILER_FUNCTION(glLightModelfv)
+GL_PROFILER_FUNCTION(glLightModeli)
+GL_PROFILER_FUNCTION(glLightModeliv)
+GL_PROFILER_FUNCTION(glLightf)
+GL_PROFILER_FUNCTION(glLightfv)
+GL_PROFILER_FUNCTION(glLighti)
+GL_PROFILER_FUNCTION(glLightiv)
+GL_PROFILER_FUNCTION(glLineStipple)
+GL_PROFILER_FUNCTION(glLineWidth)
+GL_PROFILER_FUNCTION(glLinkProgram)
+GL_PROFILER_FUNCTION(glListBase)
+GL_PROFILER_FUNCTION(glLoadIdentity)
+GL_PROFILER_FUNCTION(glLoadMatrixd)
+GL_PROFILER_FUNCTION(glLoadMatrixf)
+GL_PROFILER_FUNCTION(glLoadName)
+GL_PROFILER_FUNCTION(glLoadTransposeMatrixd)
+GL_PROFILER_FUNCTION(glLoadTransposeMatrixf)
+GL_PROFILER_FUNCTION(glLogicOp)
+GL_PROFILER_FUNCTION(glMap1d)
+GL_PROFILER_FUNCTION(glMap1f)
+GL_PROFILER_FUNCTION(glMap2d)
+GL_PROFILER_FUNCTION(glMap2f)
+GL_PROFILER_FUNCTION(glMapBuffer)
+GL_PROFILER_FUNCTION(glMapBufferRange)
+GL_PROFILER_FUNCTION(glMapGrid1d)
+GL_PROFILER_FUNCTION(glMapGrid1f)
+GL_PROFILER_FUNCTION(glMapGrid2d)
+GL_PROFILER_FUNCTION(glMapGrid2f)
+GL_PROFILER_FUNCTION(glMapNamedBuffer)
+GL_PROFILER_FUNCTION(glMapNamedBufferRange)
+GL_PROFILER_FUNCTION(glMaterialf)
+GL_PROFILER_FUNCTION(glMaterialfv)
+GL_PROFILER_FUNCTION(glMateriali)
+GL_PROFILER_FUNCTION(glMaterialiv)
+GL_PROFILER_FUNCTION(glMatrixMode)
+GL_PROFILER_FUNCTION(glMemoryBarrier)
+GL_PROFILER_FUNCTION(glMemoryBarrierByRegion)
+GL_PROFILER_FUNCTION(glMinSampleShading)
+GL_PROFILER_FUNCTION(glMultMatrixd)
+GL_PROFILER_FUNCTION(glMultMatrixf)
+GL_PROFILER_FUNCTION(glMultTransposeMatrixd)
+GL_PROFILER_FUNCTION(glMultTransposeMatrixf)
+GL_PROFILER_FUNCTION(glMultiDrawArrays)
+GL_PROFILER_FUNCTION(glMultiDrawArraysIndirect)
+GL_PROFILER_FUNCTION(glMultiDrawArraysIndirectCount)
+GL_PROFILER_FUNCTION(glMultiDrawElements)
+GL_PROFILER_FUNCTION(glMultiDrawElementsBaseVertex)
+GL_PROFILER_FUNCTION(glMultiDrawElementsIndirect)
+GL_PROFILER_FUNCTION(glMultiDrawElementsIndirectCount)
+GL_PROFILER_FUNCTION(glMultiTexCoord1d)
+GL_PROFILER_FUNCTION(glMultiTexCoord1dv)
+GL_PROFILER_FUNCTION(glMultiTexCoord1f)
+GL_PROFILER_FUNCTION(glMultiTexCoord1fv)
+GL_PROFILER_FUNCTION(glMultiTexCoord1i)
+GL_PROFILER_FUNCTION(glMultiTexCoord1iv)
+GL_PROFILER_FUNCTION(glMultiTexCoord1s)
+GL_PROFILER_FUNCTION(glMultiTexCoord1sv)
+GL_PROFILER_FUNCTION(glMultiTexCoord2d)
+GL_PROFILER_FUNCTION(glMultiTexCoord2dv)
+GL_PROFILER_FUNCTION(glMultiTexCoord2f)
+GL_PROFILER_FUNCTION(glMultiTexCoord2fv)
+GL_PROFILER_FUNCTION(glMultiTexCoord2i)
+GL_PROFILER_FUNCTION(glMultiTexCoord2iv)
+GL_PROFILER_FUNCTION(glMultiTexCoord2s)
+GL_PROFILER_FUNCTION(glMultiTexCoord2sv)
+GL_PROFILER_FUNCTION(glMultiTexCoord3d)
+GL_PROFILER_FUNCTION(glMultiTexCoord3dv)
+GL_PROFILER_FUNCTION(glMultiTexCoord3f)
+GL_PROFILER_FUNCTION(glMultiTexCoord3fv)
+GL_PROFILER_FUNCTION(glMultiTexCoord3i)
+GL_PROFILER_FUNCTION(glMultiTexCoord3iv)
+GL_PROFILER_FUNCTION(glMultiTexCoord3s)
+GL_PROFILER_FUNCTION(glMultiTexCoord3sv)
+GL_PROFILER_FUNCTION(glMultiTexCoord4d)
+GL_PROFILER_FUNCTION(glMultiTexCoord4dv)
+GL_PROFILER_FUNCTION(glMultiTexCoord4f)
+GL_PROFILER_FUNCTION(glMultiTexCoord4fv)
+GL_PROFILER_FUNCTION(glMultiTexCoord4i)
+GL_PROFILER_FUNCTION(glMultiTexCoord4iv)
+GL_PROFILER_FUNCTION(glMultiTexCoord4s)
+GL_PROFILER_FUNCTION(glMultiTexCoord4sv)
+GL_PROFILER_FUNCTION(glMultiTexCoordP1ui)
+GL_PROFILER_FUNCTION(glMultiTexCoordP1uiv)
+GL_PROFILER_FUNCTION(glMultiTexCoordP2ui)
+GL_PROFILER_FUNCTION(glMultiTexCoordP2uiv)
+GL_PROFILER_FUNCTION(glMultiTexCoordP3ui)
+GL_PROFILER_FUNCTION(glMultiTexCoordP3uiv)
+GL_PROFILER_FUNCTION(glMultiTexCoordP4ui)
+GL_PROFILER_FUNCTION(glMultiTexCoordP4uiv)
+GL_PROFILER_FUNCTION(glNamedBufferData)
+GL_PROFILER_FUNCTION(glNamedBufferStorage)
+GL_PROFILER_FUNCTION(glNamedBufferSubData)
+GL_PROFILER_FUNCTION(glNamedFramebufferDrawBuffer)
+GL_PROFILER_FUNCTION(glNamedFramebufferDrawBuffers)
+GL_PROFILER_FUNCTION(glNamedFramebufferParameteri)
+GL_PROFILER_FUNCTION(glNamedFramebufferReadBuffer)
+GL_PROFILER_FUNCTION(glNamedFramebufferRenderbuffer)
+GL_PROFILER_FUNCTION(glNamedFramebufferTexture)
+GL_PROFILER_FUNCTION(glNamedFramebufferTextureLayer)
+GL_PROFILER_FUNCTION(glNamedRenderbufferStorage)
+GL_PROFILER_FUNCTION(glNamedRenderbufferStorageMultisample)
+GL_PROFILER_FUNCTION(glNewList)
+GL_PROFILER_FUNCTION(glNormal3b)
+GL_PROFILER_FUNCTION(glNormal3bv)
+GL_PROFILER_FUNCTION(glNormal3d)
+GL_PROFILER_FUNCTION(glNormal3dv)
+GL_PROFILER_FUNCTION(glNormal3f)
+GL_PROFILER_FUNCTION(glNormal3fv)
+GL_PROFILER_FUNCTION(glNormal3i)
+GL_PROFILER_FUNCTION(glNormal3iv)
+GL_PROFILER_FUNCTION(glNormal3s)
+GL_PROFILER_FUNCTION(glNormal3sv)
+GL_PROFILER_FUNCTION(glNormalP3ui)
+GL_PROFILER_FUNCTION(glNormalP3uiv)
+GL_PROFILER_FUNCTION(glNormalPointer)
+GL_PROFILER_FUNCTION(glObjectLabel)
+GL_PROFILER_FUNCTION(glObjectPtrLabel)
+GL_PROFILER_FUNCTION(glOrtho)
+GL_PROFILER_FUNCTION(glPassThrough)
+GL_PROFILER_FUNCTION(glPatchParameterfv)
+GL_PROFILER_FUNCTION(glPatchParameteri)
+GL_PROFILER_FUNCTION(glPauseTransformFeedback)
+GL_PROFILER_FUNCTION(glPixelMapfv)
+GL_PROFILER_FUNCTION(glPixelMapuiv)
+GL_PROFILER_FUNCTION(glPixelMapusv)
+GL_PROFILER_FUNCTION(glPixelStoref)
+GL_PROFILER_FUNCTION(glPixelStorei)
+GL_PROFILER_FUNCTION(glPixelTransferf)
+GL_PROFILER_FUNCTION(glPixelTransferi)
+GL_PROFILER_FUNCTION(glPixelZoom)
+GL_PROFILER_FUNCTION(glPointParameterf)
+GL_PROFILER_FUNCTION(glPointParameterfv)
+GL_PROFILER_FUNCTION(glPointParameteri)
+GL_PROFILER_FUNCTION(glPointParameteriv)
+GL_PROFILER_FUNCTION(glPointSize)
+GL_PROFILER_FUNCTION(glPolygonMode)
+GL_PROFILER_FUNCTION(glPolygonOffset)
+GL_PROFILER_FUNCTION(glPolygonOffsetClamp)
+GL_PROFILER_FUNCTION(glPolygonStipple)
+GL_PROFILER_FUNCTION(glPopAttrib)
+GL_PROFILER_FUNCTION(glPopClientAttrib)
+GL_PROFILER_FUNCTION(glPopDebugGroup)
+GL_PROFILER_FUNCTION(glPopMatrix)
+GL_PROFILER_FUNCTION(glPopName)
+GL_PROFILER_FUNCTION(glPrimitiveRestartIndex)
+GL_PROFILER_FUNCTION(glPrioritizeTextures)
+GL_PROFILER_FUNCTION(glProgramBinary)
+GL_PROFILER_FUNCTION(glProgramParameteri)
+GL_PROFILER_FUNCTION(glProgramUniform1d)
+GL_PROFILER_FUNCTION(glProgramUniform1dv)
+GL_PROFILER_FUNCTION(glProgramUniform1f)
+GL_PROFILER_FUNCTION(glProgramUniform1fv)
+GL_PROFILER_FUNCTION(glProgramUniform1i)
+GL_PROFILER_FUNCTION(glProgramUniform1iv)
+GL_PROFILER_FUNCTION(glProgramUniform1ui)
+GL_PROFILER_FUNCTION(glProgramUniform1uiv)
+GL_PROFILER_FUNCTION(glProgramUniform2d)
+GL_PROFILER_FUNCTION(glProgramUniform2dv)
+GL_PROFILER_FUNCTION(glProgramUniform2f)
+GL_PROFILER_FUNCTION(glProgramUniform2fv)
+GL_PROFILER_FUNCTION(glProgramUniform2i)
+GL_PROFILER_FUNCTION(glProgramUniform2iv)
+GL_PROFILER_FUNCTION(glProgramUniform2ui)
+GL_PROFILER_FUNCTION(glProgramUniform2uiv)
+GL_PROFILER_FUNCTION(glProgramUniform3d)
+GL_PROFILER_FUNCTION(glProgramUniform3dv)
+GL_PROFILER_FUNCTION(glProgramUniform3f)
+GL_PROFILER_FUNCTION(glProgramUniform3fv)
+GL_PROFILER_FUNCTION(glProgramUniform3i)
+GL_PROFILER_FUNCTION(glProgramUniform3iv)
+GL_PROFILER_FUNCTION(glProgramUniform3ui)
+GL_PROFILER_FUNCTION(glProgramUniform3uiv)
+GL_PROFILER_FUNCTION(glProgramUniform4d)
+GL_PROFILER_FUNCTION(glProgramUniform4dv)
+GL_PROFILER_FUNCTION(glProgramUniform4f)
+GL_PROFILER_FUNCTION(glProgramUniform4fv)
+GL_PROFILER_FUNCTION(glProgramUniform4i)
+GL_PROFILER_FUNCTION(glProgramUniform4iv)
+GL_PROFILER_FUNCTION(glProgramUniform4ui)
+GL_PROFILER_FUNCTION(glProgramUniform4uiv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix2dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix2fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix2x3dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix2x3fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix2x4dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix2x4fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix3dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix3fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix3x2dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix3x2fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix3x4dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix3x4fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix4dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix4fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix4x2dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix4x2fv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix4x3dv)
+GL_PROFILER_FUNCTION(glProgramUniformMatrix4x3fv)
+GL_PROFILER_FUNCTION(glProvokingVertex)
+GL_PROFILER_FUNCTION(glPushAttrib)
+GL_PROFILER_FUNCTION(glPushClientAttrib)
+GL_PROFILER_FUNCTION(glPushDebugGroup)
+GL_PROFILER_FUNCTION(glPushMatrix)
+GL_PROFILER_FUNCTION(glPushName)
+GL_PROFILER_FUNCTION(glQueryCounter)
+GL_PROFILER_FUNCTION(glRasterPos2d)
+GL_PROFILER_FUNCTION(glRasterPos2dv)
+GL_PROFILER_FUNCTION(glRasterPos2f)
+GL_PROFILER_FUNCTION(glRasterPos2fv)
+GL_PROFILER_FUNCTION(glRasterPos2i)
+GL_PROFILER_FUNCTION(glRasterPos2iv)
+GL_PROFILER_FUNCTION(glRasterPos2s)
+GL_PROFILER_FUNCTION(glRasterPos2sv)
+GL_PROFILER_FUNCTION(glRasterPos3d)
+GL_PROFILER_FUNCTION(glRasterPos3dv)
+GL_PROFILER_FUNCTION(glRasterPos3f)
+GL_PROFILER_FUNCTION(glRasterPos3fv)
+GL_PROFILER_FUNCTION(glRasterPos3i)
+GL_PROFILER_FUNCTION(glRasterPos3iv)
+GL_PROFILER_FUNCTION(glRasterPos3s)
+GL_PROFILER_FUNCTION(glRasterPos3sv)
+GL_PROFILER_FUNCTION(glRasterPos4d)
+GL_PROFILER_FUNCTION(glRasterPos4dv)
+GL_PROFILER_FUNCTION(glRasterPos4f)
+GL_PROFILER_FUNCTION(glRasterPos4fv)
+GL_PROFILER_FUNCTION(glRasterPos4i)
+GL_PROFILER_FUNCTION(glRasterPos4iv)
+GL_PROFILER_FUNCTION(glRasterPos4s)
+GL_PROFILER_FUNCTION(glRasterPos4sv)
+GL_PROFILER_FUNCTION(glReadBuffer)
+GL_PROFILER_FUNCTION(glReadPixels)
+GL_PROFILER_FUNCTION(glReadnPixels)
+GL_PROFILER_FUNCTION(glRectd)
+GL_PROFILER_FUNCTION(glRectdv)
+GL_PROFILER_FUNCTION(glRectf)
+GL_PROFILER_FUNCTION(glRectfv)
+GL_PROFILER_FUNCTION(glRecti)
+GL_PROFILER_FUNCTION(glRectiv)
+GL_PROFILER_FUNCTION(glRects)
+GL_PROFILER_FUNCTION(glRectsv)
+GL_PROFILER_FUNCTION(glReleaseShaderCompiler)
+GL_PROFILER_FUNCTION(glRenderMode)
+GL_PROFILER_FUNCTION(glRenderbufferStorage)
+GL_PROFILER_FUNCTION(glRenderbufferStorageMultisample)
+GL_PROFILER_FUNCTION(glResumeTransformFeedback)
+GL_PROFILER_FUNCTION(glRotated)
+GL_PROFILER_FUNCTION(glRotatef)
+GL_PROFILER_FUNCTION(glSampleCoverage)
+GL_PROFILER_FUNCTION(glSampleMaski)
+GL_PROFILER_FUNCTION(glSamplerParameterIiv)
+GL_PROFILER_FUNCTION(glSamplerParameterIuiv)
+GL_PROFILER_FUNCTION(glSamplerParameterf)
+GL_PROFILER_FUNCTION(glSamplerParameterfv)
+GL_PROFILER_FUNCTION(glSamplerParameteri)
+GL_PROFILER_FUNCTION(glSamplerParameteriv)
+GL_PROFILER_FUNCTION(glScaled)
+GL_PROFILER_FUNCTION(glScalef)
+GL_PROFILER_FUNCTION(glScissor)
+GL_PROFILER_FUNCTION(glScissorArrayv)
+GL_PROFILER_FUNCTION(glScissorIndexed)
+GL_PROFILER_FUNCTION(glScissorIndexedv)
+GL_PROFILER_FUNCTION(glSecondaryColor3b)
+GL_PROFILER_FUNCTION(glSecondaryColor3bv)
+GL_PROFILER_FUNCTION(glSecondaryColor3d)
+GL_PROFILER_FUNCTION(glSecondaryColor3dv)
+GL_PROFILER_FUNCTION(glSecondaryColor3f)
+GL_PROFILER_FUNCTION(glSecondaryColor3fv)
+GL_PROFILER_FUNCTION(glSecondaryColor3i)
+GL_PROFILER_FUNCTION(glSecondaryColor3iv)
+GL_PROFILER_FUNCTION(glSecondaryColor3s)
+GL_PROFILER_FUNCTION(glSecondaryColor3sv)
+GL_PROFILER_FUNCTION(glSecondaryColor3ub)
+GL_PROFILER_FUNCTION(glSecondaryColor3ubv)
+GL_PROFILER_FUNCTION(glSecondaryColor3ui)
+GL_PROFILER_FUNCTION(glSecondaryColor3uiv)
+GL_PROFILER_FUNCTION(glSecondaryColor3us)
+GL_PROFILER_FUNCTION(glSecondaryColor3usv)
+GL_PROFILER_FUNCTION(glSecondaryColorP3ui)
+GL_PROFILER_FUNCTION(glSecondaryColorP3uiv)
+GL_PROFILER_FUNCTION(glSecondaryColorPointer)
+GL_PROFILER_FUNCTION(glSelectBuffer)
+GL_PROFILER_FUNCTION(glShadeModel)
+GL_PROFILER_FUNCTION(glShaderBinary)
+GL_PROFILER_FUNCTION(glShaderSource)
+GL_PROFILER_FUNCTION(glShaderStorageBlockBinding)
+GL_PROFILER_FUNCTION(glSpecializeShader)
+GL_PROFILER_FUNCTION(glStencilFunc)
+GL_PROFILER_FUNCTION(glStencilFuncSeparate)
+GL_PROFILER_FUNCTION(glStencilMask)
+GL_PROFILER_FUNCTION(glStencilMaskSeparate)
+GL_PROFILER_FUNCTION(glStencilOp)
+GL_PROFILER_FUNCTION(glStencilOpSeparate)
+GL_PROFILER_FUNCTION(glTexBuffer)
+GL_PROFILER_FUNCTION(glTexBufferRange)
+GL_PROFILER_FUNCTION(glTexCoord1d)
+GL_PROFILER_FUNCTION(glTexCoord1dv)
+GL_PROFILER_FUNCTION(glTexCoord1f)
+GL_PROFILER_FUNCTION(glTexCoord1fv)
+GL_PROFILER_FUNCTION(glTexCoord1i)
+GL_PROFILER_FUNCTION(glTexCoord1iv)
+GL_PROFILER_FUNCTION(glTexCoord1s)
+GL_PROFILER_FUNCTION(glTexCoord1sv)
+GL_PROFILER_FUNCTION(glTexCoord2d)
+GL_PROFILER_FUNCTION(glTexCoord2dv)
+GL_PROFILER_FUNCTION(glTexCoord2f)
+GL_PROFILER_FUNCTION(glTexCoord2fv)
+GL_PROFILER_FUNCTION(glTexCoord2i)
+GL_PROFILER_FUNCTION(glTexCoord2iv)
+GL_PROFILER_FUNCTION(glTexCoord2s)
+GL_PROFILER_FUNCTION(glTexCoord2sv)
+GL_PROFILER_FUNCTION(glTexCoord3d)
+GL_PROFILER_FUNCTION(glTexCoord3dv)
+GL_PROFILER_FUNCTION(glTexCoord3f)
+GL_PROFILER_FUNCTION(glTexCoord3fv)
+GL_PROFILER_FUNCTION(glTexCoord3i)
+GL_PROFILER_FUNCTION(glTexCoord3iv)
+GL_PROFILER_FUNCTION(glTexCoord3s)
+GL_PROFILER_FUNCTION(glTexCoord3sv)
+GL_PROFILER_FUNCTION(glTexCoord4d)
+GL_PROFILER_FUNCTION(glTexCoord4dv)
+GL_PROFILER_FUNCTION(glTexCoord4f)
+GL_PROFILER_FUNCTION(glTexCoord4fv)
+GL_PROFILER_FUNCTION(glTexCoord4i)
+GL_PROFILER_FUNCTION(glTexCoord4iv)
+GL_PROFILER_FUNCTION(glTexCoord4s)
+GL_PROFILER_FUNCTION(glTexCoord4sv)
+GL_PROFILER_FUNCTION(glTexCoordP1ui)
+GL_PROFILER_FUNCTION(glTexCoordP1uiv)
+GL_PROFILER_FUNCTION(glTexCoordP2ui)
+GL_PROFILER_FUNCTION(glTexCoordP2uiv)
+GL_PROFILER_FUNCTION(glTexCoordP3ui)
+GL_PROFILER_FUNCTION(glTexCoordP3uiv)
+GL_PROFILER_FUNCTION(glTexCoordP4ui)
+GL_PROFILER_FUNCTION(glTexCoordP4uiv)
+GL_PROFILER_FUNCTION(glTexCoordPointer)
+GL_PROFILER_FUNCTION(glTexEnvf)
+GL_PROFILER_FUNCTION(glTexEnvfv)
+GL_PROFILER_FUNCTION(glTexEnvi)
+GL_PROFILER_FUNCTION(glTexEnviv)
+GL_PROFILER_FUNCTION(glTexGend)
+GL_PROFILER_FUNCTION(glTexGendv)
+GL_PROFILER_FUNCTION(glTexGenf)
+GL_PROFILER_FUNCTION(glTexGenfv)
+GL_PROFILER_FUNCTION(glTexGeni)
+GL_PROFILER_FUNCTION(glTexGeniv)
+GL_PROFILER_FUNCTION(glTexImage1D)
+GL_PROFILER_FUNCTION(glTexImage2D)
+GL_PROFILER_FUNCTION(glTexImage2DMultisample)
+GL_PROFILER_FUNCTION(glTexImage3D)
+GL_PROFILER_FUNCTION(glTexImage3DMultisample)
+GL_PROFILER_FUNCTION(glTexParameterIiv)
+GL_PROFILER_FUNCTION(glTexParameterIuiv)
+GL_PROFILER_FUNCTION(glTexParameterf)
+GL_PROFILER_FUNCTION(glTexParameterfv)
+GL_PROFILER_FUNCTION(glTexParameteri)
+GL_PROFILER_FUNCTION(glTexParameteriv)
+GL_PROFILER_FUNCTION(glTexStorage1D)
+GL_PROFILER_FUNCTION(glTexStorage2D)
+GL_PROFILER_FUNCTION(glTexStorage2DMultisample)
+GL_PROFILER_FUNCTION(glTexStorage3D)
+GL_PROFILER_FUNCTION(glTexStorage3DMultisample)
+GL_PROFILER_FUNCTION(glTexSubImage1D)
+GL_PROFILER_FUNCTION(glTexSubImage2D)
+GL_PROFILER_FUNCTION(glTexSubImage3D)
+GL_PROFILER_FUNCTION(glTextureBarrier)
+GL_PROFILER_FUNCTION(glTextureBuffer)
+GL_PROFILER_FUNCTION(glTextureBufferRange)
+GL_PROFILER_FUNCTION(glTextureParameterIiv)
+GL_PROFILER_FUNCTION(glTextureParameterIuiv)
+GL_PROFILER_FUNCTION(glTextureParameterf)
+GL_PROFILER_FUNCTION(glTextureParameterfv)
+GL_PROFILER_FUNCTION(glTextureParameteri)
+GL_PROFILER_FUNCTION(glTextureParameteriv)
+GL_PROFILER_FUNCTION(glTextureStorage1D)
+GL_PROFILER_FUNCTION(glTextureStorage2D)
+GL_PROFILER_FUNCTION(glTextureStorage2DMultisample)
+GL_PROFILER_FUNCTION(glTextureStorage3D)
+GL_PROFILER_FUNCTION(glTextureStorage3DMultisample)
+GL_PROFILER_FUNCTION(glTextureSubImage1D)
+GL_PROFILER_FUNCTION(glTextureSubImage2D)
+GL_PROFILER_FUNCTION(glTextureSubImage3D)
+GL_PROFILER_FUNCTION(glTextureView)
+GL_PROFILER_FUNCTION(glTransformFeedbackBufferBase)
+GL_PROFILER_FUNCTION(glTransformFeedbackBufferRange)
+GL_PROFILER_FUNCTION(glTransformFeedbackVaryings)
+GL_PROFILER_FUNCTION(glTranslated)
+GL_PROFILER_FUNCTION(glTranslatef)
+GL_PROFILER_FUNCTION(glUniform1d)
+GL_PROFILER_FUNCTION(glUniform1dv)
+GL_PROFILER_FUNCTION(glUniform1f)
+GL_PROFILER_FUNCTION(glUniform1fv)
+GL_PROFILER_FUNCTION(glUniform1i)
+GL_PROFILER_FUNCTION(glUniform1iv)
+GL_PROFILER_FUNCTION(glUniform1ui)
+GL_PROFILER_FUNCTION(glUniform1uiv)
+GL_PROFILER_FUNCTION(glUniform2d)
+GL_PROFILER_FUNCTION(glUniform2dv)
+GL_PROFILER_FUNCTION(glUniform2f)
+GL_PROFILER_FUNCTION(glUniform2fv)
+GL_PROFILER_FUNCTION(glUniform2i)
+GL_PROFILER_FUNCTION(glUniform2iv)
+GL_PROFILER_FUNCTION(glUniform2ui)
+GL_PROFILER_FUNCTION(glUniform2uiv)
+GL_PROFILER_FUNCTION(glUniform3d)
+GL_PROFILER_FUNCTION(glUniform3dv)
+GL_PROFILER_FUNCTION(glUniform3f)
+GL_PROFILER_FUNCTION(glUniform3fv)
+GL_PROFILER_FUNCTION(glUniform3i)
+GL_PROFILER_FUNCTION(glUniform3iv)
+GL_PROFILER_FUNCTION(glUniform3ui)
+GL_PROFILER_FUNCTION(glUniform3uiv)
+GL_PROFILER_FUNCTION(glUniform4d)
+GL_PROFILER_FUNCTION(glUniform4dv)
+GL_PROFILER_FUNCTION(glUniform4f)
+GL_PROFILER_FUNCTION(glUniform4fv)
+GL_PROFILER_FUNCTION(glUniform4i)
+GL_PROFILER_FUNCTION(glUniform4iv)
+GL_PROFILER_FUNCTION(glUniform4ui)
+GL_PROFILER_FUNCTION(glUniform4uiv)
+GL_PROFILER_FUNCTION(glUniformBlockBinding)
+GL_PROFILER_FUNCTION(glUniformMatrix2dv)
+GL_PROFILER_FUNCTION(glUniformMatrix2fv)
+GL_PROFILER_FUNCTION(glUniformMatrix2x3dv)
+GL_PROFILER_FUNCTION(glUniformMatrix2x3fv)
+GL_PROFILER_FUNCTION(glUniformMatrix2x4dv)
+GL_PROFILER_FUNCTION(glUniformMatrix2x4fv)
+GL_PROFILER_FUNCTION(glUniformMatrix3dv)
+GL_PROFILER_FUNCTION(glUniformMatrix3fv)
+GL_PROFILER_FUNCTION(glUniformMatrix3x2dv)
+GL_PROFILER_FUNCTION(glUniformMatrix3x2fv)
+GL_PROFILER_FUNCTION(glUniformMatrix3x4dv)
+GL_PROFILER_FUNCTION(glUniformMatrix3x4fv)
+GL_PROFILER_FUNCTION(glUniformMatrix4dv)
+GL_PROFILER_FUNCTION(glUniformMatrix4fv)
+GL_PROFILER_FUNCTION(glUniformMatrix4x2dv)
+GL_PROFILER_FUNCTION(glUniformMatrix4x2fv)
+GL_PROFILER_FUNCTION(glUniformMatrix4x3dv)
+GL_PROFILER_FUNCTION(glUniformMatrix4x3fv)
+GL_PROFILER_FUNCTION(glUniformSubroutinesuiv)
+GL_PROFILER_FUNCTION(glUnmapBuffer)
+GL_PROFILER_FUNCTION(glUnmapNamedBuffer)
+GL_PROFILER_FUNCTION(glUseProgram)
+GL_PROFILER_FUNCTION(glUseProgramStages)
+GL_PROFILER_FUNCTION(glValidateProgram)
+GL_PROFILER_FUNCTION(glValidateProgramPipeline)
+GL_PROFILER_FUNCTION(glVertex2d)
+GL_PROFILER_FUNCTION(glVertex2dv)
+GL_PROFILER_FUNCTION(glVertex2f)
+GL_PROFILER_FUNCTION(glVertex2fv)
+GL_PROFILER_FUNCTION(glVertex2i)
+GL_PROFILER_FUNCTION(glVertex2iv)
+GL_PROFILER_FUNCTION(glVertex2s)
+GL_PROFILER_FUNCTION(glVertex2sv)
+GL_PROFILER_FUNCTION(glVertex3d)
+GL_PROFILER_FUNCTION(glVertex3dv)
+GL_PROFILER_FUNCTION(glVertex3f)
+GL_PROFILER_FUNCTION(glVertex3fv)
+GL_PROFILER_FUNCTION(glVertex3i)
+GL_PROFILER_FUNCTION(glVertex3iv)
+GL_PROFILER_FUNCTION(glVertex3s)
+GL_PROFILER_FUNCTION(glVertex3sv)
+GL_PROFILER_FUNCTION(glVertex4d)
+GL_PROFILER_FUNCTION(glVertex4dv)
+GL_PROFILER_FUNCTION(glVertex4f)
+GL_PROFILER_FUNCTION(glVertex4fv)
+GL_PROFILER_FUNCTION(glVertex4i)
+GL_PROFILER_FUNCTION(glVertex4iv)
+GL_PROFILER_FUNCTION(glVertex4s)
+GL_PROFILER_FUNCTION(glVertex4sv)
+GL_PROFILER_FUNCTION(glVertexArrayAttribBinding)
+GL_PROFILER_FUNCTION(glVertexArrayAttribFormat)
+GL_PROFILER_FUNCTION(glVertexArrayAttribIFormat)
+GL_PROFILER_FUNCTION(glVertexArrayAttribLFormat)
+GL_PROFILER_FUNCTION(glVertexArrayBindingDivisor)
+GL_PROFILER_FUNCTION(glVertexArrayElementBuffer)
+GL_PROFILER_FUNCTION(glVertexArrayVertexBuffer)
+GL_PROFILER_FUNCTION(glVertexArrayVertexBuffers)
+GL_PROFILER_FUNCTION(glVertexAttrib1d)
+GL_PROFILER_FUNCTION(glVertexAttrib1dv)
+GL_PROFILER_FUNCTION(glVertexAttrib1f)
+GL_PROFILER_FUNCTION(glVertexAttrib1fv)
+GL_PROFILER_FUNCTION(glVertexAttrib1s)
+GL_PROFILER_FUNCTION(glVertexAttrib1sv)
+GL_PROFILER_FUNCTION(glVertexAttrib2d)
+GL_PROFILER_FUNCTION(glVertexAttrib2dv)
+GL_PROFILER_FUNCTION(glVertexAttrib2f)
+GL_PROFILER_FUNCTION(glVertexAttrib2fv)
+GL_PROFILER_FUNCTION(glVertexAttrib2s)
+GL_PROFILER_FUNCTION(glVertexAttrib2sv)
+GL_PROFILER_FUNCTION(glVertexAttrib3d)
+GL_PROFILER_FUNCTION(glVertexAttrib3dv)
+GL_PROFILER_FUNCTION(glVertexAttrib3f)
+GL_PROFILER_FUNCTION(glVertexAttrib3fv)
+GL_PROFILER_FUNCTION(glVertexAttrib3s)
+GL_PROFILER_FUNCTION(glVertexAttrib3sv)
+GL_PROFILER_FUNCTION(glVertexAttrib4Nbv)
+GL_PROFILER_FUNCTION(glVertexAttrib4Niv)
+GL_PROFILER_FUNCTION(glVertexAttrib4Nsv)
+GL_PROFILER_FUNCTION(glVertexAttrib4Nub)
+GL_PROFILER_FUNCTION(glVertexAttrib4Nubv)
+GL_PROFILER_FUNCTION(glVertexAttrib4Nuiv)
+GL_PROFILER_FUNCTION(glVertexAttrib4Nusv)
+GL_PROFILER_FUNCTION(glVertexAttrib4bv)
+GL_PROFILER_FUNCTION(glVertexAttrib4d)
+GL_PROFILER_FUNCTION(glVertexAttrib4dv)
+GL_PROFILER_FUNCTION(glVertexAttrib4f)
+GL_PROFILER_FUNCTION(glVertexAttrib4fv)
+GL_PROFILER_FUNCTION(glVertexAttrib4iv)
+GL_PROFILER_FUNCTION(glVertexAttrib4s)
+GL_PROFILER_FUNCTION(glVertexAttrib4sv)
+GL_PROFILER_FUNCTION(glVertexAttrib4ubv)
+GL_PROFILER_FUNCTION(glVertexAttrib4uiv)
+GL_PROFILER_FUNCTION(glVertexAttrib4usv)
+GL_PROFILER_FUNCTION(glVertexAttribBinding)
+GL_PROFILER_FUNCTION(glVertexAttribDivisor)
+GL_PROFILER_FUNCTION(glVertexAttribFormat)
+GL_PROFILER_FUNCTION(glVertexAttribI1i)
+GL_PROFILER_FUNCTION(glVertexAttribI1iv)
+GL_PROFILER_FUNCTION(glVertexAttribI1ui)
+GL_PROFILER_FUNCTION(glVertexAttribI1uiv)
+GL_PROFILER_FUNCTION(glVertexAttribI2i)
+GL_PROFILER_FUNCTION(glVertexAttribI2iv)
+GL_PROFILER_FUNCTION(glVertexAttribI2ui)
+GL_PROFILER_FUNCTION(glVertexAttribI2uiv)
+GL_PROFILER_FUNCTION(glVertexAttribI3i)
+GL_PROFILER_FUNCTION(glVertexAttribI3iv)
+GL_PROFILER_FUNCTION(glVertexAttribI3ui)
+GL_PROFILER_FUNCTION(glVertexAttribI3uiv)
+GL_PROFILER_FUNCTION(glVertexAttribI4bv)
+GL_PROFILER_FUNCTION(glVertexAttribI4i)
+GL_PROFILER_FUNCTION(glVertexAttribI4iv)
+GL_PROFILER_FUNCTION(glVertexAttribI4sv)
+GL_PROFILER_FUNCTION(glVertexAttribI4ubv)
+GL_PROFILER_FUNCTION(glVertexAttribI4ui)
+GL_PROFILER_FUNCTION(glVertexAttribI4uiv)
+GL_PROFILER_FUNCTION(glVertexAttribI4usv)
+GL_PROFILER_FUNCTION(glVertexAttribIFormat)
+GL_PROFILER_FUNCTION(glVertexAttribIPointer)
+GL_PROFILER_FUNCTION(glVertexAttribL1d)
+GL_PROFILER_FUNCTION(glVertexAttribL1dv)
+GL_PROFILER_FUNCTION(glVertexAttribL2d)
+GL_PROFILER_FUNCTION(glVertexAttribL2dv)
+GL_PROFILER_FUNCTION(glVertexAttribL3d)
+GL_PROFILER_FUNCTION(glVertexAttribL3dv)
+GL_PROFILER_FUNCTION(glVertexAttribL4d)
+GL_PROFILER_FUNCTION(glVertexAttribL4dv)
+GL_PROFILER_FUNCTION(glVertexAttribLFormat)
+GL_PROFILER_FUNCTION(glVertexAttribLPointer)
+GL_PROFILER_FUNCTION(glVertexAttribP1ui)
+GL_PROFILER_FUNCTION(glVertexAttribP1uiv)
+GL_PROFILER_FUNCTION(glVertexAttribP2ui)
+GL_PROFILER_FUNCTION(glVertexAttribP2uiv)
+GL_PROFILER_FUNCTION(glVertexAttribP3ui)
+GL_PROFILER_FUNCTION(glVertexAttribP3uiv)
+GL_PROFILER_FUNCTION(glVertexAttribP4ui)
+GL_PROFILER_FUNCTION(glVertexAttribP4uiv)
+GL_PROFILER_FUNCTION(glVertexAttribPointer)
+GL_PROFILER_FUNCTION(glVertexBindingDivisor)
+GL_PROFILER_FUNCTION(glVertexP2ui)
+GL_PROFILER_FUNCTION(glVertexP2uiv)
+GL_PROFILER_FUNCTION(glVertexP3ui)
+GL_PROFILER_FUNCTION(glVertexP3uiv)
+GL_PROFILER_FUNCTION(glVertexP4ui)
+GL_PROFILER_FUNCTION(glVertexP4uiv)
+GL_PROFILER_FUNCTION(glVertexPointer)
+GL_PROFILER_FUNCTION(glViewport)
+GL_PROFILER_FUNCTION(glViewportArrayv)
+GL_PROFILER_FUNCTION(glViewportIndexedf)
+GL_PROFILER_FUNCTION(glViewportIndexedfv)
+GL_PROFILER_FUNCTION(glWaitSync)
+GL_PROFILER_FUNCTION(glWindowPos2d)
+GL_PROFILER_FUNCTION(glWindowPos2dv)
+GL_PROFILER_FUNCTION(glWindowPos2f)
+GL_PROFILER_FUNCTION(glWindowPos2fv)
+GL_PROFILER_FUNCTION(glWindowPos2i)
+GL_PROFILER_FUNCTION(glWindowPos2iv)
+GL_PROFILER_FUNCTION(glWindowPos2s)
+GL_PROFILER_FUNCTION(glWindowPos2sv)
+GL_PROFILER_FUNCTION(glWindowPos3d)
+GL_PROFILER_FUNCTION(glWindowPos3dv)
+GL_PROFILER_FUNCTION(glWindowPos3f)
+GL_PROFILER_FUNCTION(glWindowPos3fv)
+GL_PROFILER_FUNCTION(glWindowPos3i)
+GL_PROFILER_FUNCTION(glWindowPos3iv)
+GL_PROFILER_FUNCTION(glWindowPos3s)
+GL_PROFILER_FUNCTION(glWindowPos3sv)
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "GLState.h"
+
+std::atomic<GLuint> GLState::s_lastFrameIssuedCalls = 0;
+std::atomic<GLuint> GLState::s_lastFrameElidedCalls = 0;
+
+/// <summary>
+/// the cache of the calling thread, destroyed when the thread ends
+/// </summary>
+GLState* GLState::Instance()
+{
+	static thread_local GLState glState;
+	return &glState;
+}
+
+GLState::GLState()
+{
+	m_totalIssuedCalls = 0;
+	m_totalElidedCalls = 0;
+
+	Invalidate();
+}
+
+/// <summary>
+/// starts counting the calls of a new frame, keeping the totals of the frame that just ended. 
+/// Called on the thread drawing the frames
+/// </summary>
+void GLState::BeginFrame()
+{
+	s_lastFrameIssuedCalls = m_totalIssuedCalls;
+	s_lastFrameElidedCalls = m_totalElidedCalls;
+	m_totalIssuedCalls = 0;
+	m_totalElidedCalls = 0;
+}
+
+/// <summary>
+/// forgets all cached state, for when code outside the cache may have changed it
+/// </summary>
+void GLState::Invalidate()
+{
+	m_program = UNKNOWN;
+	m_vertexArray = UNKNOWN;
+	m_activeTextureUnit = UNKNOWN;
+	m_isBlendEnabled = UNKNOWN;
+	m_blendSource = UNKNOWN;
+	m_blendDestination = UNKNOWN;
+	m_viewport = glm::ivec4(0);
+	m_isViewportKnown = false;
+
+	m_buffers.clear();
+	m_textures.clear();
+}
+
+void GLState::UseProgram(GLuint ID)
+{
+	if (Track(m_program, ID))
+	{
+		glUseProgram(ID);
+	}
+}
+
+/// <summary>
+/// binds a vertex array. The element buffer binding belongs to the vertex array, so it is forgotten when the array changes
+/// </summary>
+void GLState::BindVertexArray(GLuint ID)
+{
+	if (Track(m_vertexArray, ID))
+	{
+		glBindVertexArray(ID);
+		m_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+	}
+}
+
+void GLState::BindBuffer(GLenum target, GLuint ID)
+{
+	auto it = m_buffers.find(target);
+	GLuint cachedID = (it == m_buffers.end()) ? UNKNOWN : it->second;
+
+	if (Track(cachedID, ID))
+	{
+		glBindBuffer(target, ID);
+		m_buffers[target] = ID;
+	}
+}
+
+/// <summary>
+/// binds a texture to a target of a texture unit, switching the active unit only when the binding changes
+/// </summary>
+/// <param name="unit">texture unit, starting at 0 for GL_TEXTURE0</param>
+/// <param name="target">texture target such as GL_TEXTURE_2D</param>
+/// <param name="ID">texture to bind, or 0 to unbind</param>
+void GLState::BindTexture(GLuint unit, GLenum target, GLuint ID)
+{
+	auto key = std::make_pair(unit, target);
+	auto it = m_textures.find(key);
+	GLuint cachedID = (it == m_textures.end()) ? UNKNOWN : it->second;
+
+	if (Track(cachedID, ID))
+	{
+		SetActiveTextureUnit(unit);
+		glBindTexture(target, ID);
+		m_textures[key] = ID;
+	}
+}
+
+void GLState::SetBlend(bool isEnabled)
+{
+	if (Track(m_isBlendEnabled, isEnabled ? GL_TRUE : GL_FALSE))
+	{
+		isEnabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+	}
+}
+
+void GLState::SetBlendFunction(GLenum source, GLenum destination)
+{
+	if (m_blendSource == source && m_blendDestination == destination)
+	{
+		m_totalElidedCalls++;
+		return;
+	}
+
+	glBlendFunc(source, destination);
+	m_blendSource = source;
+	m_blendDestination = destination;
+	m_totalIssuedCalls++;
+}
+
+void GLState::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	glm::ivec4 viewport(x, y, width, height);
+
+	if (m_isViewportKnown && m_viewport == viewport)
+	{
+		m_totalElidedCalls++;
+		return;
+	}
+
+	glViewport(x, y, width, height);
+	m_viewport = viewport;
+	m_isViewportKnown = true;
+	m_totalIssuedCalls++;
+}
+
+void GLState::InvalidateProgram(GLuint ID)
+{
+	if (m_program == ID)
+	{
+		m_program = UNKNOWN;
+	}
+}
+
+void GLState::InvalidateVertexArray(GLuint ID)
+{
+	if (m_vertexArray == ID)
+	{
+		m_vertexArray = UNKNOWN;
+		m_buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+	}
+}
+
+void GLState::InvalidateBuffer(GLuint ID)
+{
+	for (auto it = m_buffers.begin(); it != m_buffers.end();)
+	{
+		it = (it->second == ID) ? m_buffers.erase(it) : std::next(it);
+	}
+}
+
+void GLState::InvalidateTexture(GLuint ID)
+{
+	for (auto it = m_textures.begin(); it != m_textures.end();)
+	{
+		it = (it->second == ID) ? m_textures.erase(it) : std::next(it);
+	}
+}
+
+/// <summary>
+/// number of state changing calls sent to the driver during the last frame
+/// </summary>
+GLuint GLState::GetTotalIssuedCalls()
+{
+	return s_lastFrameIssuedCalls;
+}
+
+/// <summary>
+/// number of state changing calls dropped during the last frame because the state was already set
+/// </summary>
+GLuint GLState::GetTotalElidedCalls()
+{
+	return s_lastFrameElidedCalls;
+}
+
+/// <summary>
+/// counts a call and stores the new value when it differs from the cached one
+/// </summary>
+/// <returns>returns true if the call has to be sent to the driver</returns>
+bool GLState::Track(GLuint& cachedValue, GLuint newValue)
+{
+	if (cachedValue == newValue)
+	{
+		m_totalElidedCalls++;
+		return false;
+	}
+
+	cachedValue = newValue;
+	m_totalIssuedCalls++;
+	return true;
+}
+
+void GLState::SetActiveTextureUnit(GLuint unit)
+{
+	if (Track(m_activeTextureUnit, unit))
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <utility>
+#include <glm.hpp>
+#include "gl.h"
+
+//a shadow copy of the OpenGL state the engine changes: the bound program, vertex array, buffers, 
+//texture units, blend state and viewport. A call that would set a value the driver already holds is 
+//dropped, and every call, issued or elided, is counted so the savings show up per frame.
+//Code that deletes a GL object must invalidate it here, as OpenGL may hand the same ID to the next object.
+//Each thread has its own cache, describing the context current on it. Screen::MakeCurrent forgets it whenever 
+//the thread switches context, so a context handed over to another thread starts with nothing cached there.
+class GLState
+{
+
+public:
+
+	static GLState* Instance();
+
+	void BeginFrame();
+	void Invalidate();
+
+	void UseProgram(GLuint ID);
+	void BindVertexArray(GLuint ID);
+	void BindBuffer(GLenum target, GLuint ID);
+	void BindTexture(GLuint unit, GLenum target, GLuint ID);
+
+	void SetBlend(bool isEnabled);
+	void SetBlendFunction(GLenum source, GLenum destination);
+	void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	void InvalidateProgram(GLuint ID);
+	void InvalidateVertexArray(GLuint ID);
+	void InvalidateBuffer(GLuint ID);
+	void InvalidateTexture(GLuint ID);
+
+	static GLuint GetTotalIssuedCalls();
+	static GLuint GetTotalElidedCalls();
+
+private:
+
+	GLState();
+	GLState(const GLState&);
+
+	bool Track(GLuint& cachedValue, GLuint newValue);
+	void SetActiveTextureUnit(GLuint unit);
+
+	//marks a value the cache does not know, so the next call setting it is always issued
+	static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+	GLuint m_program;
+	GLuint m_vertexArray;
+	GLuint m_activeTextureUnit;
+	GLuint m_isBlendEnabled;
+	GLuint m_blendSource;
+	GLuint m_blendDestination;
+	glm::ivec4 m_viewport;
+	bool m_isViewportKnown;
+
+	std::map<GLenum, GLuint> m_buffers;
+	std::map<std::pair<GLuint, GLenum>, GLuint> m_textures;
+
+	GLuint m_totalIssuedCalls;
+	GLuint m_totalElidedCalls;
+	//published by the thread drawing the frames and read by the main thread
+	static std::atomic<GLuint> s_lastFrameIssuedCalls;
+	static std::atomic<GLuint> s_lastFrameElidedCalls;
+
+};
\ No newline at end of file
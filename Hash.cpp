@@ -0,0 +1,107 @@
+#include <cstring>
+#include "Hash.h"
+
+static const Uint64 PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const Uint64 PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static const Uint64 PRIME_3 = 0x165667B19E3779F9ULL;
+static const Uint64 PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+static const Uint64 PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+static Uint64 RotateLeft(Uint64 value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+//the lanes are read as little-endian, like on every platform the application runs on
+static Uint64 Read64(const Uint8* bytes)
+{
+	Uint64 value;
+	std::memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+static Uint32 Read32(const Uint8* bytes)
+{
+	Uint32 value;
+	std::memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+static Uint64 Round(Uint64 accumulator, Uint64 lane)
+{
+	accumulator += lane * PRIME_2;
+	accumulator = RotateLeft(accumulator, 31);
+	return accumulator * PRIME_1;
+}
+
+static Uint64 MergeRound(Uint64 hash, Uint64 accumulator)
+{
+	hash ^= Round(0, accumulator);
+	return hash * PRIME_1 + PRIME_4;
+}
+
+Uint64 Hash64(const void* data, size_t size, Uint64 seed)
+{
+	const Uint8* bytes = static_cast<const Uint8*>(data);
+	const Uint8* end = bytes + size;
+	Uint64 hash;
+
+	if (size >= 32)
+	{
+		//four independent lanes, which the processor runs side by side
+		Uint64 accumulators[4] = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+		const Uint8* lastStripe = end - 32;
+
+		do
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				accumulators[i] = Round(accumulators[i], Read64(bytes + i * 8));
+			}
+
+			bytes += 32;
+		} while (bytes <= lastStripe);
+
+		hash = RotateLeft(accumulators[0], 1) + RotateLeft(accumulators[1], 7) + 
+			   RotateLeft(accumulators[2], 12) + RotateLeft(accumulators[3], 18);
+
+		for (int i = 0; i < 4; i++)
+		{
+			hash = MergeRound(hash, accumulators[i]);
+		}
+	}
+	else
+	{
+		hash = seed + PRIME_5;
+	}
+
+	hash += size;
+
+	for (; bytes + 8 <= end; bytes += 8)
+	{
+		hash ^= Round(0, Read64(bytes));
+		hash = RotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+	}
+
+	if (bytes + 4 <= end)
+	{
+		hash ^= Read32(bytes) * PRIME_1;
+		hash = RotateLeft(hash, 23) * PRIME_2 + PRIME_3;
+		bytes += 4;
+	}
+
+	for (; bytes < end; bytes++)
+	{
+		hash ^= *bytes * PRIME_5;
+		hash = RotateLeft(hash, 11) * PRIME_1;
+	}
+
+	//the avalanche spreads every input bit over the whole hash
+	hash ^= hash >> 33;
+	hash *= PRIME_2;
+	hash ^= hash >> 29;
+	hash *= PRIME_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+#include <SDL.h>
+
+//the 64-bit xxHash (XXH64) of the bytes, which reads four 64-bit lanes at a time and hashes gigabytes per second, 
+//so the pixels of a large image hash in a few milliseconds. It is not a cryptographic hash
+Uint64 Hash64(const void* data, size_t size, Uint64 seed = 0);
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <iostream>
+#include "GLState.h"
+#include "ImageAtlas.h"
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+
+//empty border kept to the right and below each packed image, so that filtering never reads a neighbouring image
+static const GLint PADDING = 1;
+
+//a layer of the texture array, together with the state of the rectangle packer for that layer
+struct ImageAtlas::Page
+{
+	stbrp_context context;
+	std::vector<stbrp_node> nodes;
+	std::vector<GLuint> images;
+	GLint usedArea;
+	GLint freedArea;
+
+	void Reset(GLsizei pageSize)
+	{
+		nodes.resize(pageSize);
+		stbrp_init_target(&context, pageSize, pageSize, nodes.data(), pageSize);
+		images.clear();
+		usedArea = 0;
+		freedArea = 0;
+	}
+};
+
+ImageAtlas::ImageAtlas(GLsizei pageSize)
+{
+	m_ID = 0;
+	m_version = 0;
+	m_pageSize = pageSize;
+	m_totalLayers = 0;
+}
+
+ImageAtlas::~ImageAtlas()
+{
+	for (Image& image : m_images)
+	{
+		SDL_FreeSurface(image.pixels);
+	}
+
+	for (Page* page : m_pages)
+	{
+		delete page;
+	}
+
+	GLState::Instance()->InvalidateTexture(m_ID);
+	glDeleteTextures(1, &m_ID);
+}
+
+/// <summary>
+/// loads an image from disk and packs it into the first page with enough room, opening a new page if none has
+/// </summary>
+/// <param name="filename">path to the image</param>
+/// <returns>index of the image in the atlas, or -1 if the image could not be loaded</returns>
+GLint ImageAtlas::AddImage(const std::string& filename)
+{
+	SDL_Surface* loadedImage = IMG_Load(filename.c_str());
+
+	if (!loadedImage)
+	{
+		std::cout << "Error loading texture." << std::endl;
+		return -1;
+	}
+
+	SDL_Surface* pixels = SDL_ConvertSurfaceFormat(loadedImage, SDL_PIXELFORMAT_RGBA32, 0);
+	SDL_FreeSurface(loadedImage);
+
+	//images larger than a page are scaled down to fit in one
+	if (pixels->w > m_pageSize || pixels->h > m_pageSize)
+	{
+		GLfloat factor = std::min(GLfloat(m_pageSize) / pixels->w, GLfloat(m_pageSize) / pixels->h);
+		int width = std::max(1, int(pixels->w * factor));
+		int height = std::max(1, int(pixels->h * factor));
+
+		SDL_Surface* scaledPixels = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+		SDL_SetSurfaceBlendMode(pixels, SDL_BLENDMODE_NONE);
+		SDL_BlitScaled(pixels, nullptr, scaledPixels, nullptr);
+
+		SDL_FreeSurface(pixels);
+		pixels = scaledPixels;
+	}
+
+	GLuint imageIndex;
+
+	if (!m_freeImages.empty())
+	{
+		imageIndex = m_freeImages.back();
+		m_freeImages.pop_back();
+	}
+	else
+	{
+		imageIndex = static_cast<GLuint>(m_images.size());
+		m_images.emplace_back();
+	}
+
+	m_images[imageIndex] = { pixels, -1, 0, 0, { 0.0f, glm::vec4(0.0f) } };
+
+	Place(imageIndex);
+
+	m_version++;
+	return imageIndex;
+}
+
+/// <summary>
+/// removes an image from the atlas. The rectangle packer cannot reuse freed space, 
+/// so only the page that held the image is repacked, and only once half of its packed area is unused
+/// </summary>
+/// <param name="imageIndex">index returned by AddImage</param>
+void ImageAtlas::RemoveImage(GLuint imageIndex)
+{
+	Image& image = m_images[imageIndex];
+
+	if (!image.pixels)
+	{
+		return;
+	}
+
+	GLuint pageIndex = image.page;
+	Page* page = m_pages[pageIndex];
+
+	page->images.erase(std::find(page->images.begin(), page->images.end(), imageIndex));
+	page->freedArea += std::min(image.pixels->w + PADDING, m_pageSize) * std::min(image.pixels->h + PADDING, m_pageSize);
+
+	SDL_FreeSurface(image.pixels);
+	image.pixels = nullptr;
+	m_freeImages.push_back(imageIndex);
+
+	if (page->images.empty())
+	{
+		page->Reset(m_pageSize);
+	}
+	else if (page->freedArea * 2 > page->usedArea)
+	{
+		RepackPage(pageIndex);
+	}
+
+	m_version++;
+}
+
+const ImageAtlas::Region& ImageAtlas::GetRegion(GLuint imageIndex) const
+{
+	return m_images[imageIndex].region;
+}
+
+/// <summary>
+/// the version changes whenever an image is added, removed or moved, so users of the regions know to refresh them
+/// </summary>
+GLuint ImageAtlas::GetVersion() const
+{
+	return m_version;
+}
+
+void ImageAtlas::Bind()
+{
+	GLState::Instance()->BindTexture(TEXTURE_UNIT, GL_TEXTURE_2D_ARRAY, m_ID);
+}
+
+void ImageAtlas::Unbind()
+{
+	GLState::Instance()->BindTexture(TEXTURE_UNIT, GL_TEXTURE_2D_ARRAY, 0);
+}
+
+/// <summary>
+/// packs an image into the first page with enough room, opening a new page if none has, and uploads its pixels
+/// </summary>
+void ImageAtlas::Place(GLuint imageIndex)
+{
+	bool isPacked = false;
+
+	for (GLuint i = 0; i < m_pages.size() && !isPacked; i++)
+	{
+		isPacked = PackIntoPage(i, imageIndex);
+	}
+
+	if (!isPacked)
+	{
+		Page* page = new Page;
+		page->Reset(m_pageSize);
+		m_pages.push_back(page);
+
+		PackIntoPage(static_cast<GLuint>(m_pages.size() - 1), imageIndex);
+	}
+
+	ReserveLayers(static_cast<GLsizei>(m_pages.size()));
+	Upload(imageIndex);
+}
+
+bool ImageAtlas::PackIntoPage(GLuint pageIndex, GLuint imageIndex)
+{
+	Page* page = m_pages[pageIndex];
+	const Image& image = m_images[imageIndex];
+
+	stbrp_rect rect = {};
+	rect.w = std::min(image.pixels->w + PADDING, m_pageSize);
+	rect.h = std::min(image.pixels->h + PADDING, m_pageSize);
+
+	if (page->usedArea + rect.w * rect.h > m_pageSize * m_pageSize)
+	{
+		return false;
+	}
+
+	stbrp_pack_rects(&page->context, &rect, 1);
+
+	if (!rect.was_packed)
+	{
+		return false;
+	}
+
+	AssignPosition(imageIndex, pageIndex, rect.x, rect.y);
+	page->usedArea += rect.w * rect.h;
+
+	return true;
+}
+
+void ImageAtlas::AssignPosition(GLuint imageIndex, GLuint pageIndex, GLint x, GLint y)
+{
+	Image& image = m_images[imageIndex];
+	GLfloat pageSize = static_cast<GLfloat>(m_pageSize);
+
+	image.page = pageIndex;
+	image.x = x;
+	image.y = y;
+	image.region.layer = static_cast<GLfloat>(pageIndex);
+	image.region.uvRect = glm::vec4(x / pageSize, y / pageSize, image.pixels->w / pageSize, image.pixels->h / pageSize);
+
+	m_pages[pageIndex]->images.push_back(imageIndex);
+}
+
+/// <summary>
+/// packs the remaining images of a page from scratch and re-uploads them. 
+/// Images that no longer fit are moved to another page.
+/// </summary>
+void ImageAtlas::RepackPage(GLuint pageIndex)
+{
+	Page* page = m_pages[pageIndex];
+	std::vector<GLuint> images = page->images;
+
+	page->Reset(m_pageSize);
+
+	std::vector<stbrp_rect> rects(images.size());
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		rects[i] = {};
+		rects[i].id = static_cast<int>(i);
+		rects[i].w = std::min(m_images[images[i]].pixels->w + PADDING, m_pageSize);
+		rects[i].h = std::min(m_images[images[i]].pixels->h + PADDING, m_pageSize);
+	}
+
+	stbrp_pack_rects(&page->context, rects.data(), static_cast<int>(rects.size()));
+
+	GLubyte clearColor[4] = { 0, 0, 0, 0 };
+	glClearTexSubImage(m_ID, 0, 0, 0, pageIndex, m_pageSize, m_pageSize, 1, GL_RGBA, GL_UNSIGNED_BYTE, clearColor);
+
+	for (const stbrp_rect& rect : rects)
+	{
+		GLuint imageIndex = images[rect.id];
+
+		if (rect.was_packed)
+		{
+			AssignPosition(imageIndex, pageIndex, rect.x, rect.y);
+			page->usedArea += rect.w * rect.h;
+			Upload(imageIndex);
+		}
+		else
+		{
+			Place(imageIndex);
+		}
+	}
+}
+
+/// <summary>
+/// makes sure the texture array has at least the given number of layers. The array grows geometrically 
+/// and the existing layers are copied on the GPU, so pages never have to be uploaded again
+/// </summary>
+void ImageAtlas::ReserveLayers(GLsizei totalLayers)
+{
+	if (totalLayers <= m_totalLayers)
+	{
+		return;
+	}
+
+	GLsizei newTotalLayers = std::max(totalLayers, m_totalLayers * 2);
+
+	GLuint newID;
+	glGenTextures(1, &newID);
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D_ARRAY, newID);
+
+	glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, m_pageSize, m_pageSize, newTotalLayers);
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	GLubyte clearColor[4] = { 0, 0, 0, 0 };
+	glClearTexImage(newID, 0, GL_RGBA, GL_UNSIGNED_BYTE, clearColor);
+
+	if (m_ID != 0)
+	{
+		glCopyImageSubData(m_ID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			               newID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			               m_pageSize, m_pageSize, m_totalLayers);
+		GLState::Instance()->InvalidateTexture(m_ID);
+		glDeleteTextures(1, &m_ID);
+	}
+
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+
+	m_ID = newID;
+	m_totalLayers = newTotalLayers;
+}
+
+void ImageAtlas::Upload(GLuint imageIndex)
+{
+	const Image& image = m_images[imageIndex];
+
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D_ARRAY, m_ID);
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, image.pixels->pitch / 4);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, image.x, image.y, image.page, image.pixels->w, image.pixels->h, 1,
+		            GL_RGBA, GL_UNSIGNED_BYTE, image.pixels->pixels);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+}
\ No newline at end of file
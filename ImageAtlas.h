@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm.hpp>
+#include <SDL_image.h>
+#include "gl.h"
+
+//packs many images into the layers (pages) of a single GL_TEXTURE_2D_ARRAY, so that quads showing 
+//different images can be drawn with one texture binding. Small images share a page using the rectangle 
+//packer bundled with imgui, while images as large as a page fill a layer of their own.
+class ImageAtlas
+{
+
+public:
+
+	//location of an image within the atlas
+	struct Region
+	{
+		GLfloat layer;
+		glm::vec4 uvRect; //x, y of the top left corner followed by width and height, in texture coordinates
+	};
+
+	static const GLuint TEXTURE_UNIT = 1;
+
+	ImageAtlas(GLsizei pageSize = 2048);
+	~ImageAtlas();
+
+	GLint AddImage(const std::string& filename);
+	void RemoveImage(GLuint imageIndex);
+
+	const Region& GetRegion(GLuint imageIndex) const;
+	GLuint GetVersion() const;
+
+	void Bind();
+	void Unbind();
+
+private:
+
+	struct Page;
+
+	struct Image
+	{
+		SDL_Surface* pixels; //RGBA copy of the image, kept for re-uploading when its page is repacked
+		GLint page;
+		GLint x;
+		GLint y;
+		Region region;
+	};
+
+	void Place(GLuint imageIndex);
+	bool PackIntoPage(GLuint pageIndex, GLuint imageIndex);
+	void AssignPosition(GLuint imageIndex, GLuint pageIndex, GLint x, GLint y);
+	void RepackPage(GLuint pageIndex);
+	void ReserveLayers(GLsizei totalLayers);
+	void Upload(GLuint imageIndex);
+
+	GLuint m_ID;
+	GLuint m_version;
+	GLsizei m_pageSize;
+	GLsizei m_totalLayers;
+
+	std::vector<Image> m_images;
+	std::vector<Page*> m_pages;
+	std::vector<GLuint> m_freeImages;
+
+};
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include "Kernel.h"
+
+Kernel::Kernel(GLsizei width, GLsizei height)
+{
+	m_width = std::max(width, 1);
+	m_height = std::max(height, 1);
+	m_weights.assign(static_cast<size_t>(m_width) * m_height, 0.0f);
+}
+
+GLsizei Kernel::GetWidth() const
+{
+	return m_width;
+}
+
+GLsizei Kernel::GetHeight() const
+{
+	return m_height;
+}
+
+GLfloat Kernel::GetWeight(GLsizei x, GLsizei y) const
+{
+	return m_weights[static_cast<size_t>(y) * m_width + x];
+}
+
+void Kernel::SetWeight(GLsizei x, GLsizei y, GLfloat weight)
+{
+	m_weights[static_cast<size_t>(y) * m_width + x] = weight;
+}
+
+const std::vector<GLfloat>& Kernel::GetWeights() const
+{
+	return m_weights;
+}
+
+GLuint Kernel::GetTotalNonZeroWeights() const
+{
+	return static_cast<GLuint>(std::count_if(m_weights.begin(), m_weights.end(), [](GLfloat weight) { return weight != 0.0f; }));
+}
+
+/// <summary>
+/// scales the weights to add up to 1, so the kernel keeps the brightness of the image
+/// </summary>
+void Kernel::Normalize()
+{
+	double sum = 0.0;
+
+	for (GLfloat weight : m_weights)
+	{
+		sum += weight;
+	}
+
+	if (sum != 0.0)
+	{
+		for (GLfloat& weight : m_weights)
+		{
+			weight = static_cast<GLfloat>(weight / sum);
+		}
+	}
+}
+
+/// <summary>
+/// a square gaussian kernel, the one the blur effect applies in two passes
+/// </summary>
+Kernel Kernel::CreateGaussian(GLsizei radius, GLfloat sigma)
+{
+	Kernel kernel(2 * radius + 1, 2 * radius + 1);
+
+	for (GLsizei y = -radius; y <= radius; y++)
+	{
+		for (GLsizei x = -radius; x <= radius; x++)
+		{
+			kernel.SetWeight(x + radius, y + radius, std::exp(-(x * x + y * y) / (2.0f * sigma * sigma)));
+		}
+	}
+
+	kernel.Normalize();
+
+	return kernel;
+}
+
+/// <summary>
+/// a line of the given length in pixels, as if the camera moved along it while the image was taken. 
+/// The line is drawn with antialiasing, so it is smooth at any angle
+/// </summary>
+/// <param name="angle">the direction of the line in degrees, counterclockwise from the right</param>
+Kernel Kernel::CreateMotionBlur(GLsizei length, GLfloat angle)
+{
+	GLsizei size = std::max(length, 1) | 1;
+	Kernel kernel(size, size);
+
+	GLfloat radians = angle * 3.14159265f / 180.0f;
+	GLfloat directionX = std::cos(radians);
+	GLfloat directionY = -std::sin(radians);
+	GLfloat center = size / 2.0f;
+	GLuint totalSamples = static_cast<GLuint>(size) * 4;
+
+	//samples along the line are spread over the four pixels around them
+	for (GLuint i = 0; i <= totalSamples; i++)
+	{
+		GLfloat distance = (static_cast<GLfloat>(i) / totalSamples - 0.5f) * (size - 1);
+		GLfloat x = center - 0.5f + distance * directionX;
+		GLfloat y = center - 0.5f + distance * directionY;
+
+		GLsizei left = static_cast<GLsizei>(std::floor(x));
+		GLsizei top = static_cast<GLsizei>(std::floor(y));
+		GLfloat fractionX = x - left;
+		GLfloat fractionY = y - top;
+
+		for (GLsizei corner = 0; corner < 4; corner++)
+		{
+			GLsizei cornerX = left + (corner & 1);
+			GLsizei cornerY = top + (corner >> 1);
+			GLfloat weight = ((corner & 1) ? fractionX : 1.0f - fractionX) * ((corner >> 1) ? fractionY : 1.0f - fractionY);
+
+			if (cornerX >= 0 && cornerX < size && cornerY >= 0 && cornerY < size)
+			{
+				kernel.SetWeight(cornerX, cornerY, kernel.GetWeight(cornerX, cornerY) + weight);
+			}
+		}
+	}
+
+	kernel.Normalize();
+
+	return kernel;
+}
+
+/// <summary>
+/// a disc of the given radius, the shape out of focus lights take through a round lens aperture. 
+/// Pixels on the rim are weighted by how much of them the disc covers
+/// </summary>
+Kernel Kernel::CreateDisc(GLsizei radius)
+{
+	const GLsizei SUBSAMPLES = 4;
+
+	Kernel kernel(2 * radius + 1, 2 * radius + 1);
+	GLfloat radiusSquared = (radius + 0.5f) * (radius + 0.5f);
+
+	for (GLsizei y = -radius; y <= radius; y++)
+	{
+		for (GLsizei x = -radius; x <= radius; x++)
+		{
+			GLuint totalCovered = 0;
+
+			for (GLsizei subsample = 0; subsample < SUBSAMPLES * SUBSAMPLES; subsample++)
+			{
+				GLfloat subsampleX = x - 0.5f + (subsample % SUBSAMPLES + 0.5f) / SUBSAMPLES;
+				GLfloat subsampleY = y - 0.5f + (subsample / SUBSAMPLES + 0.5f) / SUBSAMPLES;
+
+				if (subsampleX * subsampleX + subsampleY * subsampleY <= radiusSquared)
+				{
+					totalCovered++;
+				}
+			}
+
+			kernel.SetWeight(x + radius, y + radius, static_cast<GLfloat>(totalCovered) / (SUBSAMPLES * SUBSAMPLES));
+		}
+	}
+
+	kernel.Normalize();
+
+	return kernel;
+}
+
+/// <summary>
+/// an unsharp mask: the image plus the given amount of its difference from a blurred copy of the given radius
+/// </summary>
+Kernel Kernel::CreateSharpen(GLsizei radius, GLfloat amount)
+{
+	Kernel kernel = CreateGaussian(radius, std::max(radius * 0.5f, 0.5f));
+
+	for (GLfloat& weight : kernel.m_weights)
+	{
+		weight *= -amount;
+	}
+
+	kernel.SetWeight(radius, radius, kernel.GetWeight(radius, radius) + 1.0f + amount);
+
+	return kernel;
+}
\ No newline at end of file
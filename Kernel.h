@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include "gl.h"
+
+//the weights of a convolution: each pixel of the result is the sum of the pixels around it, weighted by the kernel 
+//laid over the image with its middle on the pixel. Kernels of any shape can be made, the usual ones by the Create functions.
+class Kernel
+{
+
+public:
+
+	Kernel(GLsizei width, GLsizei height);
+
+	GLsizei GetWidth() const;
+	GLsizei GetHeight() const;
+
+	GLfloat GetWeight(GLsizei x, GLsizei y) const;
+	void SetWeight(GLsizei x, GLsizei y, GLfloat weight);
+	const std::vector<GLfloat>& GetWeights() const;
+
+	GLuint GetTotalNonZeroWeights() const;
+	void Normalize();
+
+	static Kernel CreateGaussian(GLsizei radius, GLfloat sigma);
+	static Kernel CreateMotionBlur(GLsizei length, GLfloat angle);
+	static Kernel CreateDisc(GLsizei radius);
+	static Kernel CreateSharpen(GLsizei radius, GLfloat amount);
+
+private:
+
+	GLsizei m_width;
+	GLsizei m_height;
+
+	//rows from top to bottom
+	std::vector<GLfloat> m_weights;
+
+};
\ No newline at end of file
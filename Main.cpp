@@ -1,25 +1,343 @@
+#include <algorithm>
 #include <iostream>
 #include <SDL.h>
 #include "Screen.h"
 #include "gl.h"
+#include "AsyncTask.h"
 #include "Shader.h"
 #include "Quad.h"
 #include "Camera.h"
+#include "Benchmarks.h"
+#include "Convolution.h"
+#include "EffectCache.h"
 #include "FileDialog.h"
+#include "FrameCapture.h"
+#include "GLProfiler.h"
+#include "FrameBudget.h"
+#include "GLState.h"
+#include "ImageAtlas.h"
+#include "PaddedBuffer.h"
+#include "PreviewResolution.h"
+#include "PyramidBlur.h"
+#include "RenderThread.h"
+#include "ShaderSources.h"
+#include "TaskScheduler.h"
+#include "TiledExporter.h"
+#include "Timer.h"
+#include "UploadThread.h"
 
 bool isAppRunning = true;
 
 const int SCREEN_WIDTH = 1920;
 const int SCREEN_HEIGHT = 1080;
 const int PROPERTIES_WINDOW_WIDTH = 400;
+const int CAPTURE_FRAMES_PER_SECOND = 60;
+const int DENOISE_RADIUS = 3;
+
+bool isProfilerShown = false;
+
+const char* KERNEL_NAMES[] = { "Motion blur", "Lens blur", "Sharpen" };
+const char* BLUR_METHOD_NAMES[] = { "Exact", "Pyramid (CPU)", "Pyramid (GPU)" };
+
+//in the order of EdgeMode
+const char* EDGE_MODE_NAMES[] = { "Clamp", "Mirror", "Wrap", "Zero" };
+
+//the exact gaussian blur slows down with its size, while the pyramid blur takes about the same time at any size
+const float MAX_EXACT_BLUR_PERCENT = 5.0f;
+const float MAX_PYRAMID_BLUR_PERCENT = 50.0f;
+
+//the utilization of the workers is averaged over this time, as single frames are too short to read
+const double SCHEDULER_STATS_MILLISECONDS = 500.0;
+
+/// <summary>
+/// applies the gaussian blur by one of the methods listed in BLUR_METHOD_NAMES
+/// </summary>
+void ApplyBlur(Quad& quad, int blurMethod, GLfloat blurPercent, bool isInvert)
+{
+	if (blurMethod == 0)
+	{
+		quad.Blur(blurPercent, isInvert);
+	}
+	else
+	{
+		quad.BlurWithPyramid(blurPercent, isInvert, blurMethod == 2);
+	}
+}
+
+/// <summary>
+/// creates one of the kernels listed in KERNEL_NAMES
+/// </summary>
+/// <param name="kernelType">index of the kernel in KERNEL_NAMES</param>
+/// <param name="size">length of the motion blur, or diameter of the lens blur and sharpen kernels, in pixels</param>
+/// <param name="angle">direction of the motion blur, in degrees</param>
+/// <param name="amount">strength of the sharpening</param>
+Kernel CreateKernel(int kernelType, GLsizei size, GLfloat angle, GLfloat amount)
+{
+	switch (kernelType)
+	{
+	case 0:
+		return Kernel::CreateMotionBlur(size, angle);
+	case 1:
+		return Kernel::CreateDisc(size / 2);
+	default:
+		return Kernel::CreateSharpen(size / 2, amount);
+	}
+}
+
+/// <summary>
+/// lists how the last convolution was computed and the estimated cost of each method
+/// </summary>
+void RenderConvolutionStats()
+{
+	Convolution::Stats stats = Convolution::Instance()->GetLastStats();
+
+	if (stats.kernelWidth == 0)
+	{
+		ImGui::TextUnformatted("Convolution: none applied yet");
+		return;
+	}
+
+	ImGui::Text("Convolution: %dx%d kernel, %s", stats.kernelWidth, stats.kernelHeight, Convolution::GetMethodName(stats.method));
+
+	if (stats.method == Convolution::Method::FFT)
+	{
+		ImGui::Text("Tile size: %d", stats.tileSize);
+	}
+
+	ImGui::Text("Time: %.1f ms on %u threads", stats.milliseconds, stats.totalThreads);
+	ImGui::Text("Estimated cost (M multiply-adds):");
+	ImGui::Text("  direct %.1f", stats.directCost);
+
+	if (stats.separableCost >= 0.0)
+	{
+		ImGui::Text("  separable %.1f", stats.separableCost);
+	}
+	else
+	{
+		ImGui::TextUnformatted("  separable n/a (rank > 1)");
+	}
+
+	if (stats.fftCost >= 0.0)
+	{
+		ImGui::Text("  FFT tiles %.1f", stats.fftCost);
+	}
+	else
+	{
+		ImGui::TextUnformatted("  FFT tiles n/a (kernel too large)");
+	}
+}
+
+/// <summary>
+/// lists how busy each worker of the task scheduler was and how many tasks it ran and stole over the last half second. 
+/// The threads waiting for tasks, mostly the UI thread, run tasks too and are listed last
+/// </summary>
+void RenderSchedulerStats()
+{
+	static std::vector<TaskScheduler::WorkerStatistics> lastStatistics = TaskScheduler::Instance()->GetWorkerStatistics();
+	static std::vector<TaskScheduler::WorkerStatistics> intervalStatistics(lastStatistics.size());
+	static double intervalMilliseconds = 0.0;
+	static Timer intervalTimer;
+
+	if (intervalTimer.GetElapsedMilliseconds() >= SCHEDULER_STATS_MILLISECONDS)
+	{
+		std::vector<TaskScheduler::WorkerStatistics> statistics = TaskScheduler::Instance()->GetWorkerStatistics();
+
+		for (size_t i = 0; i < statistics.size(); i++)
+		{
+			intervalStatistics[i].busyMilliseconds = statistics[i].busyMilliseconds - lastStatistics[i].busyMilliseconds;
+			intervalStatistics[i].totalTasks = statistics[i].totalTasks - lastStatistics[i].totalTasks;
+			intervalStatistics[i].totalStolenTasks = statistics[i].totalStolenTasks - lastStatistics[i].totalStolenTasks;
+		}
+
+		intervalMilliseconds = intervalTimer.GetElapsedMilliseconds();
+		intervalTimer.Start();
+		lastStatistics = statistics;
+	}
+
+	GLuint totalWorkers = TaskScheduler::Instance()->GetTotalWorkers();
+	ImGui::Text("Task scheduler: %u workers, %u tasks cancelled", totalWorkers, TaskScheduler::Instance()->GetTotalCancelledTasks());
+
+	for (size_t i = 0; i < intervalStatistics.size(); i++)
+	{
+		const TaskScheduler::WorkerStatistics& statistics = intervalStatistics[i];
+		float utilization = (intervalMilliseconds > 0.0) ? static_cast<float>(statistics.busyMilliseconds / intervalMilliseconds) : 0.0f;
+
+		if (i < totalWorkers)
+		{
+			ImGui::Text("Worker %u: %u tasks, %u stolen", static_cast<GLuint>(i + 1), statistics.totalTasks, statistics.totalStolenTasks);
+		}
+		else
+		{
+			ImGui::Text("Waiting threads: %u tasks, %u stolen", statistics.totalTasks, statistics.totalStolenTasks);
+		}
+
+		//several threads may wait at once, so theirs can add up to more than one core
+		ImGui::ProgressBar(std::min(utilization, 1.0f), ImVec2(-1.0f, 0.0f));
+	}
+}
+
+/// <summary>
+/// renders the profiler overlay in the top left corner of the scene, listing the last convolution, 
+/// the load of the task scheduler and the OpenGL calls of the last frame
+/// </summary>
+void RenderProfilerOverlay()
+{
+	if (!isProfilerShown)
+	{
+		return;
+	}
+
+	ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
+	ImGui::SetNextWindowSize(ImVec2(380, 420), ImGuiCond_FirstUseEver);
+	ImGui::SetNextWindowBgAlpha(0.8f);
+
+	ImGui::Begin("Profiler", &isProfilerShown);
+
+	RenderConvolutionStats();
+	ImGui::Separator();
+	RenderSchedulerStats();
+	ImGui::Separator();
+
+	if (!GLProfiler::Instance()->IsInstalled())
+	{
+		ImGui::TextWrapped("Run the application with the '--profile-gl' argument to count the OpenGL calls of each frame.");
+		ImGui::End();
+		return;
+	}
+
+	bool isTiming = GLProfiler::Instance()->IsTiming();
+
+	if (ImGui::Checkbox("Time driver calls", &isTiming))
+	{
+		GLProfiler::Instance()->SetTiming(isTiming);
+	}
+
+	ImGui::Text("OpenGL calls last frame: %u", GLProfiler::Instance()->GetTotalFrameCalls());
+
+	if (isTiming)
+	{
+		ImGui::Text("Time spent in the driver: %.3f ms", GLProfiler::Instance()->GetTotalFrameMilliseconds());
+	}
+
+	if (ImGui::BeginTable("OpenGL calls", isTiming ? 3 : 2,
+		ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY))
+	{
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed);
+
+		if (isTiming)
+		{
+			ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed);
+		}
+
+		ImGui::TableHeadersRow();
+
+		for (const GLProfiler::FunctionStats& stats : GLProfiler::Instance()->GetFrameStats())
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(stats.name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::Text("%u", stats.totalCalls);
+
+			if (isTiming)
+			{
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stats.milliseconds);
+			}
+		}
+
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
+/// <summary>
+/// height of an exported view of the given width, so the image keeps the shape of the view on screen
+/// </summary>
+GLsizei GetExportHeight(GLsizei exportWidth)
+{
+	return static_cast<GLsizei>(static_cast<double>(exportWidth) * SCREEN_HEIGHT / (SCREEN_WIDTH - PROPERTIES_WINDOW_WIDTH));
+}
+
+//the work on the 3d view asked for in the properties window, which runs on the render thread between frames 
+//and ends on the main thread, so the window goes on meanwhile. Each button waits for its last task to be done
+struct ViewTasks
+{
+	AsyncTask<> exportView;
+	AsyncTask<> switchCapture;
+	std::string exportStatus; //the outcome of the last export
+};
+
+/// <summary>
+/// renders the quad as seen by the camera into a png file, which may be far larger than the screen. 
+/// The quad is exported where it is when this is called, and the export runs on the render thread, a band of tiles between frames
+/// </summary>
+/// <param name="quad">the quad contaning the image texture</param>
+/// <param name="camera">the camera the quad is viewed with</param>
+/// <param name="filename">path of the png file</param>
+/// <param name="status">set on the main thread once the export is done</param>
+AsyncTask<> ExportView(Quad& quad, const Camera& camera, std::string filename, GLsizei width, GLsizei height, std::string& status)
+{
+	TiledExporter exporter;
+
+	quad.Update();
+	glm::mat4 model = quad.GetModel();
+
+	bool isExported = co_await exporter.Export(filename, width, height, camera, [&quad, model]() { quad.Render(model); });
+	co_await ResumeOnMainThread();
+
+	status = isExported ? "Exported " + filename : "Could not export " + filename;
+}
+
+/// <summary>
+/// starts recording the 3d view into a file on the render thread, which reads back the frames
+/// </summary>
+AsyncTask<> StartCapture(FrameCapture& capture, std::string filename)
+{
+	co_await ResumeOnRenderThread();
+	capture.Start(filename, 0, 0, SCREEN_WIDTH - PROPERTIES_WINDOW_WIDTH, SCREEN_HEIGHT, CAPTURE_FRAMES_PER_SECOND);
+	co_await ResumeOnMainThread();
+}
+
+/// <summary>
+/// stops recording the 3d view on the render thread, after the frame it is drawing
+/// </summary>
+AsyncTask<> StopCapture(FrameCapture& capture)
+{
+	co_await ResumeOnRenderThread();
+	capture.Stop();
+	co_await ResumeOnMainThread();
+}
+
+/// <summary>
+/// resumes the coroutines back on the main thread until the task is done, for work that has to end before going on
+/// </summary>
+void WaitFor(const AsyncTask<>& task)
+{
+	while (!task.IsDone())
+	{
+		if (!MainThread::Instance()->RunPending())
+		{
+			SDL_Delay(1);
+		}
+	}
+}
 
 /// <summary>
 /// renders the properties window, updating the properties of the quad according the input by the user
 /// </summary>
 /// <param name="quad">the quad contaning the image texture</param>
-void RenderPropertiesWindow(Quad& quad)
+/// <param name="camera">the camera the quad is viewed with</param>
+/// <param name="capture">records the 3d view while the user interacts with it</param>
+/// <param name="viewTasks">the export and capture of the 3d view in progress</param>
+/// <param name="frameBudget">the time effects may take of each frame while they are time-sliced</param>
+/// <param name="previewResolution">the resolution slow effects are previewed at</param>
+void RenderPropertiesWindow(Quad& quad, const Camera& camera, FrameCapture& capture, ViewTasks& viewTasks, 
+	                        FrameBudget& frameBudget, PreviewResolution& previewResolution)
 {
-	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplSDL2_NewFrame();
 	ImGui::NewFrame();
 
@@ -38,6 +356,13 @@ void RenderPropertiesWindow(Quad& quad)
 	static bool isInvert = false;
 	static bool isLockAR = false;
 	static float blurPercent = 0.0f;
+	static int blurMethod = 0;
+	static float boxBlurPercent = 0.0f;
+	static float denoiseLevel = 0.0f;
+	static int kernelType = 0;
+	static int kernelSize = 31;
+	static float kernelAngle = 0.0f;
+	static float sharpenAmount = 1.0f;
 
 
 	//buttons for loading and saving images//////////////////////////////////////
@@ -51,11 +376,17 @@ void RenderPropertiesWindow(Quad& quad)
 				imageLoaded = true;
 				isInvert = false;
 				blurPercent = 0.0f;
+				boxBlurPercent = 0.0f;
+				denoiseLevel = 0.0f;
 				quad.LoadNewTexture(std::string(filename));
 			}
 			else
 			{
+#if defined(_WIN32)
 				MessageBoxW(NULL, L"File type not supported", L"File Path", MB_OK);
+#else
+				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_WARNING, "File Path", "File type not supported", nullptr);
+#endif
 			}
 		}
 		
@@ -85,6 +416,66 @@ void RenderPropertiesWindow(Quad& quad)
 		}
 	}
 
+	//the 3d view as seen on screen, at print resolution
+	static int exportWidth = 16384;
+	ImGui::InputInt("Export width", &exportWidth, 1024, 4096);
+	exportWidth = std::clamp(exportWidth, 1, 65536);
+
+	if (!viewTasks.exportView.IsDone())
+	{
+		ImGui::Text("Exporting...");
+	}
+	else if (ImGui::Button("Export 3D view"))
+	{
+		char filename[MAX_PATH];
+		if (SaveFileDialog(filename) >= 0)
+		{
+			viewTasks.exportView = ExportView(quad, camera, filename, exportWidth, GetExportHeight(exportWidth), viewTasks.exportStatus);
+			viewTasks.exportView.Start();
+		}
+	}
+
+	ImGui::SameLine();
+	ImGui::Text("%d x %d png", exportWidth, GetExportHeight(exportWidth));
+
+	if (!viewTasks.exportStatus.empty())
+	{
+		ImGui::TextWrapped("%s", viewTasks.exportStatus.c_str());
+	}
+
+	//the 3d view as seen on screen, frame by frame
+	if (!viewTasks.switchCapture.IsDone())
+	{
+		ImGui::Text(capture.IsCapturing() ? "Stopping capture..." : "Starting capture...");
+	}
+	else if (!capture.IsCapturing())
+	{
+		if (ImGui::Button("Start capture"))
+		{
+			char filename[MAX_PATH];
+			if (SaveFileDialog(filename) >= 0)
+			{
+				viewTasks.switchCapture = StartCapture(capture, filename);
+				viewTasks.switchCapture.Start();
+			}
+		}
+
+		ImGui::SameLine();
+		ImGui::Text("png, qoi or y4m");
+	}
+	else
+	{
+		if (ImGui::Button("Stop capture"))
+		{
+			viewTasks.switchCapture = StopCapture(capture);
+			viewTasks.switchCapture.Start();
+		}
+
+		ImGui::SameLine();
+		ImGui::Text("%u frames, %u dropped, %.2f ms", 
+			capture.GetTotalCapturedFrames(), capture.GetTotalDroppedFrames(), capture.GetCaptureMilliseconds());
+	}
+
 	ImGui::Separator();
 	//sliders for controling the position, rotation and scale of the images
 	auto position = quad.GetPosition(); 
@@ -128,6 +519,81 @@ void RenderPropertiesWindow(Quad& quad)
 	ImGui::Separator();
 	/////////////post processing effects: color inversion and guassian blur///////////////////////
 
+	//images load and effects apply on the workers, while the previous result is still shown. 
+	//Time-sliced effects show their rows as they are done instead
+	GLfloat slicedProgress = 0.0f;
+	if (quad.GetSlicedProgress(slicedProgress))
+	{
+		ImGui::Text("Applying... %.0f%%", slicedProgress * 100.0f);
+	}
+	else
+	{
+		ImGui::TextUnformatted(quad.IsBusy() ? "Applying..." : "Ready");
+	}
+
+	//time-sliced effects run on the main thread, a few rows at a time within the budget of each frame, 
+	//which keeps the frames short where the workers would take the core the UI needs
+	bool isSlicing = frameBudget.IsSlicing();
+	if (ImGui::Checkbox("Time-sliced effects", &isSlicing))
+	{
+		frameBudget.SetSlicing(isSlicing);
+	}
+
+	if (isSlicing)
+	{
+		float maxBudget = static_cast<float>(frameBudget.GetMaxMilliseconds());
+		if (ImGui::SliderFloat("Budget (ms)", &maxBudget, 1.0f, 16.0f, "%.1f", ImGuiSliderFlags_AlwaysClamp))
+		{
+			frameBudget.SetMaxMilliseconds(maxBudget);
+		}
+
+		bool isAdaptive = frameBudget.IsAdaptive();
+		if (ImGui::Checkbox("Adapt to frame time", &isAdaptive))
+		{
+			frameBudget.SetAdaptive(isAdaptive);
+		}
+
+		ImGui::Text("Budget %.1f ms, effects took %.1f ms of a %.1f ms frame", frameBudget.GetMilliseconds(), 
+			frameBudget.GetLastUsedMilliseconds(), frameBudget.GetLastFrameMilliseconds());
+	}
+
+	//effects slower than the target latency are previewed on the image scaled down, and sharpen once the input settles
+	bool isAdaptivePreview = previewResolution.IsAdaptive();
+	if (ImGui::Checkbox("Adaptive preview resolution", &isAdaptivePreview))
+	{
+		previewResolution.SetAdaptive(isAdaptivePreview);
+	}
+
+	if (isAdaptivePreview)
+	{
+		float targetLatency = static_cast<float>(previewResolution.GetTargetLatencyMilliseconds());
+		if (ImGui::SliderFloat("Preview latency (ms)", &targetLatency, 10.0f, 500.0f, "%.0f", ImGuiSliderFlags_AlwaysClamp))
+		{
+			previewResolution.SetTargetLatencyMilliseconds(targetLatency);
+		}
+
+		float settleTime = static_cast<float>(previewResolution.GetSettleMilliseconds());
+		if (ImGui::SliderFloat("Sharpen after (ms)", &settleTime, 0.0f, 2000.0f, "%.0f", ImGuiSliderFlags_AlwaysClamp))
+		{
+			previewResolution.SetSettleMilliseconds(settleTime);
+		}
+
+		ImGui::Text("Preview scale 1/%d, last effect %.0f ms at 1/%d, %.0f ms estimated at full", previewResolution.GetScaleFactor(), 
+			previewResolution.GetLastLatencyMilliseconds(), previewResolution.GetLastLatencyScaleFactor(), 
+			previewResolution.GetEstimatedMilliseconds());
+	}
+
+	//changing the working format removes the effects, as they were computed in the previous format
+	bool isLinear = (quad.GetWorkingFormat() == Texture::WorkingFormat::LinearFloat);
+	if (ImGui::Checkbox("Linear-light effects", &isLinear))
+	{
+		quad.SetWorkingFormat(isLinear ? Texture::WorkingFormat::LinearFloat : Texture::WorkingFormat::Gamma8);
+		isInvert = false;
+		blurPercent = 0.0f;
+		boxBlurPercent = 0.0f;
+		denoiseLevel = 0.0f;
+	}
+
 	if (ImGui::Checkbox("Invert colors", &isInvert))
 	{
 		if (imageLoaded)
@@ -140,21 +606,146 @@ void RenderPropertiesWindow(Quad& quad)
 		}
 	}
 
-	if (ImGui::SliderFloat("Gaussian Blur", &blurPercent, 0.00f, 5.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp))
+	bool isBlurChanged = ImGui::Combo("Blur method", &blurMethod, BLUR_METHOD_NAMES, IM_ARRAYSIZE(BLUR_METHOD_NAMES)) && blurPercent > 0.0f;
+	float maxBlurPercent = (blurMethod == 0) ? MAX_EXACT_BLUR_PERCENT : MAX_PYRAMID_BLUR_PERCENT;
+	blurPercent = std::min(blurPercent, maxBlurPercent);
+
+	//the pixels the exact blur reads beyond the edges of the image, where the pyramid blur always repeats the edge pixels
+	if (blurMethod == 0)
+	{
+		int edgeMode = static_cast<int>(quad.GetEdgeMode());
+
+		if (ImGui::Combo("Edges", &edgeMode, EDGE_MODE_NAMES, IM_ARRAYSIZE(EDGE_MODE_NAMES)))
+		{
+			quad.SetEdgeMode(static_cast<EdgeMode>(edgeMode));
+			isBlurChanged = isBlurChanged || blurPercent > 0.0f;
+		}
+	}
+
+	isBlurChanged = ImGui::SliderFloat("Gaussian Blur", &blurPercent, 0.00f, maxBlurPercent, "%.2f", ImGuiSliderFlags_AlwaysClamp) || isBlurChanged;
+
+	if (isBlurChanged)
+	{
+		if (imageLoaded)
+		{
+			ApplyBlur(quad, blurMethod, blurPercent, isInvert);
+			boxBlurPercent = 0.0f;
+			denoiseLevel = 0.0f;
+		}
+		else
+		{
+			blurPercent = 0.0f;
+		}
+	}
+	else if (imageLoaded && blurMethod == 0)
+	{
+		//while the slider is idle, spare cores blur the image for the steps next to it
+		quad.SpeculateBlur(maxBlurPercent);
+	}
+
+	if (blurMethod == 0)
+	{
+		BlurCache::Statistics blurCacheStatistics = quad.GetBlurCacheStatistics();
+		ImGui::Text("Blur cache: %u hits, %u misses (%.0f%%), %u blurs, %.1f of %.0f MB", 
+			blurCacheStatistics.totalHits, blurCacheStatistics.totalMisses, blurCacheStatistics.GetHitRate() * 100.0f, 
+			blurCacheStatistics.totalEntries, blurCacheStatistics.memoryUsed / (1024.0 * 1024.0), 
+			blurCacheStatistics.memoryBudget / (1024.0 * 1024.0));
+	}
+
+	//blurs that take a while are kept on disk across sessions, shared with other instances
+	EffectCache::Statistics effectCacheStatistics = EffectCache::Instance()->GetStatistics();
+	ImGui::Text("Disk cache: %u hits, %u misses, %.0f of %.0f MB", effectCacheStatistics.totalHits, effectCacheStatistics.totalMisses, 
+		effectCacheStatistics.size / (1024.0 * 1024.0), EffectCache::Instance()->GetMaxSize() / (1024.0 * 1024.0));
+	ImGui::SameLine();
+
+	if (ImGui::SmallButton("Clear"))
+	{
+		EffectCache::Instance()->Clear();
+	}
+
+	//the box blur and the denoising read the summed-area table of the image, built on first use, 
+	//so dragging their sliders costs the same at any radius
+	if (ImGui::SliderFloat("Box Blur", &boxBlurPercent, 0.00f, 5.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp))
 	{
 		if (imageLoaded)
 		{
-			quad.Blur(blurPercent, isInvert);
+			quad.BoxBlur(boxBlurPercent, isInvert);
+			blurPercent = 0.0f;
+			denoiseLevel = 0.0f;
 		}
 		else
 		{
+			boxBlurPercent = 0.0f;
+		}
+	}
+
+	if (ImGui::SliderFloat("Denoise", &denoiseLevel, 0.00f, 0.2f, "%.3f", ImGuiSliderFlags_AlwaysClamp))
+	{
+		if (imageLoaded)
+		{
+			quad.Denoise(DENOISE_RADIUS, denoiseLevel, isInvert);
 			blurPercent = 0.0f;
+			boxBlurPercent = 0.0f;
+		}
+		else
+		{
+			denoiseLevel = 0.0f;
 		}
 	}
 
+	//kernels are applied on top of the current effects, until one of the sliders above computes the effects anew
+	ImGui::Combo("Kernel", &kernelType, KERNEL_NAMES, IM_ARRAYSIZE(KERNEL_NAMES));
+	ImGui::SliderInt("Kernel size", &kernelSize, 3, 201, "%d px", ImGuiSliderFlags_AlwaysClamp);
+
+	if (kernelType == 0)
+	{
+		ImGui::SliderFloat("Angle", &kernelAngle, 0.0f, 180.0f, "%.0f deg", ImGuiSliderFlags_AlwaysClamp);
+	}
+	else if (kernelType == 2)
+	{
+		ImGui::SliderFloat("Amount", &sharpenAmount, 0.0f, 4.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+	}
+
+	if (ImGui::Button("Apply kernel") && imageLoaded)
+	{
+		quad.Convolve(CreateKernel(kernelType, kernelSize, kernelAngle, sharpenAmount));
+	}
+
+	ImGui::Separator();
+
+	ImGui::Text("GL state calls last frame: %u issued, %u elided",
+		GLState::GetTotalIssuedCalls(), GLState::GetTotalElidedCalls());
+
+	//the main thread builds the next frame meanwhile, so this is not added to the time of a frame
+	ImGui::Text("Render thread: %.2f ms to draw and present the last frame", RenderThread::Instance()->GetLastFrameMilliseconds());
+
+	ImGui::Checkbox("Show profiler", &isProfilerShown);
+
 	ImGui::End();
+
+	RenderProfilerOverlay();
+
 	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
+
+/// <summary>
+/// draws a frame from its state on the render thread: the GUI, the quad, and the frame read back by the capture
+/// </summary>
+/// <param name="quad">the quad contaning the image texture</param>
+/// <param name="capture">records the 3d view while the user interacts with it</param>
+/// <param name="frameState">the state of the scene the main thread filled in for the frame</param>
+void RenderFrame(Quad& quad, FrameCapture& capture, FrameState& frameState)
+{
+	ImGui_ImplOpenGL3_NewFrame();
+
+	if (ImDrawData* drawData = frameState.gui.Get())
+	{
+		ImGui_ImplOpenGL3_RenderDrawData(drawData);
+	}
+
+	quad.Render(frameState.quadModel);
+
+	capture.CaptureFrame();
 }
 
 /// <summary>
@@ -166,7 +757,12 @@ bool ProcessEvent()
 	SDL_Event event;
 
 	SDL_PollEvent(&event);
-	ImGui_ImplSDL2_ProcessEvent(&event);
+
+	//headless screens have no GUI
+	if (!Screen::Instance()->IsHeadless())
+	{
+		ImGui_ImplSDL2_ProcessEvent(&event);
+	}
 
 	if (event.type == SDL_QUIT)
 	{
@@ -175,61 +771,367 @@ bool ProcessEvent()
 	return true;
 }
 
-int main(int argc, char* argv[])
+/// <summary>
+/// checks whether the application was started with the given command line argument
+/// </summary>
+bool HasArgument(int argc, char* argv[], const std::string& argument)
 {
+	for (int i = 1; i < argc; i++)
+	{
+		if (argument == argv[i])
+		{
+			return true;
+		}
+	}
 
-	Screen::Instance()->Initialize();
-	
-	if (!Shader::Instance()->CreateProgram())
+	return false;
+}
+
+/// <summary>
+/// finds the value following the given command line argument
+/// </summary>
+/// <returns>returns the value, or an empty string if the argument or its value is missing</returns>
+std::string GetArgumentValue(int argc, char* argv[], const std::string& argument)
+{
+	for (int i = 1; i < argc - 1; i++)
 	{
-		return 0;
+		if (argument == argv[i])
+		{
+			return argv[i + 1];
+		}
 	}
 
-	if (!Shader::Instance()->CreateShaders())
+	return "";
+}
+
+/// <summary>
+/// records a full turn of the quad around its vertical axis, rendered on a headless screen
+/// </summary>
+/// <param name="quad">the quad contaning the image texture</param>
+/// <param name="filename">path of the video, or of the first image of the sequence</param>
+/// <param name="totalFrames">number of frames in a full turn</param>
+void CaptureTurntable(Quad& quad, const std::string& filename, GLuint totalFrames)
+{
+	FrameCapture capture;
+
+	//nobody watches a headless screen, so every frame is kept however long it takes to write
+	capture.SetDroppingFrames(false);
+
+	if (!capture.Start(filename, 0, 0, SCREEN_WIDTH - PROPERTIES_WINDOW_WIDTH, SCREEN_HEIGHT, CAPTURE_FRAMES_PER_SECOND))
 	{
-		return 0;
+		return;
 	}
-	
-	if (!Shader::Instance()->CompileShaders("Shaders/Main.vert", Shader::ShaderType::VERTEX_SHADER))
+
+	auto rotation = quad.GetRotation();
+	Timer timer;
+
+	for (GLuint i = 0; i < totalFrames; i++)
 	{
-		return 0;
+		Screen::Instance()->ClearScreen();
+
+		quad.SetRotation(rotation.x, rotation.y + 360.0f * i / totalFrames, rotation.z);
+		quad.Update();
+		quad.Render();
+
+		capture.CaptureFrame();
+
+		Screen::Instance()->Present();
 	}
 
-	if (!Shader::Instance()->CompileShaders("Shaders/Main.frag", Shader::ShaderType::FRAGMENT_SHADER))
+	std::cout << "Turntable: " << totalFrames << " frames rendered in " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+
+	capture.Stop();
+	quad.SetRotation(rotation.x, rotation.y, rotation.z);
+}
+
+/// <summary>
+/// renders a single frame of the quad on a headless screen and saves it to a png file. 
+/// The image, its effects and the output file are given by the '--image', '--invert', '--blur' and '--output' arguments, 
+/// '--gamma8' computes the effects on 8-bit values, and '--edge-mode' sets the pixels the blur reads beyond the edges. 
+/// The '--export' argument also exports the view at the resolution given by '--export-width' and '--export-height', 
+/// and the '--capture' argument records a turntable of the quad in as many frames as given by '--capture-frames'
+/// </summary>
+/// <param name="quad">the quad contaning the image texture</param>
+/// <param name="camera">the camera the quad is viewed with</param>
+void RenderHeadlessFrame(Quad& quad, const Camera& camera, int argc, char* argv[])
+{
+	std::string imageFilename = GetArgumentValue(argc, argv, "--image");
+	std::string outputFilename = GetArgumentValue(argc, argv, "--output");
+
+	if (outputFilename.empty())
+	{
+		outputFilename = "headless.png";
+	}
+
+	//the '--gamma8' argument computes the effects on 8-bit values, as the application did before linear light
+	if (HasArgument(argc, argv, "--gamma8"))
+	{
+		quad.SetWorkingFormat(Texture::WorkingFormat::Gamma8);
+	}
+
+	std::string edgeMode = GetArgumentValue(argc, argv, "--edge-mode");
+
+	if (!edgeMode.empty())
+	{
+		quad.SetEdgeMode(static_cast<EdgeMode>(std::clamp(std::atoi(edgeMode.c_str()), 0, IM_ARRAYSIZE(EDGE_MODE_NAMES) - 1)));
+	}
+
+	if (!imageFilename.empty())
+	{
+		quad.LoadNewTexture(imageFilename);
+
+		//same order as the properties window: the blur is applied on top of the inverted colors
+		bool isInvert = HasArgument(argc, argv, "--invert");
+
+		if (isInvert)
+		{
+			quad.InvertColors();
+		}
+
+		std::string blurPercent = GetArgumentValue(argc, argv, "--blur");
+
+		if (!blurPercent.empty())
+		{
+			//the '--blur-method' argument picks the method by its index in BLUR_METHOD_NAMES
+			std::string blurMethod = GetArgumentValue(argc, argv, "--blur-method");
+
+			ApplyBlur(quad, std::atoi(blurMethod.c_str()), static_cast<GLfloat>(std::atof(blurPercent.c_str())), isInvert);
+		}
+
+		std::string boxBlurPercent = GetArgumentValue(argc, argv, "--box-blur");
+
+		if (!boxBlurPercent.empty())
+		{
+			quad.BoxBlur(static_cast<GLfloat>(std::atof(boxBlurPercent.c_str())), isInvert);
+		}
+
+		std::string denoiseLevel = GetArgumentValue(argc, argv, "--denoise");
+
+		if (!denoiseLevel.empty())
+		{
+			quad.Denoise(DENOISE_RADIUS, static_cast<GLfloat>(std::atof(denoiseLevel.c_str())), isInvert);
+		}
+
+		//the '--kernel' argument applies one of the kernels of the properties window, by its index in KERNEL_NAMES
+		std::string kernelType = GetArgumentValue(argc, argv, "--kernel");
+
+		if (!kernelType.empty())
+		{
+			std::string kernelSize = GetArgumentValue(argc, argv, "--kernel-size");
+
+			quad.Convolve(CreateKernel(std::atoi(kernelType.c_str()), kernelSize.empty() ? 31 : std::atoi(kernelSize.c_str()), 30.0f, 1.0f));
+			quad.Finish();
+
+			Convolution::Stats stats = Convolution::Instance()->GetLastStats();
+			std::cout << "Convolution: " << stats.kernelWidth << "x" << stats.kernelHeight << " kernel, " 
+				      << Convolution::GetMethodName(stats.method) << " " << stats.milliseconds << " ms" << std::endl;
+		}
+	}
+
+	//the image and its effects are loaded and applied by the workers, and have to be shown in the single frame
+	quad.Finish();
+
+	Screen::Instance()->ClearScreen();
+
+	quad.Update();
+	quad.Render();
+
+	if (Screen::Instance()->SaveFramebuffer(outputFilename))
+	{
+		std::cout << "Headless frame saved to " << outputFilename << std::endl;
+	}
+
+	Screen::Instance()->Present();
+
+	std::string exportFilename = GetArgumentValue(argc, argv, "--export");
+
+	if (!exportFilename.empty())
+	{
+		std::string exportWidth = GetArgumentValue(argc, argv, "--export-width");
+		std::string exportHeight = GetArgumentValue(argc, argv, "--export-height");
+
+		GLsizei width = exportWidth.empty() ? 16384 : std::atoi(exportWidth.c_str());
+		GLsizei height = exportHeight.empty() ? GetExportHeight(width) : std::atoi(exportHeight.c_str());
+
+		std::string status;
+		AsyncTask<> exportView = ExportView(quad, camera, exportFilename, width, height, status);
+		exportView.Start();
+		WaitFor(exportView);
+	}
+
+	std::string captureFilename = GetArgumentValue(argc, argv, "--capture");
+
+	if (!captureFilename.empty())
+	{
+		std::string captureFrames = GetArgumentValue(argc, argv, "--capture-frames");
+
+		CaptureTurntable(quad, captureFilename, captureFrames.empty() ? 120 : std::atoi(captureFrames.c_str()));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	//a headless screen renders offscreen, so the benchmarks and effects also run on machines without a display
+	Screen::Backend backend = HasArgument(argc, argv, "--headless") ? Screen::Backend::Headless : Screen::Backend::Window;
+
+	if (!Screen::Instance()->Initialize(backend))
 	{
 		return 0;
 	}
 
-	Shader::Instance()->AttachShaders();
+	//wrapping the loader's function pointers has to happen after glad loaded them
+	if (HasArgument(argc, argv, "--profile-gl"))
+	{
+		GLProfiler::Instance()->Install();
+		isProfilerShown = true;
+	}
 	
-	if (!Shader::Instance()->LinkProgram())
+	Timer shaderTimer;
+
+	if (!Shader::Instance()->CreateProgram())
 	{
 		return 0;
 	}
 
-	//================================================================
-	//objects in the 3d space: quad and camera
-	Quad quad;
-	Camera camera;
-	camera.Set3DView();
-	camera.SetViewport(0, 0, SCREEN_WIDTH - PROPERTIES_WINDOW_WIDTH, SCREEN_HEIGHT);
+	//the program is only built from source when the binary cache has nothing usable for this driver
+	if (!Shader::Instance()->LoadProgramBinary(MAIN_VERTEX_SHADER, MAIN_FRAGMENT_SHADER))
+	{
+		if (!Shader::Instance()->CreateShaders())
+		{
+			return 0;
+		}
+
+		if (!Shader::Instance()->CompileShaderSource(MAIN_VERTEX_SHADER, Shader::ShaderType::VERTEX_SHADER))
+		{
+			return 0;
+		}
+
+		if (!Shader::Instance()->CompileShaderSource(MAIN_FRAGMENT_SHADER, Shader::ShaderType::FRAGMENT_SHADER))
+		{
+			return 0;
+		}
+
+		Shader::Instance()->AttachShaders();
+
+		if (!Shader::Instance()->LinkProgram())
+		{
+			return 0;
+		}
 
-	//================================================================
-	while (isAppRunning)
+		Shader::Instance()->SaveProgramBinary(MAIN_VERTEX_SHADER, MAIN_FRAGMENT_SHADER);
+	}
+
+	std::cout << "Startup: shader build " << shaderTimer.GetElapsedMilliseconds() << " ms" << std::endl;
+
+	//samplers of different types may not share a texture unit, so the atlas of instanced scenes gets its own
+	Shader::Instance()->SendUniformData("atlasImages", static_cast<GLint>(ImageAtlas::TEXTURE_UNIT));
+
+	//the thread that first asks for the main thread is taken for it, so it is asked here, before any coroutine starts
+	MainThread::Instance();
+
+	//large images are uploaded on a thread of their own, through a context sharing the screen's, or on the main thread if there is none
+	UploadThread::Instance()->Start();
+
+	//the quad, the capture and the work on the view own GL objects, so they are destroyed in this block, 
+	//before the shaders and the screen shut down
 	{
-		Screen::Instance()->ClearScreen();
+		//================================================================
+		//objects in the 3d space: quad and camera
+		//the time-sliced effects and the previews of the quad adapt to the frames of the loop
+		FrameBudget frameBudget;
+		PreviewResolution previewResolution(frameBudget);
 
-		isAppRunning = ProcessEvent();
+		Quad quad(frameBudget, previewResolution);
+		Camera camera;
+		camera.Set3DView();
+		camera.SetViewport(0, 0, SCREEN_WIDTH - PROPERTIES_WINDOW_WIDTH, SCREEN_HEIGHT);
 
-		RenderPropertiesWindow(quad);
+		FrameCapture capture;
+		ViewTasks viewTasks;
 
-		quad.Update();
-		quad.Render();
+		if (HasArgument(argc, argv, "--no-effect-cache"))
+		{
+			EffectCache::Instance()->SetEnabled(false);
+		}
 
-		Screen::Instance()->Present();
+		//effects are time-sliced by default on machines with two cores or fewer
+		if (HasArgument(argc, argv, "--time-slicing"))
+		{
+			frameBudget.SetSlicing(true);
+		}
+
+		if (HasArgument(argc, argv, "--no-time-slicing"))
+		{
+			frameBudget.SetSlicing(false);
+		}
+
+		if (HasArgument(argc, argv, "--no-adaptive-preview"))
+		{
+			previewResolution.SetAdaptive(false);
+		}
+
+		if (HasArgument(argc, argv, "--stress"))
+		{
+			isAppRunning = RunBenchmarks(camera, SCREEN_WIDTH - PROPERTIES_WINDOW_WIDTH, SCREEN_HEIGHT);
+		}
+
+		//a headless run saves a single frame instead of running the interactive loop
+		if (Screen::Instance()->IsHeadless())
+		{
+			RenderHeadlessFrame(quad, camera, argc, argv);
+			isAppRunning = false;
+		}
+
+		//the GUI builds its fonts and device objects with the context, before the render thread takes it over
+		if (isAppRunning)
+		{
+			ImGui_ImplOpenGL3_NewFrame();
+			RenderThread::Instance()->Start([&quad, &capture](FrameState& frameState) { RenderFrame(quad, capture, frameState); });
+		}
+
+		//================================================================
+		while (isAppRunning)
+		{
+			//the calls are counted by atomics, so the calls of every thread since the last frame are collected here
+			GLProfiler::Instance()->BeginFrame();
+
+			//the time-sliced effects resumed below run within the budget of the frame
+			frameBudget.BeginFrame();
+			previewResolution.BeginFrame(quad.IsBusy());
+
+			//the steps of loading images and applying effects that are back on the main thread
+			MainThread::Instance()->RunPending();
+
+			isAppRunning = ProcessEvent();
+
+			RenderPropertiesWindow(quad, camera, capture, viewTasks, frameBudget, previewResolution);
+
+			quad.Update();
+
+			//the render thread draws this frame while the next one is built
+			FrameState& frameState = RenderThread::Instance()->GetNextFrameState();
+			frameState.quadModel = quad.GetModel();
+			frameState.gui.Copy(ImGui::GetDrawData());
+			RenderThread::Instance()->SubmitFrameState();
+		}
+
+		//the context goes back to the main thread for the shutdown, where an export or a switch of the capture still in progress ends. 
+		//The pixel buffers of the capture, the upload buffer of the quad and the upload thread's context belong to the screen, 
+		//so the capture, the jobs of the quad and the upload thread end before the screen shuts down
+		RenderThread::Instance()->Stop();
+		WaitFor(viewTasks.exportView);
+		WaitFor(viewTasks.switchCapture);
+		capture.Stop();
+		quad.Finish();
+		UploadThread::Instance()->Stop();
+
+		//the loads and effects of the quad are done, so nothing awaits the I/O threads or submits tasks any more
+		IOThreads::Instance()->Stop();
+		TaskScheduler::Instance()->Stop();
 	}
 
 	Shader::Instance()->DetachShaders();
+	PyramidBlur::Instance()->DestroyGpuResources();
 	Shader::Instance()->DestroyShaders();
 	Shader::Instance()->DestroyProgram();
 
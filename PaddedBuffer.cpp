@@ -0,0 +1,44 @@
+#include "PaddedBuffer.h"
+
+GLsizei GetEdgeIndex(GLsizei index, GLsizei size, EdgeMode edgeMode)
+{
+	if (index >= 0 && index < size)
+	{
+		return index;
+	}
+
+	switch (edgeMode)
+	{
+	case EdgeMode::Clamp:
+		return std::min(std::max(index, 0), size - 1);
+
+	case EdgeMode::Mirror:
+	{
+		//the mirrored image repeats every two sizes, the second time backwards
+		GLsizei period = 2 * size;
+		GLsizei periodIndex = ((index % period) + period) % period;
+		return (periodIndex < size) ? periodIndex : period - 1 - periodIndex;
+	}
+
+	case EdgeMode::Wrap:
+		return ((index % size) + size) % size;
+
+	default:
+		return -1;
+	}
+}
+
+const char* GetEdgeModeName(EdgeMode edgeMode)
+{
+	switch (edgeMode)
+	{
+	case EdgeMode::Clamp:
+		return "clamp";
+	case EdgeMode::Mirror:
+		return "mirror";
+	case EdgeMode::Wrap:
+		return "wrap";
+	default:
+		return "zero";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "gl.h"
+
+//how the pixels beyond the edges of an image are made up: the nearest edge pixel, the image mirrored at its edges 
+//(repeating the edge pixel, like GL_MIRRORED_REPEAT), the image repeated, or zero
+enum class EdgeMode
+{
+	Clamp,
+	Mirror,
+	Wrap,
+	Zero
+};
+
+//the index of the pixel of an image of the given size that stands in for a pixel beyond its edges, 
+//or -1 if the edge mode makes it zero
+GLsizei GetEdgeIndex(GLsizei index, GLsizei size, EdgeMode edgeMode);
+
+const char* GetEdgeModeName(EdgeMode edgeMode);
+
+//an image with a halo of pixels around it, filled by an edge mode, so that filters reading up to the halo size 
+//beyond the edges need no bounds checks and run the same loop over every pixel. 
+//Rows are addressed from the first pixel inside the image, and row indices run from -haloY to height + haloY - 1
+template <typename T>
+class PaddedBuffer
+{
+
+public:
+
+	PaddedBuffer()
+	{
+		m_width = 0;
+		m_height = 0;
+		m_channels = 0;
+		m_haloX = 0;
+		m_haloY = 0;
+	}
+
+	/// <summary>
+	/// allocates the buffer, with every pixel zero
+	/// </summary>
+	void Create(GLsizei width, GLsizei height, GLuint channels, GLsizei haloX, GLsizei haloY)
+	{
+		m_width = width;
+		m_height = height;
+		m_channels = channels;
+		m_haloX = haloX;
+		m_haloY = haloY;
+		m_pixels.assign(GetPitch() * (height + 2 * haloY), T(0));
+	}
+
+	void Clear()
+	{
+		m_pixels.clear();
+		m_pixels.shrink_to_fit();
+		m_width = 0;
+		m_height = 0;
+	}
+
+	/// <summary>
+	/// copies rows of tightly packed pixels with the same channels into the image, converting them to the buffer's type, 
+	/// and fills the halo beside them. Rows can be set by several threads at once
+	/// </summary>
+	template <typename S>
+	void SetRows(const S* pixels, GLsizei firstRow, GLsizei lastRow, EdgeMode edgeMode)
+	{
+		size_t rowSize = static_cast<size_t>(m_width) * m_channels;
+
+		for (GLsizei i = firstRow; i < lastRow; ++i)
+		{
+			const S* sourceRow = pixels + i * rowSize;
+			T* row = GetRow(i);
+
+			for (size_t x = 0; x < rowSize; ++x)
+			{
+				row[x] = static_cast<T>(sourceRow[x]);
+			}
+
+			FillRowHalo(i, edgeMode);
+		}
+	}
+
+	/// <summary>
+	/// fills the halo beside a row of the image from the pixels in the row
+	/// </summary>
+	void FillRowHalo(GLsizei rowIndex, EdgeMode edgeMode)
+	{
+		T* row = GetRow(rowIndex);
+
+		for (GLsizei j = 0; j < m_haloX; ++j)
+		{
+			FillPixel(row, -1 - j, edgeMode);
+			FillPixel(row, m_width + j, edgeMode);
+		}
+	}
+
+	/// <summary>
+	/// fills the halo above and below the image from its rows, halo included, which fills the corners as well. 
+	/// The halo beside the rows has to be filled first
+	/// </summary>
+	void FillColumnHalo(EdgeMode edgeMode)
+	{
+		for (GLsizei i = 0; i < m_haloY; ++i)
+		{
+			FillRow(-1 - i, edgeMode);
+			FillRow(m_height + i, edgeMode);
+		}
+	}
+
+	T* GetRow(GLsizei rowIndex)
+	{
+		return &m_pixels[(rowIndex + m_haloY) * GetPitch() + m_haloX * m_channels];
+	}
+
+	const T* GetRow(GLsizei rowIndex) const
+	{
+		return &m_pixels[(rowIndex + m_haloY) * GetPitch() + m_haloX * m_channels];
+	}
+
+	//the whole buffer, halo included, from its first row
+	T* GetData() { return m_pixels.data(); }
+	const T* GetData() const { return m_pixels.data(); }
+
+	bool IsEmpty() const { return m_pixels.empty(); }
+	GLsizei GetWidth() const { return m_width; }
+	GLsizei GetHeight() const { return m_height; }
+	GLsizei GetPaddedWidth() const { return m_width + 2 * m_haloX; }
+	GLsizei GetPaddedHeight() const { return m_height + 2 * m_haloY; }
+	GLsizei GetHaloX() const { return m_haloX; }
+	GLsizei GetHaloY() const { return m_haloY; }
+
+	//the number of values in a row, halo included
+	size_t GetPitch() const { return static_cast<size_t>(m_width + 2 * m_haloX) * m_channels; }
+
+private:
+
+	void FillPixel(T* row, GLsizei pixelIndex, EdgeMode edgeMode)
+	{
+		GLsizei edgeIndex = GetEdgeIndex(pixelIndex, m_width, edgeMode);
+
+		T* pixel = row + pixelIndex * static_cast<GLsizei>(m_channels);
+
+		for (GLuint channel = 0; channel < m_channels; ++channel)
+		{
+			pixel[channel] = (edgeIndex >= 0) ? row[edgeIndex * m_channels + channel] : T(0);
+		}
+	}
+
+	void FillRow(GLsizei rowIndex, EdgeMode edgeMode)
+	{
+		GLsizei edgeIndex = GetEdgeIndex(rowIndex, m_height, edgeMode);
+		T* row = GetRow(rowIndex) - m_haloX * m_channels;
+
+		if (edgeIndex >= 0)
+		{
+			std::copy_n(GetRow(edgeIndex) - m_haloX * m_channels, GetPitch(), row);
+		}
+		else
+		{
+			std::fill_n(row, GetPitch(), T(0));
+		}
+	}
+
+	std::vector<T> m_pixels;
+	GLsizei m_width;
+	GLsizei m_height;
+	GLuint m_channels;
+	GLsizei m_haloX;
+	GLsizei m_haloY;
+
+};
\ No newline at end of file
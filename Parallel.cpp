@@ -0,0 +1,13 @@
+#include <algorithm>
+#include <thread>
+#include "Parallel.h"
+
+void ParallelFor(GLuint totalItems, const std::function<void(GLuint first, GLuint last)>& work, TaskPriority priority)
+{
+	TaskScheduler::Instance()->ParallelFor(totalItems, work, priority);
+}
+
+GLuint GetTotalParallelThreads()
+{
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
\ No newline at end of file
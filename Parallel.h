@@ -0,0 +1,13 @@
+#pragma once
+
+#include <functional>
+#include "gl.h"
+#include "TaskScheduler.h"
+
+//runs the work for all items on every core and waits for it. Items are handed out one at a time as threads finish 
+//their previous one, which keeps the threads busy when items take different times, such as tiles at the edges of an image. 
+//The work runs on the task scheduler, ahead of any less urgent work queued there
+void ParallelFor(GLuint totalItems, const std::function<void(GLuint first, GLuint last)>& work, 
+	             TaskPriority priority = TaskPriority::Interactive);
+
+GLuint GetTotalParallelThreads();
\ No newline at end of file
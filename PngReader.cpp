@@ -0,0 +1,609 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "PngReader.h"
+
+//deflate length and distance codes: the smallest value of each code and the number of extra bits following it
+static const Uint16 LENGTH_BASES[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	                                     35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const Uint8 LENGTH_EXTRA_BITS[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const Uint16 DISTANCE_BASES[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	                                       257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const Uint8 DISTANCE_EXTRA_BITS[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	                                           7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+//the order in which the lengths of the code length code are stored
+static const Uint8 CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+static const Uint32 MAX_CODE_LENGTH = 15;
+
+/// <summary>
+/// reads the bits of a deflate stream, least significant bit first
+/// </summary>
+class BitReader
+{
+
+public:
+
+	BitReader(const Uint8* data, size_t size)
+	{
+		m_data = data;
+		m_size = size;
+		m_position = 0;
+		m_buffer = 0;
+		m_totalBits = 0;
+		m_isOverrun = false;
+	}
+
+	/// <summary>
+	/// the next bits, without consuming them. Bits past the end of the data read as zeros
+	/// </summary>
+	Uint32 Peek(Uint32 totalBits)
+	{
+		while (m_totalBits < totalBits)
+		{
+			Uint64 byte = (m_position < m_size) ? m_data[m_position] : 0;
+			m_buffer |= byte << m_totalBits;
+			m_totalBits += 8;
+			m_position++;
+		}
+
+		return static_cast<Uint32>(m_buffer & ((static_cast<Uint64>(1) << totalBits) - 1));
+	}
+
+	void Consume(Uint32 totalBits)
+	{
+		m_buffer >>= totalBits;
+		m_totalBits -= totalBits;
+
+		//the buffered bits beyond the data are padding and may not be used
+		if (m_position > m_size && (m_position - m_size) * 8 > m_totalBits)
+		{
+			m_isOverrun = true;
+		}
+	}
+
+	Uint32 Read(Uint32 totalBits)
+	{
+		Uint32 bits = Peek(totalBits);
+		Consume(totalBits);
+		return bits;
+	}
+
+	/// <summary>
+	/// skips to the next byte boundary, where stored blocks start
+	/// </summary>
+	void AlignToByte()
+	{
+		Consume(m_totalBits % 8);
+	}
+
+	bool IsOverrun() const
+	{
+		return m_isOverrun;
+	}
+
+private:
+
+	const Uint8* m_data;
+	size_t m_size;
+	size_t m_position;
+	Uint64 m_buffer;
+	Uint32 m_totalBits;
+	bool m_isOverrun;
+
+};
+
+/// <summary>
+/// a table decoding a huffman code in a single lookup. Each entry holds the symbol of the code the entry's bits start with, 
+/// shifted left by 4, and the length of that code, or 0 where no code matches
+/// </summary>
+struct HuffmanTable
+{
+	std::vector<Uint16> entries;
+	Uint32 maxLength;
+};
+
+/// <summary>
+/// builds the decoding table of a canonical huffman code from the code lengths of its symbols
+/// </summary>
+/// <returns>returns false if the lengths do not describe a valid code</returns>
+static bool BuildTable(const Uint8* lengths, Uint32 totalSymbols, HuffmanTable& table)
+{
+	Uint32 totalCodes[MAX_CODE_LENGTH + 1] = { 0 };
+
+	for (Uint32 symbol = 0; symbol < totalSymbols; symbol++)
+	{
+		totalCodes[lengths[symbol]]++;
+	}
+
+	totalCodes[0] = 0;
+	table.maxLength = 1;
+
+	//the first code of each length, and a check that no length has more codes than fit
+	Uint32 nextCodes[MAX_CODE_LENGTH + 1] = { 0 };
+	Uint32 code = 0;
+	Sint32 remainingCodes = 1;
+
+	for (Uint32 length = 1; length <= MAX_CODE_LENGTH; length++)
+	{
+		code = (code + totalCodes[length - 1]) << 1;
+		nextCodes[length] = code;
+
+		remainingCodes = (remainingCodes << 1) - static_cast<Sint32>(totalCodes[length]);
+
+		if (remainingCodes < 0)
+		{
+			return false;
+		}
+
+		if (totalCodes[length] > 0)
+		{
+			table.maxLength = length;
+		}
+	}
+
+	table.entries.assign(static_cast<size_t>(1) << table.maxLength, 0);
+
+	for (Uint32 symbol = 0; symbol < totalSymbols; symbol++)
+	{
+		Uint32 length = lengths[symbol];
+
+		if (length == 0)
+		{
+			continue;
+		}
+
+		//deflate stores codes most significant bit first, so their bits are reversed for the lookup
+		Uint32 symbolCode = nextCodes[length]++;
+		Uint32 reversedCode = 0;
+
+		for (Uint32 i = 0; i < length; i++)
+		{
+			reversedCode = (reversedCode << 1) | ((symbolCode >> i) & 1);
+		}
+
+		for (size_t entry = reversedCode; entry < table.entries.size(); entry += static_cast<size_t>(1) << length)
+		{
+			table.entries[entry] = static_cast<Uint16>((symbol << 4) | length);
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// reads the next symbol of a huffman code
+/// </summary>
+/// <returns>returns the symbol, or -1 if the bits match no code</returns>
+static Sint32 DecodeSymbol(BitReader& reader, const HuffmanTable& table)
+{
+	Uint16 entry = table.entries[reader.Peek(table.maxLength)];
+	Uint32 length = entry & 15;
+
+	if (length == 0)
+	{
+		return -1;
+	}
+
+	reader.Consume(length);
+
+	return entry >> 4;
+}
+
+static Uint32 ReadBigEndian(const Uint8* bytes)
+{
+	return (static_cast<Uint32>(bytes[0]) << 24) | (static_cast<Uint32>(bytes[1]) << 16) | 
+		   (static_cast<Uint32>(bytes[2]) << 8) | bytes[3];
+}
+
+PngReader::PngReader()
+{
+	m_width = 0;
+	m_height = 0;
+	m_channels = 0;
+	m_bitDepth = 0;
+}
+
+/// <summary>
+/// reads a png file and its header. The pixels are decoded by ReadPixels
+/// </summary>
+/// <returns>returns false if the file is not a png this reader supports</returns>
+bool PngReader::Open(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file)
+	{
+		std::cout << "Error opening png file: " << filename << std::endl;
+		return false;
+	}
+
+	std::vector<Uint8> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	return Open(bytes, filename);
+}
+
+/// <summary>
+/// reads the header of a png file already read into memory, such as by an I/O thread. The pixels are decoded by ReadPixels
+/// </summary>
+/// <param name="filename">the file the bytes were read from, for the error messages</param>
+/// <returns>returns false if the file is not a png this reader supports</returns>
+bool PngReader::Open(const std::vector<Uint8>& bytes, const std::string& filename)
+{
+	const Uint8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+	if (bytes.size() < 33 || !std::equal(std::begin(signature), std::end(signature), bytes.begin()))
+	{
+		return false;
+	}
+
+	const Uint8 CHANNELS[] = { 1, 0, 3, 0, 2, 0, 4 };
+
+	m_compressedData.clear();
+	m_channels = 0;
+
+	for (size_t position = 8; position + 12 <= bytes.size();)
+	{
+		Uint32 size = ReadBigEndian(&bytes[position]);
+		std::string type(reinterpret_cast<const char*>(&bytes[position + 4]), 4);
+		const Uint8* data = &bytes[position + 8];
+
+		if (size > bytes.size() - position - 12)
+		{
+			std::cout << "Error: png file is truncated: " << filename << std::endl;
+			return false;
+		}
+
+		if (type == "IHDR" && size >= 13)
+		{
+			m_width = ReadBigEndian(data);
+			m_height = ReadBigEndian(data + 4);
+			m_bitDepth = data[8];
+
+			Uint8 colorType = data[9];
+			Uint8 interlace = data[12];
+
+			//palettes and interlaced rows are not supported
+			if ((m_bitDepth != 8 && m_bitDepth != 16) || colorType > 6 || CHANNELS[colorType] == 0 || interlace != 0 ||
+				m_width == 0 || m_height == 0)
+			{
+				return false;
+			}
+
+			m_channels = CHANNELS[colorType];
+		}
+		else if (type == "IDAT")
+		{
+			m_compressedData.insert(m_compressedData.end(), data, data + size);
+		}
+		else if (type == "IEND")
+		{
+			break;
+		}
+
+		position += static_cast<size_t>(size) + 12;
+	}
+
+	return (m_channels > 0) && !m_compressedData.empty();
+}
+
+/// <summary>
+/// decodes all rows of the image, from top to bottom, without any padding between them. 
+/// 16-bit values are stored most significant byte first, as in the file
+/// </summary>
+/// <returns>returns false if the image data is damaged</returns>
+bool PngReader::ReadPixels(std::vector<Uint8>& pixels)
+{
+	std::vector<Uint8> data;
+
+	if (!Inflate(data) || !Unfilter(data, pixels))
+	{
+		std::cout << "Error: png image data is damaged" << std::endl;
+		return false;
+	}
+
+	m_compressedData.clear();
+	m_compressedData.shrink_to_fit();
+
+	return true;
+}
+
+Uint32 PngReader::GetWidth() const
+{
+	return m_width;
+}
+
+Uint32 PngReader::GetHeight() const
+{
+	return m_height;
+}
+
+/// <summary>
+/// 1 for gray, 2 for gray and alpha, 3 for RGB and 4 for RGBA pixels
+/// </summary>
+Uint32 PngReader::GetChannels() const
+{
+	return m_channels;
+}
+
+Uint32 PngReader::GetBitDepth() const
+{
+	return m_bitDepth;
+}
+
+/// <summary>
+/// decompresses the zlib stream of the image, which holds the filtered rows
+/// </summary>
+bool PngReader::Inflate(std::vector<Uint8>& data)
+{
+	if (m_compressedData.size() < 6 || (m_compressedData[0] & 0x0F) != 8 || (m_compressedData[1] & 0x20) != 0 ||
+		((m_compressedData[0] << 8) | m_compressedData[1]) % 31 != 0)
+	{
+		return false;
+	}
+
+	size_t rowSize = static_cast<size_t>(m_width) * m_channels * (m_bitDepth / 8) + 1;
+	size_t dataSize = rowSize * m_height;
+
+	data.clear();
+	data.reserve(dataSize);
+
+	BitReader reader(m_compressedData.data() + 2, m_compressedData.size() - 2);
+
+	HuffmanTable literalTable;
+	HuffmanTable distanceTable;
+	bool isFinalBlock = false;
+
+	while (!isFinalBlock)
+	{
+		isFinalBlock = (reader.Read(1) == 1);
+		Uint32 blockType = reader.Read(2);
+
+		if (blockType == 0)
+		{
+			//stored block: the length, its complement, and the bytes as they are
+			reader.AlignToByte();
+			Uint32 length = reader.Read(16);
+
+			if ((reader.Read(16) ^ 0xFFFF) != length)
+			{
+				return false;
+			}
+
+			for (Uint32 i = 0; i < length; i++)
+			{
+				data.push_back(static_cast<Uint8>(reader.Read(8)));
+			}
+
+			continue;
+		}
+
+		Uint8 lengths[288 + 32];
+
+		if (blockType == 1)
+		{
+			std::fill(lengths, lengths + 144, 8);
+			std::fill(lengths + 144, lengths + 256, 9);
+			std::fill(lengths + 256, lengths + 280, 7);
+			std::fill(lengths + 280, lengths + 288, 8);
+			std::fill(lengths + 288, lengths + 320, 5);
+
+			BuildTable(lengths, 288, literalTable);
+			BuildTable(lengths + 288, 32, distanceTable);
+		}
+		else if (blockType == 2)
+		{
+			Uint32 totalLiteralCodes = reader.Read(5) + 257;
+			Uint32 totalDistanceCodes = reader.Read(5) + 1;
+			Uint32 totalCodeLengthCodes = reader.Read(4) + 4;
+
+			Uint8 codeLengthLengths[19] = { 0 };
+
+			for (Uint32 i = 0; i < totalCodeLengthCodes; i++)
+			{
+				codeLengthLengths[CODE_LENGTH_ORDER[i]] = static_cast<Uint8>(reader.Read(3));
+			}
+
+			HuffmanTable codeLengthTable;
+
+			if (!BuildTable(codeLengthLengths, 19, codeLengthTable))
+			{
+				return false;
+			}
+
+			//the code lengths of both codes form one sequence, in which runs are coded by symbols 16 to 18
+			Uint32 totalLengths = totalLiteralCodes + totalDistanceCodes;
+
+			for (Uint32 i = 0; i < totalLengths;)
+			{
+				Sint32 symbol = DecodeSymbol(reader, codeLengthTable);
+				Uint32 repeat = 1;
+				Uint8 length = 0;
+
+				if (symbol < 0)
+				{
+					return false;
+				}
+				else if (symbol < 16)
+				{
+					length = static_cast<Uint8>(symbol);
+				}
+				else if (symbol == 16)
+				{
+					if (i == 0)
+					{
+						return false;
+					}
+
+					length = lengths[i - 1];
+					repeat = 3 + reader.Read(2);
+				}
+				else if (symbol == 17)
+				{
+					repeat = 3 + reader.Read(3);
+				}
+				else
+				{
+					repeat = 11 + reader.Read(7);
+				}
+
+				if (i + repeat > totalLengths)
+				{
+					return false;
+				}
+
+				std::fill(lengths + i, lengths + i + repeat, length);
+				i += repeat;
+			}
+
+			if (!BuildTable(lengths, totalLiteralCodes, literalTable) || 
+				!BuildTable(lengths + totalLiteralCodes, totalDistanceCodes, distanceTable))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			return false;
+		}
+
+		while (true)
+		{
+			Sint32 symbol = DecodeSymbol(reader, literalTable);
+
+			if (symbol < 0 || symbol > 285 || reader.IsOverrun())
+			{
+				return false;
+			}
+
+			if (symbol < 256)
+			{
+				data.push_back(static_cast<Uint8>(symbol));
+				continue;
+			}
+
+			if (symbol == 256)
+			{
+				break;
+			}
+
+			Uint32 length = LENGTH_BASES[symbol - 257] + reader.Read(LENGTH_EXTRA_BITS[symbol - 257]);
+			Sint32 distanceSymbol = DecodeSymbol(reader, distanceTable);
+
+			if (distanceSymbol < 0 || distanceSymbol > 29)
+			{
+				return false;
+			}
+
+			Uint32 distance = DISTANCE_BASES[distanceSymbol] + reader.Read(DISTANCE_EXTRA_BITS[distanceSymbol]);
+
+			if (distance > data.size() || data.size() + length > dataSize)
+			{
+				return false;
+			}
+
+			//matches may overlap the bytes they produce, so they are copied byte by byte
+			size_t start = data.size() - distance;
+
+			for (Uint32 i = 0; i < length; i++)
+			{
+				data.push_back(data[start + i]);
+			}
+		}
+
+		if (data.size() > dataSize)
+		{
+			return false;
+		}
+	}
+
+	return (data.size() == dataSize) && !reader.IsOverrun();
+}
+
+/// <summary>
+/// undoes the filter of each row, which stored its bytes as differences from neighbouring bytes
+/// </summary>
+bool PngReader::Unfilter(std::vector<Uint8>& data, std::vector<Uint8>& pixels)
+{
+	size_t bytesPerPixel = static_cast<size_t>(m_channels) * (m_bitDepth / 8);
+	size_t rowSize = static_cast<size_t>(m_width) * bytesPerPixel;
+
+	pixels.resize(rowSize * m_height);
+
+	//the row above the first one counts as all zeros
+	std::vector<Uint8> zeroRow(rowSize, 0);
+
+	for (Uint32 row = 0; row < m_height; row++)
+	{
+		Uint8 filter = data[row * (rowSize + 1)];
+		const Uint8* filtered = &data[row * (rowSize + 1) + 1];
+		const Uint8* previous = (row > 0) ? &pixels[(row - 1) * rowSize] : zeroRow.data();
+		Uint8* current = &pixels[row * rowSize];
+
+		switch (filter)
+		{
+		case 0:
+			std::copy_n(filtered, rowSize, current);
+			break;
+
+		case 1:
+			std::copy_n(filtered, bytesPerPixel, current);
+
+			for (size_t i = bytesPerPixel; i < rowSize; i++)
+			{
+				current[i] = static_cast<Uint8>(filtered[i] + current[i - bytesPerPixel]);
+			}
+			break;
+
+		case 2:
+			for (size_t i = 0; i < rowSize; i++)
+			{
+				current[i] = static_cast<Uint8>(filtered[i] + previous[i]);
+			}
+			break;
+
+		case 3:
+			for (size_t i = 0; i < rowSize; i++)
+			{
+				int left = (i >= bytesPerPixel) ? current[i - bytesPerPixel] : 0;
+				current[i] = static_cast<Uint8>(filtered[i] + (left + previous[i]) / 2);
+			}
+			break;
+
+		case 4:
+			for (size_t i = 0; i < rowSize; i++)
+			{
+				int left = (i >= bytesPerPixel) ? current[i - bytesPerPixel] : 0;
+				int above = previous[i];
+				int aboveLeft = (i >= bytesPerPixel) ? previous[i - bytesPerPixel] : 0;
+
+				//paeth: whichever neighbour is closest to left + above - aboveLeft
+				int leftDistance = std::abs(above - aboveLeft);
+				int aboveDistance = std::abs(left - aboveLeft);
+				int aboveLeftDistance = std::abs(left + above - 2 * aboveLeft);
+				int prediction = aboveLeft;
+
+				if (leftDistance <= aboveDistance && leftDistance <= aboveLeftDistance)
+				{
+					prediction = left;
+				}
+				else if (aboveDistance <= aboveLeftDistance)
+				{
+					prediction = above;
+				}
+
+				current[i] = static_cast<Uint8>(filtered[i] + prediction);
+			}
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+//reads png files of 8 or 16 bits per channel, keeping all 16 bits that image loaders usually strip. 
+//Gray, gray with alpha, RGB and RGBA images without interlacing are supported, which covers what scanners and 
+//image editors write at 16 bits. Other pngs are left to SDL_image.
+class PngReader
+{
+
+public:
+
+	PngReader();
+
+	bool Open(const std::string& filename);
+	bool Open(const std::vector<Uint8>& bytes, const std::string& filename);
+	bool ReadPixels(std::vector<Uint8>& pixels);
+
+	Uint32 GetWidth() const;
+	Uint32 GetHeight() const;
+	Uint32 GetChannels() const;
+	Uint32 GetBitDepth() const;
+
+private:
+
+	PngReader(const PngReader&);
+
+	bool Inflate(std::vector<Uint8>& data);
+	bool Unfilter(std::vector<Uint8>& data, std::vector<Uint8>& pixels);
+
+	Uint32 m_width;
+	Uint32 m_height;
+	Uint32 m_channels;
+	Uint32 m_bitDepth;
+
+	//the zlib stream of all IDAT chunks
+	std::vector<Uint8> m_compressedData;
+
+};
\ No newline at end of file
@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <iostream>
+#include "PngWriter.h"
+
+//deflate length and distance codes: the smallest value of each code and the number of extra bits following it
+static const Uint16 LENGTH_BASES[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	                                     35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const Uint8 LENGTH_EXTRA_BITS[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const Uint16 DISTANCE_BASES[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	                                       257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const Uint8 DISTANCE_EXTRA_BITS[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	                                           7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static const size_t IDAT_CHUNK_SIZE = 65536;
+
+/// <summary>
+/// huffman codes are defined most significant bit first, while deflate packs bits starting from the least significant one
+/// </summary>
+static Uint32 ReverseBits(Uint32 code, Uint32 totalBits)
+{
+	Uint32 reversed = 0;
+
+	for (Uint32 i = 0; i < totalBits; i++)
+	{
+		reversed = (reversed << 1) | ((code >> i) & 1);
+	}
+
+	return reversed;
+}
+
+static Uint32 UpdateCrc(Uint32 crc, const Uint8* data, size_t size)
+{
+	static Uint32 table[256] = { 0 };
+
+	if (table[1] == 0)
+	{
+		for (Uint32 i = 0; i < 256; i++)
+		{
+			Uint32 value = i;
+
+			for (int bit = 0; bit < 8; bit++)
+			{
+				value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+			}
+
+			table[i] = value;
+		}
+	}
+
+	for (size_t i = 0; i < size; i++)
+	{
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+
+	return crc;
+}
+
+static void AppendBigEndian(std::vector<Uint8>& bytes, Uint32 value)
+{
+	bytes.push_back(static_cast<Uint8>(value >> 24));
+	bytes.push_back(static_cast<Uint8>(value >> 16));
+	bytes.push_back(static_cast<Uint8>(value >> 8));
+	bytes.push_back(static_cast<Uint8>(value));
+}
+
+PngWriter::PngWriter()
+{
+	m_width = 0;
+	m_height = 0;
+	m_channels = 0;
+	m_totalRowsWritten = 0;
+
+	m_position = 0;
+	m_inputBase = 0;
+	m_adlerA = 1;
+	m_adlerB = 0;
+
+	m_bitBuffer = 0;
+	m_totalBits = 0;
+}
+
+PngWriter::~PngWriter()
+{
+	if (m_file.is_open())
+	{
+		Close();
+	}
+}
+
+/// <summary>
+/// creates the png file and writes its header. The rows are then written from top to bottom with WriteRows
+/// </summary>
+/// <param name="channels">1 for gray, 2 for gray and alpha, 3 for RGB and 4 for RGBA pixels</param>
+/// <param name="bitDepth">8 or 16 bits per channel. 16-bit values are written most significant byte first</param>
+/// <returns>returns false if the file could not be created</returns>
+bool PngWriter::Open(const std::string& filename, Uint32 width, Uint32 height, Uint32 channels, Uint32 bitDepth)
+{
+	const Uint8 COLOR_TYPES[] = { 0, 4, 2, 6 };
+
+	if (channels < 1 || channels > 4 || (bitDepth != 8 && bitDepth != 16) || width == 0 || height == 0)
+	{
+		std::cout << "Error: unsupported png format" << std::endl;
+		return false;
+	}
+
+	m_file.open(filename, std::ios::binary);
+
+	if (!m_file)
+	{
+		std::cout << "Error creating png file: " << filename << std::endl;
+		return false;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_channels = channels;
+	m_totalRowsWritten = 0;
+
+	//the row above the first one counts as all zeros
+	m_previousRow.assign(static_cast<size_t>(width) * channels * (bitDepth / 8), 0);
+	m_filteredRow.resize(m_previousRow.size() + 1);
+
+	m_input.clear();
+	m_position = 0;
+	m_inputBase = 0;
+	m_hashHeads.assign(static_cast<size_t>(1) << HASH_BITS, -1);
+	m_adlerA = 1;
+	m_adlerB = 0;
+
+	m_data.clear();
+	m_bitBuffer = 0;
+	m_totalBits = 0;
+
+	const Uint8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	m_file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+	std::vector<Uint8> header;
+	AppendBigEndian(header, width);
+	AppendBigEndian(header, height);
+	header.push_back(static_cast<Uint8>(bitDepth));
+	header.push_back(COLOR_TYPES[channels - 1]);
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+	WriteChunk("IHDR", header.data(), header.size());
+
+	//zlib header, then a single final deflate block with fixed huffman codes that spans all rows
+	m_data.push_back(0x78);
+	m_data.push_back(0x01);
+	WriteBits(1, 1);
+	WriteBits(1, 2);
+
+	return m_file.good();
+}
+
+/// <summary>
+/// compresses and writes the next rows of the image
+/// </summary>
+/// <param name="pixels">the first row to write</param>
+/// <param name="totalRows">number of rows to write</param>
+/// <param name="pitch">distance in bytes between the starts of two rows</param>
+/// <returns>returns false if the rows do not fit in the image or could not be written</returns>
+bool PngWriter::WriteRows(const Uint8* pixels, Uint32 totalRows, size_t pitch)
+{
+	if (!m_file.is_open() || m_totalRowsWritten + totalRows > m_height)
+	{
+		std::cout << "Error writing png rows" << std::endl;
+		return false;
+	}
+
+	size_t rowSize = m_previousRow.size();
+
+	for (Uint32 row = 0; row < totalRows; row++)
+	{
+		const Uint8* pixelRow = pixels + row * pitch;
+
+		//the "up" filter stores each byte as its difference from the byte above it, turning flat areas into runs of zeros
+		m_filteredRow[0] = 2;
+
+		for (size_t i = 0; i < rowSize; i++)
+		{
+			m_filteredRow[i + 1] = static_cast<Uint8>(pixelRow[i] - m_previousRow[i]);
+		}
+
+		std::copy_n(pixelRow, rowSize, m_previousRow.begin());
+
+		for (Uint8 byte : m_filteredRow)
+		{
+			m_adlerA = (m_adlerA + byte) % 65521;
+			m_adlerB = (m_adlerB + m_adlerA) % 65521;
+		}
+
+		m_input.insert(m_input.end(), m_filteredRow.begin(), m_filteredRow.end());
+		Compress(false);
+	}
+
+	m_totalRowsWritten += totalRows;
+
+	return m_file.good();
+}
+
+/// <summary>
+/// compresses the remaining rows and finishes the file
+/// </summary>
+/// <returns>returns false if not all rows of the image were written, or the file could not be written</returns>
+bool PngWriter::Close()
+{
+	if (!m_file.is_open())
+	{
+		return false;
+	}
+
+	Compress(true);
+	WriteLiteral(256);
+
+	if (m_totalBits > 0)
+	{
+		m_data.push_back(static_cast<Uint8>(m_bitBuffer));
+		m_bitBuffer = 0;
+		m_totalBits = 0;
+	}
+
+	AppendBigEndian(m_data, (m_adlerB << 16) | m_adlerA);
+	FlushData(true);
+
+	WriteChunk("IEND", nullptr, 0);
+
+	bool isComplete = (m_totalRowsWritten == m_height) && m_file.good();
+	m_file.close();
+
+	if (!isComplete)
+	{
+		std::cout << "Error: png file is incomplete" << std::endl;
+	}
+
+	return isComplete;
+}
+
+Uint32 PngWriter::GetWidth() const
+{
+	return m_width;
+}
+
+Uint32 PngWriter::GetHeight() const
+{
+	return m_height;
+}
+
+void PngWriter::WriteChunk(const char* type, const Uint8* data, size_t size)
+{
+	std::vector<Uint8> length;
+	AppendBigEndian(length, static_cast<Uint32>(size));
+	m_file.write(reinterpret_cast<const char*>(length.data()), length.size());
+	m_file.write(type, 4);
+	m_file.write(reinterpret_cast<const char*>(data), size);
+
+	Uint32 crc = UpdateCrc(0xFFFFFFFFu, reinterpret_cast<const Uint8*>(type), 4);
+	crc = UpdateCrc(crc, data, size) ^ 0xFFFFFFFFu;
+
+	std::vector<Uint8> checksum;
+	AppendBigEndian(checksum, crc);
+	m_file.write(reinterpret_cast<const char*>(checksum.data()), checksum.size());
+}
+
+/// <summary>
+/// writes the compressed bytes in IDAT chunks, keeping a partial chunk back unless all bytes are flushed
+/// </summary>
+void PngWriter::FlushData(bool isAll)
+{
+	if (m_data.size() >= IDAT_CHUNK_SIZE || (isAll && !m_data.empty()))
+	{
+		WriteChunk("IDAT", m_data.data(), m_data.size());
+		m_data.clear();
+	}
+}
+
+/// <summary>
+/// encodes the buffered bytes as literals and back references into the previous 32K bytes. 
+/// Unless this is the final call, the last bytes are kept back so a match is never cut short by the end of the buffer
+/// </summary>
+void PngWriter::Compress(bool isFinal)
+{
+	size_t end = m_input.size();
+	size_t limit = isFinal ? end : (end > MAX_MATCH ? end - MAX_MATCH : 0);
+
+	while (m_position < limit)
+	{
+		Uint32 matchLength = 0;
+		Uint32 distance = 0;
+
+		if (m_position + MIN_MATCH <= end)
+		{
+			const Uint8* bytes = &m_input[m_position];
+			Uint32 hash = (((bytes[0] << 16) | (bytes[1] << 8) | bytes[2]) * 2654435761u) >> (32 - HASH_BITS);
+
+			Sint64 candidate = m_hashHeads[hash];
+			Sint64 absolutePosition = static_cast<Sint64>(m_inputBase + m_position);
+			m_hashHeads[hash] = absolutePosition;
+
+			if (candidate >= 0 && absolutePosition - candidate <= static_cast<Sint64>(WINDOW_SIZE))
+			{
+				const Uint8* matchBytes = &m_input[static_cast<size_t>(candidate - m_inputBase)];
+				Uint32 maxLength = static_cast<Uint32>(std::min<size_t>(MAX_MATCH, end - m_position));
+
+				while (matchLength < maxLength && matchBytes[matchLength] == bytes[matchLength])
+				{
+					matchLength++;
+				}
+
+				distance = static_cast<Uint32>(absolutePosition - candidate);
+			}
+		}
+
+		if (matchLength >= MIN_MATCH)
+		{
+			WriteMatch(matchLength, distance);
+			m_position += matchLength;
+		}
+		else
+		{
+			WriteLiteral(m_input[m_position]);
+			m_position++;
+		}
+	}
+
+	//only the deflate window before the current position is needed for later matches
+	if (m_position > 2 * WINDOW_SIZE)
+	{
+		size_t totalDropped = m_position - WINDOW_SIZE;
+		m_input.erase(m_input.begin(), m_input.begin() + totalDropped);
+		m_inputBase += totalDropped;
+		m_position -= totalDropped;
+	}
+
+	FlushData(false);
+}
+
+void PngWriter::WriteBits(Uint32 bits, Uint32 totalBits)
+{
+	m_bitBuffer |= static_cast<Uint64>(bits) << m_totalBits;
+	m_totalBits += totalBits;
+
+	while (m_totalBits >= 8)
+	{
+		m_data.push_back(static_cast<Uint8>(m_bitBuffer));
+		m_bitBuffer >>= 8;
+		m_totalBits -= 8;
+	}
+}
+
+/// <summary>
+/// writes a literal byte, end of block or length symbol with the fixed huffman codes of deflate
+/// </summary>
+void PngWriter::WriteLiteral(Uint32 symbol)
+{
+	if (symbol < 144)
+	{
+		WriteBits(ReverseBits(0x30 + symbol, 8), 8);
+	}
+	else if (symbol < 256)
+	{
+		WriteBits(ReverseBits(0x190 + symbol - 144, 9), 9);
+	}
+	else if (symbol < 280)
+	{
+		WriteBits(ReverseBits(symbol - 256, 7), 7);
+	}
+	else
+	{
+		WriteBits(ReverseBits(0xC0 + symbol - 280, 8), 8);
+	}
+}
+
+void PngWriter::WriteMatch(Uint32 length, Uint32 distance)
+{
+	Uint32 lengthCode = static_cast<Uint32>(std::upper_bound(LENGTH_BASES, LENGTH_BASES + 29, length) - LENGTH_BASES) - 1;
+	WriteLiteral(257 + lengthCode);
+	WriteBits(length - LENGTH_BASES[lengthCode], LENGTH_EXTRA_BITS[lengthCode]);
+
+	Uint32 distanceCode = static_cast<Uint32>(std::upper_bound(DISTANCE_BASES, DISTANCE_BASES + 30, distance) - DISTANCE_BASES) - 1;
+	WriteBits(ReverseBits(distanceCode, 5), 5);
+	WriteBits(distance - DISTANCE_BASES[distanceCode], DISTANCE_EXTRA_BITS[distanceCode]);
+}
\ No newline at end of file
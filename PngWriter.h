@@ -0,0 +1,66 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+//writes a png file row by row, so images far larger than memory can be encoded while they are produced.
+//Rows are compressed on the fly with a small deflate encoder (greedy LZ77 matches with fixed Huffman codes), 
+//which keeps no more than the 32K deflate window of the rows written so far.
+class PngWriter
+{
+
+public:
+
+	PngWriter();
+	~PngWriter();
+
+	bool Open(const std::string& filename, Uint32 width, Uint32 height, Uint32 channels, Uint32 bitDepth = 8);
+	bool WriteRows(const Uint8* pixels, Uint32 totalRows, size_t pitch);
+	bool Close();
+
+	Uint32 GetWidth() const;
+	Uint32 GetHeight() const;
+
+private:
+
+	PngWriter(const PngWriter&);
+
+	void WriteChunk(const char* type, const Uint8* data, size_t size);
+	void FlushData(bool isAll);
+
+	void Compress(bool isFinal);
+	void WriteBits(Uint32 bits, Uint32 totalBits);
+	void WriteLiteral(Uint32 symbol);
+	void WriteMatch(Uint32 length, Uint32 distance);
+
+	static const size_t WINDOW_SIZE = 32768;
+	static const Uint32 MIN_MATCH = 3;
+	static const Uint32 MAX_MATCH = 258;
+	static const Uint32 HASH_BITS = 15;
+
+	std::ofstream m_file;
+
+	Uint32 m_width;
+	Uint32 m_height;
+	Uint32 m_channels;
+	Uint32 m_totalRowsWritten;
+
+	std::vector<Uint8> m_previousRow;
+	std::vector<Uint8> m_filteredRow;
+
+	//uncompressed bytes: the deflate window followed by the bytes still to compress
+	std::vector<Uint8> m_input;
+	size_t m_position;
+	Uint64 m_inputBase;
+	std::vector<Sint64> m_hashHeads;
+	Uint32 m_adlerA;
+	Uint32 m_adlerB;
+
+	//compressed bytes not yet written in an IDAT chunk
+	std::vector<Uint8> m_data;
+	Uint64 m_bitBuffer;
+	Uint32 m_totalBits;
+
+};
\ No newline at end of file
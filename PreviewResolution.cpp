@@ -0,0 +1,228 @@
+#include <algorithm>
+#include "FrameBudget.h"
+#include "PreviewResolution.h"
+
+//a preview within about three frames at 60 hz keeps up with a slider being dragged
+static const double DEFAULT_TARGET_LATENCY_MILLISECONDS = 50.0;
+
+//a pause in a drag this long shows the full resolution
+static const double DEFAULT_SETTLE_MILLISECONDS = 300.0;
+
+//previews are scaled down by 8 at most, below which too little of the image is left to judge the effects by
+static const GLsizei MAX_LEVEL = 3;
+
+//the scale drops once effects take this share longer than the target, and rises once the finer scale would take this share less
+static const double LATENCY_HYSTERESIS = 0.25;
+
+//the weight of a new latency against the ones before it
+static const double LATENCY_SMOOTHING = 0.5;
+
+//frames this share over the target frame time while effects are applied are slow, and this many in a row drop the scale a step
+static const double FRAME_TIME_TOLERANCE = 0.5;
+static const GLuint MAX_SLOW_FRAMES = 3;
+
+//the scale only rises after this many frames without a change of it and without a slow frame
+static const GLuint MIN_FRAMES_BEFORE_RISE = 30;
+
+PreviewResolution::PreviewResolution(const FrameBudget& frameBudget) : m_frameBudget(frameBudget)
+{
+	m_isAdaptive = true;
+	m_targetLatencyMilliseconds = DEFAULT_TARGET_LATENCY_MILLISECONDS;
+	m_settleMilliseconds = DEFAULT_SETTLE_MILLISECONDS;
+
+	m_level = 0;
+	m_totalPixels = 0;
+	m_millisecondsPerPixel = 0.0;
+	m_lastLatencyMilliseconds = 0.0;
+	m_lastLatencyScaleFactor = 1;
+
+	m_totalSlowFrames = 0;
+	m_totalFramesSinceChange = 0;
+	m_totalFramesSinceSlow = 0;
+}
+
+/// <summary>
+/// counts the frames since the scale last changed, and the slow frames while effects are applied, 
+/// which drop the scale a step as soon as a few come in a row. Called after the frame budget's BeginFrame, which measured the last frame
+/// </summary>
+/// <param name="isApplyingEffects">an image is being loaded or effects are being applied</param>
+void PreviewResolution::BeginFrame(bool isApplyingEffects)
+{
+	m_totalFramesSinceChange++;
+	m_totalFramesSinceSlow++;
+
+	double maxFrameMilliseconds = m_frameBudget.GetTargetFrameMilliseconds() * (1.0 + FRAME_TIME_TOLERANCE);
+
+	if (!isApplyingEffects || m_frameBudget.GetLastFrameMilliseconds() <= maxFrameMilliseconds)
+	{
+		m_totalSlowFrames = 0;
+		return;
+	}
+
+	m_totalSlowFrames++;
+	m_totalFramesSinceSlow = 0;
+
+	if (m_isAdaptive && m_totalSlowFrames >= MAX_SLOW_FRAMES && m_level < MAX_LEVEL)
+	{
+		m_level++;
+		m_totalSlowFrames = 0;
+		m_totalFramesSinceChange = 0;
+	}
+}
+
+/// <summary>
+/// notes an input that changes the effects, which the full resolution waits to settle
+/// </summary>
+void PreviewResolution::OnInput()
+{
+	m_inputTimer.Start();
+}
+
+/// <summary>
+/// whether there was no input for the settle time, so the effects are applied at full resolution
+/// </summary>
+bool PreviewResolution::IsSettled() const
+{
+	return m_inputTimer.GetElapsedMilliseconds() >= m_settleMilliseconds;
+}
+
+/// <summary>
+/// chooses the scale factor of the preview of an effect on an image, from the latency of the last effects. 
+/// The scale drops to the first one within the target at once, and rises a step when the next finer one is well within it, 
+/// as long as the scale has held and no frame was slow for a while
+/// </summary>
+/// <param name="totalPixels">of the image at full resolution</param>
+/// <returns>returns 1 if the effect is applied at full resolution without a preview</returns>
+GLsizei PreviewResolution::ChooseScaleFactor(GLsizei totalPixels)
+{
+	m_totalPixels = totalPixels;
+
+	if (!m_isAdaptive)
+	{
+		m_level = 0;
+		return 1;
+	}
+
+	GLsizei level = m_level;
+
+	//until an effect was measured, the latency is not known, and the scale holds
+	if (m_millisecondsPerPixel > 0.0)
+	{
+		if (EstimateMilliseconds(totalPixels, level) > m_targetLatencyMilliseconds * (1.0 + LATENCY_HYSTERESIS))
+		{
+			while (level < MAX_LEVEL && EstimateMilliseconds(totalPixels, level) > m_targetLatencyMilliseconds)
+			{
+				level++;
+			}
+		}
+		else if (level > 0 && m_totalFramesSinceChange >= MIN_FRAMES_BEFORE_RISE && m_totalFramesSinceSlow >= MIN_FRAMES_BEFORE_RISE && 
+			     EstimateMilliseconds(totalPixels, level - 1) < m_targetLatencyMilliseconds * (1.0 - LATENCY_HYSTERESIS))
+		{
+			level--;
+		}
+	}
+
+	if (level != m_level)
+	{
+		m_level = level;
+		m_totalFramesSinceChange = 0;
+	}
+
+	return GetScaleFactor();
+}
+
+/// <summary>
+/// adds the time an effect took from its start until it was shown, which estimates the latency of the next effects
+/// </summary>
+/// <param name="totalPixels">of the image at full resolution</param>
+/// <param name="scaleFactor">the image was scaled down by, 1 at full resolution</param>
+void PreviewResolution::AddLatency(double milliseconds, GLsizei totalPixels, GLsizei scaleFactor)
+{
+	double totalScaledPixels = static_cast<double>(totalPixels) / (static_cast<double>(scaleFactor) * scaleFactor);
+
+	if (totalScaledPixels <= 0.0)
+	{
+		return;
+	}
+
+	double millisecondsPerPixel = milliseconds / totalScaledPixels;
+
+	m_millisecondsPerPixel = (m_millisecondsPerPixel > 0.0) ? 
+		m_millisecondsPerPixel + (millisecondsPerPixel - m_millisecondsPerPixel) * LATENCY_SMOOTHING : millisecondsPerPixel;
+
+	m_lastLatencyMilliseconds = milliseconds;
+	m_lastLatencyScaleFactor = scaleFactor;
+}
+
+/// <summary>
+/// sets whether effects are previewed at a lower resolution while they would miss the target latency, 
+/// or always applied at full resolution
+/// </summary>
+void PreviewResolution::SetAdaptive(bool isAdaptive)
+{
+	m_isAdaptive = isAdaptive;
+
+	if (!m_isAdaptive)
+	{
+		m_level = 0;
+	}
+}
+
+bool PreviewResolution::IsAdaptive() const
+{
+	return m_isAdaptive;
+}
+
+void PreviewResolution::SetTargetLatencyMilliseconds(double targetLatencyMilliseconds)
+{
+	m_targetLatencyMilliseconds = std::max(targetLatencyMilliseconds, 1.0);
+}
+
+double PreviewResolution::GetTargetLatencyMilliseconds() const
+{
+	return m_targetLatencyMilliseconds;
+}
+
+void PreviewResolution::SetSettleMilliseconds(double settleMilliseconds)
+{
+	m_settleMilliseconds = std::max(settleMilliseconds, 0.0);
+}
+
+double PreviewResolution::GetSettleMilliseconds() const
+{
+	return m_settleMilliseconds;
+}
+
+/// <summary>
+/// the factor the last preview was scaled down by, 1 at full resolution
+/// </summary>
+GLsizei PreviewResolution::GetScaleFactor() const
+{
+	return 1 << m_level;
+}
+
+double PreviewResolution::GetLastLatencyMilliseconds() const
+{
+	return m_lastLatencyMilliseconds;
+}
+
+GLsizei PreviewResolution::GetLastLatencyScaleFactor() const
+{
+	return m_lastLatencyScaleFactor;
+}
+
+/// <summary>
+/// the latency the next effect is estimated to take at full resolution on the image the scale was last chosen for
+/// </summary>
+double PreviewResolution::GetEstimatedMilliseconds() const
+{
+	return EstimateMilliseconds(m_totalPixels, 0);
+}
+
+/// <summary>
+/// the latency of an effect on an image scaled down by 2 to the power of the level, which takes a time in proportion to its pixels
+/// </summary>
+double PreviewResolution::EstimateMilliseconds(GLsizei totalPixels, GLsizei level) const
+{
+	return m_millisecondsPerPixel * totalPixels / static_cast<double>(1 << (2 * level));
+}
\ No newline at end of file
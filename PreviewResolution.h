@@ -0,0 +1,62 @@
+#pragma once
+
+#include "gl.h"
+#include "FrameBudget.h"
+#include "Timer.h"
+
+//the resolution effects are previewed at while the input goes on, chosen from the measured latency of the effects 
+//and the frame time. Effects that would take longer than the target latency at full resolution are first applied on 
+//a copy of the image scaled down by a power of two, and at full resolution once the input has settled. 
+//The scale drops at once to what the target needs, and rises a step at a time only when the finer scale is well within 
+//the target and the frames have kept up for a while, so it does not swing between two scales. 
+//Owned by the frame loop along with the frame budget it reads the frame times from. Used on the main thread only
+class PreviewResolution
+{
+
+public:
+
+	PreviewResolution(const FrameBudget& frameBudget);
+
+	void BeginFrame(bool isApplyingEffects);
+	void OnInput();
+	bool IsSettled() const;
+
+	GLsizei ChooseScaleFactor(GLsizei totalPixels);
+	void AddLatency(double milliseconds, GLsizei totalPixels, GLsizei scaleFactor);
+
+	void SetAdaptive(bool isAdaptive);
+	bool IsAdaptive() const;
+	void SetTargetLatencyMilliseconds(double targetLatencyMilliseconds);
+	double GetTargetLatencyMilliseconds() const;
+	void SetSettleMilliseconds(double settleMilliseconds);
+	double GetSettleMilliseconds() const;
+
+	GLsizei GetScaleFactor() const;
+	double GetLastLatencyMilliseconds() const;
+	GLsizei GetLastLatencyScaleFactor() const;
+	double GetEstimatedMilliseconds() const;
+
+private:
+
+	PreviewResolution(const PreviewResolution&);
+
+	double EstimateMilliseconds(GLsizei totalPixels, GLsizei level) const;
+
+	const FrameBudget& m_frameBudget; //measures the frames, which drop the scale when they run slow
+
+	bool m_isAdaptive; //effects are previewed at a lower resolution while they would miss the target latency
+	double m_targetLatencyMilliseconds; //the time from an input to its preview being shown
+	double m_settleMilliseconds; //without input, after which the effects are applied at full resolution
+
+	GLsizei m_level; //the scale factor of previews is 2 to the power of the level, with no preview at level 0
+	GLsizei m_totalPixels; //of the image the scale was last chosen for
+	double m_millisecondsPerPixel; //the latency of the last effects per pixel at full resolution, 0 until one was measured
+	double m_lastLatencyMilliseconds;
+	GLsizei m_lastLatencyScaleFactor;
+
+	GLuint m_totalSlowFrames; //in a row, while effects were applied
+	GLuint m_totalFramesSinceChange;
+	GLuint m_totalFramesSinceSlow;
+	Timer m_inputTimer; //since the last input
+
+};
\ No newline at end of file
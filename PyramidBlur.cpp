@@ -0,0 +1,521 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "GLState.h"
+#include "Parallel.h"
+#include "PyramidBlur.h"
+#include "Shader.h"
+#include "ShaderSources.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PYRAMID_BLUR_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+//passes of Shaders/PyramidBlur.frag
+static const GLint DOWNSAMPLE_PASS = 0;
+static const GLint UPSAMPLE_PASS = 1;
+static const GLint BLUR_PASS = 2;
+
+//the largest radius of the gaussian the shader blurs the smallest level with
+static const GLsizei MAX_GPU_RADIUS = 32;
+
+//the smallest level is made no smaller than to leave this much blur to it, so the result keeps the shape of a gaussian
+static const double MIN_COARSE_SIGMA = 1.0;
+
+//one RGBA pixel in a SIMD register, so each pass weighs whole pixels at once
+#ifdef PYRAMID_BLUR_USE_SSE2
+
+using Pixel = __m128;
+
+static Pixel ZeroPixel()
+{
+	return _mm_setzero_ps();
+}
+
+static Pixel LoadPixel(const GLfloat* pixel)
+{
+	return _mm_loadu_ps(pixel);
+}
+
+static void StorePixel(GLfloat* pixel, Pixel value)
+{
+	_mm_storeu_ps(pixel, value);
+}
+
+static Pixel AddPixels(Pixel a, Pixel b)
+{
+	return _mm_add_ps(a, b);
+}
+
+static Pixel ScalePixel(Pixel a, GLfloat weight)
+{
+	return _mm_mul_ps(a, _mm_set1_ps(weight));
+}
+
+#else
+
+struct Pixel
+{
+	GLfloat values[4];
+};
+
+static Pixel ZeroPixel()
+{
+	return { { 0.0f, 0.0f, 0.0f, 0.0f } };
+}
+
+static Pixel LoadPixel(const GLfloat* pixel)
+{
+	return { { pixel[0], pixel[1], pixel[2], pixel[3] } };
+}
+
+static void StorePixel(GLfloat* pixel, Pixel value)
+{
+	std::copy_n(value.values, 4, pixel);
+}
+
+static Pixel AddPixels(Pixel a, Pixel b)
+{
+	return { { a.values[0] + b.values[0], a.values[1] + b.values[1], a.values[2] + b.values[2], a.values[3] + b.values[3] } };
+}
+
+static Pixel ScalePixel(Pixel a, GLfloat weight)
+{
+	return { { a.values[0] * weight, a.values[1] * weight, a.values[2] * weight, a.values[3] * weight } };
+}
+
+#endif
+
+/// <summary>
+/// the weights of a gaussian from its middle out, summing to 1 over both sides
+/// </summary>
+static std::vector<GLfloat> CreateWeights(GLfloat sigma, GLsizei maxRadius)
+{
+	GLsizei radius = std::min(static_cast<GLsizei>(std::ceil(3.0f * sigma)), maxRadius);
+	std::vector<GLfloat> weights(radius + 1);
+	GLfloat sum = 0.0f;
+
+	for (GLsizei i = 0; i <= radius; i++)
+	{
+		weights[i] = std::exp(-static_cast<GLfloat>(i * i) / (2.0f * sigma * sigma));
+		sum += (i == 0) ? weights[i] : 2.0f * weights[i];
+	}
+
+	for (GLfloat& weight : weights)
+	{
+		weight /= sum;
+	}
+
+	return weights;
+}
+
+PyramidBlur* PyramidBlur::Instance()
+{
+	static PyramidBlur* pyramidBlur = new PyramidBlur;
+	return pyramidBlur;
+}
+
+PyramidBlur::PyramidBlur()
+{
+	m_program = 0;
+	m_vertexArray = 0;
+	m_framebuffer = 0;
+	m_isGpuFailed = false;
+}
+
+/// <summary>
+/// blurs RGBA float pixels on the CPU
+/// </summary>
+/// <param name="result">the blurred pixels, which may not be the same as the pixels</param>
+/// <param name="sigmaX">standard deviation of the gaussian along the rows, in pixels</param>
+/// <param name="sigmaY">standard deviation of the gaussian along the columns, in pixels</param>
+void PyramidBlur::Apply(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, GLfloat sigmaX, GLfloat sigmaY)
+{
+	GLfloat coarseSigmaX;
+	GLfloat coarseSigmaY;
+	std::vector<Level> levels = CreateLevels(width, height, sigmaX, sigmaY, coarseSigmaX, coarseSigmaY);
+	size_t coarsest = levels.size() - 1;
+
+	if (coarsest == 0)
+	{
+		std::copy_n(pixels, static_cast<size_t>(width) * height * 4, result);
+		Blur(result, levels[0], coarseSigmaX, coarseSigmaY);
+		return;
+	}
+
+	//the first level is the image itself, and the last one scaled up is the result
+	std::vector<std::vector<GLfloat>> images(levels.size());
+
+	for (size_t i = 1; i < levels.size(); i++)
+	{
+		images[i].resize(static_cast<size_t>(levels[i].width) * levels[i].height * 4);
+		Downsample((i == 1) ? pixels : images[i - 1].data(), levels[i - 1], images[i].data(), levels[i]);
+	}
+
+	Blur(images[coarsest].data(), levels[coarsest], coarseSigmaX, coarseSigmaY);
+
+	for (size_t i = coarsest; i > 1; i--)
+	{
+		Upsample(images[i].data(), levels[i], images[i - 1].data(), levels[i - 1]);
+	}
+
+	Upsample(images[1].data(), levels[1], result, levels[0]);
+}
+
+/// <summary>
+/// blurs RGBA float pixels on the GPU, with the levels stored as half floats
+/// </summary>
+/// <param name="result">the blurred pixels, which may be the same as the pixels</param>
+/// <returns>returns false if the shaders could not be built, in which case the result is left as it is</returns>
+bool PyramidBlur::ApplyOnGpu(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, GLfloat sigmaX, GLfloat sigmaY)
+{
+	if (!CreateGpuResources())
+	{
+		return false;
+	}
+
+	GLfloat coarseSigmaX;
+	GLfloat coarseSigmaY;
+	std::vector<Level> levels = CreateLevels(width, height, sigmaX, sigmaY, coarseSigmaX, coarseSigmaY);
+	size_t coarsest = levels.size() - 1;
+
+	//one texture per level, and one for the first of the two blur passes over the smallest level
+	std::vector<GLuint> textures(levels.size() + 1);
+	glGenTextures(static_cast<GLsizei>(textures.size()), textures.data());
+
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		const Level& level = levels[std::min(i, coarsest)];
+
+		GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, textures[i]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, level.width, level.height, 0, GL_RGBA, GL_FLOAT, (i == 0) ? pixels : nullptr);
+	}
+
+	GLint previousFramebuffer = 0;
+	GLint previousViewport[4];
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	GLState::Instance()->UseProgram(m_program);
+	GLState::Instance()->BindVertexArray(m_vertexArray);
+	glUniform1i(glGetUniformLocation(m_program, "sourceImage"), 0);
+
+	for (size_t i = 1; i <= coarsest; i++)
+	{
+		RenderPass(textures[i - 1], levels[i - 1], textures[i], levels[i], DOWNSAMPLE_PASS);
+	}
+
+	GLuint coarseTexture = textures[coarsest];
+	GLuint blurTexture = textures.back();
+	const GLfloat coarseSigmas[] = { coarseSigmaX, coarseSigmaY };
+
+	for (int direction = 0; direction < 2; direction++)
+	{
+		std::vector<GLfloat> weights = CreateWeights(coarseSigmas[direction], MAX_GPU_RADIUS);
+
+		glUniform2f(glGetUniformLocation(m_program, "direction"), (direction == 0) ? 1.0f : 0.0f, (direction == 0) ? 0.0f : 1.0f);
+		glUniform1i(glGetUniformLocation(m_program, "radius"), static_cast<GLint>(weights.size()) - 1);
+		glUniform1fv(glGetUniformLocation(m_program, "weights"), static_cast<GLsizei>(weights.size()), weights.data());
+
+		RenderPass(coarseTexture, levels[coarsest], blurTexture, levels[coarsest], BLUR_PASS);
+		std::swap(coarseTexture, blurTexture);
+	}
+
+	for (size_t i = coarsest; i > 0; i--)
+	{
+		RenderPass(textures[i], levels[i], textures[i - 1], levels[i - 1], UPSAMPLE_PASS);
+	}
+
+	//the last pass left the first level attached to the framebuffer
+	GLState::Instance()->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, result);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+	GLState::Instance()->SetViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+	GLState::Instance()->UseProgram(Shader::Instance()->GetShaderProgramID());
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, 0);
+
+	for (GLuint texture : textures)
+	{
+		GLState::Instance()->InvalidateTexture(texture);
+	}
+
+	glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+
+	return true;
+}
+
+void PyramidBlur::DestroyGpuResources()
+{
+	if (m_program != 0)
+	{
+		GLState::Instance()->InvalidateProgram(m_program);
+		glDeleteProgram(m_program);
+	}
+
+	if (m_vertexArray != 0)
+	{
+		GLState::Instance()->InvalidateVertexArray(m_vertexArray);
+		glDeleteVertexArrays(1, &m_vertexArray);
+	}
+
+	if (m_framebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+	}
+
+	m_program = 0;
+	m_vertexArray = 0;
+	m_framebuffer = 0;
+}
+
+/// <summary>
+/// the sizes of the levels, from the image down to the smallest level the gaussians allow. Halving a level 
+/// adds a variance of 3/4 of its texels, and scaling the next level back up bilinearly 3/16 of that level's texels, 
+/// so L levels add (4^L - 1) / 2 in pixels of the image
+/// </summary>
+/// <param name="coarseSigmaX">the standard deviation, in texels of the smallest level, still to be blurred along the rows</param>
+/// <param name="coarseSigmaY">the standard deviation, in texels of the smallest level, still to be blurred along the columns</param>
+std::vector<PyramidBlur::Level> PyramidBlur::CreateLevels(GLsizei width, GLsizei height, GLfloat sigmaX, GLfloat sigmaY, 
+	                                                      GLfloat& coarseSigmaX, GLfloat& coarseSigmaY) const
+{
+	std::vector<Level> levels = { { width, height } };
+	double minVariance = std::pow(std::min(sigmaX, sigmaY), 2.0);
+	double scale = 1.0;
+
+	while (levels.back().width > 1 && levels.back().height > 1)
+	{
+		double nextScale = scale * 4.0;
+
+		if ((nextScale - 1.0) / 2.0 + MIN_COARSE_SIGMA * MIN_COARSE_SIGMA * nextScale > minVariance)
+		{
+			break;
+		}
+
+		levels.push_back({ (levels.back().width + 1) / 2, (levels.back().height + 1) / 2 });
+		scale = nextScale;
+	}
+
+	double pyramidVariance = (scale - 1.0) / 2.0;
+	coarseSigmaX = static_cast<GLfloat>(std::sqrt(std::max(sigmaX * sigmaX - pyramidVariance, 0.0) / scale));
+	coarseSigmaY = static_cast<GLfloat>(std::sqrt(std::max(sigmaY * sigmaY - pyramidVariance, 0.0) / scale));
+
+	return levels;
+}
+
+/// <summary>
+/// halves a level, weighing the 4 x 4 pixels around each pixel of the smaller level by (1 3 3 1) / 8 in each direction
+/// </summary>
+void PyramidBlur::Downsample(const GLfloat* pixels, const Level& level, GLfloat* result, const Level& coarseLevel)
+{
+	static const GLfloat WEIGHTS[4] = { 0.125f, 0.375f, 0.375f, 0.125f };
+
+	ParallelFor(coarseLevel.height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			const GLfloat* rows[4];
+
+			for (GLsizei j = 0; j < 4; j++)
+			{
+				rows[j] = pixels + static_cast<size_t>(std::clamp(2 * y - 1 + j, 0, level.height - 1)) * level.width * 4;
+			}
+
+			GLfloat* resultRow = result + static_cast<size_t>(y) * coarseLevel.width * 4;
+
+			for (GLsizei x = 0; x < coarseLevel.width; x++)
+			{
+				GLsizei columns[4];
+
+				for (GLsizei i = 0; i < 4; i++)
+				{
+					columns[i] = std::clamp(2 * x - 1 + i, 0, level.width - 1) * 4;
+				}
+
+				Pixel sum = ZeroPixel();
+
+				for (GLsizei j = 0; j < 4; j++)
+				{
+					Pixel rowSum = ScalePixel(LoadPixel(rows[j] + columns[0]), WEIGHTS[0]);
+
+					for (GLsizei i = 1; i < 4; i++)
+					{
+						rowSum = AddPixels(rowSum, ScalePixel(LoadPixel(rows[j] + columns[i]), WEIGHTS[i]));
+					}
+
+					sum = AddPixels(sum, ScalePixel(rowSum, WEIGHTS[j]));
+				}
+
+				StorePixel(resultRow + x * 4, sum);
+			}
+		}
+	});
+}
+
+/// <summary>
+/// doubles a level bilinearly. Each pixel of the larger level lies a quarter of a texel from the nearest pixel 
+/// of the smaller level, which weighs 3/4 in each direction, and the next one 1/4
+/// </summary>
+void PyramidBlur::Upsample(const GLfloat* pixels, const Level& level, GLfloat* result, const Level& fineLevel)
+{
+	ParallelFor(fineLevel.height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			GLsizei nearY = std::min(y / 2, level.height - 1);
+			GLsizei farY = std::clamp((y % 2 == 0) ? nearY - 1 : nearY + 1, 0, level.height - 1);
+
+			const GLfloat* nearRow = pixels + static_cast<size_t>(nearY) * level.width * 4;
+			const GLfloat* farRow = pixels + static_cast<size_t>(farY) * level.width * 4;
+			GLfloat* resultRow = result + static_cast<size_t>(y) * fineLevel.width * 4;
+
+			for (GLsizei x = 0; x < fineLevel.width; x++)
+			{
+				GLsizei nearX = std::min(x / 2, level.width - 1);
+				GLsizei farX = std::clamp((x % 2 == 0) ? nearX - 1 : nearX + 1, 0, level.width - 1);
+
+				Pixel nearSum = AddPixels(ScalePixel(LoadPixel(nearRow + nearX * 4), 0.75f), ScalePixel(LoadPixel(nearRow + farX * 4), 0.25f));
+				Pixel farSum = AddPixels(ScalePixel(LoadPixel(farRow + nearX * 4), 0.75f), ScalePixel(LoadPixel(farRow + farX * 4), 0.25f));
+
+				StorePixel(resultRow + x * 4, AddPixels(ScalePixel(nearSum, 0.75f), ScalePixel(farSum, 0.25f)));
+			}
+		}
+	});
+}
+
+/// <summary>
+/// blurs a level in place with a gaussian, along the rows and then along the columns
+/// </summary>
+void PyramidBlur::Blur(GLfloat* pixels, const Level& level, GLfloat sigmaX, GLfloat sigmaY)
+{
+	std::vector<GLfloat> weightsX = CreateWeights(sigmaX, level.width);
+	std::vector<GLfloat> weightsY = CreateWeights(sigmaY, level.height);
+	std::vector<GLfloat> rowResult(static_cast<size_t>(level.width) * level.height * 4);
+	GLsizei radiusX = static_cast<GLsizei>(weightsX.size()) - 1;
+	GLsizei radiusY = static_cast<GLsizei>(weightsY.size()) - 1;
+
+	ParallelFor(level.height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			const GLfloat* row = pixels + static_cast<size_t>(y) * level.width * 4;
+			GLfloat* resultRow = &rowResult[static_cast<size_t>(y) * level.width * 4];
+
+			for (GLsizei x = 0; x < level.width; x++)
+			{
+				Pixel sum = ScalePixel(LoadPixel(row + x * 4), weightsX[0]);
+
+				for (GLsizei i = 1; i <= radiusX; i++)
+				{
+					Pixel pair = AddPixels(LoadPixel(row + std::max(x - i, 0) * 4), LoadPixel(row + std::min(x + i, level.width - 1) * 4));
+					sum = AddPixels(sum, ScalePixel(pair, weightsX[i]));
+				}
+
+				StorePixel(resultRow + x * 4, sum);
+			}
+		}
+	});
+
+	ParallelFor(level.height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			GLfloat* resultRow = pixels + static_cast<size_t>(y) * level.width * 4;
+
+			for (GLsizei x = 0; x < level.width; x++)
+			{
+				Pixel sum = ScalePixel(LoadPixel(&rowResult[(static_cast<size_t>(y) * level.width + x) * 4]), weightsY[0]);
+
+				for (GLsizei j = 1; j <= radiusY; j++)
+				{
+					size_t above = static_cast<size_t>(std::max(y - j, 0)) * level.width + x;
+					size_t below = static_cast<size_t>(std::min(y + j, level.height - 1)) * level.width + x;
+
+					sum = AddPixels(sum, ScalePixel(AddPixels(LoadPixel(&rowResult[above * 4]), LoadPixel(&rowResult[below * 4])), weightsY[j]));
+				}
+
+				StorePixel(resultRow + x * 4, sum);
+			}
+		}
+	});
+}
+
+/// <summary>
+/// builds the program of the passes, and the framebuffer and vertex array they render with, on first use
+/// </summary>
+/// <returns>returns false if the shaders could not be built</returns>
+bool PyramidBlur::CreateGpuResources()
+{
+	if (m_program != 0 || m_isGpuFailed)
+	{
+		return !m_isGpuFailed;
+	}
+
+	const char* sources[] = { PYRAMID_BLUR_VERTEX_SHADER, PYRAMID_BLUR_FRAGMENT_SHADER };
+	const GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+	GLuint shaders[2];
+
+	m_program = glCreateProgram();
+
+	for (int i = 0; i < 2; i++)
+	{
+		shaders[i] = glCreateShader(types[i]);
+		glShaderSource(shaders[i], 1, &sources[i], nullptr);
+		glCompileShader(shaders[i]);
+		glAttachShader(m_program, shaders[i]);
+	}
+
+	glLinkProgram(m_program);
+
+	for (GLuint shader : shaders)
+	{
+		glDetachShader(m_program, shader);
+		glDeleteShader(shader);
+	}
+
+	GLint isLinked = GL_FALSE;
+	glGetProgramiv(m_program, GL_LINK_STATUS, &isLinked);
+
+	if (isLinked != GL_TRUE)
+	{
+		GLchar errorMessage[1000];
+		GLsizei bufferSize = 1000;
+
+		glGetProgramInfoLog(m_program, bufferSize, &bufferSize, errorMessage);
+		std::cout << "Error building the pyramid blur shaders: " << errorMessage << std::endl;
+
+		glDeleteProgram(m_program);
+		m_program = 0;
+		m_isGpuFailed = true;
+		return false;
+	}
+
+	//the passes draw a single triangle made in the vertex shader, but core profiles still need a vertex array bound
+	glGenVertexArrays(1, &m_vertexArray);
+	glGenFramebuffers(1, &m_framebuffer);
+
+	return true;
+}
+
+/// <summary>
+/// renders a level from another one with one of the passes of the shader
+/// </summary>
+void PyramidBlur::RenderPass(GLuint source, const Level& sourceLevel, GLuint target, const Level& targetLevel, GLint pass)
+{
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+
+	GLState::Instance()->SetViewport(0, 0, targetLevel.width, targetLevel.height);
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, source);
+
+	glUniform1i(glGetUniformLocation(m_program, "pass"), pass);
+	glUniform2f(glGetUniformLocation(m_program, "texelSize"), 1.0f / sourceLevel.width, 1.0f / sourceLevel.height);
+
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+}
\ No newline at end of file
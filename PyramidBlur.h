@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include "gl.h"
+
+//blurs with gaussians of any size in the time of a few passes over the image: the image is halved level by level 
+//with a (1 3 3 1) / 8 filter, the smallest level is blurred by the gaussian the halving left to do, 
+//and the levels are scaled back up with bilinear filtering. Each level adds a known variance, so the pyramid as a whole 
+//has the variance of the requested gaussian. Runs on the CPU with SIMD and on the GPU through framebuffers.
+//Pixels beyond the edges repeat the edge pixels.
+class PyramidBlur
+{
+
+public:
+
+	static PyramidBlur* Instance();
+
+	void Apply(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, GLfloat sigmaX, GLfloat sigmaY);
+	bool ApplyOnGpu(const GLfloat* pixels, GLfloat* result, GLsizei width, GLsizei height, GLfloat sigmaX, GLfloat sigmaY);
+
+	void DestroyGpuResources();
+
+private:
+
+	struct Level
+	{
+		GLsizei width;
+		GLsizei height;
+	};
+
+	PyramidBlur();
+	PyramidBlur(const PyramidBlur&);
+
+	std::vector<Level> CreateLevels(GLsizei width, GLsizei height, GLfloat sigmaX, GLfloat sigmaY, 
+		                            GLfloat& coarseSigmaX, GLfloat& coarseSigmaY) const;
+
+	void Downsample(const GLfloat* pixels, const Level& level, GLfloat* result, const Level& coarseLevel);
+	void Upsample(const GLfloat* pixels, const Level& level, GLfloat* result, const Level& fineLevel);
+	void Blur(GLfloat* pixels, const Level& level, GLfloat sigmaX, GLfloat sigmaY);
+
+	bool CreateGpuResources();
+	void RenderPass(GLuint source, const Level& sourceLevel, GLuint target, const Level& targetLevel, GLint pass);
+
+	GLuint m_program;
+	GLuint m_vertexArray;
+	GLuint m_framebuffer;
+	bool m_isGpuFailed;
+
+};
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include <cstring>
+#include <iostream>
+#include "QoiWriter.h"
+
+static const Uint8 QOI_OP_INDEX = 0x00;
+static const Uint8 QOI_OP_DIFF = 0x40;
+static const Uint8 QOI_OP_LUMA = 0x80;
+static const Uint8 QOI_OP_RUN = 0xC0;
+static const Uint8 QOI_OP_RGB = 0xFE;
+static const Uint8 QOI_OP_RGBA = 0xFF;
+static const Uint32 QOI_MAX_RUN = 62;
+
+static const size_t DATA_FLUSH_SIZE = 65536;
+
+static void AppendBigEndian(std::vector<Uint8>& bytes, Uint32 value)
+{
+	bytes.push_back(static_cast<Uint8>(value >> 24));
+	bytes.push_back(static_cast<Uint8>(value >> 16));
+	bytes.push_back(static_cast<Uint8>(value >> 8));
+	bytes.push_back(static_cast<Uint8>(value));
+}
+
+QoiWriter::QoiWriter()
+{
+	m_width = 0;
+	m_height = 0;
+	m_channels = 0;
+	m_totalRowsWritten = 0;
+	m_runLength = 0;
+
+	std::memset(m_seenPixels, 0, sizeof(m_seenPixels));
+	std::memset(m_previousPixel, 0, sizeof(m_previousPixel));
+}
+
+QoiWriter::~QoiWriter()
+{
+	if (m_file.is_open())
+	{
+		Close();
+	}
+}
+
+/// <summary>
+/// creates the qoi file and writes its header. The rows are then written from top to bottom with WriteRows
+/// </summary>
+/// <param name="channels">3 for RGB and 4 for RGBA pixels</param>
+/// <returns>returns false if the file could not be created</returns>
+bool QoiWriter::Open(const std::string& filename, Uint32 width, Uint32 height, Uint32 channels)
+{
+	if ((channels != 3 && channels != 4) || width == 0 || height == 0)
+	{
+		std::cout << "Error: unsupported qoi format" << std::endl;
+		return false;
+	}
+
+	m_file.open(filename, std::ios::binary);
+
+	if (!m_file)
+	{
+		std::cout << "Error creating qoi file: " << filename << std::endl;
+		return false;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_channels = channels;
+	m_totalRowsWritten = 0;
+	m_runLength = 0;
+
+	std::memset(m_seenPixels, 0, sizeof(m_seenPixels));
+	m_previousPixel[0] = 0;
+	m_previousPixel[1] = 0;
+	m_previousPixel[2] = 0;
+	m_previousPixel[3] = 255;
+
+	m_data.clear();
+	m_data.insert(m_data.end(), { 'q', 'o', 'i', 'f' });
+	AppendBigEndian(m_data, width);
+	AppendBigEndian(m_data, height);
+	m_data.push_back(static_cast<Uint8>(channels));
+	m_data.push_back(0);
+
+	return true;
+}
+
+/// <summary>
+/// encodes and writes the next rows of the image
+/// </summary>
+/// <param name="pixels">the first row to write</param>
+/// <param name="totalRows">number of rows to write</param>
+/// <param name="pitch">distance in bytes between the starts of two rows</param>
+/// <returns>returns false if the rows do not fit in the image or could not be written</returns>
+bool QoiWriter::WriteRows(const Uint8* pixels, Uint32 totalRows, size_t pitch)
+{
+	if (!m_file.is_open() || m_totalRowsWritten + totalRows > m_height)
+	{
+		std::cout << "Error writing qoi rows" << std::endl;
+		return false;
+	}
+
+	for (Uint32 row = 0; row < totalRows; row++)
+	{
+		const Uint8* pixel = pixels + row * pitch;
+
+		for (Uint32 column = 0; column < m_width; column++, pixel += m_channels)
+		{
+			Uint8 alpha = (m_channels == 4) ? pixel[3] : 255;
+
+			if (pixel[0] == m_previousPixel[0] && pixel[1] == m_previousPixel[1] &&
+				pixel[2] == m_previousPixel[2] && alpha == m_previousPixel[3])
+			{
+				m_runLength++;
+
+				if (m_runLength == QOI_MAX_RUN)
+				{
+					WriteRun();
+				}
+
+				continue;
+			}
+
+			WriteRun();
+
+			Uint32 hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + alpha * 11) % 64;
+			Uint8* seenPixel = m_seenPixels[hash];
+
+			if (seenPixel[0] == pixel[0] && seenPixel[1] == pixel[1] && seenPixel[2] == pixel[2] && seenPixel[3] == alpha)
+			{
+				m_data.push_back(QOI_OP_INDEX | static_cast<Uint8>(hash));
+			}
+			else if (alpha == m_previousPixel[3])
+			{
+				int redDifference = static_cast<Sint8>(pixel[0] - m_previousPixel[0]);
+				int greenDifference = static_cast<Sint8>(pixel[1] - m_previousPixel[1]);
+				int blueDifference = static_cast<Sint8>(pixel[2] - m_previousPixel[2]);
+				int redGreenDifference = redDifference - greenDifference;
+				int blueGreenDifference = blueDifference - greenDifference;
+
+				if (redDifference >= -2 && redDifference <= 1 && greenDifference >= -2 && greenDifference <= 1 && 
+					blueDifference >= -2 && blueDifference <= 1)
+				{
+					m_data.push_back(QOI_OP_DIFF | static_cast<Uint8>(((redDifference + 2) << 4) | ((greenDifference + 2) << 2) | (blueDifference + 2)));
+				}
+				else if (greenDifference >= -32 && greenDifference <= 31 && redGreenDifference >= -8 && redGreenDifference <= 7 && 
+					     blueGreenDifference >= -8 && blueGreenDifference <= 7)
+				{
+					m_data.push_back(QOI_OP_LUMA | static_cast<Uint8>(greenDifference + 32));
+					m_data.push_back(static_cast<Uint8>(((redGreenDifference + 8) << 4) | (blueGreenDifference + 8)));
+				}
+				else
+				{
+					m_data.insert(m_data.end(), { QOI_OP_RGB, pixel[0], pixel[1], pixel[2] });
+				}
+			}
+			else
+			{
+				m_data.insert(m_data.end(), { QOI_OP_RGBA, pixel[0], pixel[1], pixel[2], alpha });
+			}
+
+			seenPixel[0] = m_previousPixel[0] = pixel[0];
+			seenPixel[1] = m_previousPixel[1] = pixel[1];
+			seenPixel[2] = m_previousPixel[2] = pixel[2];
+			seenPixel[3] = m_previousPixel[3] = alpha;
+		}
+
+		FlushData(false);
+	}
+
+	m_totalRowsWritten += totalRows;
+
+	return m_file.good();
+}
+
+/// <summary>
+/// ends the last run of pixels and finishes the file
+/// </summary>
+/// <returns>returns false if not all rows of the image were written, or the file could not be written</returns>
+bool QoiWriter::Close()
+{
+	if (!m_file.is_open())
+	{
+		return false;
+	}
+
+	WriteRun();
+	m_data.insert(m_data.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+	FlushData(true);
+
+	bool isComplete = (m_totalRowsWritten == m_height) && m_file.good();
+	m_file.close();
+
+	if (!isComplete)
+	{
+		std::cout << "Error: qoi file is incomplete" << std::endl;
+	}
+
+	return isComplete;
+}
+
+/// <summary>
+/// writes the run of repeated pixels counted so far, if any
+/// </summary>
+void QoiWriter::WriteRun()
+{
+	if (m_runLength > 0)
+	{
+		m_data.push_back(QOI_OP_RUN | static_cast<Uint8>(m_runLength - 1));
+		m_runLength = 0;
+	}
+}
+
+void QoiWriter::FlushData(bool isAll)
+{
+	if (m_data.size() >= DATA_FLUSH_SIZE || (isAll && !m_data.empty()))
+	{
+		m_file.write(reinterpret_cast<const char*>(m_data.data()), m_data.size());
+		m_data.clear();
+	}
+}
\ No newline at end of file
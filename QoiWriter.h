@@ -0,0 +1,43 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+//writes a qoi ("quite ok image") file row by row. Qoi compresses about as well as a fast png encoder 
+//at a fraction of the cost, which makes it suited to image sequences written while rendering.
+class QoiWriter
+{
+
+public:
+
+	QoiWriter();
+	~QoiWriter();
+
+	bool Open(const std::string& filename, Uint32 width, Uint32 height, Uint32 channels);
+	bool WriteRows(const Uint8* pixels, Uint32 totalRows, size_t pitch);
+	bool Close();
+
+private:
+
+	QoiWriter(const QoiWriter&);
+
+	void WriteRun();
+	void FlushData(bool isAll);
+
+	std::ofstream m_file;
+
+	Uint32 m_width;
+	Uint32 m_height;
+	Uint32 m_channels;
+	Uint32 m_totalRowsWritten;
+
+	//encoder state carried across rows: recently seen pixels, the previous pixel and the length of the current run
+	Uint8 m_seenPixels[64][4];
+	Uint8 m_previousPixel[4];
+	Uint32 m_runLength;
+
+	std::vector<Uint8> m_data;
+
+};
\ No newline at end of file
@@ -1,28 +1,29 @@
+#include <algorithm>
 #include <gtc/matrix_transform.hpp>
 #include "Quad.h"
+#include "RenderThread.h"
 #include "Shader.h"
+#include "Timer.h"
+#include "UploadThread.h"
 
-Quad::Quad():m_model(1.0f),m_position(0.0f),m_rotation(0.0f),m_scale(1.0f)
+Quad::Quad(FrameBudget& frameBudget, PreviewResolution& previewResolution):m_blurCache(m_texture),
+	m_frameBudget(frameBudget),m_previewResolution(previewResolution),m_model(1.0f),m_position(0.0f),m_rotation(0.0f),m_scale(1.0f)
 {
 	m_isDirty = true;
+	m_slicedEffect = nullptr;
+	m_totalInputs = 0;
+	m_isFinishing = false;
+	m_previewScaleFactor = 0;
+	m_isPreviewShown = false;
 
-	//data that represents vertices for the quad
-	GLfloat vertices[] = { -0.5f,  0.5f, 0.0f,
-						    0.5f,  0.5f, 0.0f,
-						    0.5f, -0.5f, 0.0f,
-					       -0.5f, -0.5f, 0.0f  };
+	//a preview is replaced by the full resolution result moments later, so its blurs are not kept in the effect cache
+	m_previewTexture.SetEffectCacheEnabled(false);
 
-	//data that represents colors for the quad
-	GLfloat colors[] = { 1.0f, 1.0f, 1.0f,
-					     1.0f, 1.0f, 1.0f,
-					     1.0f, 1.0f, 1.0f,
-					     1.0f, 1.0f, 1.0f  };
-
-	//data that represents UV coordinates for the quad
-	GLfloat UVs[] = { 0.0f, 0.0f,
-					  1.f, 0.0f,
-					  1.f, 1.f,
-					  0.0f, 1.f };
+	//data that represents the vertices of the quad, each with its position and UV coordinates
+	QuadVertex vertices[] = { { glm::vec3(-0.5f,  0.5f, 0.0f), glm::vec2(0.0f, 0.0f) },
+	                          { glm::vec3( 0.5f,  0.5f, 0.0f), glm::vec2(1.0f, 0.0f) },
+	                          { glm::vec3( 0.5f, -0.5f, 0.0f), glm::vec2(1.0f, 1.0f) },
+	                          { glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec2(0.0f, 1.0f) } };
 
 	//index buffer to control the rendering
 	GLuint indices[] = { 0, 1, 3,
@@ -31,18 +32,17 @@ Quad::Quad():m_model(1.0f),m_position(0.0f),m_rotation(0.0f),m_scale(1.0f)
 	m_buffer.CreateBuffer(6, true);
 	m_buffer.FillEBO(indices, sizeof(indices), Buffer::FillType::Once);
 	m_buffer.FillVBO(Buffer::VBOType::VertexBuffer, vertices, sizeof(vertices), Buffer::FillType::Once);
-	m_buffer.FillVBO(Buffer::VBOType::ColorBuffer, colors, sizeof(colors), Buffer::FillType::Once);
-	m_buffer.FillVBO(Buffer::VBOType::TextureBuffer, UVs, sizeof(UVs), Buffer::FillType::Once);
 
 	m_buffer.LinkEBO();
-	m_buffer.LinkVBO("vertexIn", Buffer::VBOType::VertexBuffer, Buffer::ComponentType::XYZ, Buffer::DataType::FloatData);
-	m_buffer.LinkVBO("colorIn", Buffer::VBOType::ColorBuffer, Buffer::ComponentType::RGB, Buffer::DataType::FloatData);
-	m_buffer.LinkVBO("textureIn", Buffer::VBOType::TextureBuffer, Buffer::ComponentType::UV, Buffer::DataType::FloatData);
+	m_buffer.LinkVBO<QuadVertexLayout>(Buffer::VBOType::VertexBuffer);
 }
 
 Quad::~Quad()
 {
+	Finish();
+	m_blurCache.Reset();
 	m_texture.Unload();
+	m_previewTexture.Unload();
 	m_buffer.DestroyBuffer();
 }
 
@@ -64,37 +64,65 @@ void Quad::Update()
 }
 
 /// <summary>
-/// loads a new texture image, and sets it to the default position in 3d space
+/// starts loading a new texture image, dropping the jobs queued before and the rows left of an effect running time-sliced, and sets it to the default position in 3d space 
+/// once decoded. The current image is shown until the new one is uploaded
 /// </summary>
 /// <param name="filename">path to the image</param>
 void Quad::LoadNewTexture(const std::string& filename)
 {
-	m_texture.Unload(); 
-	SetDefaultPosition();
-	m_texture.Load(filename);
+	m_jobs.clear();
+	m_jobs.push_back({ filename, nullptr, nullptr, nullptr, false, ++m_totalInputs });
+
+	if (m_slicedEffect)
+	{
+		m_slicedEffect->Cancel();
+	}
+
+	StartJobs();
 }
 
 void Quad::SaveTextureImage(const std::string& filename)
 {
+	Finish();
 	m_texture.SaveImage(filename);
 }
 
 
 void Quad::SaveTextureImageWithEffects(const std::string& filename)
 {
+	Finish();
 	m_texture.SaveImageWithEffects(filename);
 }
 
 /// <summary>
-/// renders the quad, and the texture image if one was loaded
+/// renders the quad, and the texture image if one was loaded. 
+/// The texture is left bound, so the next frame's bind is dropped by the GL state cache
 /// </summary>
 void Quad::Render()
 {
-	Shader::Instance()->SendUniformData("model", m_model);
+	Render(m_model);
+}
 
-	m_texture.Bind();
+/// <summary>
+/// renders the quad with the model matrix of a frame state, which the main thread may have changed since. 
+/// Called on the thread the screen's context is current on, which alone replaces the texture. 
+/// A preview of the effects is drawn in place of the texture until they are applied at full resolution
+/// </summary>
+void Quad::Render(const glm::mat4& model)
+{
+	Texture& texture = m_isPreviewShown ? m_previewTexture : m_texture;
+
+	Shader::Instance()->SendUniformData("isInstanced", 0);
+	Shader::Instance()->SendUniformData("isLinear", static_cast<GLint>(texture.IsUploadedLinear()));
+	Shader::Instance()->SendUniformData("model", model);
+
+	texture.Bind();
 	m_buffer.Render(Buffer::DrawType::Triangles);
-	m_texture.Unbind();
+}
+
+const glm::mat4& Quad::GetModel() const
+{
+	return m_model;
 }
 
 const glm::vec3& Quad::GetPosition() const
@@ -152,12 +180,522 @@ void Quad::SetDefaultPosition()
 
 void Quad::InvertColors()
 {
-	m_texture.Invert();
-	m_texture.Reload();
+	QueueEffect([this]() { m_texture.Invert(); }, [this](SlicedEffect& effect) { m_texture.SliceInvert(effect); return true; }, nullptr, false);
 }
 
+/// <summary>
+/// blurs the texture, taking the blur from the blur cache if it was computed ahead of time. 
+/// A blur from the blur cache is applied at once rather than time-sliced or previewed
+/// </summary>
 void Quad::Blur(GLfloat blurPercent, bool isInvert)
 {
-	m_texture.Blur(blurPercent/100,isInvert);
-	m_texture.Reload();
+	m_blurCache.OnInput(blurPercent / 100);
+
+	QueueEffect([this, blurPercent, isInvert]()
+	{
+		std::shared_ptr<const Texture::BlurResult> blur = m_blurCache.Find(blurPercent / 100);
+
+		if (blur)
+		{
+			m_texture.ApplyBlur(*blur, isInvert);
+		}
+		else
+		{
+			m_texture.Blur(blurPercent / 100, isInvert);
+		}
+	},
+	[this, blurPercent, isInvert](SlicedEffect& effect)
+	{
+		if (m_blurCache.Find(blurPercent / 100))
+		{
+			return false;
+		}
+
+		m_texture.SliceBlur(blurPercent / 100, isInvert, effect);
+		return true;
+	},
+	[this, blurPercent, isInvert](Texture& texture, GLsizei)
+	{
+		if (m_blurCache.Contains(blurPercent / 100))
+		{
+			return false;
+		}
+
+		texture.Blur(blurPercent / 100, isInvert);
+		return true;
+	}, true);
+}
+
+/// <summary>
+/// computes the blurs for the slider steps next to the last blur on spare cores. 
+/// Called while the slider is idle, as any blur cancels them, and waits until the last blur is shown
+/// </summary>
+void Quad::SpeculateBlur(GLfloat maxBlurPercent)
+{
+	if (IsBusy())
+	{
+		return;
+	}
+
+	m_blurCache.Speculate(maxBlurPercent / 100);
+}
+
+BlurCache::Statistics Quad::GetBlurCacheStatistics() const
+{
+	return m_blurCache.GetStatistics();
+}
+
+/// <summary>
+/// blurs the texture with a box of the size of the gaussian blur's kernel, in the same time for any size
+/// </summary>
+void Quad::BoxBlur(GLfloat blurPercent, bool isInvert)
+{
+	QueueEffect([this, blurPercent, isInvert]() { m_texture.BoxBlur(blurPercent / 100, isInvert); }, 
+		        [this, blurPercent, isInvert](SlicedEffect& effect) { m_texture.SliceBoxBlur(blurPercent / 100, isInvert, effect); return true; }, 
+		        [blurPercent, isInvert](Texture& texture, GLsizei) { texture.BoxBlur(blurPercent / 100, isInvert); return true; }, 
+		        true);
+}
+
+/// <summary>
+/// blurs the texture like Blur, through a pyramid of halved images on the CPU or the GPU. 
+/// The GPU pyramid runs on the render thread, which owns the OpenGL context
+/// </summary>
+void Quad::BlurWithPyramid(GLfloat blurPercent, bool isInvert, bool isOnGpu)
+{
+	QueueEffect([this, blurPercent, isInvert, isOnGpu]() { m_texture.BlurWithPyramid(blurPercent / 100, isInvert, isOnGpu); }, nullptr, 
+		        [blurPercent, isInvert, isOnGpu](Texture& texture, GLsizei) { texture.BlurWithPyramid(blurPercent / 100, isInvert, isOnGpu); return true; }, 
+		        true, isOnGpu);
+}
+
+/// <summary>
+/// smooths the flat areas of the texture, keeping its edges. The radius is in pixels, so previews scale it down with the image
+/// </summary>
+void Quad::Denoise(GLsizei radius, GLfloat noiseLevel, bool isInvert)
+{
+	QueueEffect([this, radius, noiseLevel, isInvert]() { m_texture.Denoise(radius, noiseLevel, isInvert); }, 
+		        [this, radius, noiseLevel, isInvert](SlicedEffect& effect) { m_texture.SliceDenoise(radius, noiseLevel, isInvert, effect); return true; }, 
+		        [radius, noiseLevel, isInvert](Texture& texture, GLsizei scaleFactor) 
+		        { 
+		            texture.Denoise(std::max(radius / scaleFactor, 1), noiseLevel, isInvert); 
+		            return true; 
+		        }, 
+		        true);
+}
+
+/// <summary>
+/// convolves the texture with a kernel on top of its current effects
+/// </summary>
+void Quad::Convolve(const Kernel& kernel)
+{
+	QueueEffect([this, kernel]() { m_texture.Convolve(kernel); }, nullptr, nullptr, false);
+}
+
+/// <summary>
+/// sets the format the effects on the texture are computed in, removing the current effects. 
+/// The pixels are uploaded again on the render thread, and the preview is scaled again in the new format when next needed
+/// </summary>
+void Quad::SetWorkingFormat(Texture::WorkingFormat workingFormat)
+{
+	Finish();
+	m_blurCache.Reset();
+	m_previewScaleFactor = 0;
+
+	RenderThread::Instance()->Run([this, workingFormat]() 
+	{ 
+		m_texture.SetWorkingFormat(workingFormat); 
+		m_isPreviewShown = false; 
+	});
+}
+
+Texture::WorkingFormat Quad::GetWorkingFormat() const
+{
+	return m_texture.GetWorkingFormat();
+}
+
+/// <summary>
+/// sets how the blurs make up the pixels beyond the edges of the texture. The blurs computed ahead of time are dropped, 
+/// and the current effects are kept until they are applied again
+/// </summary>
+void Quad::SetEdgeMode(EdgeMode edgeMode)
+{
+	Finish();
+	m_blurCache.Reset();
+	m_texture.SetEdgeMode(edgeMode);
+	m_previewTexture.SetEdgeMode(edgeMode);
+}
+
+EdgeMode Quad::GetEdgeMode() const
+{
+	return m_texture.GetEdgeMode();
+}
+
+/// <summary>
+/// whether an image is being loaded or effects are being applied
+/// </summary>
+bool Quad::IsBusy() const
+{
+	return !m_jobRunner.IsDone();
+}
+
+/// <summary>
+/// the share of the rows of the time-sliced effect being applied that are done
+/// </summary>
+/// <returns>returns false if no effect is running time-sliced</returns>
+bool Quad::GetSlicedProgress(GLfloat& progress) const
+{
+	if (!m_slicedEffect)
+	{
+		return false;
+	}
+
+	progress = m_slicedEffect->GetProgress();
+	return true;
+}
+
+/// <summary>
+/// waits for the queued jobs, resuming their steps on the main thread meanwhile, without waiting for the input to settle. 
+/// Called before reading or changing the texture on the main thread, such as to save it
+/// </summary>
+void Quad::Finish()
+{
+	m_isFinishing = true;
+
+	while (IsBusy())
+	{
+		//each turn counts as a frame, so time-sliced effects go on with a whole budget each time
+		m_frameBudget.BeginFrame();
+
+		if (!MainThread::Instance()->RunPending())
+		{
+			SDL_Delay(1);
+		}
+	}
+
+	m_isFinishing = false;
+}
+
+/// <summary>
+/// queues an effect after the jobs queued. An effect computed from the source pixels replaces 
+/// what the effects queued since the last image would have made of them, so those are dropped, 
+/// along with the rows left of an effect running time-sliced and an effect waiting for the input to settle
+/// </summary>
+/// <param name="slice">adds the passes of the effect to run it time-sliced on the main thread, 
+/// returning false if it is to run at once instead. Called on the workers. May be empty for effects that are never time-sliced</param>
+/// <param name="preview">applies the effect on the image scaled down by the factor, returning false if the effect 
+/// is quick enough without a preview. Called like the effect. May be empty for effects that are never previewed, 
+/// which have to be those that start from the current effects</param>
+/// <param name="isFromSource">the effect starts from the pixels of the loaded image, instead of the current effects</param>
+/// <param name="isOnRenderThread">the effect uses OpenGL, and runs on the render thread instead of the workers</param>
+void Quad::QueueEffect(std::function<void()> effect, std::function<bool(SlicedEffect&)> slice, 
+	                   std::function<bool(Texture&, GLsizei)> preview, bool isFromSource, bool isOnRenderThread)
+{
+	if (isFromSource)
+	{
+		m_totalInputs++;
+		m_previewResolution.OnInput();
+
+		while (!m_jobs.empty() && m_jobs.back().filename.empty())
+		{
+			m_jobs.pop_back();
+		}
+
+		if (m_slicedEffect)
+		{
+			m_slicedEffect->Cancel();
+		}
+	}
+
+	m_jobs.push_back({ std::string(), std::move(effect), std::move(slice), std::move(preview), isOnRenderThread, m_totalInputs });
+	StartJobs();
+}
+
+void Quad::StartJobs()
+{
+	if (m_jobRunner.IsDone())
+	{
+		m_jobRunner = RunJobs();
+		m_jobRunner.Start();
+	}
+}
+
+/// <summary>
+/// runs the queued jobs one after the other. The queue is only touched on the main thread, 
+/// which every job returns to before the next is taken
+/// </summary>
+AsyncTask<> Quad::RunJobs()
+{
+	while (!m_jobs.empty())
+	{
+		Job job = std::move(m_jobs.front());
+		m_jobs.pop_front();
+
+		if (!job.filename.empty())
+		{
+			co_await LoadTexture(job.filename);
+		}
+		else if (m_texture.IsLoaded())
+		{
+			co_await ApplyEffect(std::move(job));
+		}
+
+		co_await ResumeOnMainThread();
+	}
+}
+
+/// <summary>
+/// reads an image file on an I/O thread and decodes it on the workers, then replaces the loaded image on the workers
+/// </summary>
+AsyncTask<> Quad::LoadTexture(std::string filename)
+{
+	co_await ResumeOnIO();
+
+	std::vector<Uint8> bytes;
+
+	if (!Texture::ReadFile(filename, bytes))
+	{
+		co_return;
+	}
+
+	co_await ResumeOnWorker(TaskPriority::Interactive);
+
+	Texture::Image image;
+
+	if (!Texture::Decode(filename, bytes, image))
+	{
+		co_return;
+	}
+
+	//the blurs computed ahead read the pixels replaced, so they are dropped first
+	co_await ResumeOnMainThread();
+
+	m_blurCache.Reset();
+	m_previewScaleFactor = 0;
+
+	co_await ResumeOnWorker(TaskPriority::Interactive);
+
+	m_texture.Load(image);
+
+	co_await ResumeOnMainThread();
+
+	SetDefaultPosition();
+
+	co_await UploadTexture(m_texture);
+}
+
+/// <summary>
+/// applies an effect on the workers, or on the render thread if it uses OpenGL, and uploads the result. 
+/// While effects are time-sliced, those that can be run on the main thread a few rows per frame instead. 
+/// Effects that would take longer than the target latency are previewed at a lower resolution first, and applied 
+/// at full resolution once the input settles, unless newer input replaces them meanwhile. 
+/// The latency of effects that can be previewed chooses the resolution of the next previews
+/// </summary>
+AsyncTask<> Quad::ApplyEffect(Job job)
+{
+	GLsizei totalPixels = m_texture.GetWidth() * m_texture.GetHeight();
+
+	if (job.preview)
+	{
+		GLsizei scaleFactor = m_previewResolution.ChooseScaleFactor(totalPixels);
+
+		if (scaleFactor > 1 && co_await ApplyPreview(job, scaleFactor))
+		{
+			//a job queued behind, such as an inversion, needs the full resolution at once
+			while (!m_isFinishing && m_jobs.empty() && job.input == m_totalInputs && !m_previewResolution.IsSettled())
+			{
+				co_await ResumeOnNextFrame();
+			}
+
+			if (job.input != m_totalInputs)
+			{
+				co_return;
+			}
+		}
+	}
+
+	Timer timer;
+
+	if (job.slice && m_frameBudget.IsSlicing())
+	{
+		co_await ResumeOnWorker(TaskPriority::Interactive);
+
+		SlicedEffect slicedEffect;
+
+		if (job.slice(slicedEffect))
+		{
+			co_await RunSlicedEffect(slicedEffect);
+
+			//the frames between the slices are not part of the latency
+			if (job.preview && !slicedEffect.IsCancelled())
+			{
+				co_await ResumeOnMainThread();
+
+				m_previewResolution.AddLatency(slicedEffect.GetMilliseconds(), totalPixels, 1);
+			}
+
+			co_return;
+		}
+	}
+
+	if (job.isOnRenderThread)
+	{
+		co_await ResumeOnRenderThread();
+	}
+	else
+	{
+		co_await ResumeOnWorker(TaskPriority::Interactive);
+	}
+
+	job.effect();
+
+	co_await UploadTexture(m_texture);
+
+	if (job.preview)
+	{
+		co_await ResumeOnMainThread();
+
+		m_previewResolution.AddLatency(timer.GetElapsedMilliseconds(), totalPixels, 1);
+	}
+}
+
+/// <summary>
+/// applies an effect on the image scaled down by a factor, scaling it again first if the preview texture holds another scale, 
+/// and shows the result in place of the texture. Ends on the main thread
+/// </summary>
+/// <returns>returns false if the effect needs no preview, such as a blur computed ahead of time</returns>
+AsyncTask<bool> Quad::ApplyPreview(const Job& job, GLsizei scaleFactor)
+{
+	if (m_previewScaleFactor != scaleFactor)
+	{
+		co_await ResumeOnWorker(TaskPriority::Interactive);
+
+		m_previewTexture.LoadScaled(m_texture, scaleFactor);
+		m_previewScaleFactor = scaleFactor;
+	}
+
+	Timer timer;
+
+	if (job.isOnRenderThread)
+	{
+		co_await ResumeOnRenderThread();
+	}
+	else
+	{
+		co_await ResumeOnWorker(TaskPriority::Interactive);
+	}
+
+	if (!job.preview(m_previewTexture, scaleFactor))
+	{
+		co_await ResumeOnMainThread();
+		co_return false;
+	}
+
+	co_await UploadTexture(m_previewTexture);
+	co_await ResumeOnMainThread();
+
+	m_previewResolution.AddLatency(timer.GetElapsedMilliseconds(), m_texture.GetWidth() * m_texture.GetHeight(), scaleFactor);
+	co_return true;
+}
+
+/// <summary>
+/// runs the passes of a time-sliced effect on the main thread, within the budget of each frame, and uploads the final rows 
+/// done in a frame to the texture before the next frame is drawn, so the result builds up on screen. 
+/// A preview shown meanwhile is kept until the last rows are done. Its completion then runs on the workers
+/// </summary>
+AsyncTask<> Quad::RunSlicedEffect(SlicedEffect& slicedEffect)
+{
+	GLuint totalShownRows = 0;
+	bool isDone = false;
+
+	while (!isDone)
+	{
+		co_await ResumeOnNextFrame();
+
+		m_slicedEffect = &slicedEffect;
+
+		Timer timer;
+		isDone = slicedEffect.Run(m_frameBudget.GetRemainingMilliseconds());
+		m_frameBudget.Use(timer.GetElapsedMilliseconds());
+
+		GLuint totalFinalRows = slicedEffect.GetTotalFinalRows();
+
+		if (totalFinalRows > totalShownRows)
+		{
+			co_await ResumeOnRenderThread();
+
+			m_texture.UploadRows(totalShownRows, totalFinalRows);
+			totalShownRows = totalFinalRows;
+		}
+	}
+
+	if (!slicedEffect.IsCancelled())
+	{
+		co_await ResumeOnRenderThread();
+
+		m_isPreviewShown = false;
+	}
+
+	co_await ResumeOnMainThread();
+
+	m_slicedEffect = nullptr;
+
+	if (!slicedEffect.IsCancelled())
+	{
+		co_await ResumeOnWorker(TaskPriority::Interactive);
+
+		slicedEffect.Complete();
+	}
+}
+
+/// <summary>
+/// uploads the pixels with effects to a new texture on the upload thread, which the render thread shows in place of 
+/// the current one once the GPU has passed the fence after it. Without an upload thread, the upload buffer is mapped 
+/// on the render thread, written on the workers, and copied to the texture by the GPU, after which the buffer may be written again. 
+/// The texture uploaded, the quad's own or its preview, is the one drawn from then on
+/// </summary>
+AsyncTask<> Quad::UploadTexture(Texture& texture)
+{
+	if (UploadThread::Instance()->IsRunning())
+	{
+		co_await ResumeOnUploadThread();
+
+		GLuint textureID = texture.UploadInChunks();
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		//the fence is only polled, so it is sent to the GPU now. Without a fence, the upload thread waits for the GPU itself
+		if (fence)
+		{
+			glFlush();
+		}
+		else
+		{
+			glFinish();
+		}
+
+		co_await WaitForFence(fence);
+		co_await ResumeOnRenderThread();
+
+		texture.Publish(textureID);
+		m_isPreviewShown = (&texture == &m_previewTexture);
+		co_return;
+	}
+
+	co_await ResumeOnRenderThread();
+
+	void* mappedPixels = texture.BeginUpload();
+
+	if (!mappedPixels)
+	{
+		co_return;
+	}
+
+	co_await ResumeOnWorker(TaskPriority::Interactive);
+
+	texture.WriteUpload(mappedPixels);
+
+	co_await ResumeOnRenderThread();
+
+	GLsync fence = texture.EndUpload();
+	m_isPreviewShown = (&texture == &m_previewTexture);
+
+	co_await WaitForFence(fence);
 }
\ No newline at end of file
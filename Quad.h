@@ -1,24 +1,53 @@
 #pragma once
 
+#include <deque>
+#include <functional>
+#include <string>
 #include <glm.hpp>
 #include "gl.h"
+#include "AsyncTask.h"
+#include "BlurCache.h"
 #include "Buffer.h"
+#include "FrameBudget.h"
+#include "PreviewResolution.h"
+#include "SlicedEffect.h"
 #include "Texture.h"
 
+//a vertex of the quad mesh, interleaved in a single vertex buffer. 
+//The attribute locations match the layout qualifiers in Shaders/Main.vert
+struct QuadVertex
+{
+	glm::vec3 position;
+	glm::vec2 UV;
+};
+
+using QuadVertexLayout = VertexLayout<Attribute<0, glm::vec3>, Attribute<1, glm::vec2>>;
+static_assert(sizeof(QuadVertex) == QuadVertexLayout::STRIDE, "QuadVertex must match QuadVertexLayout");
+
+//the image shown in the 3d view. Loading an image and applying effects on it are queued as jobs of a coroutine, 
+//which reads files on an I/O thread, decodes and computes effects on the workers and uploads on the upload thread, 
+//so the frame loop never waits for them and keeps showing the previous image until the new one is uploaded. 
+//Effects too slow to follow the input are first shown on a copy of the image at a lower resolution
 class Quad
 {
 
 public:
 
-	Quad();
+	Quad(FrameBudget& frameBudget, PreviewResolution& previewResolution);
 	~Quad();
 
 	void Update();
 	void Render();
+	void Render(const glm::mat4& model);
 	void LoadNewTexture(const std::string& filename);
 	void SaveTextureImage(const std::string& filename);
 	void SaveTextureImageWithEffects(const std::string& filename);
 
+	bool IsBusy() const;
+	bool GetSlicedProgress(GLfloat& progress) const;
+	void Finish();
+
+	const glm::mat4& GetModel() const;
 	const glm::vec3& GetPosition() const;
 	const glm::vec3& GetRotation() const;
 	const glm::vec3& GetScale() const;
@@ -31,12 +60,57 @@ public:
 
 	void InvertColors();
 	void Blur(GLfloat blurPercent, bool isInvert);
+	void SpeculateBlur(GLfloat maxBlurPercent);
+	BlurCache::Statistics GetBlurCacheStatistics() const;
+	void Convolve(const Kernel& kernel);
+	void BoxBlur(GLfloat blurPercent, bool isInvert);
+	void BlurWithPyramid(GLfloat blurPercent, bool isInvert, bool isOnGpu);
+	void Denoise(GLsizei radius, GLfloat noiseLevel, bool isInvert);
+
+	void SetWorkingFormat(Texture::WorkingFormat workingFormat);
+	Texture::WorkingFormat GetWorkingFormat() const;
+	void SetEdgeMode(EdgeMode edgeMode);
+	EdgeMode GetEdgeMode() const;
 
 
 private:
 
+	//an image to load, or an effect changing the pixels with effects of the texture
+	struct Job
+	{
+		std::string filename;
+		std::function<void()> effect;
+		std::function<bool(SlicedEffect&)> slice; //adds the passes of the effect to run it time-sliced, if it can
+		std::function<bool(Texture&, GLsizei)> preview; //applies the effect on the image scaled down by the factor, if it needs to
+		bool isOnRenderThread; //the effect uses OpenGL
+		GLuint input; //the count of inputs when it was queued
+	};
+
+	void QueueEffect(std::function<void()> effect, std::function<bool(SlicedEffect&)> slice, 
+		             std::function<bool(Texture&, GLsizei)> preview, bool isFromSource, bool isOnRenderThread = false);
+	void StartJobs();
+	AsyncTask<> RunJobs();
+	AsyncTask<> LoadTexture(std::string filename);
+	AsyncTask<> ApplyEffect(Job job);
+	AsyncTask<bool> ApplyPreview(const Job& job, GLsizei scaleFactor);
+	AsyncTask<> RunSlicedEffect(SlicedEffect& slicedEffect);
+	AsyncTask<> UploadTexture(Texture& texture);
+
 	Buffer m_buffer;	
 	Texture m_texture;
+	Texture m_previewTexture; //the image scaled down, which effects are previewed on
+	GLsizei m_previewScaleFactor; //of the image in the preview texture, 0 if it has to be scaled again
+	bool m_isPreviewShown; //the preview texture is drawn in place of the texture. Only touched on the thread the screen's context is current on
+	BlurCache m_blurCache; //blurs for the slider steps next to the current one, computed while the slider is idle
+
+	FrameBudget& m_frameBudget; //of the frame loop, which time-sliced effects run within
+	PreviewResolution& m_previewResolution; //chooses the scale of the previews
+
+	std::deque<Job> m_jobs; //waiting for the job running
+	AsyncTask<> m_jobRunner;
+	SlicedEffect* m_slicedEffect; //running time-sliced on the main thread, if any
+	GLuint m_totalInputs; //images loaded and effects from the source queued, which drop the effects waiting for the input to settle
+	bool m_isFinishing; //the jobs are waited for, so effects no longer wait for the input to settle
 
 	bool m_isDirty;
 
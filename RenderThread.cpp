@@ -0,0 +1,419 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include "GLState.h"
+#include "RenderThread.h"
+#include "Screen.h"
+#include "Timer.h"
+
+//copies the elements of an ImGui vector, keeping its memory when it is large enough already
+template <typename T>
+static void CopyVector(ImVector<T>& target, const ImVector<T>& source)
+{
+	target.resize(source.Size);
+
+	if (source.Size > 0)
+	{
+		std::memcpy(target.Data, source.Data, source.size_in_bytes());
+	}
+}
+
+//set on the render thread, so coroutines already there go on at once
+static thread_local bool isRenderThread = false;
+
+GuiDrawData::GuiDrawData()
+{
+}
+
+GuiDrawData::~GuiDrawData()
+{
+	for (ImDrawList* drawList : m_drawLists)
+	{
+		IM_DELETE(drawList);
+	}
+}
+
+/// <summary>
+/// copies the draw lists ImGui built for the frame, which ImGui reuses once the next frame starts. Called on the main thread
+/// </summary>
+void GuiDrawData::Copy(const ImDrawData* drawData)
+{
+	m_drawData = *drawData;
+
+	while (m_drawLists.size() < static_cast<size_t>(drawData->CmdListsCount))
+	{
+		m_drawLists.push_back(IM_NEW(ImDrawList)(drawData->CmdLists[m_drawLists.size()]->_Data));
+	}
+
+	for (int i = 0; i < drawData->CmdListsCount; i++)
+	{
+		const ImDrawList* source = drawData->CmdLists[i];
+		ImDrawList* target = m_drawLists[i];
+
+		CopyVector(target->CmdBuffer, source->CmdBuffer);
+		CopyVector(target->IdxBuffer, source->IdxBuffer);
+		CopyVector(target->VtxBuffer, source->VtxBuffer);
+		target->Flags = source->Flags;
+	}
+
+	m_drawData.CmdLists = m_drawLists.data();
+}
+
+/// <returns>returns nullptr if nothing was copied yet</returns>
+ImDrawData* GuiDrawData::Get()
+{
+	return m_drawData.Valid ? &m_drawData : nullptr;
+}
+
+RenderThread* RenderThread::Instance()
+{
+	static RenderThread* renderThread = new RenderThread;
+	return renderThread;
+}
+
+RenderThread::RenderThread()
+{
+	m_isRunning = false;
+	m_isStopping = false;
+
+	m_nextFrameState = 0;
+	m_waitingFrameState = NO_FRAME_STATE;
+	m_drawnFrameState = NO_FRAME_STATE;
+
+	m_lastFrameMilliseconds = 0.0;
+}
+
+/// <summary>
+/// hands the screen's context over to the render thread and starts it. Called on the main thread before the interactive loop
+/// </summary>
+/// <param name="renderFrame">draws a frame from its state, between clearing the screen and presenting it</param>
+/// <returns>returns false if the context could not be made current on the render thread, 
+/// in which case the main thread keeps it and draws the frames itself</returns>
+bool RenderThread::Start(std::function<void(FrameState&)> renderFrame)
+{
+	if (m_isRunning)
+	{
+		return true;
+	}
+
+	m_renderFrame = std::move(renderFrame);
+
+	//a context is current on one thread at a time
+	Screen::Instance()->MakeCurrent(nullptr);
+
+	std::promise<bool> isCurrent;
+	std::future<bool> isCurrentResult = isCurrent.get_future();
+
+	m_isStopping = false;
+	m_thread = std::thread(&RenderThread::Loop, this, std::ref(isCurrent));
+
+	if (!isCurrentResult.get())
+	{
+		std::cout << "Error making the OpenGL context current on the render thread" << std::endl;
+
+		m_thread.join();
+		Screen::Instance()->MakeCurrent(Screen::Instance()->GetContext());
+		return false;
+	}
+
+	m_isRunning = true;
+	return true;
+}
+
+/// <summary>
+/// draws the frame submitted last, ends the render thread and hands the context back to the main thread. 
+/// Coroutines still waiting for the render thread or for fences resume on the main thread instead. Called on the main thread
+/// </summary>
+void RenderThread::Stop()
+{
+	if (!m_isRunning)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+
+	Screen::Instance()->MakeCurrent(Screen::Instance()->GetContext());
+
+	std::vector<std::coroutine_handle<>> handles;
+	std::vector<FenceWait> fenceWaits;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isRunning = false;
+		handles.swap(m_handles);
+		fenceWaits.swap(m_fenceWaits);
+	}
+
+	for (std::coroutine_handle<> handle : handles)
+	{
+		MainThread::Instance()->Post(handle);
+	}
+
+	for (const FenceWait& fenceWait : fenceWaits)
+	{
+		MainThread::Instance()->WaitForFence(fenceWait.fence, fenceWait.handle);
+	}
+}
+
+bool RenderThread::IsRunning() const
+{
+	return m_isRunning;
+}
+
+/// <summary>
+/// whether the calling thread is the one the screen's context is current on: the render thread while it runs, 
+/// the main thread otherwise
+/// </summary>
+bool RenderThread::IsCurrent() const
+{
+	return m_isRunning ? isRenderThread : MainThread::Instance()->IsCurrent();
+}
+
+/// <summary>
+/// the state to fill in for the next frame, which neither waits to be drawn nor is being drawn. Called on the main thread
+/// </summary>
+FrameState& RenderThread::GetNextFrameState()
+{
+	return m_frameStates[m_nextFrameState];
+}
+
+/// <summary>
+/// hands the state filled in over to the render thread. Waits while the state submitted before is not taken yet, 
+/// so the main thread runs at most one frame ahead of the one drawn. Without a render thread, the frame is drawn at once. 
+/// Called on the main thread
+/// </summary>
+void RenderThread::SubmitFrameState()
+{
+	if (!m_isRunning)
+	{
+		GLState::Instance()->BeginFrame();
+		Screen::Instance()->ClearScreen();
+		m_renderFrame(m_frameStates[m_nextFrameState]);
+		Screen::Instance()->Present();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_waitingFrameState == NO_FRAME_STATE; });
+
+		m_waitingFrameState = m_nextFrameState;
+
+		for (int i = 0; i < TOTAL_FRAME_STATES; i++)
+		{
+			if (i != m_waitingFrameState && i != m_drawnFrameState)
+			{
+				m_nextFrameState = i;
+				break;
+			}
+		}
+	}
+
+	m_condition.notify_all();
+}
+
+/// <summary>
+/// runs work that needs the screen's context on the render thread, between frames, and waits for it. 
+/// Without a render thread, the work runs at once. Called on the main thread
+/// </summary>
+void RenderThread::Run(const std::function<void()>& work)
+{
+	if (!m_isRunning)
+	{
+		work();
+		return;
+	}
+
+	std::promise<void> isDone;
+	std::future<void> isDoneResult = isDone.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_work.push_back([&]() { work(); isDone.set_value(); });
+	}
+
+	m_condition.notify_all();
+	isDoneResult.wait();
+}
+
+/// <summary>
+/// queues a coroutine to be resumed on the render thread before the next frame, 
+/// or on the main thread if the render thread is not running. Called from any thread
+/// </summary>
+void RenderThread::Post(std::coroutine_handle<> handle)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_isRunning)
+		{
+			m_handles.push_back(handle);
+			m_condition.notify_all();
+			return;
+		}
+	}
+
+	MainThread::Instance()->Post(handle);
+}
+
+/// <summary>
+/// resumes a coroutine on the render thread once the GPU has passed a fence, 
+/// or on the main thread if the render thread is not running. Called from any thread
+/// </summary>
+void RenderThread::WaitForFence(GLsync fence, std::coroutine_handle<> handle)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_isRunning)
+		{
+			m_fenceWaits.push_back({ fence, handle });
+			m_condition.notify_all();
+			return;
+		}
+	}
+
+	MainThread::Instance()->WaitForFence(fence, handle);
+}
+
+/// <summary>
+/// the time the render thread took to draw and present the last frame, waiting for the display included
+/// </summary>
+double RenderThread::GetLastFrameMilliseconds() const
+{
+	return m_lastFrameMilliseconds;
+}
+
+void RenderThread::Loop(std::promise<bool>& isCurrent)
+{
+	if (!Screen::Instance()->MakeCurrent(Screen::Instance()->GetContext()))
+	{
+		isCurrent.set_value(false);
+		return;
+	}
+
+	isCurrent.set_value(true);
+	isRenderThread = true;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto isWoken = [this]() 
+	{ 
+		return m_isStopping || m_waitingFrameState != NO_FRAME_STATE || !m_work.empty() || !m_handles.empty(); 
+	};
+
+	while (true)
+	{
+		//fences are only polled, so the thread wakes up every millisecond while any is waited for
+		if (m_fenceWaits.empty())
+		{
+			m_condition.wait(lock, isWoken);
+		}
+		else
+		{
+			m_condition.wait_for(lock, std::chrono::milliseconds(1), isWoken);
+		}
+
+		RunPending(lock);
+
+		if (m_waitingFrameState != NO_FRAME_STATE)
+		{
+			m_drawnFrameState = m_waitingFrameState;
+			m_waitingFrameState = NO_FRAME_STATE;
+
+			lock.unlock();
+			m_condition.notify_all();
+
+			Timer timer;
+
+			GLState::Instance()->BeginFrame();
+			Screen::Instance()->ClearScreen();
+			m_renderFrame(m_frameStates[m_drawnFrameState]);
+			Screen::Instance()->Present();
+
+			m_lastFrameMilliseconds = timer.GetElapsedMilliseconds();
+
+			lock.lock();
+		}
+		else if (m_isStopping && m_work.empty() && m_handles.empty())
+		{
+			break;
+		}
+	}
+
+	lock.unlock();
+
+	isRenderThread = false;
+	Screen::Instance()->MakeCurrent(nullptr);
+}
+
+/// <summary>
+/// runs the work queued by Run, and resumes the coroutines moved to the render thread and those whose fences the GPU has passed. 
+/// The lock is released meanwhile, so they may queue more, which wait for the next call
+/// </summary>
+void RenderThread::RunPending(std::unique_lock<std::mutex>& lock)
+{
+	std::vector<std::function<void()>> work;
+	std::vector<std::coroutine_handle<>> handles;
+
+	work.swap(m_work);
+	handles.swap(m_handles);
+
+	for (size_t i = 0; i < m_fenceWaits.size();)
+	{
+		GLenum status = glClientWaitSync(m_fenceWaits[i].fence, 0, 0);
+
+		//a failed wait resumes the coroutine too, which would otherwise wait forever
+		if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED)
+		{
+			glDeleteSync(m_fenceWaits[i].fence);
+			handles.push_back(m_fenceWaits[i].handle);
+			m_fenceWaits.erase(m_fenceWaits.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	if (work.empty() && handles.empty())
+	{
+		return;
+	}
+
+	lock.unlock();
+
+	for (const std::function<void()>& function : work)
+	{
+		function();
+	}
+
+	for (std::coroutine_handle<> handle : handles)
+	{
+		handle.resume();
+	}
+
+	lock.lock();
+}
+
+bool RenderThreadAwaiter::await_ready() const noexcept
+{
+	return RenderThread::Instance()->IsCurrent();
+}
+
+void RenderThreadAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+	RenderThread::Instance()->Post(handle);
+}
+
+RenderThreadAwaiter ResumeOnRenderThread()
+{
+	return {};
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm.hpp>
+#include "gl.h"
+#include "imgui/imgui.h"
+#include "AsyncTask.h"
+
+//a copy of the draw lists ImGui built for a frame, which the render thread draws while ImGui builds the next frame's. 
+//The lists are kept between frames, so copying only allocates when the GUI grows
+class GuiDrawData
+{
+
+public:
+
+	GuiDrawData();
+	~GuiDrawData();
+
+	void Copy(const ImDrawData* drawData);
+	ImDrawData* Get();
+
+private:
+
+	GuiDrawData(const GuiDrawData&);
+	GuiDrawData& operator=(const GuiDrawData&);
+
+	ImDrawData m_drawData;
+	std::vector<ImDrawList*> m_drawLists;
+
+};
+
+//the state of the scene a frame is drawn from, filled in by the main thread and drawn by the render thread
+struct FrameState
+{
+	glm::mat4 quadModel = glm::mat4(1.0f);
+	GuiDrawData gui;
+};
+
+//a thread that owns the screen's OpenGL context while the interactive loop runs, and draws and presents the frames, 
+//so the main thread builds the GUI and updates the scene for the next frame while the last one is drawn. 
+//The two threads hand frames over through three FrameStates: one filled in, one waiting, and one being drawn. 
+//Other work that needs the context runs on the render thread too, through Run, ResumeOnRenderThread and fences, 
+//or on the main thread while the render thread is not running
+class RenderThread
+{
+
+public:
+
+	static RenderThread* Instance();
+
+	bool Start(std::function<void(FrameState&)> renderFrame);
+	void Stop();
+	bool IsRunning() const;
+	bool IsCurrent() const;
+
+	FrameState& GetNextFrameState();
+	void SubmitFrameState();
+
+	void Run(const std::function<void()>& work);
+	void Post(std::coroutine_handle<> handle);
+	void WaitForFence(GLsync fence, std::coroutine_handle<> handle);
+
+	double GetLastFrameMilliseconds() const;
+
+private:
+
+	struct FenceWait
+	{
+		GLsync fence;
+		std::coroutine_handle<> handle;
+	};
+
+	RenderThread();
+	RenderThread(const RenderThread&);
+
+	void Loop(std::promise<bool>& isCurrent);
+	void RunPending(std::unique_lock<std::mutex>& lock);
+
+	static const int TOTAL_FRAME_STATES = 3;
+	static const int NO_FRAME_STATE = -1;
+
+	std::function<void(FrameState&)> m_renderFrame;
+	std::thread m_thread;
+	std::atomic<bool> m_isRunning; //read by the threads posting coroutines, changed under the mutex
+	bool m_isStopping;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+
+	FrameState m_frameStates[TOTAL_FRAME_STATES];
+	int m_nextFrameState; //filled in by the main thread
+	int m_waitingFrameState; //submitted, and not taken by the render thread yet
+	int m_drawnFrameState; //being drawn by the render thread
+
+	std::vector<std::function<void()>> m_work;
+	std::vector<std::coroutine_handle<>> m_handles;
+	std::vector<FenceWait> m_fenceWaits;
+
+	std::atomic<double> m_lastFrameMilliseconds;
+
+};
+
+//moves the coroutine to the render thread, for work that needs the screen's OpenGL context, 
+//or to the main thread while the render thread is not running
+struct RenderThreadAwaiter
+{
+	bool await_ready() const noexcept;
+	void await_suspend(std::coroutine_handle<> handle) const;
+	void await_resume() const noexcept {}
+};
+
+RenderThreadAwaiter ResumeOnRenderThread();
\ No newline at end of file
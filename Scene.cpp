@@ -0,0 +1,240 @@
+#include <gtc/matrix_transform.hpp>
+#include "Scene.h"
+#include "Shader.h"
+
+Scene::Scene()
+{
+	m_isDirty = true;
+	m_atlasVersion = 0;
+
+	//data that represents the vertices of the shared quad mesh, each with its position and UV coordinates
+	QuadVertex vertices[] = { { glm::vec3(-0.5f,  0.5f, 0.0f), glm::vec2(0.0f, 0.0f) },
+	                          { glm::vec3( 0.5f,  0.5f, 0.0f), glm::vec2(1.0f, 0.0f) },
+	                          { glm::vec3( 0.5f, -0.5f, 0.0f), glm::vec2(1.0f, 1.0f) },
+	                          { glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec2(0.0f, 1.0f) } };
+
+	//index buffer to control the rendering
+	GLuint indices[] = { 0, 1, 3,
+					     3, 1, 2 };
+
+	m_buffer.CreateBuffer(6, true, true);
+	m_buffer.FillEBO(indices, sizeof(indices), Buffer::FillType::Once);
+	m_buffer.FillVBO(Buffer::VBOType::VertexBuffer, vertices, sizeof(vertices), Buffer::FillType::Once);
+
+	m_buffer.LinkEBO();
+	m_buffer.LinkVBO<QuadVertexLayout>(Buffer::VBOType::VertexBuffer);
+	m_buffer.LinkVBO<InstanceLayout>(Buffer::VBOType::InstanceBuffer);
+}
+
+Scene::~Scene()
+{
+	m_buffer.DestroyBuffer();
+}
+
+/// <summary>
+/// loads an image into the scene's atlas, so that quads in the scene can refer to it by the returned index
+/// </summary>
+/// <param name="filename">path to the image</param>
+/// <returns>index of the texture within the scene, or -1 if the image could not be loaded</returns>
+GLint Scene::LoadTexture(const std::string& filename)
+{
+	return m_atlas.AddImage(filename);
+}
+
+/// <summary>
+/// removes an image from the scene's atlas. Quads still referring to it must be removed or given another texture.
+/// </summary>
+void Scene::UnloadTexture(GLuint textureIndex)
+{
+	m_atlas.RemoveImage(textureIndex);
+}
+
+/// <summary>
+/// adds a quad to the scene
+/// </summary>
+/// <returns>index of the quad, used for changing its transform later</returns>
+GLuint Scene::AddQuad(GLuint textureIndex, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+	m_quads.push_back({ position, rotation, scale, textureIndex, false });
+	m_isDirty = true;
+
+	return static_cast<GLuint>(m_quads.size() - 1);
+}
+
+void Scene::SetTransform(GLuint quadIndex, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+	m_quads[quadIndex].position = position;
+	m_quads[quadIndex].rotation = rotation;
+	m_quads[quadIndex].scale = scale;
+
+	//only the moved quad is refitted into the hierarchy on the next update
+	if (!m_quads[quadIndex].isDirty)
+	{
+		m_quads[quadIndex].isDirty = true;
+		m_dirtyQuads.push_back(quadIndex);
+	}
+}
+
+void Scene::Clear()
+{
+	m_quads.clear();
+	m_dirtyQuads.clear();
+	m_isDirty = true;
+}
+
+GLuint Scene::GetTotalQuads() const
+{
+	return static_cast<GLuint>(m_quads.size());
+}
+
+GLuint Scene::GetTotalVisibleQuads() const
+{
+	return static_cast<GLuint>(m_visibleQuads.size());
+}
+
+/// <summary>
+/// finds the quad under the mouse, using the hierarchy to test only the quads whose bounds the mouse ray passes through
+/// </summary>
+/// <param name="camera">the camera the scene is viewed with</param>
+/// <param name="mouseX">mouse position in pixels, relative to the left of the viewport</param>
+/// <param name="mouseY">mouse position in pixels, relative to the top of the viewport</param>
+/// <returns>index of the closest quad under the mouse, or -1 if there is none</returns>
+GLint Scene::Pick(const Camera& camera, int mouseX, int mouseY) const
+{
+	glm::vec3 origin;
+	glm::vec3 direction;
+	camera.GetRay(mouseX, mouseY, origin, direction);
+
+	return m_bvh.Raycast(origin, direction, [&](GLuint quadIndex, GLfloat& distance)
+	{
+		//in the quad's local space the quad is the unit square around the origin of the z = 0 plane.
+		//The transform is affine, so the distance along the local ray equals the distance along the world ray
+		glm::mat4 inverseModel = glm::inverse(m_models[quadIndex]);
+		glm::vec3 localOrigin = glm::vec3(inverseModel * glm::vec4(origin, 1.0f));
+		glm::vec3 localDirection = glm::vec3(inverseModel * glm::vec4(direction, 0.0f));
+
+		if (std::abs(localDirection.z) < 1e-6f)
+		{
+			return false;
+		}
+
+		distance = -localOrigin.z / localDirection.z;
+		glm::vec3 hit = localOrigin + distance * localDirection;
+
+		return distance >= 0.0f && std::abs(hit.x) <= 0.5f && std::abs(hit.y) <= 0.5f;
+	});
+}
+
+/// <summary>
+/// brings the hierarchy up to date with the quads, culls the quads outside the camera's view, 
+/// and rebuilds the instance buffer from the visible quads if anything changed
+/// </summary>
+/// <param name="camera">the camera the scene is viewed with</param>
+void Scene::Update(const Camera& camera)
+{
+	bool isChanged = m_isDirty || !m_dirtyQuads.empty() || m_atlasVersion != m_atlas.GetVersion();
+
+	if (m_isDirty)
+	{
+		m_models.resize(m_quads.size());
+		m_bounds.resize(m_quads.size());
+
+		for (GLuint i = 0; i < m_quads.size(); i++)
+		{
+			UpdateModel(i);
+		}
+
+		m_bvh.Build(m_bounds);
+	}
+	else if (!m_dirtyQuads.empty())
+	{
+		for (GLuint quadIndex : m_dirtyQuads)
+		{
+			UpdateModel(quadIndex);
+		}
+
+		m_bvh.Refit(m_dirtyQuads, m_bounds);
+	}
+
+	for (GLuint quadIndex : m_dirtyQuads)
+	{
+		m_quads[quadIndex].isDirty = false;
+	}
+
+	m_dirtyQuads.clear();
+	m_isDirty = false;
+
+	m_visibleQuads.swap(m_previousVisibleQuads);
+	m_bvh.QueryFrustum(camera.GetProjection() * camera.GetView(), m_visibleQuads);
+
+	if (!isChanged && m_visibleQuads == m_previousVisibleQuads)
+	{
+		return;
+	}
+
+	m_instances.resize(m_visibleQuads.size());
+	for (size_t i = 0; i < m_visibleQuads.size(); i++)
+	{
+		GLuint quadIndex = m_visibleQuads[i];
+		const ImageAtlas::Region& region = m_atlas.GetRegion(m_quads[quadIndex].textureIndex);
+
+		m_instances[i] = { m_models[quadIndex], region.uvRect, region.layer };
+	}
+
+	m_buffer.FillVBO(Buffer::VBOType::InstanceBuffer, m_instances.data(),
+		m_instances.size() * sizeof(InstanceData), Buffer::FillType::Ongoing);
+
+	m_atlasVersion = m_atlas.GetVersion();
+}
+
+/// <summary>
+/// renders all quads in the scene with one instanced draw call, sampling their images from the atlas
+/// </summary>
+void Scene::Render()
+{
+	if (m_instances.empty())
+	{
+		return;
+	}
+
+	Shader::Instance()->SendUniformData("isInstanced", 1);
+
+	m_atlas.Bind();
+	m_buffer.RenderInstanced(Buffer::DrawType::Triangles, static_cast<GLsizei>(m_instances.size()));
+}
+
+/// <summary>
+/// recomputes the model matrix of a quad and its world space bounds
+/// </summary>
+void Scene::UpdateModel(GLuint quadIndex)
+{
+	const QuadInstance& quad = m_quads[quadIndex];
+
+	glm::mat4 model = glm::mat4(1.0f);
+	model = glm::translate(model, quad.position);
+	model = glm::rotate(model, glm::radians(quad.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	model = glm::rotate(model, glm::radians(quad.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+	model = glm::rotate(model, glm::radians(quad.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	model = glm::scale(model, quad.scale);
+
+	m_models[quadIndex] = model;
+
+	glm::vec3 corners[] = { glm::vec3(model * glm::vec4(-0.5f,  0.5f, 0.0f, 1.0f)),
+		                    glm::vec3(model * glm::vec4( 0.5f,  0.5f, 0.0f, 1.0f)),
+		                    glm::vec3(model * glm::vec4( 0.5f, -0.5f, 0.0f, 1.0f)),
+		                    glm::vec3(model * glm::vec4(-0.5f, -0.5f, 0.0f, 1.0f)) };
+
+	BoundingVolumeHierarchy::AABB& bounds = m_bounds[quadIndex];
+	bounds.min = corners[0];
+	bounds.max = corners[0];
+
+	for (const glm::vec3& corner : corners)
+	{
+		bounds.min = glm::min(bounds.min, corner);
+		bounds.max = glm::max(bounds.max, corner);
+	}
+
+	//quads are flat, so the bounds are given a little thickness to keep ray tests against them well defined
+	bounds.min -= glm::vec3(1e-4f);
+	bounds.max += glm::vec3(1e-4f);
+}
\ No newline at end of file
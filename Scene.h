@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm.hpp>
+#include "gl.h"
+#include "Buffer.h"
+#include "BoundingVolumeHierarchy.h"
+#include "Camera.h"
+#include "ImageAtlas.h"
+#include "Quad.h"
+
+//a collection of quads that share one static quad mesh and are drawn with a single instanced draw call.
+//Each quad is an instance with its own transform and an index of an image in the scene's image atlas.
+//A bounding volume hierarchy over the quads skips the ones outside the view and finds the quad under the mouse.
+class Scene
+{
+
+public:
+
+	Scene();
+	~Scene();
+
+	GLint LoadTexture(const std::string& filename);
+	void UnloadTexture(GLuint textureIndex);
+
+	GLuint AddQuad(GLuint textureIndex, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+	void SetTransform(GLuint quadIndex, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+	void Clear();
+
+	GLuint GetTotalQuads() const;
+	GLuint GetTotalVisibleQuads() const;
+
+	GLint Pick(const Camera& camera, int mouseX, int mouseY) const;
+
+	void Update(const Camera& camera);
+	void Render();
+
+private:
+
+	//per-quad state on the CPU side
+	struct QuadInstance
+	{
+		glm::vec3 position;
+		glm::vec3 rotation;
+		glm::vec3 scale;
+		GLuint textureIndex;
+		bool isDirty;
+	};
+
+	//per-instance data as laid out in the instance buffer. 
+	//The attribute locations match the layout qualifiers in Shaders/Main.vert
+	struct InstanceData
+	{
+		glm::mat4 model;
+		glm::vec4 uvRect;
+		GLfloat layer;
+	};
+
+	using InstanceLayout = VertexLayout<Attribute<2, glm::mat4>, Attribute<6, glm::vec4>, Attribute<7, GLfloat>>;
+	static_assert(sizeof(InstanceData) == InstanceLayout::STRIDE, "InstanceData must match InstanceLayout");
+
+	Buffer m_buffer;
+	ImageAtlas m_atlas;
+
+	bool m_isDirty; //set when quads are added or removed, which requires rebuilding the hierarchy
+	GLuint m_atlasVersion;
+
+	std::vector<QuadInstance> m_quads;
+	std::vector<glm::mat4> m_models;
+	std::vector<BoundingVolumeHierarchy::AABB> m_bounds;
+	std::vector<GLuint> m_dirtyQuads; //quads moved since the last update, refitted into the hierarchy
+
+	BoundingVolumeHierarchy m_bvh;
+	std::vector<GLuint> m_visibleQuads;
+	std::vector<GLuint> m_previousVisibleQuads;
+
+	std::vector<InstanceData> m_instances;
+
+	void UpdateModel(GLuint quadIndex);
+
+};
\ No newline at end of file
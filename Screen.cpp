@@ -1,6 +1,19 @@
+#include <algorithm>
 #include <iostream>
+#include <vector>
+#include <SDL_image.h>
+#include "GLState.h"
 #include "Screen.h"
 #include "gl.h"
+#include "Timer.h"
+
+//headless screens render without any window system through EGL where it is available (Mesa's surfaceless 
+//platform runs on llvmpipe), and through a hidden window everywhere else
+#if defined(__linux__)
+#define SCREEN_USE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
 
 Screen* Screen::Instance()
 {
@@ -12,20 +25,287 @@ Screen::Screen()
 {
 	window = nullptr;
 	context = nullptr;
+
+	m_backend = Backend::Window;
+	m_width = 1920;
+	m_height = 1080;
+
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+
+	m_eglDisplay = nullptr;
+	m_eglConfig = nullptr;
+	m_eglContext = nullptr;
 }
 
 /// <summary>
-/// initializes the screen, including the display windlow's location and size
+/// initializes the screen, including the display windlow's location and size. 
+/// A headless screen gets an offscreen framebuffer of the same size and no GUI
 /// </summary>
+/// <param name="backend">whether to render into a window or headless</param>
 /// <returns></returns>
-bool Screen::Initialize()
+bool Screen::Initialize(Backend backend)
 {
-	if (SDL_Init(SDL_INIT_EVERYTHING) == -1)
+	Timer timer;
+
+	m_backend = backend;
+
+	Uint32 subsystems = SDL_INIT_EVERYTHING;
+
+#ifdef SCREEN_USE_EGL
+	//EGL needs no video subsystem, which would fail on machines without a display
+	if (m_backend == Backend::Headless)
+	{
+		subsystems = SDL_INIT_TIMER | SDL_INIT_EVENTS;
+	}
+#endif
+
+	if (SDL_Init(subsystems) == -1)
 	{
 		std::cout << "Error initializing SDL" << std::endl;
 		return false;
 	}
 
+	std::cout << "Startup: SDL init " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+	timer.Start();
+
+	bool isContextCreated = false;
+
+	if (m_backend == Backend::Window)
+	{
+		isContextCreated = CreateWindowContext(SDL_WINDOW_OPENGL | SDL_WINDOW_MAXIMIZED | SDL_WINDOW_RESIZABLE);
+	}
+	else
+	{
+#ifdef SCREEN_USE_EGL
+		isContextCreated = CreateEGLContext();
+#else
+		isContextCreated = CreateWindowContext(SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+#endif
+	}
+
+	if (!isContextCreated)
+	{
+		return false;
+	}
+
+	std::cout << "Startup: GL context " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+	timer.Start();
+
+	int version = 0;
+
+#ifdef SCREEN_USE_EGL
+	if (m_eglContext)
+	{
+		version = gladLoadGL(reinterpret_cast<GLADloadfunc>(eglGetProcAddress));
+	}
+	else
+#endif
+	{
+		version = gladLoaderLoadGL();
+	}
+
+	if (!version)
+	{
+		std::cout << "Error loading extensions!" << std::endl;
+	}
+
+	std::cout << "Startup: glad load " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+	timer.Start();
+
+	if (m_backend == Backend::Headless)
+	{
+		std::cout << "Headless screen: " << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << std::endl;
+		return CreateFramebuffer();
+	}
+
+	ImGui::CreateContext();
+	ImGui_ImplOpenGL3_Init("#version 460");
+	ImGui_ImplSDL2_InitForOpenGL(window, context);
+
+	std::cout << "Startup: ImGui init " << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+
+	return true;
+}
+
+void Screen::ClearScreen()
+{
+	glClear(GL_COLOR_BUFFER_BIT);
+}
+
+/// <summary>
+/// shows the frame in the window. A headless screen waits for the frame to finish instead, 
+/// so frame times measure the same work as with a window
+/// </summary>
+void Screen::Present()
+{
+	if (m_backend == Backend::Headless)
+	{
+		glFinish();
+		return;
+	}
+
+	SDL_GL_SwapWindow(window);
+}
+
+void Screen::Shutdown()
+{
+	glDeleteRenderbuffers(1, &m_colorBuffer);
+	glDeleteRenderbuffers(1, &m_depthBuffer);
+	glDeleteFramebuffers(1, &m_framebuffer);
+
+#ifdef SCREEN_USE_EGL
+	if (m_eglContext)
+	{
+		eglMakeCurrent(m_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(m_eglDisplay, m_eglContext);
+		eglTerminate(m_eglDisplay);
+	}
+#endif
+
+	if (context)
+	{
+		SDL_GL_DeleteContext(context);
+	}
+
+	if (window)
+	{
+		SDL_DestroyWindow(window);
+	}
+
+	SDL_Quit();
+}
+
+/// <summary>
+/// the screen's OpenGL context, for handing it over to another thread with MakeCurrent
+/// </summary>
+void* Screen::GetContext() const
+{
+	return m_eglContext ? m_eglContext : context;
+}
+
+/// <summary>
+/// creates a second OpenGL context sharing textures, buffers and fences with the screen's, for another thread 
+/// to make current with MakeCurrent. The screen's context stays current on the calling thread. Called on the main thread
+/// </summary>
+/// <returns>returns nullptr if the driver cannot share a context</returns>
+void* Screen::CreateSharedContext()
+{
+	void* sharedContext = nullptr;
+
+#ifdef SCREEN_USE_EGL
+	if (m_eglContext)
+	{
+		sharedContext = CreateEGLCoreContext(m_eglContext);
+	}
+	else
+#endif
+	{
+		//SDL makes the new context current, so the screen's is made current again
+		SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+		sharedContext = SDL_GL_CreateContext(window);
+		SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+		SDL_GL_MakeCurrent(window, context);
+	}
+
+	if (!sharedContext)
+	{
+		std::cout << "Error creating a shared OpenGL context" << std::endl;
+	}
+
+	return sharedContext;
+}
+
+/// <summary>
+/// makes the screen's context or one from CreateSharedContext current on the calling thread, or none if given nullptr. 
+/// A context is current on one thread at a time. The GL state cached on the thread belonged to the context before, so it is forgotten
+/// </summary>
+bool Screen::MakeCurrent(void* context)
+{
+	GLState::Instance()->Invalidate();
+
+#ifdef SCREEN_USE_EGL
+	if (m_eglContext)
+	{
+		return eglMakeCurrent(m_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, context ? context : EGL_NO_CONTEXT);
+	}
+#endif
+
+	return SDL_GL_MakeCurrent(window, static_cast<SDL_GLContext>(context)) == 0;
+}
+
+/// <summary>
+/// destroys a context from CreateSharedContext, once no thread has it current any more
+/// </summary>
+void Screen::DestroySharedContext(void* sharedContext)
+{
+#ifdef SCREEN_USE_EGL
+	if (m_eglContext)
+	{
+		eglDestroyContext(m_eglDisplay, sharedContext);
+		return;
+	}
+#endif
+
+	SDL_GL_DeleteContext(static_cast<SDL_GLContext>(sharedContext));
+}
+
+bool Screen::IsHeadless() const
+{
+	return m_backend == Backend::Headless;
+}
+
+GLsizei Screen::GetWidth() const
+{
+	return m_width;
+}
+
+GLsizei Screen::GetHeight() const
+{
+	return m_height;
+}
+
+/// <summary>
+/// saves the frame rendered so far as a png file. Call before Present, as the back buffer is undefined after a swap
+/// </summary>
+/// <param name="filename">save path</param>
+/// <returns>returns false if the file could not be written</returns>
+bool Screen::SaveFramebuffer(const std::string& filename)
+{
+	GLsizei pitch = m_width * 4;
+	std::vector<Uint8> pixels(pitch * m_height);
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+	SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, m_width, m_height, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (!image)
+	{
+		std::cout << "Error saving framebuffer: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	//OpenGL stores the bottom row first
+	for (GLsizei row = 0; row < m_height; row++)
+	{
+		std::copy_n(&pixels[(m_height - 1 - row) * pitch], pitch, static_cast<Uint8*>(image->pixels) + row * image->pitch);
+	}
+
+	bool isSaved = (IMG_SavePNG(image, filename.c_str()) == 0);
+	SDL_FreeSurface(image);
+
+	if (!isSaved)
+	{
+		std::cout << "Error saving framebuffer: " << filename << std::endl;
+	}
+
+	return isSaved;
+}
+
+bool Screen::CreateWindowContext(Uint32 windowFlags)
+{
 	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
 	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 8);
 	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 8);
@@ -37,12 +317,12 @@ bool Screen::Initialize()
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
 
 	window = SDL_CreateWindow("Graphics Engine",
 							  SDL_WINDOWPOS_UNDEFINED,
 							  SDL_WINDOWPOS_UNDEFINED,
-							  1920, 1080, SDL_WINDOW_OPENGL | SDL_WINDOW_MAXIMIZED | SDL_WINDOW_RESIZABLE);
+							  m_width, m_height, windowFlags);
 
 	if (!window)
 	{
@@ -58,32 +338,124 @@ bool Screen::Initialize()
 		return false;
 	}
 
-	if (!gladLoaderLoadGL())
+	return true;
+}
+
+/// <summary>
+/// creates an OpenGL core context that is current without any surface, 
+/// preferring Mesa's surfaceless platform so no display server is needed
+/// </summary>
+bool Screen::CreateEGLContext()
+{
+#ifdef SCREEN_USE_EGL
+	EGLDisplay display = EGL_NO_DISPLAY;
+
+	auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+	if (getPlatformDisplay)
 	{
-		std::cout << "Error loading extensions!" << std::endl;
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
 	}
 
-	ImGui::CreateContext();
-	ImGui_ImplOpenGL3_Init("#version 460");
-	ImGui_ImplSDL2_InitForOpenGL(window, context);
+	if (display == EGL_NO_DISPLAY)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+	{
+		std::cout << "Error initializing EGL" << std::endl;
+		return false;
+	}
+
+	m_eglDisplay = display;
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		std::cout << "Error binding the OpenGL API to EGL" << std::endl;
+		return false;
+	}
+
+	const EGLint configAttributes[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		                                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		                                EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+		                                EGL_NONE };
+
+	EGLConfig config;
+	EGLint totalConfigs = 0;
+
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &totalConfigs) || totalConfigs == 0)
+	{
+		std::cout << "Error choosing an EGL config" << std::endl;
+		return false;
+	}
+
+	m_eglConfig = config;
+	m_eglContext = CreateEGLCoreContext(EGL_NO_CONTEXT);
+
+	if (m_eglContext == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_eglContext))
+	{
+		std::cout << "Error creating EGL context" << std::endl;
+		return false;
+	}
 
 	return true;
+#else
+	return false;
+#endif
 }
 
-void Screen::ClearScreen()
+/// <summary>
+/// creates an OpenGL 4.6 core context, or 4.5 where the driver stops there, sharing objects with the given context
+/// </summary>
+/// <returns>returns EGL_NO_CONTEXT if the context could not be created</returns>
+void* Screen::CreateEGLCoreContext(void* sharedContext)
 {
-	glClear(GL_COLOR_BUFFER_BIT);
-}
+#ifdef SCREEN_USE_EGL
+	//software renderers such as llvmpipe stop at 4.5, which has everything the renderer uses
+	const EGLint minorVersions[] = { 6, 5 };
 
-void Screen::Present()
-{
-	SDL_GL_SwapWindow(window);
+	for (EGLint minorVersion : minorVersions)
+	{
+		const EGLint contextAttributes[] = { EGL_CONTEXT_MAJOR_VERSION, 4,
+			                                 EGL_CONTEXT_MINOR_VERSION, minorVersion,
+			                                 EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			                                 EGL_NONE };
+
+		EGLContext context = eglCreateContext(m_eglDisplay, m_eglConfig, sharedContext, contextAttributes);
+
+		if (context != EGL_NO_CONTEXT)
+		{
+			return context;
+		}
+	}
+#endif
+
+	return nullptr;
 }
 
-void Screen::Shutdown()
+/// <summary>
+/// creates the offscreen framebuffer headless screens render into and leaves it bound
+/// </summary>
+bool Screen::CreateFramebuffer()
 {
-	SDL_GL_DeleteContext(context);
-	SDL_DestroyWindow(window);
-	SDL_Quit();
-}
+	glCreateRenderbuffers(1, &m_colorBuffer);
+	glNamedRenderbufferStorage(m_colorBuffer, GL_RGBA8, m_width, m_height);
+
+	glCreateRenderbuffers(1, &m_depthBuffer);
+	glNamedRenderbufferStorage(m_depthBuffer, GL_DEPTH24_STENCIL8, m_width, m_height);
+
+	glCreateFramebuffers(1, &m_framebuffer);
+	glNamedFramebufferRenderbuffer(m_framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glNamedFramebufferRenderbuffer(m_framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
 
+	if (glCheckNamedFramebufferStatus(m_framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Error creating the offscreen framebuffer" << std::endl;
+		return false;
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+
+	return true;
+}
\ No newline at end of file
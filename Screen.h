@@ -1,6 +1,8 @@
 #pragma once
 
+#include <string>
 #include <SDL.h>
+#include "gl.h"
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_opengl3.h"
 #include "imgui/imgui_impl_sdl2.h"
@@ -10,19 +12,53 @@ class Screen
 
 public:
 
+	//a window shows the frames and the GUI. A headless screen renders into an offscreen framebuffer instead, 
+	//through an EGL context without any window system where EGL is available, otherwise through a hidden window
+	enum class Backend { Window, Headless };
+
 	static Screen* Instance();
 
-	bool Initialize();
+	bool Initialize(Backend backend = Backend::Window);
 	void ClearScreen();
 	void Present();
 	void Shutdown();
 
+	bool IsHeadless() const;
+	GLsizei GetWidth() const;
+	GLsizei GetHeight() const;
+
+	bool SaveFramebuffer(const std::string& filename);
+
+	void* GetContext() const;
+	void* CreateSharedContext();
+	bool MakeCurrent(void* context);
+	void DestroySharedContext(void* sharedContext);
+
 private:
 
 	Screen();
 	Screen(const Screen&);
 
+	bool CreateWindowContext(Uint32 windowFlags);
+	bool CreateEGLContext();
+	void* CreateEGLCoreContext(void* sharedContext);
+	bool CreateFramebuffer();
+
 	SDL_Window* window;
 	SDL_GLContext context;
 
+	Backend m_backend;
+	GLsizei m_width;
+	GLsizei m_height;
+
+	//offscreen render target of headless screens
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+
+	//EGLDisplay, EGLConfig and EGLContext, kept opaque so EGL headers are only needed by Screen.cpp
+	void* m_eglDisplay;
+	void* m_eglConfig;
+	void* m_eglContext;
+
 };
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <vector>
+#include <SDL.h>
+#include "GLState.h"
 #include "Shader.h"
 
 Shader* Shader::Instance()
@@ -59,14 +63,7 @@ bool Shader::CreateShaders()
 bool Shader::CompileShaders(const std::string& filename, ShaderType shaderType)
 {
 
-	std::fstream file;
-	std::string text;
-	std::string sourceCode;
-	GLuint shaderID;
-
-	shaderID = (shaderType == ShaderType::VERTEX_SHADER) ? m_vertexShaderID : m_fragmentShaderID;
-
-	file.open(filename);
+	std::ifstream file(filename);
 
 	if (!file)
 	{
@@ -74,13 +71,20 @@ bool Shader::CompileShaders(const std::string& filename, ShaderType shaderType)
 		return false;
 	}
 
-	while (!file.eof())
-	{
-		std::getline(file, text);
-		sourceCode += text + "\n";
-	}
+	std::stringstream sourceCode;
+	sourceCode << file.rdbuf();
+
+	return CompileShaderSource(sourceCode.str(), shaderType);
+}
 
-	file.close();
+/// <summary>
+/// compiles shader source code that is already in memory, such as the sources embedded at build time
+/// </summary>
+/// <param name="sourceCode">GLSL source code of the shader</param>
+/// <param name="shaderType">the shader object to compile the source code into</param>
+bool Shader::CompileShaderSource(const std::string& sourceCode, ShaderType shaderType)
+{
+	GLuint shaderID = (shaderType == ShaderType::VERTEX_SHADER) ? m_vertexShaderID : m_fragmentShaderID;
 
 	const GLchar* finalSourceCode = reinterpret_cast<const GLchar*>(sourceCode.c_str());
 	glShaderSource(shaderID, 1, &finalSourceCode, nullptr);
@@ -115,9 +119,12 @@ void Shader::AttachShaders()
 
 bool Shader::LinkProgram()
 {
+	//lets the driver keep the linked binary around so it can be cached with SaveProgramBinary
+	glProgramParameteri(m_shaderProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
 	glLinkProgram(m_shaderProgramID);
 
-	glUseProgram(m_shaderProgramID);
+	GLState::Instance()->UseProgram(m_shaderProgramID);
 
 	GLint errorCode;
 	glGetProgramiv(m_shaderProgramID, GL_LINK_STATUS, &errorCode);
@@ -139,20 +146,153 @@ bool Shader::LinkProgram()
 	return true;
 }
 
+/// <summary>
+/// links the program from a binary cached by a previous run, skipping shader compilation entirely
+/// </summary>
+/// <param name="vertexSource">vertex shader source the binary was built from</param>
+/// <param name="fragmentSource">fragment shader source the binary was built from</param>
+/// <returns>false if there is no usable binary for the current driver and sources</returns>
+bool Shader::LoadProgramBinary(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	GLint totalFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &totalFormats);
+
+	if (totalFormats == 0)
+	{
+		return false;
+	}
+
+	std::string filename = GetProgramBinaryFilename(vertexSource, fragmentSource);
+
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	GLenum binaryFormat = 0;
+	file.read(reinterpret_cast<char*>(&binaryFormat), sizeof(binaryFormat));
+
+	std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (binary.empty())
+	{
+		return false;
+	}
+
+	glProgramBinary(m_shaderProgramID, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+	GLint errorCode;
+	glGetProgramiv(m_shaderProgramID, GL_LINK_STATUS, &errorCode);
+
+	if (errorCode != GL_TRUE)
+	{
+		//the driver rejected the binary (e.g. it was updated), so the program has to be built from source
+		std::cout << "Cached shader program is out of date: " << filename << std::endl;
+		return false;
+	}
+
+	GLState::Instance()->UseProgram(m_shaderProgramID);
+
+	std::cout << "Shader program loaded from cache!" << std::endl;
+	return true;
+}
+
+/// <summary>
+/// writes the binary of the linked program to disk so that the next run can load it with LoadProgramBinary
+/// </summary>
+/// <param name="vertexSource">vertex shader source the program was built from</param>
+/// <param name="fragmentSource">fragment shader source the program was built from</param>
+bool Shader::SaveProgramBinary(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	GLint errorCode;
+	glGetProgramiv(m_shaderProgramID, GL_LINK_STATUS, &errorCode);
+
+	GLint binaryLength = 0;
+	glGetProgramiv(m_shaderProgramID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+	if (errorCode != GL_TRUE || binaryLength == 0)
+	{
+		return false;
+	}
+
+	GLenum binaryFormat = 0;
+	std::vector<char> binary(binaryLength);
+	glGetProgramBinary(m_shaderProgramID, binaryLength, &binaryLength, &binaryFormat, binary.data());
+
+	std::string filename = GetProgramBinaryFilename(vertexSource, fragmentSource);
+
+	std::ofstream file(filename, std::ios::binary);
+
+	if (!file)
+	{
+		std::cout << "Error writing shader cache file: " << filename << std::endl;
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(binaryFormat));
+	file.write(binary.data(), binaryLength);
+
+	return true;
+}
+
+/// <summary>
+/// the cache file name is a hash of the driver identification and the shader sources, 
+/// so a driver update or a shader change never picks up a stale binary
+/// </summary>
+std::string Shader::GetProgramBinaryFilename(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	std::string key;
+	key += reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+	key += reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+	key += reinterpret_cast<const char*>(glGetString(GL_VERSION));
+	key += vertexSource;
+	key += fragmentSource;
+
+	//64-bit FNV-1a
+	Uint64 hash = 14695981039346656037ULL;
+	for (unsigned char c : key)
+	{
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+
+	std::stringstream filename;
+
+	char* cachePath = SDL_GetPrefPath("QuadInSpace", "ShaderCache");
+	if (cachePath)
+	{
+		filename << cachePath;
+		SDL_free(cachePath);
+	}
+
+	filename << std::hex << hash << ".bin";
+	return filename.str();
+}
+
 void Shader::DetachShaders()
 {
-	glDetachShader(m_shaderProgramID, m_vertexShaderID);
-	glDetachShader(m_shaderProgramID, m_fragmentShaderID);
+	//shaders are never created when the program was loaded from the binary cache
+	if (m_vertexShaderID != 0)
+	{
+		glDetachShader(m_shaderProgramID, m_vertexShaderID);
+		glDetachShader(m_shaderProgramID, m_fragmentShaderID);
+	}
 }
 
 void Shader::DestroyShaders()
 {
-	glDeleteShader(m_vertexShaderID);
-	glDeleteShader(m_fragmentShaderID);
+	if (m_vertexShaderID != 0)
+	{
+		glDeleteShader(m_vertexShaderID);
+		glDeleteShader(m_fragmentShaderID);
+	}
 }
 
 void Shader::DestroyProgram()
 {
+	GLState::Instance()->InvalidateProgram(m_shaderProgramID);
 	glDeleteProgram(m_shaderProgramID);
 }
 
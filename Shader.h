@@ -19,8 +19,12 @@ public:
 	bool CreateShaders();
 
 	bool CompileShaders(const std::string& filename, ShaderType shaderType);
+	bool CompileShaderSource(const std::string& sourceCode, ShaderType shaderType);
 	void AttachShaders();
 	bool LinkProgram();
+
+	bool LoadProgramBinary(const std::string& vertexSource, const std::string& fragmentSource);
+	bool SaveProgramBinary(const std::string& vertexSource, const std::string& fragmentSource);
 	
 	void DetachShaders();
 	void DestroyShaders();
@@ -41,6 +45,8 @@ private:
 	Shader();
 	Shader(const Shader&);
 
+	std::string GetProgramBinaryFilename(const std::string& vertexSource, const std::string& fragmentSource);
+
 	GLuint m_shaderProgramID;
 	GLuint m_vertexShaderID;
 	GLuint m_fragmentShaderID;
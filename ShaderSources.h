@@ -0,0 +1,20 @@
+#pragma once
+
+//GLSL sources embedded into the executable at build time. The .inl files are generated from
+//the files in Shaders by the pre-build event, which wraps each file in a raw string literal.
+
+static const char* const MAIN_VERTEX_SHADER =
+#include "Shaders/Main.vert.inl"
+;
+
+static const char* const MAIN_FRAGMENT_SHADER =
+#include "Shaders/Main.frag.inl"
+;
+
+static const char* const PYRAMID_BLUR_VERTEX_SHADER =
+#include "Shaders/PyramidBlur.vert.inl"
+;
+
+static const char* const PYRAMID_BLUR_FRAGMENT_SHADER =
+#include "Shaders/PyramidBlur.frag.inl"
+;
\ No newline at end of file
@@ -1,15 +1,36 @@
-#version 460
+#version 450
 
 
-in vec3 colorOut;
 in vec3 vertexOut;
 in vec2 textureOut;
+flat in float textureLayerOut;
 
 out vec4 fragColor;
 uniform sampler2D textureImage;
+uniform sampler2DArray atlasImages;
+uniform bool isInstanced;
+uniform bool isLinear;
 
+//textures in linear light are gamma encoded for the screen, like the images they were loaded from
+vec3 LinearToSrgb(vec3 color)
+{
+	color = clamp(color, 0.0, 1.0);
+	return mix(color * 12.92, 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055, step(0.0031308, color));
+}
 
 void main()
 {
-		fragColor = texture(textureImage, textureOut); 
+	if (isInstanced)
+	{
+		fragColor = texture(atlasImages, vec3(textureOut, textureLayerOut));
+	}
+	else
+	{
+		fragColor = texture(textureImage, textureOut);
+
+		if (isLinear)
+		{
+			fragColor.rgb = LinearToSrgb(fragColor.rgb);
+		}
+	}
 }
\ No newline at end of file
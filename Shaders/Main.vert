@@ -1,23 +1,32 @@
-#version 460
+#version 450
 
-in vec3 vertexIn;
-in vec3 colorIn;
-in vec2 textureIn;
+//attribute locations match QuadVertexLayout in Quad.h and Scene::InstanceLayout in Scene.h
+layout(location = 0) in vec3 vertexIn;
+layout(location = 1) in vec2 textureIn;
+
+//per-instance attributes, only used when the quads of a Scene are drawn with one instanced draw call
+layout(location = 2) in mat4 instanceModel;
+layout(location = 6) in vec4 instanceUVRect;
+layout(location = 7) in float instanceLayer;
 
 out vec3 vertexOut;
-out vec3 colorOut;
 out vec2 textureOut;
+flat out float textureLayerOut;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 proj;
+uniform bool isInstanced;
 
 void main()
 {
-	colorOut = colorIn;
-	textureOut = textureIn;
+	mat4 worldModel = isInstanced ? instanceModel : model;
+
+	//instanced quads show a rectangle of one layer of the image atlas
+	textureOut = isInstanced ? instanceUVRect.xy + textureIn * instanceUVRect.zw : textureIn;
+	textureLayerOut = instanceLayer;
 
-	vertexOut = (model * vec4(vertexIn, 1.0)).xyz;
+	vertexOut = (worldModel * vec4(vertexIn, 1.0)).xyz;
 
-	gl_Position = proj * view * model * vec4(vertexIn, 1.0);
+	gl_Position = proj * view * worldModel * vec4(vertexIn, 1.0);
 }
\ No newline at end of file
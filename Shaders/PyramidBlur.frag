@@ -0,0 +1,50 @@
+#version 450
+
+//passes of PyramidBlur, each rendering a level of the pyramid from another one
+const int DOWNSAMPLE_PASS = 0;
+const int UPSAMPLE_PASS = 1;
+const int BLUR_PASS = 2;
+
+const int MAX_RADIUS = 32;
+
+in vec2 textureOut;
+
+out vec4 fragColor;
+
+uniform sampler2D sourceImage;
+uniform int pass;
+uniform vec2 texelSize;
+uniform vec2 direction;
+uniform int radius;
+uniform float weights[MAX_RADIUS + 1];
+
+void main()
+{
+	if (pass == DOWNSAMPLE_PASS)
+	{
+		//four bilinear taps 0.75 texels around the middle weigh the 4 x 4 source texels by (1 3 3 1) / 8 in each direction
+		vec2 offset = 0.75 * texelSize;
+
+		fragColor = 0.25 * (texture(sourceImage, textureOut + vec2(-offset.x, -offset.y)) + 
+			                texture(sourceImage, textureOut + vec2(offset.x, -offset.y)) + 
+			                texture(sourceImage, textureOut + vec2(-offset.x, offset.y)) + 
+			                texture(sourceImage, textureOut + vec2(offset.x, offset.y)));
+	}
+	else if (pass == UPSAMPLE_PASS)
+	{
+		//a bilinear tap weighs the two nearest source texels by 3 / 4 and 1 / 4 in each direction
+		fragColor = texture(sourceImage, textureOut);
+	}
+	else
+	{
+		vec2 step = direction * texelSize;
+		vec4 sum = weights[0] * texture(sourceImage, textureOut);
+
+		for (int i = 1; i <= radius; i++)
+		{
+			sum += weights[i] * (texture(sourceImage, textureOut + i * step) + texture(sourceImage, textureOut - i * step));
+		}
+
+		fragColor = sum;
+	}
+}
\ No newline at end of file
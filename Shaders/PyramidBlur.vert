@@ -0,0 +1,12 @@
+#version 450
+
+//a triangle covering the viewport, made from the index of the vertex without any vertex buffer
+out vec2 textureOut;
+
+void main()
+{
+	vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+
+	textureOut = position;
+	gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "SlicedEffect.h"
+#include "Timer.h"
+
+SlicedEffect::SlicedEffect()
+{
+	m_passIndex = 0;
+	m_totalDoneRows = 0;
+	m_totalRows = 0;
+	m_totalRowsBeforePass = 0;
+	m_isCancelled = false;
+	m_milliseconds = 0.0;
+}
+
+/// <summary>
+/// adds a pass after the ones added before. Work on the whole image at once, such as filling the halo of a buffer, 
+/// is a pass of a single row
+/// </summary>
+/// <param name="work">runs the pass on a range of rows, which is only ever run once</param>
+void SlicedEffect::AddPass(GLuint totalRows, std::function<void(GLuint first, GLuint last)> work)
+{
+	if (totalRows > 0)
+	{
+		m_passes.push_back({ totalRows, std::move(work) });
+		m_totalRows += totalRows;
+	}
+}
+
+/// <summary>
+/// sets work that follows the passes off the main thread, such as storing the result in the effect cache
+/// </summary>
+/// <param name="completion">given the time the passes took</param>
+void SlicedEffect::SetCompletion(std::function<void(double milliseconds)> completion)
+{
+	m_completion = std::move(completion);
+}
+
+/// <summary>
+/// runs rows of the passes, one at a time, until the time given is used up. A row is run even if no time is left, 
+/// so the effect always moves on
+/// </summary>
+/// <returns>returns true once every pass is done or the effect is cancelled</returns>
+bool SlicedEffect::Run(double milliseconds)
+{
+	Timer timer;
+
+	do
+	{
+		if (IsDone())
+		{
+			break;
+		}
+
+		Pass& pass = m_passes[m_passIndex];
+		pass.work(m_totalDoneRows, m_totalDoneRows + 1);
+
+		if (++m_totalDoneRows == pass.totalRows)
+		{
+			m_totalRowsBeforePass += pass.totalRows;
+			m_totalDoneRows = 0;
+			m_passIndex++;
+		}
+	} while (timer.GetElapsedMilliseconds() < milliseconds);
+
+	m_milliseconds += timer.GetElapsedMilliseconds();
+	return IsDone();
+}
+
+/// <summary>
+/// runs the completion set, unless the effect was cancelled. Called once every pass is done
+/// </summary>
+void SlicedEffect::Complete()
+{
+	if (m_completion && !m_isCancelled)
+	{
+		m_completion(m_milliseconds);
+	}
+}
+
+/// <summary>
+/// stops the effect before its next row, such as when an effect replacing it is queued. The rows done are left as they are
+/// </summary>
+void SlicedEffect::Cancel()
+{
+	m_isCancelled = true;
+}
+
+bool SlicedEffect::IsDone() const
+{
+	return m_isCancelled || m_passIndex == m_passes.size();
+}
+
+bool SlicedEffect::IsCancelled() const
+{
+	return m_isCancelled;
+}
+
+/// <summary>
+/// the rows done by the last pass, which hold the final pixels and may be shown
+/// </summary>
+GLuint SlicedEffect::GetTotalFinalRows() const
+{
+	if (m_passes.empty() || m_passIndex + 1 < m_passes.size())
+	{
+		return 0;
+	}
+
+	return (m_passIndex == m_passes.size()) ? m_passes.back().totalRows : m_totalDoneRows;
+}
+
+/// <summary>
+/// the share of the rows of all passes that are done, between 0 and 1
+/// </summary>
+GLfloat SlicedEffect::GetProgress() const
+{
+	if (m_totalRows == 0)
+	{
+		return 1.0f;
+	}
+
+	return static_cast<GLfloat>(m_totalRowsBeforePass + m_totalDoneRows) / m_totalRows;
+}
+
+/// <summary>
+/// the time spent running the passes so far
+/// </summary>
+double SlicedEffect::GetMilliseconds() const
+{
+	return m_milliseconds;
+}
\ No newline at end of file
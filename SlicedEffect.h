@@ -0,0 +1,51 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "gl.h"
+
+//an effect split into passes over the rows of the image, each run a range of rows at a time, so it may stop between 
+//any two rows and go on later. The main loop runs it for the time each frame can spare, which keeps the frames short 
+//where few cores are free. The rows of the last pass are final, and are shown as they are done
+class SlicedEffect
+{
+
+public:
+
+	SlicedEffect();
+
+	void AddPass(GLuint totalRows, std::function<void(GLuint first, GLuint last)> work);
+	void SetCompletion(std::function<void(double milliseconds)> completion);
+
+	bool Run(double milliseconds);
+	void Complete();
+	void Cancel();
+
+	bool IsDone() const;
+	bool IsCancelled() const;
+	GLuint GetTotalFinalRows() const;
+	GLfloat GetProgress() const;
+	double GetMilliseconds() const;
+
+private:
+
+	SlicedEffect(const SlicedEffect&);
+	SlicedEffect& operator=(const SlicedEffect&);
+
+	struct Pass
+	{
+		GLuint totalRows;
+		std::function<void(GLuint first, GLuint last)> work;
+	};
+
+	std::vector<Pass> m_passes;
+	std::function<void(double milliseconds)> m_completion; //run on the workers once every pass is done
+
+	size_t m_passIndex; //the pass running
+	GLuint m_totalDoneRows; //of the pass running
+	GLuint m_totalRows; //of all passes
+	GLuint m_totalRowsBeforePass; //of the passes done
+	bool m_isCancelled;
+	double m_milliseconds; //spent running the passes
+
+};
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include "Parallel.h"
+#include "SummedAreaTable.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SUMMED_AREA_TABLE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+//weights of the channels in the luminance (Rec. 709)
+static const GLfloat RED_LUMINANCE = 0.2126f;
+static const GLfloat GREEN_LUMINANCE = 0.7152f;
+static const GLfloat BLUE_LUMINANCE = 0.0722f;
+
+//columns summed by each thread at a time, as wide as to sum along memory
+static const GLsizei COLUMN_STRIP_WIDTH = 256;
+
+SummedAreaTable::SummedAreaTable()
+{
+	m_width = 0;
+	m_height = 0;
+}
+
+/// <summary>
+/// builds the table of RGBA float pixels
+/// </summary>
+void SummedAreaTable::Build(const GLfloat* pixels, GLsizei width, GLsizei height)
+{
+	Build(width, height, [pixels, width](GLsizei y, GLfloat*)
+	{
+		return pixels + static_cast<size_t>(y) * width * 4;
+	});
+}
+
+/// <summary>
+/// builds the table of 8-bit RGB or RGBA pixels, as values between 0 and 1 like float pixels. 
+/// Pixels without alpha count as opaque
+/// </summary>
+void SummedAreaTable::Build(const Uint8* pixels, Uint8 depth, GLsizei width, GLsizei height)
+{
+	Build(width, height, [pixels, depth, width](GLsizei y, GLfloat* row)
+	{
+		const Uint8* sourceRow = pixels + static_cast<size_t>(y) * width * depth;
+
+		for (GLsizei x = 0; x < width; x++)
+		{
+			for (Uint8 channel = 0; channel < 4; channel++)
+			{
+				row[x * 4 + channel] = (channel < depth) ? sourceRow[x * depth + channel] / 255.0f : 1.0f;
+			}
+		}
+
+		return static_cast<const GLfloat*>(row);
+	});
+}
+
+/// <summary>
+/// sums each row of pixels, in parallel, then adds up the row sums down strips of columns, also in parallel
+/// </summary>
+/// <param name="loadRow">returns the RGBA float pixels of a row, which it may convert into the buffer it is given</param>
+template <typename LoadRow>
+void SummedAreaTable::Build(GLsizei width, GLsizei height, LoadRow loadRow)
+{
+	m_width = width;
+	m_height = height;
+
+	size_t tableWidth = static_cast<size_t>(width) + 1;
+	m_sums.assign(tableWidth * (height + 1) * 4, 0.0);
+	m_luminanceSquareSums.assign(tableWidth * (height + 1), 0.0);
+
+	ParallelFor(height, [&](GLuint first, GLuint last)
+	{
+		std::vector<GLfloat> rowBuffer(static_cast<size_t>(width) * 4);
+
+		for (GLuint y = first; y < last; y++)
+		{
+			const GLfloat* row = loadRow(y, rowBuffer.data());
+			double* sums = &m_sums[((y + 1) * tableWidth + 1) * 4];
+			double* luminanceSquareSums = &m_luminanceSquareSums[(y + 1) * tableWidth + 1];
+
+#ifdef SUMMED_AREA_TABLE_USE_SSE2
+			__m128d redGreen = _mm_setzero_pd();
+			__m128d blueAlpha = _mm_setzero_pd();
+
+			for (GLsizei x = 0; x < width; x++)
+			{
+				__m128 pixel = _mm_loadu_ps(row + x * 4);
+
+				redGreen = _mm_add_pd(redGreen, _mm_cvtps_pd(pixel));
+				blueAlpha = _mm_add_pd(blueAlpha, _mm_cvtps_pd(_mm_movehl_ps(pixel, pixel)));
+
+				_mm_storeu_pd(sums + x * 4, redGreen);
+				_mm_storeu_pd(sums + x * 4 + 2, blueAlpha);
+			}
+#else
+			double rowSums[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+			for (GLsizei x = 0; x < width; x++)
+			{
+				for (int channel = 0; channel < 4; channel++)
+				{
+					rowSums[channel] += row[x * 4 + channel];
+					sums[x * 4 + channel] = rowSums[channel];
+				}
+			}
+#endif
+
+			double luminanceSquareSum = 0.0;
+
+			for (GLsizei x = 0; x < width; x++)
+			{
+				double luminance = RED_LUMINANCE * row[x * 4] + GREEN_LUMINANCE * row[x * 4 + 1] + BLUE_LUMINANCE * row[x * 4 + 2];
+				luminanceSquareSum += luminance * luminance;
+				luminanceSquareSums[x] = luminanceSquareSum;
+			}
+		}
+	});
+
+	GLuint totalStrips = (width + COLUMN_STRIP_WIDTH - 1) / COLUMN_STRIP_WIDTH;
+
+	ParallelFor(totalStrips, [&](GLuint first, GLuint last)
+	{
+		size_t firstColumn = static_cast<size_t>(first) * COLUMN_STRIP_WIDTH + 1;
+		size_t lastColumn = std::min(static_cast<size_t>(last) * COLUMN_STRIP_WIDTH + 1, tableWidth);
+
+		for (GLsizei y = 2; y <= height; y++)
+		{
+			double* sums = &m_sums[y * tableWidth * 4];
+			const double* sumsAbove = sums - tableWidth * 4;
+
+#ifdef SUMMED_AREA_TABLE_USE_SSE2
+			for (size_t i = firstColumn * 4; i < lastColumn * 4; i += 2)
+			{
+				_mm_storeu_pd(sums + i, _mm_add_pd(_mm_loadu_pd(sums + i), _mm_loadu_pd(sumsAbove + i)));
+			}
+#else
+			for (size_t i = firstColumn * 4; i < lastColumn * 4; i++)
+			{
+				sums[i] += sumsAbove[i];
+			}
+#endif
+
+			double* luminanceSquareSums = &m_luminanceSquareSums[y * tableWidth];
+			const double* luminanceSquareSumsAbove = luminanceSquareSums - tableWidth;
+
+			for (size_t i = firstColumn; i < lastColumn; i++)
+			{
+				luminanceSquareSums[i] += luminanceSquareSumsAbove[i];
+			}
+		}
+	});
+}
+
+void SummedAreaTable::Clear()
+{
+	m_width = 0;
+	m_height = 0;
+
+	m_sums.clear();
+	m_sums.shrink_to_fit();
+	m_luminanceSquareSums.clear();
+	m_luminanceSquareSums.shrink_to_fit();
+}
+
+bool SummedAreaTable::IsBuilt() const
+{
+	return !m_sums.empty();
+}
+
+GLsizei SummedAreaTable::GetWidth() const
+{
+	return m_width;
+}
+
+GLsizei SummedAreaTable::GetHeight() const
+{
+	return m_height;
+}
+
+/// <summary>
+/// the sum of the RGBA values of the pixels from left to right and from top to bottom, the right and bottom ones excluded. 
+/// The rectangle is cut to the image
+/// </summary>
+glm::dvec4 SummedAreaTable::GetSum(GLsizei left, GLsizei top, GLsizei right, GLsizei bottom) const
+{
+	size_t tableWidth = static_cast<size_t>(m_width) + 1;
+
+	left = std::clamp(left, 0, m_width);
+	right = std::clamp(right, left, m_width);
+	top = std::clamp(top, 0, m_height);
+	bottom = std::clamp(bottom, top, m_height);
+
+	const double* topLeft = &m_sums[(top * tableWidth + left) * 4];
+	const double* topRight = &m_sums[(top * tableWidth + right) * 4];
+	const double* bottomLeft = &m_sums[(bottom * tableWidth + left) * 4];
+	const double* bottomRight = &m_sums[(bottom * tableWidth + right) * 4];
+
+	return glm::dvec4(bottomRight[0] - bottomLeft[0] - topRight[0] + topLeft[0],
+		              bottomRight[1] - bottomLeft[1] - topRight[1] + topLeft[1],
+		              bottomRight[2] - bottomLeft[2] - topRight[2] + topLeft[2],
+		              bottomRight[3] - bottomLeft[3] - topRight[3] + topLeft[3]);
+}
+
+/// <summary>
+/// the mean of the RGBA values of the pixels in a box around a pixel. Only the pixels of the box inside the image count
+/// </summary>
+glm::vec4 SummedAreaTable::GetMean(GLsizei x, GLsizei y, GLsizei horizontalRadius, GLsizei verticalRadius) const
+{
+	GLsizei left = std::max(x - horizontalRadius, 0);
+	GLsizei right = std::min(x + horizontalRadius + 1, m_width);
+	GLsizei top = std::max(y - verticalRadius, 0);
+	GLsizei bottom = std::min(y + verticalRadius + 1, m_height);
+
+	double area = static_cast<double>(right - left) * (bottom - top);
+
+	return glm::vec4(GetSum(left, top, right, bottom) / area);
+}
+
+/// <summary>
+/// the variance of the luminance of the pixels in a box around a pixel, which is high at edges and in textured areas 
+/// and low in flat ones. Only the pixels of the box inside the image count
+/// </summary>
+GLfloat SummedAreaTable::GetLuminanceVariance(GLsizei x, GLsizei y, GLsizei horizontalRadius, GLsizei verticalRadius) const
+{
+	size_t tableWidth = static_cast<size_t>(m_width) + 1;
+
+	GLsizei left = std::max(x - horizontalRadius, 0);
+	GLsizei right = std::min(x + horizontalRadius + 1, m_width);
+	GLsizei top = std::max(y - verticalRadius, 0);
+	GLsizei bottom = std::min(y + verticalRadius + 1, m_height);
+
+	double area = static_cast<double>(right - left) * (bottom - top);
+	glm::dvec4 mean = GetSum(left, top, right, bottom) / area;
+	double meanLuminance = RED_LUMINANCE * mean.r + GREEN_LUMINANCE * mean.g + BLUE_LUMINANCE * mean.b;
+
+	double luminanceSquareSum = m_luminanceSquareSums[bottom * tableWidth + right] - m_luminanceSquareSums[bottom * tableWidth + left] - 
+		                        m_luminanceSquareSums[top * tableWidth + right] + m_luminanceSquareSums[top * tableWidth + left];
+
+	//rounding may leave flat areas slightly below zero
+	return static_cast<GLfloat>(std::max(luminanceSquareSum / area - meanLuminance * meanLuminance, 0.0));
+}
+
+/// <summary>
+/// averages the pixels in a box around each pixel, in parallel. Each pixel takes four lookups, whatever the radius
+/// </summary>
+/// <param name="result">the RGBA float pixels of the blurred image</param>
+void SummedAreaTable::BoxBlur(GLfloat* result, GLsizei horizontalRadius, GLsizei verticalRadius) const
+{
+	ParallelFor(m_height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			BoxBlurRow(y, result + static_cast<size_t>(y) * m_width * 4, horizontalRadius, verticalRadius);
+		}
+	});
+}
+
+/// <summary>
+/// averages the pixels in a box around each pixel of a row, for blurs run a few rows at a time
+/// </summary>
+/// <param name="resultRow">the RGBA float pixels of the row of the blurred image</param>
+void SummedAreaTable::BoxBlurRow(GLsizei y, GLfloat* resultRow, GLsizei horizontalRadius, GLsizei verticalRadius) const
+{
+	for (GLsizei x = 0; x < m_width; x++)
+	{
+		glm::vec4 mean = GetMean(x, y, horizontalRadius, verticalRadius);
+
+		resultRow[x * 4] = mean.r;
+		resultRow[x * 4 + 1] = mean.g;
+		resultRow[x * 4 + 2] = mean.b;
+		resultRow[x * 4 + 3] = mean.a;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <SDL.h>
+#include <glm.hpp>
+#include "gl.h"
+
+//the sums of the RGBA values of all pixels above and left of each pixel (an integral image), from which the sum 
+//of any rectangle of pixels takes four lookups: box blurs of any radius take the same time, and local means and variances 
+//of the luminance come for free. Sums are kept in doubles, which hold sums of billions of pixels without losing precision.
+class SummedAreaTable
+{
+
+public:
+
+	SummedAreaTable();
+
+	void Build(const GLfloat* pixels, GLsizei width, GLsizei height);
+	void Build(const Uint8* pixels, Uint8 depth, GLsizei width, GLsizei height);
+	void Clear();
+
+	bool IsBuilt() const;
+	GLsizei GetWidth() const;
+	GLsizei GetHeight() const;
+
+	glm::dvec4 GetSum(GLsizei left, GLsizei top, GLsizei right, GLsizei bottom) const;
+	glm::vec4 GetMean(GLsizei x, GLsizei y, GLsizei horizontalRadius, GLsizei verticalRadius) const;
+	GLfloat GetLuminanceVariance(GLsizei x, GLsizei y, GLsizei horizontalRadius, GLsizei verticalRadius) const;
+
+	void BoxBlur(GLfloat* result, GLsizei horizontalRadius, GLsizei verticalRadius) const;
+	void BoxBlurRow(GLsizei y, GLfloat* resultRow, GLsizei horizontalRadius, GLsizei verticalRadius) const;
+
+private:
+
+	template <typename LoadRow>
+	void Build(GLsizei width, GLsizei height, LoadRow loadRow);
+
+	GLsizei m_width;
+	GLsizei m_height;
+
+	//both tables have a row and a column of zeros before the first pixel, which spares the lookups any checks
+	std::vector<double> m_sums; //4 values per entry
+	std::vector<double> m_luminanceSquareSums;
+
+};
\ No newline at end of file
@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <utility>
+#include "Parallel.h"
+#include "TaskScheduler.h"
+#include "Timer.h"
+
+//the worker the current thread is, or -1 for the UI thread and any other thread
+static thread_local GLint currentWorkerIndex = -1;
+
+//the tasks the current thread is inside of. Tasks run while waiting within a task are already timed by the outer task
+static thread_local GLuint currentTaskDepth = 0;
+
+CancellationToken::CancellationToken() : m_isCancelled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+void CancellationToken::Cancel()
+{
+	*m_isCancelled = true;
+}
+
+bool CancellationToken::IsCancelled() const
+{
+	return *m_isCancelled;
+}
+
+bool Task::IsDone() const
+{
+	return m_isDone;
+}
+
+/// <summary>
+/// whether the task was dropped by its cancellation token before it started. Valid once it is done
+/// </summary>
+bool Task::IsCancelled() const
+{
+	return m_isCancelled;
+}
+
+TaskScheduler::TaskScheduler() : m_isStopping(false), m_totalCancelledTasks(0)
+{
+	for (std::atomic<GLint>& totalQueuedTasks : m_totalQueuedTasks)
+	{
+		totalQueuedTasks = 0;
+	}
+
+	GLuint totalWorkers = GetTotalParallelThreads();
+	totalWorkers = (totalWorkers > 1) ? totalWorkers - 1 : 1;
+
+	//the workers steal from each other, so all of them exist before the first starts
+	for (GLuint i = 0; i < totalWorkers; i++)
+	{
+		m_workers.push_back(std::make_unique<Worker>());
+	}
+
+	for (GLuint i = 0; i < totalWorkers; i++)
+	{
+		m_workers[i]->thread = std::thread(&TaskScheduler::Run, this, i);
+	}
+}
+
+TaskScheduler* TaskScheduler::Instance()
+{
+	static TaskScheduler* taskScheduler = new TaskScheduler;
+	return taskScheduler;
+}
+
+/// <summary>
+/// runs the tasks queued, then ends the workers. Called on the main thread before the application ends, 
+/// once nothing submits tasks any more. Tasks waited for afterwards run on the thread waiting for them
+/// </summary>
+void TaskScheduler::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+
+	m_condition.notify_all();
+
+	for (std::unique_ptr<Worker>& worker : m_workers)
+	{
+		if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+}
+
+/// <summary>
+/// queues work to run on the workers once the tasks it depends on are done. 
+/// A task a worker submits goes to its own queue, to run next on the same core
+/// </summary>
+/// <param name="dependencies">tasks to run before this one, which may be done already</param>
+/// <param name="token">drops the task when cancelled before it starts. Tasks depending on it still run</param>
+TaskHandle TaskScheduler::Submit(std::function<void()> work, TaskPriority priority, 
+	                             const std::vector<TaskHandle>& dependencies, const CancellationToken& token)
+{
+	auto task = std::make_shared<Task>();
+	task->m_work = std::move(work);
+	task->m_priority = priority;
+	task->m_token = token;
+	task->m_isCancelled = false;
+	task->m_isDone = false;
+
+	//the task waits for itself until all its dependencies know of it, so none of them can start it early
+	task->m_totalWaitingDependencies = 1;
+
+	for (const TaskHandle& dependency : dependencies)
+	{
+		std::lock_guard<std::mutex> lock(dependency->m_mutex);
+
+		if (!dependency->m_isDone)
+		{
+			dependency->m_dependents.push_back(task);
+			task->m_totalWaitingDependencies++;
+		}
+	}
+
+	if (--task->m_totalWaitingDependencies == 0)
+	{
+		Schedule(task);
+	}
+
+	return task;
+}
+
+/// <summary>
+/// waits until a task is done, running queued tasks of its class or a more urgent one meanwhile. 
+/// Less urgent tasks are left to the workers, as one of them could hold up the task waited for
+/// </summary>
+void TaskScheduler::Wait(const TaskHandle& task)
+{
+	while (!task->IsDone())
+	{
+		if (RunTask(currentWorkerIndex, task->m_priority))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this, &task]() { return task->IsDone() || IsTaskQueued(task->m_priority); });
+	}
+}
+
+void TaskScheduler::Wait(const std::vector<TaskHandle>& tasks)
+{
+	for (const TaskHandle& task : tasks)
+	{
+		Wait(task);
+	}
+}
+
+/// <summary>
+/// runs the work for all items on every core and waits for it. The calling thread takes its share, 
+/// and the items are handed out one at a time as threads finish their previous one
+/// </summary>
+void TaskScheduler::ParallelFor(GLuint totalItems, const std::function<void(GLuint first, GLuint last)>& work, TaskPriority priority)
+{
+	GLuint totalTasks = std::min(GetTotalParallelThreads(), totalItems);
+
+	if (totalTasks <= 1)
+	{
+		work(0, totalItems);
+		return;
+	}
+
+	std::atomic<GLuint> nextItem{ 0 };
+
+	//tasks starting after the items ran out return at once
+	auto runItems = [&]()
+	{
+		for (GLuint item = nextItem++; item < totalItems; item = nextItem++)
+		{
+			work(item, item + 1);
+		}
+	};
+
+	std::vector<TaskHandle> tasks;
+
+	for (GLuint i = 1; i < totalTasks; i++)
+	{
+		tasks.push_back(Submit(runItems, priority));
+	}
+
+	runItems();
+	Wait(tasks);
+}
+
+GLuint TaskScheduler::GetTotalWorkers() const
+{
+	return static_cast<GLuint>(m_workers.size());
+}
+
+/// <summary>
+/// the time each worker spent running tasks and the tasks it ran, followed by those of the threads waiting for tasks
+/// </summary>
+std::vector<TaskScheduler::WorkerStatistics> TaskScheduler::GetWorkerStatistics() const
+{
+	std::vector<WorkerStatistics> statistics;
+
+	auto addStatistics = [&statistics](const Counters& counters)
+	{
+		WorkerStatistics workerStatistics;
+		workerStatistics.busyMilliseconds = counters.busyMicroseconds / 1000.0;
+		workerStatistics.totalTasks = counters.totalTasks;
+		workerStatistics.totalStolenTasks = counters.totalStolenTasks;
+		statistics.push_back(workerStatistics);
+	};
+
+	for (const std::unique_ptr<Worker>& worker : m_workers)
+	{
+		addStatistics(worker->counters);
+	}
+
+	addStatistics(m_otherThreadCounters);
+	return statistics;
+}
+
+/// <summary>
+/// number of tasks dropped by their cancellation token before they started
+/// </summary>
+Uint32 TaskScheduler::GetTotalCancelledTasks() const
+{
+	return m_totalCancelledTasks;
+}
+
+const char* TaskScheduler::GetPriorityName(TaskPriority priority)
+{
+	switch (priority)
+	{
+	case TaskPriority::Interactive:
+		return "interactive";
+	case TaskPriority::Background:
+		return "background";
+	default:
+		return "speculative";
+	}
+}
+
+/// <summary>
+/// the loop of a worker, which runs the most urgent task it finds and sleeps while there are none
+/// </summary>
+void TaskScheduler::Run(GLuint workerIndex)
+{
+	currentWorkerIndex = static_cast<GLint>(workerIndex);
+
+	while (true)
+	{
+		if (RunTask(currentWorkerIndex, TaskPriority::Speculative))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_isStopping || IsTaskQueued(TaskPriority::Speculative); });
+
+		if (m_isStopping && !IsTaskQueued(TaskPriority::Speculative))
+		{
+			break;
+		}
+	}
+}
+
+/// <summary>
+/// queues a task whose dependencies are done
+/// </summary>
+void TaskScheduler::Schedule(const TaskHandle& task)
+{
+	GLuint priority = static_cast<GLuint>(task->m_priority);
+	m_totalQueuedTasks[priority]++;
+
+	if (currentWorkerIndex >= 0)
+	{
+		Worker& worker = *m_workers[currentWorkerIndex];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.queues[priority].push_back(task);
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(m_sharedMutex);
+		m_sharedQueues[priority].push_back(task);
+	}
+
+	Notify();
+}
+
+/// <summary>
+/// takes the most urgent queued task down to the given class: the newest of the worker's own queue, 
+/// the oldest submitted by other threads, or else the oldest of another worker
+/// </summary>
+/// <param name="workerIndex">the worker looking, or -1 for another thread, which has no queue of its own</param>
+/// <param name="isStolen">set when the task was taken from another worker</param>
+TaskHandle TaskScheduler::FindTask(GLint workerIndex, TaskPriority lowestPriority, bool& isStolen)
+{
+	GLint totalWorkers = static_cast<GLint>(m_workers.size());
+	isStolen = false;
+
+	for (GLuint priority = 0; priority <= static_cast<GLuint>(lowestPriority); priority++)
+	{
+		if (m_totalQueuedTasks[priority] <= 0)
+		{
+			continue;
+		}
+
+		auto take = [this, priority](std::mutex& mutex, std::deque<TaskHandle>& queue, bool isNewest)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			TaskHandle task;
+
+			if (!queue.empty())
+			{
+				task = isNewest ? queue.back() : queue.front();
+				isNewest ? queue.pop_back() : queue.pop_front();
+				m_totalQueuedTasks[priority]--;
+			}
+
+			return task;
+		};
+
+		TaskHandle task;
+
+		if (workerIndex >= 0)
+		{
+			Worker& worker = *m_workers[workerIndex];
+			task = take(worker.mutex, worker.queues[priority], true);
+		}
+
+		if (!task)
+		{
+			task = take(m_sharedMutex, m_sharedQueues[priority], false);
+		}
+
+		//each worker starts looking at the next one, which spreads the thieves over the victims
+		for (GLint i = 1; !task && i <= totalWorkers; i++)
+		{
+			GLint victimIndex = (workerIndex + i) % totalWorkers;
+
+			if (victimIndex != workerIndex)
+			{
+				Worker& victim = *m_workers[victimIndex];
+				task = take(victim.mutex, victim.queues[priority], false);
+				isStolen = (task != nullptr);
+			}
+		}
+
+		if (task)
+		{
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+/// <summary>
+/// runs the most urgent queued task down to the given class, unless it was cancelled
+/// </summary>
+/// <returns>returns false if no task was queued</returns>
+bool TaskScheduler::RunTask(GLint workerIndex, TaskPriority lowestPriority)
+{
+	bool isStolen = false;
+	TaskHandle task = FindTask(workerIndex, lowestPriority, isStolen);
+
+	if (!task)
+	{
+		return false;
+	}
+
+	if (task->m_token.IsCancelled())
+	{
+		task->m_isCancelled = true;
+		m_totalCancelledTasks++;
+	}
+	else
+	{
+		Counters& counters = (workerIndex >= 0) ? m_workers[workerIndex]->counters : m_otherThreadCounters;
+		Timer timer;
+
+		currentTaskDepth++;
+		task->m_work();
+		currentTaskDepth--;
+
+		if (currentTaskDepth == 0)
+		{
+			counters.busyMicroseconds += static_cast<Uint64>(timer.GetElapsedMilliseconds() * 1000.0);
+		}
+
+		counters.totalTasks++;
+
+		if (isStolen)
+		{
+			counters.totalStolenTasks++;
+		}
+	}
+
+	Complete(task);
+	return true;
+}
+
+/// <summary>
+/// marks a task done and queues the tasks that were only waiting for it
+/// </summary>
+void TaskScheduler::Complete(const TaskHandle& task)
+{
+	//what the work holds is released before anyone waiting for the task goes on
+	task->m_work = nullptr;
+
+	std::vector<TaskHandle> dependents;
+
+	{
+		std::lock_guard<std::mutex> lock(task->m_mutex);
+		task->m_isDone = true;
+		dependents.swap(task->m_dependents);
+	}
+
+	for (const TaskHandle& dependent : dependents)
+	{
+		if (--dependent->m_totalWaitingDependencies == 0)
+		{
+			Schedule(dependent);
+		}
+	}
+
+	Notify();
+}
+
+bool TaskScheduler::IsTaskQueued(TaskPriority lowestPriority) const
+{
+	for (GLuint priority = 0; priority <= static_cast<GLuint>(lowestPriority); priority++)
+	{
+		if (m_totalQueuedTasks[priority] > 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/// <summary>
+/// wakes the sleeping threads to look again. The mutex is taken so none of them misses the change 
+/// between checking for it and going to sleep
+/// </summary>
+void TaskScheduler::Notify()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+	}
+
+	m_condition.notify_all();
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <SDL.h>
+#include "gl.h"
+
+//the classes of work sharing the cores, most urgent first. Idle threads always take the most urgent task there is, 
+//so the previews the user waits for run ahead of saves, which run ahead of work that may never be needed
+enum class TaskPriority
+{
+	Interactive,
+	Background,
+	Speculative
+};
+
+//a flag shared by the tasks it is given to. Tasks cancelled before they start are dropped by the scheduler, 
+//and long tasks check it themselves to stop early. Copies share the flag
+class CancellationToken
+{
+
+public:
+
+	CancellationToken();
+
+	void Cancel();
+	bool IsCancelled() const;
+
+private:
+
+	std::shared_ptr<std::atomic<bool>> m_isCancelled;
+
+};
+
+//a unit of work of the task scheduler, which runs once the tasks it depends on are done
+class Task
+{
+
+public:
+
+	bool IsDone() const;
+	bool IsCancelled() const;
+
+private:
+
+	friend class TaskScheduler;
+
+	std::function<void()> m_work;
+	TaskPriority m_priority;
+	CancellationToken m_token;
+	bool m_isCancelled; //dropped before it started, set before the task is done
+
+	std::atomic<GLint> m_totalWaitingDependencies;
+	std::atomic<bool> m_isDone;
+
+	std::mutex m_mutex;
+	std::vector<std::shared_ptr<Task>> m_dependents; //the tasks waiting for this one
+
+};
+
+using TaskHandle = std::shared_ptr<Task>;
+
+//the threads all CPU work of the application runs on, one fewer than the cores so the UI thread keeps one. 
+//Each worker has its own queues, where the tasks it submits go, and takes its newest task first while it is still in the cache. 
+//Workers out of work steal the oldest task of the others, which is usually the largest piece left. 
+//Threads waiting for a task run the queued tasks of the same or a more urgent class meanwhile, so waiting never idles a core, 
+//and tasks may wait for others without running out of threads. The workers start with the first use of the scheduler, 
+//and are stopped by the main thread before the application ends
+class TaskScheduler
+{
+
+public:
+
+	struct WorkerStatistics
+	{
+		double busyMilliseconds = 0.0; //the time spent running tasks since the start
+		Uint32 totalTasks = 0;
+		Uint32 totalStolenTasks = 0; //taken from the queues of other workers
+	};
+
+	static TaskScheduler* Instance();
+
+	void Stop();
+
+	TaskHandle Submit(std::function<void()> work, TaskPriority priority, 
+		              const std::vector<TaskHandle>& dependencies = {}, const CancellationToken& token = CancellationToken());
+	void Wait(const TaskHandle& task);
+	void Wait(const std::vector<TaskHandle>& tasks);
+
+	void ParallelFor(GLuint totalItems, const std::function<void(GLuint first, GLuint last)>& work, TaskPriority priority);
+
+	GLuint GetTotalWorkers() const;
+	std::vector<WorkerStatistics> GetWorkerStatistics() const;
+	Uint32 GetTotalCancelledTasks() const;
+
+	static const char* GetPriorityName(TaskPriority priority);
+
+private:
+
+	static const GLuint TOTAL_PRIORITIES = 3;
+
+	//read by the profiler while the tasks run
+	struct Counters
+	{
+		std::atomic<Uint64> busyMicroseconds{ 0 };
+		std::atomic<Uint32> totalTasks{ 0 };
+		std::atomic<Uint32> totalStolenTasks{ 0 };
+	};
+
+	struct Worker
+	{
+		std::thread thread;
+		std::mutex mutex;
+		std::deque<TaskHandle> queues[TOTAL_PRIORITIES];
+		Counters counters;
+	};
+
+	TaskScheduler();
+	TaskScheduler(const TaskScheduler&);
+
+	void Run(GLuint workerIndex);
+	void Schedule(const TaskHandle& task);
+	TaskHandle FindTask(GLint workerIndex, TaskPriority lowestPriority, bool& isStolen);
+	bool RunTask(GLint workerIndex, TaskPriority lowestPriority);
+	void Complete(const TaskHandle& task);
+	bool IsTaskQueued(TaskPriority lowestPriority) const;
+	void Notify();
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+
+	//tasks submitted by threads other than the workers, such as the UI thread
+	std::mutex m_sharedMutex;
+	std::deque<TaskHandle> m_sharedQueues[TOTAL_PRIORITIES];
+
+	//the tasks queued anywhere, counted before they are queued, so a thread that sees none can sleep
+	std::atomic<GLint> m_totalQueuedTasks[TOTAL_PRIORITIES];
+
+	//wakes the sleeping workers when tasks are queued, and the waiting threads when tasks are done
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_isStopping; //the workers end once the queues are empty
+
+	//the tasks run by threads other than the workers while they wait
+	Counters m_otherThreadCounters;
+	std::atomic<Uint32> m_totalCancelledTasks;
+
+};
\ No newline at end of file
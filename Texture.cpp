@@ -1,77 +1,500 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <vector>
 #include <glm.hpp>
 
+#include "ColorConversion.h"
+#include "Convolution.h"
+#include "EffectCache.h"
+#include "Hash.h"
+#include "Parallel.h"
+#include "GLState.h"
+#include "PaddedBuffer.h"
+#include "PngReader.h"
+#include "PngWriter.h"
+#include "PyramidBlur.h"
 #include "Texture.h"
+#include "Timer.h"
 
 Texture::Texture()
 {
 	m_textureData = nullptr;
 	m_ID = 0;
+	m_uploadBuffer = 0;
+	m_uploadBufferSize = 0;
+	m_isUploadedLinear = false;
+
+	m_workingFormat = WorkingFormat::LinearFloat;
+	m_edgeMode = EdgeMode::Clamp;
+	m_is16Bit = false;
+	m_hasAlpha = false;
+	m_isSourceHashed = false;
+	m_sourceHash = 0;
+	m_isEffectCacheEnabled = true;
+
+	m_isIncrementalBlur = true;
+	m_isLastBlurIncremental = false;
+	m_blurSigmaX = 0.0f;
+	m_blurSigmaY = 0.0f;
+	m_blurSpreadX = 0;
+	m_blurSpreadY = 0;
+	m_blurError = 0.0;
 }
 
 void Texture::Bind()
 {
-	glBindTexture(GL_TEXTURE_2D, m_ID);
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, m_ID);
+}
+
+Texture::Image::~Image()
+{
+	SDL_FreeSurface(surface);
+}
+
+/// <summary>
+/// loads an image file into the texture, decoding it into linear light for the effects
+/// </summary>
+/// <returns>returns false if the image could not be loaded</returns>
+bool Texture::Load(const std::string& filename)
+{
+	std::vector<Uint8> bytes;
+	Image image;
+
+	if (!ReadFile(filename, bytes) || !Decode(filename, bytes, image))
+	{
+		return false;
+	}
+
+	Load(image);
+	Reload();
+
+	return true;
+}
+
+/// <summary>
+/// reads the whole of a file, the part of loading an image that waits for the disk
+/// </summary>
+/// <returns>returns false if the file could not be read</returns>
+bool Texture::ReadFile(const std::string& filename, std::vector<Uint8>& bytes)
+{
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file)
+	{
+		std::cout << "Error loading texture." << std::endl;
+		return false;
+	}
+
+	bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
 }
 
-void Texture::Load(const std::string& filename)
+/// <summary>
+/// decodes an image file read into memory, and converts it into linear light for the effects. 
+/// Touches no state of a texture or of OpenGL, so it runs on any thread
+/// </summary>
+/// <param name="filename">the file the bytes were read from, whose extension tells 16-bit pngs apart</param>
+/// <returns>returns false if the image could not be decoded</returns>
+bool Texture::Decode(const std::string& filename, const std::vector<Uint8>& bytes, Image& image)
 {
-	m_textureData = IMG_Load(filename.c_str());
+	//SDL_image reduces 16-bit pngs to 8 bits, so they are read here
+	image.is16Bit = (std::string(GetExtension(filename.c_str())) == "png") && DecodePng16(bytes, filename, image);
+
+	if (!image.is16Bit)
+	{
+		image.surface = IMG_Load_RW(SDL_RWFromConstMem(bytes.data(), static_cast<int>(bytes.size())), 1);
+	}
 
-	if (!m_textureData)
+	if (!image.surface)
 	{
 		std::cout << "Error loading texture." << std::endl;
-		return;
+		return false;
+	}
+
+	if (!image.is16Bit)
+	{
+		size_t totalPixels = static_cast<size_t>(image.surface->w) * image.surface->h;
+		Uint8 depth = image.surface->format->BytesPerPixel;
+
+		image.hasAlpha = (depth == 4);
+		image.linearPixels.resize(totalPixels * 4);
+		ConvertSrgb8ToLinear((Uint8*)image.surface->pixels, depth, image.linearPixels.data(), totalPixels);
 	}
 
+	return true;
+}
+
+/// <summary>
+/// takes over a decoded image, replacing the loaded one. The texture keeps showing the previous image 
+/// until the new one is uploaded. Touches no state of OpenGL, so it runs on any thread while nothing else reads the pixels
+/// </summary>
+void Texture::Load(Image& image)
+{
+	FreePixels();
+
+	m_textureData = image.surface;
+	image.surface = nullptr;
+	m_is16Bit = image.is16Bit;
+	m_hasAlpha = image.hasAlpha;
+	m_linearPixels = std::move(image.linearPixels);
+
 	GLsizei width = m_textureData->w;
 	GLsizei height = m_textureData->h;
 	Uint8* pixels = (Uint8*)m_textureData->pixels;
 	Uint8 depth = m_textureData->format->BytesPerPixel;
-	GLint format = ((depth == 4) ? GL_RGBA : GL_RGB);
 
-	glGenTextures(1, &m_ID);
+	m_pixelsWithEffects = new Uint8[width * height * depth]();
+	std::copy_n(pixels, width * height * depth, m_pixelsWithEffects);
 
-	glBindTexture(GL_TEXTURE_2D, m_ID);
+	m_linearPixelsWithEffects = m_linearPixels;
+}
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+/// <summary>
+/// loads the image of another texture scaled down by a factor, each pixel the average of a block of its pixels, 
+/// in its working format and edge mode. Effects on it preview the effects on the other texture in a fraction of the time. 
+/// Touches no state of OpenGL, like Load
+/// </summary>
+void Texture::LoadScaled(const Texture& source, GLsizei scaleFactor)
+{
+	GLsizei sourceWidth = source.m_textureData->w;
+	GLsizei sourceHeight = source.m_textureData->h;
+	Uint8 depth = source.m_textureData->format->BytesPerPixel;
 
-	m_pixelsWithEffects = new Uint8[width * height * depth]();
-	std::copy_n(pixels, width * height * depth, m_pixelsWithEffects);
+	//the blocks along the right and bottom edges are cut off by the image, and average the pixels they hold
+	GLsizei width = (sourceWidth + scaleFactor - 1) / scaleFactor;
+	GLsizei height = (sourceHeight + scaleFactor - 1) / scaleFactor;
 
-	//OpenGL by default expects the image rows index to be aligned to 4 bytes, meaning images rows must be divisible by 4. 
-	// This commend tells openGL that the image rows' index can be any value, in orther words sets to an alignment of 1 byte. 
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	Image image;
+	image.surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, source.m_textureData->format->BitsPerPixel, 
+		                                           source.m_textureData->format->format);
 
-	glBindTexture(GL_TEXTURE_2D, 0);
+	if (!image.surface)
+	{
+		std::cout << "Error scaling texture." << std::endl;
+		return;
+	}
+
+	image.is16Bit = source.m_is16Bit;
+	image.hasAlpha = source.m_hasAlpha;
+	image.linearPixels.resize(static_cast<size_t>(width) * height * 4);
+
+	const Uint8* sourcePixels = (const Uint8*)source.m_textureData->pixels;
+	const GLfloat* sourceLinearPixels = source.m_linearPixels.data();
+	Uint8* pixels = (Uint8*)image.surface->pixels;
+	GLfloat* linearPixels = image.linearPixels.data();
+
+	ParallelFor(height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			GLsizei firstRow = y * scaleFactor;
+			GLsizei lastRow = std::min(firstRow + scaleFactor, sourceHeight);
+
+			for (GLsizei x = 0; x < width; x++)
+			{
+				GLsizei firstColumn = x * scaleFactor;
+				GLsizei lastColumn = std::min(firstColumn + scaleFactor, sourceWidth);
+
+				Uint32 sums[4] = { 0, 0, 0, 0 };
+				GLfloat linearSums[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+				for (GLsizei row = firstRow; row < lastRow; row++)
+				{
+					for (GLsizei column = firstColumn; column < lastColumn; column++)
+					{
+						size_t sourceIndex = static_cast<size_t>(row) * sourceWidth + column;
+
+						for (Uint8 c = 0; c < depth; c++)
+						{
+							sums[c] += sourcePixels[sourceIndex * depth + c];
+						}
+
+						for (int c = 0; c < 4; c++)
+						{
+							linearSums[c] += sourceLinearPixels[sourceIndex * 4 + c];
+						}
+					}
+				}
+
+				Uint32 totalBlockPixels = (lastRow - firstRow) * (lastColumn - firstColumn);
+				size_t index = static_cast<size_t>(y) * width + x;
+
+				for (Uint8 c = 0; c < depth; c++)
+				{
+					pixels[index * depth + c] = static_cast<Uint8>((sums[c] + totalBlockPixels / 2) / totalBlockPixels);
+				}
+
+				for (int c = 0; c < 4; c++)
+				{
+					linearPixels[index * 4 + c] = linearSums[c] / totalBlockPixels;
+				}
+			}
+		}
+	});
+
+	m_workingFormat = source.m_workingFormat;
+	m_edgeMode = source.m_edgeMode;
+
+	Load(image);
 }
 
+/// <summary>
+/// uploads the pixels with the current effects applied on them to the texture. 
+/// In linear light the texture is stored as half floats, which the shader encodes back to sRGB
+/// </summary>
 void Texture::Reload()
+{
+	Upload(m_linearPixelsWithEffects.data(), m_pixelsWithEffects);
+}
+
+/// <summary>
+/// specifies the texture from the pixels with effects in the working format, 
+/// given as pointers into client memory or as offsets into the bound upload buffer
+/// </summary>
+void Texture::Upload(const GLfloat* linearPixels, const Uint8* pixels)
 {
 	GLsizei width = m_textureData->w;
 	GLsizei height = m_textureData->h;
-	Uint8* pixels = m_pixelsWithEffects;
 	Uint8 depth = m_textureData->format->BytesPerPixel;
 	GLint format = ((depth == 4) ? GL_RGBA : GL_RGB);
-	glBindTexture(GL_TEXTURE_2D, m_ID);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	if (!m_ID)
+	{
+		glGenTextures(1, &m_ID);
+
+		GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, m_ID);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+
+	//OpenGL by default expects the image rows index to be aligned to 4 bytes, meaning images rows must be divisible by 4. 
+	// This commend tells openGL that the image rows' index can be any value, in orther words sets to an alignment of 1 byte. 
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, m_ID);
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, linearPixels);
+	}
+	else
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	}
+
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, 0);
+	m_isUploadedLinear = IsLinear();
 }
 
 void Texture::Unbind()
 {
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, 0);
 }
 
 void Texture::Unload()
+{
+	FreePixels();
+
+	GLState::Instance()->InvalidateTexture(m_ID);
+	glDeleteTextures(1, &m_ID);
+	m_ID = 0;
+	m_isUploadedLinear = false;
+
+	GLState::Instance()->InvalidateBuffer(m_uploadBuffer);
+	glDeleteBuffers(1, &m_uploadBuffer);
+	m_uploadBuffer = 0;
+	m_uploadBufferSize = 0;
+}
+
+/// <summary>
+/// maps the upload buffer for the pixels with the current effects, to be written by WriteUpload on any thread 
+/// and uploaded by EndUpload. The buffer is reused while the size of the pixels stays the same. Called on the main thread
+/// </summary>
+/// <returns>returns nullptr if the buffer could not be mapped</returns>
+void* Texture::BeginUpload()
+{
+	GLsizeiptr size = GetUploadSize();
+
+	if (size != m_uploadBufferSize)
+	{
+		GLState::Instance()->InvalidateBuffer(m_uploadBuffer);
+		glDeleteBuffers(1, &m_uploadBuffer);
+
+		glCreateBuffers(1, &m_uploadBuffer);
+		glNamedBufferData(m_uploadBuffer, size, nullptr, GL_STREAM_DRAW);
+		m_uploadBufferSize = size;
+	}
+
+	//the previous contents are dropped, so the driver never waits for the last upload to finish reading them
+	void* mappedPixels = glMapNamedBufferRange(m_uploadBuffer, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+	if (!mappedPixels)
+	{
+		std::cout << "Error mapping the upload buffer of a texture" << std::endl;
+	}
+
+	return mappedPixels;
+}
+
+/// <summary>
+/// copies the pixels with the current effects into the mapped upload buffer. Touches no state of OpenGL, so it runs on any thread
+/// </summary>
+void Texture::WriteUpload(void* mappedPixels) const
+{
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		std::copy(m_linearPixelsWithEffects.begin(), m_linearPixelsWithEffects.end(), static_cast<GLfloat*>(mappedPixels));
+	}
+	else
+	{
+		std::copy_n(m_pixelsWithEffects, GetUploadSize(), static_cast<Uint8*>(mappedPixels));
+	}
+}
+
+/// <summary>
+/// uploads the pixels written into the upload buffer to the texture. The copy runs on the GPU, 
+/// and the fence returned tells when it is done and the buffer may be written again. Called on the main thread
+/// </summary>
+/// <returns>returns nullptr if the buffer was not mapped</returns>
+GLsync Texture::EndUpload()
+{
+	if (!glUnmapNamedBuffer(m_uploadBuffer))
+	{
+		return nullptr;
+	}
+
+	GLState::Instance()->BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadBuffer);
+	Upload(nullptr, nullptr);
+
+	//uploads from client memory elsewhere must not read from the buffer
+	GLState::Instance()->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	//the fence is only polled, so it is sent to the GPU now rather than whenever the driver flushes next
+	GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+
+	return fence;
+}
+
+//the rows of an image uploaded on the upload thread are sent in bands of about this size, each flushed on its own, 
+//so the driver interleaves them with the frames drawn meanwhile instead of taking the whole image in one go
+static const GLsizeiptr UPLOAD_CHUNK_BYTES = 4 * 1024 * 1024;
+
+/// <summary>
+/// uploads the pixels with the current effects to a new texture, a band of rows at a time. 
+/// Runs on the upload thread, whose context shares objects with the main one, so the texture shown is drawn meanwhile
+/// </summary>
+/// <returns>returns the new texture, which Publish shows once the GPU has passed a fence made after the upload</returns>
+GLuint Texture::UploadInChunks() const
+{
+	GLsizei width = m_textureData->w;
+	GLsizei height = m_textureData->h;
+	Uint8 depth = m_textureData->format->BytesPerPixel;
+	bool isLinear = (m_workingFormat == WorkingFormat::LinearFloat);
+
+	GLint internalFormat = isLinear ? GL_RGBA16F : ((depth == 4) ? GL_RGBA : GL_RGB);
+	GLenum format = isLinear ? GL_RGBA : ((depth == 4) ? GL_RGBA : GL_RGB);
+	GLenum type = isLinear ? GL_FLOAT : GL_UNSIGNED_BYTE;
+	GLsizeiptr rowSize = GetUploadSize() / height;
+	const Uint8* pixels = isLinear ? reinterpret_cast<const Uint8*>(m_linearPixelsWithEffects.data()) : m_pixelsWithEffects;
+
+	//bound directly rather than through the upload thread's GLState, which textures deleted on the screen's context never invalidate
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
+
+	GLsizei rowsPerChunk = static_cast<GLsizei>(std::max<GLsizeiptr>(UPLOAD_CHUNK_BYTES / rowSize, 1));
+
+	for (GLsizei firstRow = 0; firstRow < height; firstRow += rowsPerChunk)
+	{
+		GLsizei totalRows = std::min(rowsPerChunk, height - firstRow);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, width, totalRows, format, type, pixels + firstRow * rowSize);
+		glFlush();
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return texture;
+}
+
+/// <summary>
+/// shows a texture uploaded by UploadInChunks in place of the current one, which is deleted. 
+/// Called on the thread the screen's context is current on
+/// </summary>
+void Texture::Publish(GLuint texture)
+{
+	GLState::Instance()->InvalidateTexture(m_ID);
+	glDeleteTextures(1, &m_ID);
+	m_ID = texture;
+	m_isUploadedLinear = IsLinear();
+}
+
+/// <summary>
+/// uploads a range of rows of the pixels with the current effects to the texture shown, such as the rows of a time-sliced effect 
+/// done so far. Called on the thread the screen's context is current on
+/// </summary>
+void Texture::UploadRows(GLsizei first, GLsizei last)
+{
+	//the texture shown holds the loaded image in the working format, unless the image or the format changed since
+	if (!m_ID || first >= last || m_isUploadedLinear != IsLinear())
+	{
+		return;
+	}
+
+	bool isLinear = (m_workingFormat == WorkingFormat::LinearFloat);
+	GLenum format = (isLinear || m_textureData->format->BytesPerPixel == 4) ? GL_RGBA : GL_RGB;
+	GLsizeiptr rowSize = GetUploadSize() / m_textureData->h;
+	const Uint8* pixels = isLinear ? reinterpret_cast<const Uint8*>(m_linearPixelsWithEffects.data()) : m_pixelsWithEffects;
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, m_ID);
+
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, m_textureData->w, last - first, format, isLinear ? GL_FLOAT : GL_UNSIGNED_BYTE, 
+		            pixels + first * rowSize);
+
+	GLState::Instance()->BindTexture(0, GL_TEXTURE_2D, 0);
+}
+
+/// <summary>
+/// frees the pixels of the loaded image and the buffers of the effects, keeping the texture and its upload buffer
+/// </summary>
+void Texture::FreePixels()
 {
 	delete[] m_pixelsWithEffects;
 	SDL_FreeSurface(m_textureData);
-	glDeleteTextures(1, &m_ID);
+
+	m_pixelsWithEffects = nullptr;
+	m_textureData = nullptr;
+
+	m_linearPixels.clear();
+	m_linearPixels.shrink_to_fit();
+	m_linearPixelsWithEffects.clear();
+	m_linearPixelsWithEffects.shrink_to_fit();
+	m_summedAreaTable.Clear();
+	m_blurredPixels.Clear();
+	m_isSourceHashed = false;
+}
+
+/// <summary>
+/// the size of the pixels with the current effects as uploaded in the working format
+/// </summary>
+GLsizeiptr Texture::GetUploadSize() const
+{
+	GLsizeiptr totalPixels = static_cast<GLsizeiptr>(m_textureData->w) * m_textureData->h;
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		return totalPixels * 4 * sizeof(GLfloat);
+	}
+
+	return totalPixels * m_textureData->format->BytesPerPixel;
 }
 
 /// <summary>
@@ -82,7 +505,11 @@ void Texture::SaveImage(const std::string& filename)
 {
 	std::string extension = GetExtension(filename.c_str());
 
-	if (extension == "jpg")
+	if (m_is16Bit && extension != "jpg")
+	{
+		SavePng16(filename, m_linearPixels);
+	}
+	else if (extension == "jpg")
 	{
 		IMG_SaveJPG(m_textureData, filename.c_str(), 100);
 	}
@@ -100,6 +527,17 @@ void Texture::SaveImageWithEffects(const std::string& filename)
 {
 	std::string extension = GetExtension(filename.c_str());
 
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		if (m_is16Bit && extension != "jpg")
+		{
+			SavePng16(filename, m_linearPixelsWithEffects);
+			return;
+		}
+
+		EncodePixelsWithEffects();
+	}
+
 	GLsizei width = m_textureData->w;
 	GLsizei height = m_textureData->h;
 	Uint8 depth = m_textureData->format->BytesPerPixel;
@@ -123,13 +561,29 @@ void Texture::SaveImageWithEffects(const std::string& filename)
 
 void Texture::Invert()
 {
+	InvertRows(0, m_textureData->h);
+}
+
+/// <summary>
+/// inverts the colors of a range of rows of the pixels with effects, leaving alpha as it is
+/// </summary>
+void Texture::InvertRows(GLsizei first, GLsizei last)
+{
+	size_t rowPixels = static_cast<size_t>(m_textureData->w);
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		InvertSrgb(m_linearPixelsWithEffects.data() + first * rowPixels * 4, (last - first) * rowPixels);
+		return;
+	}
+
 	Uint8 depth = m_textureData->format->BytesPerPixel;
 
 	if (m_pixelsWithEffects != nullptr)
 	{
-		GLsizei nbytes = m_textureData->w * m_textureData->h * m_textureData->format->BytesPerPixel;
+		GLsizei lastByte = static_cast<GLsizei>(last * rowPixels * depth);
 
-		for (int i = 0; i < nbytes; i++)
+		for (GLsizei i = static_cast<GLsizei>(first * rowPixels * depth); i < lastByte; i++)
 		{
 			if (depth < 4 || (i + 1) % 4 != 0)
 			{
@@ -140,115 +594,1278 @@ void Texture::Invert()
 }
 
 
+//effects computed faster than this are not stored in the effect cache, as reading them back would take about as long
+static const double MIN_CACHED_EFFECT_MILLISECONDS = 20.0;
+
 void Texture::Blur(GLfloat blurFactor, bool isInvert)
 {
-	GLsizei bradiusHori = GLsizei(blurFactor * m_textureData->w / 2);
-	GLsizei bradiusVerti = GLsizei(blurFactor * m_textureData->h / 2);
+	GLsizei bradiusHori;
+	GLsizei bradiusVerti;
+	GetBlurRadii(blurFactor, bradiusHori, bradiusVerti);
+
+	//blurs that take a while are kept in the effect cache, where later sessions and other instances find them
+	bool isBlurred = bradiusHori > 0 && bradiusVerti > 0;
+	bool isCached = isBlurred && m_isEffectCacheEnabled;
+	Uint64 cacheKey = isCached ? EffectCache::GetKey(GetSourceHash(), GetBlurParameters(bradiusHori, bradiusVerti, isInvert)) : 0;
+
+	if (isCached && LoadCachedEffects(cacheKey))
+	{
+		m_isLastBlurIncremental = false;
+		return;
+	}
 
-	if (bradiusHori == 0 || bradiusVerti == 0)
+	Timer timer;
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		if (bradiusHori == 0 || bradiusVerti == 0)
+		{
+			m_linearPixelsWithEffects = m_linearPixels;
+		}
+		else
+		{
+			BlurLinear(bradiusHori, bradiusVerti);
+		}
+	}
+	else if (bradiusHori == 0 || bradiusVerti == 0)
 	{
 		GLsizei nbytes = m_textureData->w * m_textureData->h * m_textureData->format->BytesPerPixel;
 		std::copy_n((Uint8*)m_textureData->pixels, nbytes, m_pixelsWithEffects);
 	}
 	else
 	{
-		Uint8* temp = HorizontalBlur(bradiusHori, bradiusHori * .3f);
-		VerticalBlur(temp, bradiusVerti, bradiusVerti * .3f);
+		PaddedBuffer<GLfloat> tempPixels;
+		tempPixels.Create(m_textureData->w, m_textureData->h, m_textureData->format->BytesPerPixel, 0, bradiusVerti);
+
+		HorizontalBlur(bradiusHori, bradiusHori * .3f, tempPixels);
+		VerticalBlur(tempPixels, bradiusVerti, bradiusVerti * .3f, m_pixelsWithEffects);
 	}
 
 	if (isInvert)
 	{
 		Invert();
 	}
+
+	//an incremental blur differs slightly from the blur of the source, which is what the cache holds
+	bool isFromSource = isCached && (!IsLinear() || !m_isLastBlurIncremental);
+
+	if (isFromSource && timer.GetElapsedMilliseconds() >= MIN_CACHED_EFFECT_MILLISECONDS)
+	{
+		StoreCachedEffects(cacheKey);
+	}
+}
+
+
+/// <summary>
+/// the parameters of a blur in the effect cache, which name everything the result depends on. 
+/// Their version changes with the blur
+/// </summary>
+std::string Texture::GetBlurParameters(GLsizei horizontalRadius, GLsizei verticalRadius, bool isInvert) const
+{
+	std::stringstream parameters;
+	parameters << "blur 2 " << (IsLinear() ? "linear" : "gamma8") << " " << m_textureData->w << "x" << m_textureData->h << "x" 
+		       << static_cast<int>(m_textureData->format->BytesPerPixel) << " " << horizontalRadius << " " << verticalRadius << " " 
+		       << GetEdgeModeName(m_edgeMode) << " " << isInvert;
+
+	return parameters.str();
 }
 
+/// <summary>
+/// gets the radii of the blur kernels along the rows and the columns for a blur factor
+/// </summary>
+void Texture::GetBlurRadii(GLfloat blurFactor, GLsizei& horizontalRadius, GLsizei& verticalRadius) const
+{
+	horizontalRadius = GLsizei(blurFactor * m_textureData->w / 2);
+	verticalRadius = GLsizei(blurFactor * m_textureData->h / 2);
+}
 
-Uint8* Texture::HorizontalBlur(GLsizei radius, GLfloat sigma)
+/// <summary>
+/// the normalized gaussian kernel of the given radius, shared by the passes of the blurs
+/// </summary>
+static std::vector<GLfloat> CreateGaussianKernel(GLsizei radius, GLfloat sigma)
 {
-	// Create the horizontal Gaussian kernel
-	int kernelSize = 2 * radius + 1;
-	std::vector<double> kernel(kernelSize, 0.0);
+	std::vector<double> kernel(2 * radius + 1, 0.0);
 	double sum = 0.0;
 
-	for (int i = -radius; i <= radius; ++i) {
-		double exponent = -(i * i) / (2 * sigma * sigma);
-		double value = std::exp(exponent) / (sqrt(2 * M_PI) * sigma);
-		kernel[i + radius] = value;
-		sum += value;
+	for (int i = -radius; i <= radius; ++i)
+	{
+		kernel[i + radius] = std::exp(-(i * i) / (2 * sigma * sigma));
+		sum += kernel[i + radius];
 	}
 
-	// Normalize the kernel
-	for (int i = 0; i < kernelSize; ++i) {
-		kernel[i] /= sum;
+	std::vector<GLfloat> normalizedKernel(kernel.size());
+
+	for (size_t i = 0; i < kernel.size(); ++i)
+	{
+		normalizedKernel[i] = static_cast<GLfloat>(kernel[i] / sum);
+	}
+
+	return normalizedKernel;
+}
+
+/// <summary>
+/// blurs the rows of the loaded image into the rows of the given pixels, in floats, and fills their halo above and below 
+/// for VerticalBlur. Each row is padded by the pixels the edge mode gives beyond its edges, so every pixel sums 
+/// the same taps without bounds checks, and the taps are summed a whole row at a time, which the compiler vectorizes
+/// </summary>
+/// <param name="tempPixels">of the size of the image, with a halo above and below of the radius of the vertical blur</param>
+/// <param name="isCancelled">checked before each row, stopping the blur when it returns true</param>
+/// <returns>returns false if the blur was cancelled</returns>
+bool Texture::HorizontalBlur(GLsizei radius, GLfloat sigma, PaddedBuffer<GLfloat>& tempPixels, 
+	                         const std::function<bool()>& isCancelled) const
+{
+	std::vector<GLfloat> kernel = CreateGaussianKernel(radius, sigma);
+
+	PaddedBuffer<GLfloat> paddedRow;
+	paddedRow.Create(m_textureData->w, 1, m_textureData->format->BytesPerPixel, radius, 0);
+
+	for (GLsizei i = 0; i < m_textureData->h; ++i)
+	{
+		if (isCancelled && isCancelled())
+		{
+			return false;
+		}
+
+		HorizontalBlurRows(kernel, paddedRow, tempPixels, i, i + 1);
+	}
+
+	tempPixels.FillColumnHalo(m_edgeMode);
+	return true;
+}
+
+/// <summary>
+/// blurs a range of rows of the loaded image into the rows of the given pixels, as HorizontalBlur does
+/// </summary>
+/// <param name="paddedRow">a row of the width of the image, with a halo of the radius of the kernel</param>
+void Texture::HorizontalBlurRows(const std::vector<GLfloat>& kernel, PaddedBuffer<GLfloat>& paddedRow, 
+	                             PaddedBuffer<GLfloat>& tempPixels, GLsizei first, GLsizei last) const
+{
+	GLsizei radius = static_cast<GLsizei>(kernel.size() / 2);
+	Uint8 depth = m_textureData->format->BytesPerPixel;
+	size_t rowSize = static_cast<size_t>(m_textureData->w) * depth;
+	const Uint8* pixels = (Uint8*)m_textureData->pixels;
+
+	for (GLsizei i = first; i < last; ++i)
+	{
+		paddedRow.SetRows(pixels + i * rowSize, 0, 1, m_edgeMode);
+
+		const GLfloat* firstTap = paddedRow.GetRow(0) - radius * depth;
+		GLfloat* row = tempPixels.GetRow(i);
+		std::fill_n(row, rowSize, 0.0f);
+
+		for (GLsizei k = 0; k <= 2 * radius; ++k)
+		{
+			GLfloat weight = kernel[k];
+			const GLfloat* tapRow = firstTap + k * depth;
+
+			for (size_t x = 0; x < rowSize; ++x)
+			{
+				row[x] += weight * tapRow[x];
+			}
+		}
+	}
+}
+
+/// <summary>
+/// blurs the columns of the horizontally blurred pixels into the result, rounding them to 8 bits and leaving its alpha 
+/// as it is. The halo of the pixels holds the rows beyond the edges, so every row sums the same taps
+/// </summary>
+/// <param name="isCancelled">checked before each row, stopping the blur when it returns true</param>
+/// <returns>returns false if the blur was cancelled</returns>
+bool Texture::VerticalBlur(const PaddedBuffer<GLfloat>& tempPixels, GLsizei radius, GLfloat sigma, Uint8* result, 
+	                       const std::function<bool()>& isCancelled) const
+{
+	std::vector<GLfloat> kernel = CreateGaussianKernel(radius, sigma);
+	std::vector<GLfloat> row(static_cast<size_t>(m_textureData->w) * m_textureData->format->BytesPerPixel);
+
+	for (GLsizei i = 0; i < m_textureData->h; ++i)
+	{
+		if (isCancelled && isCancelled())
+		{
+			return false;
+		}
+
+		VerticalBlurRows(kernel, tempPixels, row, result, i, i + 1);
+	}
+
+	return true;
+}
+
+/// <summary>
+/// blurs a range of rows of the horizontally blurred pixels into the result, as VerticalBlur does
+/// </summary>
+/// <param name="row">of the size of a row of the image, which the sums are kept in</param>
+void Texture::VerticalBlurRows(const std::vector<GLfloat>& kernel, const PaddedBuffer<GLfloat>& tempPixels, 
+	                           std::vector<GLfloat>& row, Uint8* result, GLsizei first, GLsizei last) const
+{
+	GLsizei radius = static_cast<GLsizei>(kernel.size() / 2);
+	Uint8 depth = m_textureData->format->BytesPerPixel;
+	size_t rowSize = static_cast<size_t>(m_textureData->w) * depth;
+
+	for (GLsizei i = first; i < last; ++i)
+	{
+		std::fill(row.begin(), row.end(), 0.0f);
+
+		for (GLsizei k = 0; k <= 2 * radius; ++k)
+		{
+			GLfloat weight = kernel[k];
+			const GLfloat* tapRow = tempPixels.GetRow(i - radius + k);
+
+			for (size_t x = 0; x < rowSize; ++x)
+			{
+				row[x] += weight * tapRow[x];
+			}
+		}
+
+		Uint8* resultRow = result + i * rowSize;
+
+		for (size_t x = 0; x < rowSize; x += depth)
+		{
+			for (Uint8 channel = 0; channel < 3; ++channel)
+			{
+				resultRow[x + channel] = Uint8(std::min(std::max(row[x + channel] + 0.5f, 0.0f), 255.0f));
+			}
+		}
+	}
+}
+
+//the incremental blur blurs the source again once the tails its truncated kernels leave out add up to this share
+static const double MAX_INCREMENTAL_BLUR_ERROR = 0.01;
+
+//the smallest margin kept around the blurred pixels, so small blurs can grow a few steps before the source is blurred again
+static const GLsizei MIN_BLUR_MARGIN = 8;
+
+/// <summary>
+/// blurs a row of RGBA float pixels in place with the kernel, leaving alpha as it is. Only the pixels at least the radius away 
+/// from the ends have all their taps in the row, so those nearer the ends are left as they are and every pixel blurred sums 
+/// the same taps. The taps are summed a whole row at a time, which the compiler vectorizes
+/// </summary>
+/// <param name="row">of the size of the row, which it is copied into first</param>
+static void BlurFloatRowHorizontally(GLfloat* blurredRow, GLsizei width, const std::vector<GLfloat>& kernel, std::vector<GLfloat>& row)
+{
+	GLsizei radius = static_cast<GLsizei>(kernel.size() / 2);
+
+	if (width <= 2 * radius)
+	{
+		return;
+	}
+
+	std::copy_n(blurredRow, static_cast<size_t>(width) * 4, row.data());
+
+	size_t first = static_cast<size_t>(radius) * 4;
+	size_t last = static_cast<size_t>(width - radius) * 4;
+	std::fill(blurredRow + first, blurredRow + last, 0.0f);
+
+	for (GLsizei k = 0; k <= 2 * radius; ++k)
+	{
+		GLfloat weight = kernel[k];
+		const GLfloat* tapRow = row.data() + static_cast<size_t>(k) * 4;
+
+		for (size_t x = first; x < last; ++x)
+		{
+			blurredRow[x] += weight * tapRow[x - first];
+		}
+	}
+
+	for (size_t x = first + 3; x < last; x += 4)
+	{
+		blurredRow[x] = row[x];
+	}
+}
+
+/// <summary>
+/// sums the rows of the source around row i, weighted by the kernel, into the result row. The rows from i - radius 
+/// to i + radius must be in the source. Whole rows are weighted and summed at once, which keeps the vertical pass running along memory
+/// </summary>
+/// <param name="rowStride">the values between the starts of two rows of the source</param>
+/// <param name="rowSize">the values summed of each row, from the start of the row</param>
+static void BlurFloatRowVertically(const GLfloat* source, size_t rowStride, GLsizei i, 
+	                               const std::vector<GLfloat>& kernel, GLfloat* result, size_t rowSize)
+{
+	GLsizei radius = static_cast<GLsizei>(kernel.size() / 2);
+	std::fill(result, result + rowSize, 0.0f);
+
+	for (GLsizei k = 0; k <= 2 * radius; ++k)
+	{
+		GLfloat weight = kernel[k];
+		const GLfloat* tapRow = source + (i - radius + k) * rowStride;
+
+		for (size_t x = 0; x < rowSize; ++x)
+		{
+			result[x] += weight * tapRow[x];
+		}
+	}
+}
+
+/// <summary>
+/// blurs RGBA float pixels in place, along the rows and then along the columns. The pixels nearer the edges of the buffer 
+/// than the radius lack taps and are left as they are, so images are given a halo of the pixels beyond their edges first. 
+/// Without a cancellation check the rows run in parallel; with one, they run on the calling thread, 
+/// as speculative work only takes the core it runs on
+/// </summary>
+/// <param name="isCancelled">checked before each row, stopping the blur when it returns true</param>
+/// <returns>returns false if the blur was cancelled</returns>
+static bool BlurFloatPixels(GLfloat* pixels, GLsizei width, GLsizei height, GLsizei horizontalRadius, GLfloat sigmaX, 
+	                        GLsizei verticalRadius, GLfloat sigmaY, const std::function<bool()>& isCancelled = nullptr)
+{
+	size_t rowSize = static_cast<size_t>(width) * 4;
+
+	auto forRows = [&isCancelled](GLsizei totalRows, const std::function<void(GLuint first, GLuint last)>& work)
+	{
+		if (!isCancelled)
+		{
+			ParallelFor(totalRows, work);
+			return true;
+		}
+
+		for (GLsizei i = 0; i < totalRows; ++i)
+		{
+			if (isCancelled())
+			{
+				return false;
+			}
+
+			work(i, i + 1);
+		}
+
+		return true;
+	};
+
+	if (horizontalRadius > 0)
+	{
+		std::vector<GLfloat> kernel = CreateGaussianKernel(horizontalRadius, sigmaX);
+
+		bool isDone = forRows(height, [&](GLuint first, GLuint last)
+		{
+			std::vector<GLfloat> row(rowSize);
+
+			for (GLsizei i = first; i < static_cast<GLsizei>(last); ++i)
+			{
+				BlurFloatRowHorizontally(pixels + i * rowSize, width, kernel, row);
+			}
+		});
+
+		if (!isDone)
+		{
+			return false;
+		}
+	}
+
+	if (verticalRadius > 0 && height > 2 * verticalRadius)
+	{
+		std::vector<GLfloat> kernel = CreateGaussianKernel(verticalRadius, sigmaY);
+		std::vector<GLfloat> tempPixels(pixels, pixels + rowSize * height);
+
+		//the rows from the radius on, which have all their taps
+		bool isDone = forRows(height - 2 * verticalRadius, [&](GLuint first, GLuint last)
+		{
+			for (GLsizei i = first + verticalRadius; i < static_cast<GLsizei>(last) + verticalRadius; ++i)
+			{
+				BlurFloatRowVertically(tempPixels.data(), rowSize, i, kernel, pixels + i * rowSize, rowSize);
+			}
+		});
+
+		if (!isDone)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// copies the colors of the image inside the halo of blurred pixels into the result, with the alpha of the source
+/// </summary>
+static void CopyBlurredPixels(const PaddedBuffer<GLfloat>& blurredPixels, const std::vector<GLfloat>& sourcePixels, 
+	                          std::vector<GLfloat>& result)
+{
+	size_t rowSize = static_cast<size_t>(blurredPixels.GetWidth()) * 4;
+
+	for (GLsizei i = 0; i < blurredPixels.GetHeight(); ++i)
+	{
+		GLfloat* row = &result[i * rowSize];
+		std::copy_n(blurredPixels.GetRow(i), rowSize, row);
+
+		for (size_t x = 3; x < rowSize; x += 4)
+		{
+			row[x] = sourcePixels[i * rowSize + x];
+		}
+	}
+}
+
+/// <summary>
+/// blurs the loaded image with the given radii into the result, without touching the pixels with effects, 
+/// so that it can run on another thread while the texture is used. The linear blur is the one from the source, 
+/// never an incremental one. The loaded image must not change while it runs
+/// </summary>
+/// <param name="isCancelled">checked before each row, stopping the blur when it returns true</param>
+/// <returns>returns false if the blur was cancelled</returns>
+bool Texture::ComputeBlur(GLsizei horizontalRadius, GLsizei verticalRadius, BlurResult& result, 
+	                      const std::function<bool()>& isCancelled) const
+{
+	result.horizontalRadius = horizontalRadius;
+	result.verticalRadius = verticalRadius;
+	result.linearPixels.clear();
+	result.pixels.clear();
+
+	bool isEmpty = horizontalRadius == 0 || verticalRadius == 0;
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		if (isEmpty)
+		{
+			result.linearPixels = m_linearPixels;
+			return true;
+		}
+
+		//the halo holds the pixels beyond the edges the blur reads, as the edge mode gives them
+		PaddedBuffer<GLfloat> blurredPixels;
+		blurredPixels.Create(m_textureData->w, m_textureData->h, 4, horizontalRadius, verticalRadius);
+		blurredPixels.SetRows(m_linearPixels.data(), 0, m_textureData->h, m_edgeMode);
+		blurredPixels.FillColumnHalo(m_edgeMode);
+
+		if (!BlurFloatPixels(blurredPixels.GetData(), blurredPixels.GetPaddedWidth(), blurredPixels.GetPaddedHeight(), 
+			                 horizontalRadius, horizontalRadius * .3f, verticalRadius, verticalRadius * .3f, isCancelled))
+		{
+			return false;
+		}
+
+		result.linearPixels.resize(m_linearPixels.size());
+		CopyBlurredPixels(blurredPixels, m_linearPixels, result.linearPixels);
+
+		return true;
+	}
+
+	size_t nbytes = static_cast<size_t>(m_textureData->w) * m_textureData->h * m_textureData->format->BytesPerPixel;
+	const Uint8* pixels = (Uint8*)m_textureData->pixels;
+	result.pixels.assign(pixels, pixels + nbytes);
+
+	if (isEmpty)
+	{
+		return true;
+	}
+
+	PaddedBuffer<GLfloat> tempPixels;
+	tempPixels.Create(m_textureData->w, m_textureData->h, m_textureData->format->BytesPerPixel, 0, verticalRadius);
+
+	return HorizontalBlur(horizontalRadius, horizontalRadius * .3f, tempPixels, isCancelled) && 
+		   VerticalBlur(tempPixels, verticalRadius, verticalRadius * .3f, result.pixels.data(), isCancelled);
+}
+
+/// <summary>
+/// replaces the pixels with effects by a blur computed by ComputeBlur in the current working format
+/// </summary>
+void Texture::ApplyBlur(const BlurResult& result, bool isInvert)
+{
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		m_linearPixelsWithEffects = result.linearPixels;
+	}
+	else
+	{
+		std::copy(result.pixels.begin(), result.pixels.end(), m_pixelsWithEffects);
+	}
+
+	if (isInvert)
+	{
+		Invert();
+	}
+}
+
+size_t Texture::BlurResult::GetSize() const
+{
+	return linearPixels.size() * sizeof(GLfloat) + pixels.size();
+}
+
+/// <summary>
+/// blurs the pixels in linear light with the same kernels as HorizontalBlur and VerticalBlur. 
+/// Taps beyond the edges read the pixels the edge mode gives, and alpha is kept as it is. 
+/// A gaussian of sigma s2 is one of sigma s1 followed by one of sigma sqrt(s2^2 - s1^2), so a larger blur than the last one 
+/// only blurs the last result by that small difference. The last result is kept in floats with a margin around the image, 
+/// which holds the pixels beyond the edges blurred along with the image, so the edges come out the same too
+/// </summary>
+void Texture::BlurLinear(GLsizei horizontalRadius, GLsizei verticalRadius)
+{
+	GLsizei width = m_textureData->w;
+	GLsizei height = m_textureData->h;
+	GLfloat sigmaX = horizontalRadius * .3f;
+	GLfloat sigmaY = verticalRadius * .3f;
+
+	GLsizei deltaRadiusX = 0;
+	GLsizei deltaRadiusY = 0;
+	GLfloat deltaSigmaX = 0.0f;
+	GLfloat deltaSigmaY = 0.0f;
+	double error = m_blurError;
+
+	bool isIncremental = m_isIncrementalBlur && !m_blurredPixels.IsEmpty() && sigmaX >= m_blurSigmaX && sigmaY >= m_blurSigmaY;
+
+	if (isIncremental)
+	{
+		deltaSigmaX = std::sqrt(sigmaX * sigmaX - m_blurSigmaX * m_blurSigmaX);
+		deltaSigmaY = std::sqrt(sigmaY * sigmaY - m_blurSigmaY * m_blurSigmaY);
+		deltaRadiusX = static_cast<GLsizei>(std::ceil(deltaSigmaX / .3f));
+		deltaRadiusY = static_cast<GLsizei>(std::ceil(deltaSigmaY / .3f));
+
+		//the truncated kernels leave out their tails, which add up over the increments
+		error += (deltaRadiusX > 0) ? std::erfc(deltaRadiusX / (deltaSigmaX * std::sqrt(2.0))) : 0.0;
+		error += (deltaRadiusY > 0) ? std::erfc(deltaRadiusY / (deltaSigmaY * std::sqrt(2.0))) : 0.0;
+
+		isIncremental = error <= MAX_INCREMENTAL_BLUR_ERROR && 
+			            m_blurSpreadX + deltaRadiusX <= m_blurredPixels.GetHaloX() && 
+			            m_blurSpreadY + deltaRadiusY <= m_blurredPixels.GetHaloY();
+	}
+
+	if (isIncremental)
+	{
+		BlurFloatPixels(m_blurredPixels.GetData(), m_blurredPixels.GetPaddedWidth(), m_blurredPixels.GetPaddedHeight(), 
+			            deltaRadiusX, deltaSigmaX, deltaRadiusY, deltaSigmaY);
+
+		m_blurError = error;
+		m_blurSpreadX += deltaRadiusX;
+		m_blurSpreadY += deltaRadiusY;
+	}
+	else
+	{
+		//the margin leaves room for the blur to grow to about twice its size before the source is blurred again. 
+		//It is filled with the pixels the edge mode gives beyond the edges, and blurred along with the image
+		m_blurredPixels.Create(width, height, 4, 2 * horizontalRadius + MIN_BLUR_MARGIN, 2 * verticalRadius + MIN_BLUR_MARGIN);
+
+		ParallelFor(height, [&](GLuint first, GLuint last)
+		{
+			m_blurredPixels.SetRows(m_linearPixels.data(), first, last, m_edgeMode);
+		});
+
+		m_blurredPixels.FillColumnHalo(m_edgeMode);
+
+		BlurFloatPixels(m_blurredPixels.GetData(), m_blurredPixels.GetPaddedWidth(), m_blurredPixels.GetPaddedHeight(), 
+			            horizontalRadius, sigmaX, verticalRadius, sigmaY);
+
+		m_blurError = 0.0;
+		m_blurSpreadX = horizontalRadius;
+		m_blurSpreadY = verticalRadius;
+	}
+
+	m_blurSigmaX = sigmaX;
+	m_blurSigmaY = sigmaY;
+	m_isLastBlurIncremental = isIncremental;
+
+	CopyBlurredPixels(m_blurredPixels, m_linearPixels, m_linearPixelsWithEffects);
+}
+
+/// <summary>
+/// sets how the blurs make up the pixels beyond the edges of the image
+/// </summary>
+void Texture::SetEdgeMode(EdgeMode edgeMode)
+{
+	m_edgeMode = edgeMode;
+	m_blurredPixels.Clear();
+}
+
+EdgeMode Texture::GetEdgeMode() const
+{
+	return m_edgeMode;
+}
+
+/// <summary>
+/// sets whether a larger blur than the last one only blurs the last result by the difference, 
+/// instead of blurring the source again
+/// </summary>
+void Texture::SetIncrementalBlur(bool isIncrementalBlur)
+{
+	m_isIncrementalBlur = isIncrementalBlur;
+	m_blurredPixels.Clear();
+}
+
+/// <summary>
+/// sets whether blurs are looked up in and stored to the effect cache. Effects on a texture that is only shown 
+/// for a moment, such as a preview, are not worth hashing the image and writing the result to the disk
+/// </summary>
+void Texture::SetEffectCacheEnabled(bool isEnabled)
+{
+	m_isEffectCacheEnabled = isEnabled;
+}
+
+/// <summary>
+/// whether the last blur in linear light was computed from the previous blur rather than from the source
+/// </summary>
+bool Texture::IsLastBlurIncremental() const
+{
+	return m_isLastBlurIncremental;
+}
+
+/// <summary>
+/// convolves the pixels with the current effects with a kernel, on top of those effects. Alpha is kept as it is
+/// </summary>
+void Texture::Convolve(const Kernel& kernel)
+{
+	GLsizei width = m_textureData->w;
+	GLsizei height = m_textureData->h;
+	size_t totalPixels = static_cast<size_t>(width) * height;
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		std::vector<GLfloat> pixels = m_linearPixelsWithEffects;
+		Convolution::Instance()->Apply(pixels.data(), m_linearPixelsWithEffects.data(), width, height, kernel);
+
+		for (size_t i = 3; i < pixels.size(); i += 4)
+		{
+			m_linearPixelsWithEffects[i] = pixels[i];
+		}
+
+		return;
+	}
+
+	Uint8 depth = m_textureData->format->BytesPerPixel;
+	std::vector<GLfloat> pixels(totalPixels * 4, 1.0f);
+	std::vector<GLfloat> result(totalPixels * 4);
+
+	for (size_t i = 0; i < totalPixels; i++)
+	{
+		for (Uint8 channel = 0; channel < std::min(depth, Uint8(3)); channel++)
+		{
+			pixels[i * 4 + channel] = m_pixelsWithEffects[i * depth + channel];
+		}
+	}
+
+	Convolution::Instance()->Apply(pixels.data(), result.data(), width, height, kernel);
+
+	for (size_t i = 0; i < totalPixels; i++)
+	{
+		for (Uint8 channel = 0; channel < std::min(depth, Uint8(3)); channel++)
+		{
+			m_pixelsWithEffects[i * depth + channel] = Uint8(std::min(std::max(result[i * 4 + channel] + 0.5f, 0.0f), 255.0f));
+		}
+	}
+}
+
+/// <summary>
+/// averages the pixels in a box around each pixel, through the summed-area table, so large radii cost no more than small ones. 
+/// The box has the size of the blur kernel of Blur
+/// </summary>
+void Texture::BoxBlur(GLfloat blurFactor, bool isInvert)
+{
+	GLsizei horizontalRadius = GLsizei(blurFactor * m_textureData->w / 2);
+	GLsizei verticalRadius = GLsizei(blurFactor * m_textureData->h / 2);
+
+	const SummedAreaTable& summedAreaTable = GetSummedAreaTable();
+	std::vector<GLfloat> pixels(static_cast<size_t>(m_textureData->w) * m_textureData->h * 4);
+
+	summedAreaTable.BoxBlur(pixels.data(), horizontalRadius, verticalRadius);
+	SetPixelsWithEffects(pixels);
+
+	if (isInvert)
+	{
+		Invert();
+	}
+}
+
+/// <summary>
+/// blurs with the gaussians of Blur through a pyramid of halved images, in about the time of a few passes over the image 
+/// whatever the size of the blur. Pixels beyond the edges repeat the edge pixels, so edges are not darkened
+/// </summary>
+/// <param name="isOnGpu">whether the pyramid is computed on the GPU, which falls back to the CPU if it cannot</param>
+void Texture::BlurWithPyramid(GLfloat blurFactor, bool isInvert, bool isOnGpu)
+{
+	GLsizei width = m_textureData->w;
+	GLsizei height = m_textureData->h;
+	GLfloat sigmaX = GLsizei(blurFactor * width / 2) * .3f;
+	GLfloat sigmaY = GLsizei(blurFactor * height / 2) * .3f;
+
+	std::vector<GLfloat> pixels(static_cast<size_t>(width) * height * 4, 1.0f);
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		pixels = m_linearPixels;
+	}
+	else
+	{
+		Uint8 depth = m_textureData->format->BytesPerPixel;
+
+		for (size_t i = 0; i < static_cast<size_t>(width) * height; i++)
+		{
+			for (Uint8 channel = 0; channel < depth; channel++)
+			{
+				pixels[i * 4 + channel] = ((Uint8*)m_textureData->pixels)[i * depth + channel] / 255.0f;
+			}
+		}
+	}
+
+	if (!isOnGpu || !PyramidBlur::Instance()->ApplyOnGpu(pixels.data(), pixels.data(), width, height, sigmaX, sigmaY))
+	{
+		std::vector<GLfloat> sourcePixels = pixels;
+		PyramidBlur::Instance()->Apply(sourcePixels.data(), pixels.data(), width, height, sigmaX, sigmaY);
+	}
+
+	SetPixelsWithEffects(pixels);
+
+	if (isInvert)
+	{
+		Invert();
+	}
+}
+
+/// <summary>
+/// smooths flat areas while keeping edges and texture (a Lee filter). Each pixel moves towards the mean of the box 
+/// around it by the share of the box's luminance variance that the noise accounts for
+/// </summary>
+/// <param name="radius">radius of the box around each pixel</param>
+/// <param name="noiseLevel">standard deviation of the noise, with values between 0 and 1</param>
+void Texture::Denoise(GLsizei radius, GLfloat noiseLevel, bool isInvert)
+{
+	GLsizei width = m_textureData->w;
+	GLsizei height = m_textureData->h;
+
+	const SummedAreaTable& summedAreaTable = GetSummedAreaTable();
+	std::vector<GLfloat> pixels(static_cast<size_t>(width) * height * 4);
+
+	ParallelFor(height, [&](GLuint first, GLuint last)
+	{
+		for (GLsizei y = first; y < static_cast<GLsizei>(last); y++)
+		{
+			DenoiseRow(summedAreaTable, y, radius, noiseLevel, pixels.data() + static_cast<size_t>(y) * width * 4);
+		}
+	});
+
+	SetPixelsWithEffects(pixels);
+
+	if (isInvert)
+	{
+		Invert();
+	}
+}
+
+/// <summary>
+/// smooths a row of the loaded image as Denoise does, into the colors of a row of RGBA float pixels
+/// </summary>
+void Texture::DenoiseRow(const SummedAreaTable& summedAreaTable, GLsizei y, GLsizei radius, GLfloat noiseLevel, 
+	                     GLfloat* resultRow) const
+{
+	GLsizei width = m_textureData->w;
+	Uint8 depth = m_textureData->format->BytesPerPixel;
+	GLfloat noiseVariance = noiseLevel * noiseLevel;
+
+	for (GLsizei x = 0; x < width; x++)
+	{
+		size_t index = static_cast<size_t>(y) * width + x;
+		glm::vec4 mean = summedAreaTable.GetMean(x, y, radius, radius);
+		GLfloat variance = summedAreaTable.GetLuminanceVariance(x, y, radius, radius);
+		GLfloat detail = (variance > 0.0f) ? std::max(variance - noiseVariance, 0.0f) / variance : 0.0f;
+
+		for (Uint8 channel = 0; channel < 3; channel++)
+		{
+			GLfloat value = (m_workingFormat == WorkingFormat::LinearFloat) ? m_linearPixels[index * 4 + channel] : 
+				            ((Uint8*)m_textureData->pixels)[index * depth + channel] / 255.0f;
+
+			resultRow[x * 4 + channel] = mean[channel] + detail * (value - mean[channel]);
+		}
 	}
+}
+
+/// <summary>
+/// adds the pass of Invert to a time-sliced effect
+/// </summary>
+void Texture::SliceInvert(SlicedEffect& effect)
+{
+	effect.AddPass(m_textureData->h, [this](GLuint first, GLuint last) { InvertRows(first, last); });
+}
+
+//the kernels and buffers of a blur run a few rows at a time, shared by its passes
+struct SlicedBlurBuffers
+{
+	std::vector<GLfloat> horizontalKernel;
+	std::vector<GLfloat> verticalKernel;
+	PaddedBuffer<GLfloat> pixels; //blurred along the rows, with a halo of the pixels beyond the edges
+	PaddedBuffer<GLfloat> paddedRow; //a row of the loaded image with its halo, in the 8-bit gamma working format
+	std::vector<GLfloat> row;
+};
+
+/// <summary>
+/// adds the passes of Blur to a time-sliced effect: along the rows, then along the columns, whose rows are final. 
+/// Called on the workers, which look the blur up in the effect cache, and store it there once it is done if it took a while. 
+/// The blur in linear light always starts from the source, so the next blur does too
+/// </summary>
+void Texture::SliceBlur(GLfloat blurFactor, bool isInvert, SlicedEffect& effect)
+{
+	GLsizei horizontalRadius;
+	GLsizei verticalRadius;
+	GetBlurRadii(blurFactor, horizontalRadius, verticalRadius);
 
-	Uint8 depth = m_textureData->format->BytesPerPixel;
 	GLsizei width = m_textureData->w;
-	const Uint8* pixels = (Uint8*)m_textureData->pixels;
+	GLsizei height = m_textureData->h;
+	Uint8 depth = m_textureData->format->BytesPerPixel;
+
+	m_blurredPixels.Clear();
+	m_isLastBlurIncremental = false;
+
+	if (horizontalRadius == 0 || verticalRadius == 0)
+	{
+		effect.AddPass(height, [this, width, depth, isInvert](GLuint first, GLuint last)
+		{
+			size_t firstPixel = static_cast<size_t>(first) * width;
+			size_t totalPixels = static_cast<size_t>(last - first) * width;
+
+			if (m_workingFormat == WorkingFormat::LinearFloat)
+			{
+				std::copy_n(m_linearPixels.data() + firstPixel * 4, totalPixels * 4, m_linearPixelsWithEffects.data() + firstPixel * 4);
+			}
+			else
+			{
+				std::copy_n((Uint8*)m_textureData->pixels + firstPixel * depth, totalPixels * depth, m_pixelsWithEffects + firstPixel * depth);
+			}
 
-	// Apply the horizontal blur pass
-	Uint8* tempPixels = new Uint8[width * m_textureData->h * depth];
-	for (int i = 0; i < m_textureData->h; ++i) {
-		for (int j = 0; j < width; ++j) {
-			tempPixels[i * width * depth + j * depth] = 0; //Red channel
-			tempPixels[i * width * depth + j * depth + 1] = 0; //green channel
-			tempPixels[i * width * depth + j * depth + 2] = 0; //blue channel
+			if (isInvert)
+			{
+				InvertRows(first, last);
+			}
+		});
+
+		return;
+	}
+
+	Uint64 cacheKey = m_isEffectCacheEnabled ? EffectCache::GetKey(GetSourceHash(), GetBlurParameters(horizontalRadius, verticalRadius, isInvert)) : 0;
+
+	//a cached blur is final at once, and its rows are shown in a single pass
+	if (m_isEffectCacheEnabled && LoadCachedEffects(cacheKey))
+	{
+		effect.AddPass(height, [](GLuint, GLuint) {});
+		return;
+	}
+
+	std::shared_ptr<SlicedBlurBuffers> buffers = std::make_shared<SlicedBlurBuffers>();
+	buffers->horizontalKernel = CreateGaussianKernel(horizontalRadius, horizontalRadius * .3f);
+	buffers->verticalKernel = CreateGaussianKernel(verticalRadius, verticalRadius * .3f);
+
+	if (m_workingFormat == WorkingFormat::LinearFloat)
+	{
+		//the halo holds the pixels beyond the edges the blur reads, as the edge mode gives them
+		PaddedBuffer<GLfloat>& pixels = buffers->pixels;
+		pixels.Create(width, height, 4, horizontalRadius, verticalRadius);
+		buffers->row.resize(static_cast<size_t>(pixels.GetPaddedWidth()) * 4);
+
+		effect.AddPass(height, [this, buffers](GLuint first, GLuint last) 
+		{ 
+			buffers->pixels.SetRows(m_linearPixels.data(), first, last, m_edgeMode); 
+		});
+
+		effect.AddPass(1, [this, buffers](GLuint, GLuint) { buffers->pixels.FillColumnHalo(m_edgeMode); });
+
+		effect.AddPass(pixels.GetPaddedHeight(), [buffers](GLuint first, GLuint last)
+		{
+			size_t rowSize = static_cast<size_t>(buffers->pixels.GetPaddedWidth()) * 4;
+
+			for (GLuint i = first; i < last; ++i)
+			{
+				BlurFloatRowHorizontally(buffers->pixels.GetData() + i * rowSize, buffers->pixels.GetPaddedWidth(), 
+					                     buffers->horizontalKernel, buffers->row);
+			}
+		});
+
+		//the columns inside the halo are summed straight into the pixels with effects, and alpha is kept from the source
+		effect.AddPass(height, [this, buffers, width, horizontalRadius, verticalRadius, isInvert](GLuint first, GLuint last)
+		{
+			size_t rowSize = static_cast<size_t>(width) * 4;
+			size_t paddedRowSize = static_cast<size_t>(buffers->pixels.GetPaddedWidth()) * 4;
+
+			for (GLuint i = first; i < last; ++i)
+			{
+				GLfloat* row = &m_linearPixelsWithEffects[i * rowSize];
+				BlurFloatRowVertically(buffers->pixels.GetData() + horizontalRadius * 4, paddedRowSize, 
+					                   i + verticalRadius, buffers->verticalKernel, row, rowSize);
 
-			for (int k = -radius; k <= radius; ++k) {
-				if (j + k >= 0 && j + k < width)
+				for (size_t x = 3; x < rowSize; x += 4)
 				{
-					tempPixels[i * width * depth + j * depth] += Uint8(kernel[k + radius] * pixels[i * width * depth + (j + k) * depth]);
-					tempPixels[i * width * depth + j * depth + 1] += Uint8(kernel[k + radius] * pixels[i * width * depth + (j + k) * depth + 1]);
-					tempPixels[i * width * depth + j * depth + 2] += Uint8(kernel[k + radius] * pixels[i * width * depth + (j + k) * depth + 2]);
+					row[x] = m_linearPixels[i * rowSize + x];
 				}
 			}
+
+			if (isInvert)
+			{
+				InvertRows(first, last);
+			}
+		});
+	}
+	else
+	{
+		buffers->pixels.Create(width, height, depth, 0, verticalRadius);
+		buffers->paddedRow.Create(width, 1, depth, horizontalRadius, 0);
+		buffers->row.resize(static_cast<size_t>(width) * depth);
+
+		effect.AddPass(height, [this, buffers](GLuint first, GLuint last)
+		{
+			HorizontalBlurRows(buffers->horizontalKernel, buffers->paddedRow, buffers->pixels, first, last);
+		});
+
+		effect.AddPass(1, [this, buffers](GLuint, GLuint) { buffers->pixels.FillColumnHalo(m_edgeMode); });
+
+		effect.AddPass(height, [this, buffers, isInvert](GLuint first, GLuint last)
+		{
+			VerticalBlurRows(buffers->verticalKernel, buffers->pixels, buffers->row, m_pixelsWithEffects, first, last);
+
+			if (isInvert)
+			{
+				InvertRows(first, last);
+			}
+		});
+	}
+
+	effect.SetCompletion([this, cacheKey](double milliseconds)
+	{
+		if (m_isEffectCacheEnabled && milliseconds >= MIN_CACHED_EFFECT_MILLISECONDS)
+		{
+			StoreCachedEffects(cacheKey);
+		}
+	});
+}
+
+/// <summary>
+/// adds the pass of BoxBlur to a time-sliced effect. Called on the workers, which build the summed-area table first
+/// </summary>
+void Texture::SliceBoxBlur(GLfloat blurFactor, bool isInvert, SlicedEffect& effect)
+{
+	GLsizei horizontalRadius = GLsizei(blurFactor * m_textureData->w / 2);
+	GLsizei verticalRadius = GLsizei(blurFactor * m_textureData->h / 2);
+
+	GetSummedAreaTable();
+	std::shared_ptr<std::vector<GLfloat>> row = std::make_shared<std::vector<GLfloat>>(static_cast<size_t>(m_textureData->w) * 4);
+
+	effect.AddPass(m_textureData->h, [this, row, horizontalRadius, verticalRadius, isInvert](GLuint first, GLuint last)
+	{
+		for (GLuint y = first; y < last; y++)
+		{
+			m_summedAreaTable.BoxBlurRow(y, row->data(), horizontalRadius, verticalRadius);
+			SetRowsWithEffects(row->data(), y, y + 1);
+		}
+
+		if (isInvert)
+		{
+			InvertRows(first, last);
+		}
+	});
+}
+
+/// <summary>
+/// adds the pass of Denoise to a time-sliced effect. Called on the workers, which build the summed-area table first
+/// </summary>
+void Texture::SliceDenoise(GLsizei radius, GLfloat noiseLevel, bool isInvert, SlicedEffect& effect)
+{
+	GetSummedAreaTable();
+	std::shared_ptr<std::vector<GLfloat>> row = std::make_shared<std::vector<GLfloat>>(static_cast<size_t>(m_textureData->w) * 4);
+
+	effect.AddPass(m_textureData->h, [this, row, radius, noiseLevel, isInvert](GLuint first, GLuint last)
+	{
+		for (GLuint y = first; y < last; y++)
+		{
+			DenoiseRow(m_summedAreaTable, y, radius, noiseLevel, row->data());
+			SetRowsWithEffects(row->data(), y, y + 1);
 		}
+
+		if (isInvert)
+		{
+			InvertRows(first, last);
+		}
+	});
+}
+
+/// <summary>
+/// the summed-area table of the loaded image in the working format, built on the first request
+/// </summary>
+const SummedAreaTable& Texture::GetSummedAreaTable()
+{
+	if (!m_summedAreaTable.IsBuilt())
+	{
+		if (m_workingFormat == WorkingFormat::LinearFloat)
+		{
+			m_summedAreaTable.Build(m_linearPixels.data(), m_textureData->w, m_textureData->h);
+		}
+		else
+		{
+			m_summedAreaTable.Build((Uint8*)m_textureData->pixels, m_textureData->format->BytesPerPixel, 
+				                    m_textureData->w, m_textureData->h);
+		}
+	}
+
+	return m_summedAreaTable;
+}
+
+/// <summary>
+/// sets the format effects are computed in. The current effects are removed, as they were computed in the previous format
+/// </summary>
+void Texture::SetWorkingFormat(WorkingFormat workingFormat)
+{
+	if (workingFormat == m_workingFormat)
+	{
+		return;
+	}
+
+	m_workingFormat = workingFormat;
+	m_summedAreaTable.Clear();
+	m_blurredPixels.Clear();
+
+	if (m_textureData)
+	{
+		GLsizei nbytes = m_textureData->w * m_textureData->h * m_textureData->format->BytesPerPixel;
+		std::copy_n((Uint8*)m_textureData->pixels, nbytes, m_pixelsWithEffects);
+		m_linearPixelsWithEffects = m_linearPixels;
+
+		Reload();
 	}
-	return tempPixels;
 }
 
-void Texture::VerticalBlur(Uint8* tempPixels, GLsizei radius, GLfloat sigma)
+Texture::WorkingFormat Texture::GetWorkingFormat() const
 {
-	// Create the vertical Gaussian kernel
-	int kernelSize = 2 * radius + 1;
-	std::vector<double> kernel(kernelSize, 0.0);
-	double sum = 0.0;
+	return m_workingFormat;
+}
+
+/// <summary>
+/// whether the texture holds colors in linear light, which have to be gamma encoded when drawn
+/// </summary>
+bool Texture::IsLinear() const
+{
+	return m_textureData && m_workingFormat == WorkingFormat::LinearFloat;
+}
+
+/// <summary>
+/// whether the texture shown holds linear half floats, which the shader encodes to sRGB. 
+/// Follows the working format once the pixels in it are uploaded
+/// </summary>
+bool Texture::IsUploadedLinear() const
+{
+	return m_isUploadedLinear;
+}
+
+/// <summary>
+/// reads a png of 16 bits per channel into linear light. An 8-bit RGBA copy is kept for the 8-bit working format 
+/// and for saving in 8-bit formats
+/// </summary>
+/// <returns>returns false if the file is not a 16-bit png, or could not be read</returns>
+bool Texture::DecodePng16(const std::vector<Uint8>& fileBytes, const std::string& filename, Image& image)
+{
+	PngReader reader;
+
+	if (!reader.Open(fileBytes, filename) || reader.GetBitDepth() != 16)
+	{
+		return false;
+	}
+
+	std::vector<Uint8> bytes;
+
+	if (!reader.ReadPixels(bytes))
+	{
+		return false;
+	}
+
+	GLsizei width = reader.GetWidth();
+	GLsizei height = reader.GetHeight();
+	Uint32 channels = reader.GetChannels();
+	size_t totalPixels = static_cast<size_t>(width) * height;
+
+	//png stores the most significant byte first
+	std::vector<Uint16> values(totalPixels * channels);
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		values[i] = static_cast<Uint16>((bytes[i * 2] << 8) | bytes[i * 2 + 1]);
+	}
+
+	image.linearPixels.resize(totalPixels * 4);
+	ConvertSrgb16ToLinear(values.data(), channels, image.linearPixels.data(), totalPixels);
+
+	image.hasAlpha = (channels == 2 || channels == 4);
+	image.surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (!image.surface)
+	{
+		return false;
+	}
+
+	ConvertLinearToSrgb8(image.linearPixels.data(), (Uint8*)image.surface->pixels, 4, totalPixels);
+
+	return true;
+}
+
+/// <summary>
+/// saves pixels in linear light to a png of 16 bits per channel
+/// </summary>
+/// <returns>returns false if the file could not be written</returns>
+bool Texture::SavePng16(const std::string& filename, const std::vector<GLfloat>& linearPixels)
+{
+	GLsizei width = m_textureData->w;
+	GLsizei height = m_textureData->h;
+	Uint32 channels = m_hasAlpha ? 4 : 3;
+
+	PngWriter writer;
+
+	if (!writer.Open(filename, width, height, channels, 16))
+	{
+		return false;
+	}
+
+	std::vector<Uint16> values(static_cast<size_t>(width) * channels);
+	std::vector<Uint8> row(values.size() * 2);
+
+	for (GLsizei i = 0; i < height; i++)
+	{
+		ConvertLinearToSrgb16(&linearPixels[static_cast<size_t>(i) * width * 4], values.data(), channels, width);
+
+		for (size_t j = 0; j < values.size(); j++)
+		{
+			row[j * 2] = static_cast<Uint8>(values[j] >> 8);
+			row[j * 2 + 1] = static_cast<Uint8>(values[j]);
+		}
+
+		if (!writer.WriteRows(row.data(), 1, row.size()))
+		{
+			return false;
+		}
+	}
+
+	return writer.Close();
+}
+
+/// <summary>
+/// the hash of the loaded image, computed on first use. The pixels in linear light hold every source precision, 
+/// as 8-bit values convert to distinct floats
+/// </summary>
+Uint64 Texture::GetSourceHash()
+{
+	if (!m_isSourceHashed)
+	{
+		m_sourceHash = Hash64(m_linearPixels.data(), m_linearPixels.size() * sizeof(GLfloat));
+		m_isSourceHashed = true;
+	}
+
+	return m_sourceHash;
+}
+
+/// <summary>
+/// replaces the pixels with effects by the result stored in the effect cache for the key
+/// </summary>
+/// <returns>returns false if the cache holds no result of the size of the pixels for the key</returns>
+bool Texture::LoadCachedEffects(Uint64 key)
+{
+	std::vector<Uint8> data;
+
+	if (!EffectCache::Instance()->Load(key, data))
+	{
+		return false;
+	}
+
+	size_t totalPixels = static_cast<size_t>(m_textureData->w) * m_textureData->h;
+
+	if (IsLinear() && data.size() == totalPixels * 4 * sizeof(GLfloat))
+	{
+		std::memcpy(m_linearPixelsWithEffects.data(), data.data(), data.size());
+		return true;
+	}
 
-	for (int i = -radius; i <= radius; ++i) {
-		double exponent = -(i * i) / (2 * sigma * sigma);
-		double value = std::exp(exponent) / (sqrt(2 * M_PI) * sigma);
-		kernel[i + radius] = value;
-		sum += value;
+	if (!IsLinear() && data.size() == totalPixels * m_textureData->format->BytesPerPixel)
+	{
+		std::copy(data.begin(), data.end(), m_pixelsWithEffects);
+		return true;
 	}
 
-	// Normalize the kernel
-	for (int i = 0; i < kernelSize; ++i) {
-		kernel[i] /= sum;
+	return false;
+}
+
+/// <summary>
+/// stores the pixels with effects in the effect cache for the key
+/// </summary>
+void Texture::StoreCachedEffects(Uint64 key)
+{
+	if (IsLinear())
+	{
+		EffectCache::Instance()->Store(key, m_linearPixelsWithEffects.data(), m_linearPixelsWithEffects.size() * sizeof(GLfloat));
+	}
+	else
+	{
+		size_t nbytes = static_cast<size_t>(m_textureData->w) * m_textureData->h * m_textureData->format->BytesPerPixel;
+		EffectCache::Instance()->Store(key, m_pixelsWithEffects, nbytes);
 	}
+}
+
+/// <summary>
+/// encodes the pixels in linear light with the current effects into the 8-bit pixels saved to 8-bit files
+/// </summary>
+void Texture::EncodePixelsWithEffects()
+{
+	ConvertLinearToSrgb8(m_linearPixelsWithEffects.data(), m_pixelsWithEffects, m_textureData->format->BytesPerPixel, 
+		                 m_linearPixelsWithEffects.size() / 4);
+}
+
+/// <summary>
+/// replaces the colors of the pixels with effects by RGBA float pixels, with values between 0 and 1 in the working format. 
+/// The alpha of the loaded image is kept
+/// </summary>
+void Texture::SetPixelsWithEffects(const std::vector<GLfloat>& pixels)
+{
+	SetRowsWithEffects(pixels.data(), 0, m_textureData->h);
+}
 
+/// <summary>
+/// replaces the colors of a range of rows of the pixels with effects, as SetPixelsWithEffects does
+/// </summary>
+/// <param name="pixels">the RGBA float pixels of the rows</param>
+void Texture::SetRowsWithEffects(const GLfloat* pixels, GLsizei first, GLsizei last)
+{
+	size_t firstPixel = static_cast<size_t>(first) * m_textureData->w;
+	size_t totalPixels = static_cast<size_t>(last - first) * m_textureData->w;
 	Uint8 depth = m_textureData->format->BytesPerPixel;
 
-	// Apply the vertical blur pass
-	for (int i = 0; i < m_textureData->h; ++i) {
-		for (int j = 0; j < m_textureData->w; ++j) {
+	for (size_t i = 0; i < totalPixels; i++)
+	{
+		size_t index = firstPixel + i;
 
-			glm::vec3 RGBvalue(0.0f);
-			for (int k = -radius; k <= radius; ++k) {
-				if (i + k >= 0 && i + k < m_textureData->h)
-				{
-					RGBvalue.x += float(kernel[k + radius] * tempPixels[(i + k) * m_textureData->w * depth + j * depth]);
-					RGBvalue.y += float(kernel[k + radius] * tempPixels[(i + k) * m_textureData->w * depth + j * depth + 1]);
-					RGBvalue.z += float(kernel[k + radius] * tempPixels[(i + k) * m_textureData->w * depth + j * depth + 2]);
-				}
+		for (Uint8 channel = 0; channel < 3; channel++)
+		{
+			if (m_workingFormat == WorkingFormat::LinearFloat)
+			{
+				m_linearPixelsWithEffects[index * 4 + channel] = pixels[i * 4 + channel];
+			}
+			else
+			{
+				m_pixelsWithEffects[index * depth + channel] = Uint8(std::min(std::max(pixels[i * 4 + channel] * 255.0f + 0.5f, 0.0f), 255.0f));
 			}
-			m_pixelsWithEffects[i * m_textureData->w * depth + j * depth] = Uint8(RGBvalue.x);
-			m_pixelsWithEffects[i * m_textureData->w * depth + j * depth + 1] = Uint8(RGBvalue.y);
-			m_pixelsWithEffects[i * m_textureData->w * depth + j * depth + 2] = Uint8(RGBvalue.z);
-
 		}
 	}
 }
 
+bool Texture::IsLoaded() const
+{
+	return m_textureData != nullptr;
+}
+
+GLsizei Texture::GetWidth() const
+{
+	return m_textureData->w;
+}
+
+GLsizei Texture::GetHeight() const
+{
+	return m_textureData->h;
+}
+
+Uint8 Texture::GetBytesPerPixel() const
+{
+	return m_textureData->format->BytesPerPixel;
+}
+
+/// <summary>
+/// the 8-bit pixels with the current effects. In linear light they are only encoded when the image is saved
+/// </summary>
+const Uint8* Texture::GetPixelsWithEffects() const
+{
+	return m_pixelsWithEffects;
+}
+
+/// <summary>
+/// the RGBA pixels in linear light with the current effects
+/// </summary>
+const std::vector<GLfloat>& Texture::GetLinearPixelsWithEffects() const
+{
+	return m_linearPixelsWithEffects;
+}
+
 const char* Texture::GetExtension(const char* filename)
 {
 	size_t pathlen = strlen(filename);
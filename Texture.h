@@ -1,35 +1,167 @@
 #pragma once
 
+#include <functional>
 #include <string>
+#include <vector>
 #include <SDL_image.h>
 #include "gl.h"
+#include "Kernel.h"
+#include "PaddedBuffer.h"
+#include "SlicedEffect.h"
+#include "SummedAreaTable.h"
 
 class Texture
 {
 
 public:
 
+	//the format effects are computed in: 8-bit gamma encoded values, or floats in linear light, 
+	//which neither band nor darken and keep the precision of 16-bit images. Linear textures are stored as half floats.
+	enum class WorkingFormat
+	{
+		Gamma8,
+		LinearFloat
+	};
+
+	//a blur of the loaded image computed apart from the pixels with effects, such as ahead of time by the blur cache, 
+	//and applied to them later
+	struct BlurResult
+	{
+		GLsizei horizontalRadius;
+		GLsizei verticalRadius;
+		std::vector<GLfloat> linearPixels; //in the linear float working format
+		std::vector<Uint8> pixels; //in the 8-bit gamma working format
+
+		size_t GetSize() const;
+	};
+
+	//an image file decoded away from the main thread, which Load takes over
+	struct Image
+	{
+		SDL_Surface* surface = nullptr; //the 8-bit pixels as loaded, RGBA for 16-bit pngs
+		std::vector<GLfloat> linearPixels; //RGBA in linear light
+		bool is16Bit = false;
+		bool hasAlpha = false;
+
+		Image() = default;
+		~Image();
+
+	private:
+
+		Image(const Image&);
+		Image& operator=(const Image&);
+	};
+
 	Texture();
 
 	void Bind();
-	void Load(const std::string& filename);
+	bool Load(const std::string& filename);
+	void Load(Image& image);
+	void LoadScaled(const Texture& source, GLsizei scaleFactor);
 	void Unbind();
 	void Unload();
 	void Reload();
 
+	static bool ReadFile(const std::string& filename, std::vector<Uint8>& bytes);
+	static bool Decode(const std::string& filename, const std::vector<Uint8>& bytes, Image& image);
+
+	void* BeginUpload();
+	void WriteUpload(void* mappedPixels) const;
+	GLsync EndUpload();
+	GLuint UploadInChunks() const;
+	void Publish(GLuint texture);
+	void UploadRows(GLsizei first, GLsizei last);
+
 	void SaveImage(const std::string& filename);
 	void SaveImageWithEffects(const std::string& filename);
 
 	void Invert();
 	void Blur(GLfloat blurFactor, bool isInvert);
+	void GetBlurRadii(GLfloat blurFactor, GLsizei& horizontalRadius, GLsizei& verticalRadius) const;
+	bool ComputeBlur(GLsizei horizontalRadius, GLsizei verticalRadius, BlurResult& result, 
+		             const std::function<bool()>& isCancelled = nullptr) const;
+	void ApplyBlur(const BlurResult& result, bool isInvert);
+	void Convolve(const Kernel& kernel);
+	void BoxBlur(GLfloat blurFactor, bool isInvert);
+	void BlurWithPyramid(GLfloat blurFactor, bool isInvert, bool isOnGpu);
+	void SetIncrementalBlur(bool isIncrementalBlur);
+	bool IsLastBlurIncremental() const;
+	void SetEffectCacheEnabled(bool isEnabled);
+	void SetEdgeMode(EdgeMode edgeMode);
+	EdgeMode GetEdgeMode() const;
+	void Denoise(GLsizei radius, GLfloat noiseLevel, bool isInvert);
+
+	void SliceInvert(SlicedEffect& effect);
+	void SliceBlur(GLfloat blurFactor, bool isInvert, SlicedEffect& effect);
+	void SliceBoxBlur(GLfloat blurFactor, bool isInvert, SlicedEffect& effect);
+	void SliceDenoise(GLsizei radius, GLfloat noiseLevel, bool isInvert, SlicedEffect& effect);
+
+	const SummedAreaTable& GetSummedAreaTable();
+
+	void SetWorkingFormat(WorkingFormat workingFormat);
+	WorkingFormat GetWorkingFormat() const;
+	bool IsLinear() const;
+	bool IsUploadedLinear() const;
+
+	bool IsLoaded() const;
+	GLsizei GetWidth() const;
+	GLsizei GetHeight() const;
+	Uint8 GetBytesPerPixel() const;
+	const Uint8* GetPixelsWithEffects() const;
+	const std::vector<GLfloat>& GetLinearPixelsWithEffects() const;
 
 private:
-	Uint8* HorizontalBlur(GLsizei radius, GLfloat sigma);
-	void VerticalBlur(Uint8* tempPixels, GLsizei radius, GLfloat sigma);
-	const char* GetExtension(const char* filename);
+	bool HorizontalBlur(GLsizei radius, GLfloat sigma, PaddedBuffer<GLfloat>& tempPixels, 
+		                const std::function<bool()>& isCancelled = nullptr) const;
+	bool VerticalBlur(const PaddedBuffer<GLfloat>& tempPixels, GLsizei radius, GLfloat sigma, Uint8* result, 
+		              const std::function<bool()>& isCancelled = nullptr) const;
+	void HorizontalBlurRows(const std::vector<GLfloat>& kernel, PaddedBuffer<GLfloat>& paddedRow, 
+		                    PaddedBuffer<GLfloat>& tempPixels, GLsizei first, GLsizei last) const;
+	void VerticalBlurRows(const std::vector<GLfloat>& kernel, const PaddedBuffer<GLfloat>& tempPixels, 
+		                  std::vector<GLfloat>& row, Uint8* result, GLsizei first, GLsizei last) const;
+	std::string GetBlurParameters(GLsizei horizontalRadius, GLsizei verticalRadius, bool isInvert) const;
+	void InvertRows(GLsizei first, GLsizei last);
+	void DenoiseRow(const SummedAreaTable& summedAreaTable, GLsizei y, GLsizei radius, GLfloat noiseLevel, GLfloat* resultRow) const;
+	void BlurLinear(GLsizei horizontalRadius, GLsizei verticalRadius);
+	static bool DecodePng16(const std::vector<Uint8>& fileBytes, const std::string& filename, Image& image);
+	void Upload(const GLfloat* linearPixels, const Uint8* pixels);
+	GLsizeiptr GetUploadSize() const;
+	void FreePixels();
+	bool SavePng16(const std::string& filename, const std::vector<GLfloat>& linearPixels);
+	void EncodePixelsWithEffects();
+	void SetPixelsWithEffects(const std::vector<GLfloat>& pixels);
+	void SetRowsWithEffects(const GLfloat* pixels, GLsizei first, GLsizei last);
+	Uint64 GetSourceHash();
+	bool LoadCachedEffects(Uint64 key);
+	void StoreCachedEffects(Uint64 key);
+	static const char* GetExtension(const char* filename);
 
 	SDL_Surface* m_textureData; //includes  pixels of loaded image without the current effects applied on it
 	Uint8* m_pixelsWithEffects = nullptr; //pixels of loaded image WITH the current effects applied on it 
 	GLuint m_ID;
+	GLuint m_uploadBuffer; //the pixels with effects are written into it off the main thread, and copied to the texture by the GPU
+	GLsizeiptr m_uploadBufferSize;
+	bool m_isUploadedLinear; //the texture shown holds linear half floats. Only touched on the thread the screen's context is current on
+
+	WorkingFormat m_workingFormat;
+	EdgeMode m_edgeMode; //the pixels the blurs read beyond the edges of the image
+	bool m_is16Bit; //the image was loaded from a 16-bit png, whose precision is kept when saving it
+	bool m_hasAlpha;
+	std::vector<GLfloat> m_linearPixels; //RGBA pixels of loaded image in linear light, without the current effects
+	std::vector<GLfloat> m_linearPixelsWithEffects;
+	SummedAreaTable m_summedAreaTable; //of the loaded image in the working format, built when first needed
+	bool m_isSourceHashed;
+	Uint64 m_sourceHash; //of the loaded image, which finds the effects computed on it in the effect cache
+	bool m_isEffectCacheEnabled; //off for textures whose effects are thrown away at once, such as previews
+
+	//the last blur in linear light, with a margin around the image the blur spreads into, which larger blurs start from
+	bool m_isIncrementalBlur;
+	bool m_isLastBlurIncremental;
+	PaddedBuffer<GLfloat> m_blurredPixels;
+	GLfloat m_blurSigmaX;
+	GLfloat m_blurSigmaY;
+	GLsizei m_blurSpreadX; //how far the blurred pixels have spread from the image, the sum of the radii of the kernels
+	GLsizei m_blurSpreadY;
+	double m_blurError; //share of the gaussian the kernels left out since the source was last blurred
 
 };
\ No newline at end of file
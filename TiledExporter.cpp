@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <iostream>
+#include "GLState.h"
+#include "RenderThread.h"
+#include "Shader.h"
+#include "TiledExporter.h"
+#include "Timer.h"
+
+//exported images have no alpha, like the view on screen
+static const GLsizei BYTES_PER_PIXEL = 3;
+
+TiledExporter::TiledExporter()
+{
+	m_width = 0;
+	m_height = 0;
+	m_tileSize = 0;
+
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+
+	for (PendingTile& tile : m_pendingTiles)
+	{
+		tile = { 0, nullptr, 0, 0, 0 };
+	}
+}
+
+/// <summary>
+/// renders the camera's view into a png file of the given size, tile by tile. Moves to the render thread, 
+/// which renders a band of tiles between frames, and encodes each band on a worker. Ends on the render thread
+/// </summary>
+/// <param name="filename">path of the png file</param>
+/// <param name="width">width of the image in pixels</param>
+/// <param name="height">height of the image in pixels</param>
+/// <param name="camera">the camera whose view and projection are rendered, which has to stay as it is until the export is done</param>
+/// <param name="render">draws the objects in view, once per tile. Called on the render thread</param>
+/// <returns>returns false if the file could not be written</returns>
+AsyncTask<bool> TiledExporter::Export(std::string filename, GLsizei width, GLsizei height, const Camera& camera, RenderFunction render)
+{
+	co_await ResumeOnRenderThread();
+
+	if (width <= 0 || height <= 0 || !m_writer.Open(filename, width, height, BYTES_PER_PIXEL))
+	{
+		std::cout << "Error exporting view to " << filename << std::endl;
+		co_return false;
+	}
+
+	Timer timer;
+
+	m_width = width;
+	m_height = height;
+
+	CreateTargets();
+	m_band.resize(static_cast<size_t>(width) * m_tileSize * BYTES_PER_PIXEL);
+
+	bool isWritten = true;
+	GLuint totalTiles = 0;
+
+	//bands run from the top of the image down, the order in which png rows are written
+	for (GLsizei y = 0; y < height && isWritten; y += m_tileSize)
+	{
+		GLsizei tileHeight = std::min(m_tileSize, height - y);
+
+		if (!RenderBand(camera, render, y, tileHeight, totalTiles))
+		{
+			isWritten = false;
+			break;
+		}
+
+		//the frames drawn meanwhile go on with the band being encoded, and the next band renders after them
+		co_await ResumeOnWorker(TaskPriority::Background);
+		isWritten = m_writer.WriteRows(m_band.data(), tileHeight, static_cast<size_t>(width) * BYTES_PER_PIXEL);
+		co_await ResumeOnRenderThread();
+	}
+
+	DestroyTargets();
+	m_band.clear();
+	m_band.shrink_to_fit();
+
+	isWritten = m_writer.Close() && isWritten;
+
+	if (isWritten)
+	{
+		std::cout << "Export: " << width << "x" << height << " in " << totalTiles << " tiles, " 
+			      << timer.GetElapsedMilliseconds() << " ms" << std::endl;
+	}
+	else
+	{
+		std::cout << "Error exporting view to " << filename << std::endl;
+	}
+
+	co_return isWritten;
+}
+
+/// <summary>
+/// renders the tiles of a band of the image and reads them back into the band, putting back the framebuffer, 
+/// viewport and projection of the frames after
+/// </summary>
+/// <param name="y">the first row of the band, counted from the top</param>
+/// <param name="totalTiles">the tiles rendered so far, which picks the pixel buffer of each tile</param>
+/// <returns>returns false if a tile could not be read back</returns>
+bool TiledExporter::RenderBand(const Camera& camera, const RenderFunction& render, GLsizei y, GLsizei tileHeight, GLuint& totalTiles)
+{
+	GLint previousFramebuffer = 0;
+	GLint previousViewport[4];
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, previousViewport);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+	bool isRead = true;
+
+	for (GLsizei x = 0; x < m_width && isRead; x += m_tileSize)
+	{
+		GLsizei tileWidth = std::min(m_tileSize, m_width - x);
+
+		//the pixel buffer is reused, so the tile read into it two tiles ago has to be collected first
+		PendingTile& tile = m_pendingTiles[totalTiles % TOTAL_PIXEL_BUFFERS];
+
+		if (tile.fence && !CollectTile(tile))
+		{
+			isRead = false;
+			break;
+		}
+
+		RenderTile(camera, render, x, y, tileWidth, tileHeight);
+
+		GLState::Instance()->BindBuffer(GL_PIXEL_PACK_BUFFER, tile.pixelBuffer);
+		glReadPixels(0, 0, tileWidth, tileHeight, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+		tile.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		tile.x = x;
+		tile.width = tileWidth;
+		tile.height = tileHeight;
+
+		totalTiles++;
+	}
+
+	//collect the tiles still in flight, oldest first, so the band is whole before it is encoded
+	for (GLuint i = 0; i < TOTAL_PIXEL_BUFFERS; i++)
+	{
+		PendingTile& tile = m_pendingTiles[(totalTiles + i) % TOTAL_PIXEL_BUFFERS];
+
+		if (tile.fence)
+		{
+			isRead = CollectTile(tile) && isRead;
+		}
+	}
+
+	GLState::Instance()->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+	GLState::Instance()->SetViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+	Shader::Instance()->SendUniformData("proj", camera.GetProjection());
+
+	return isRead;
+}
+
+/// <summary>
+/// creates the offscreen framebuffer the tiles render into and the pixel buffers they are read into. 
+/// Tiles are as large as the driver allows, up to MAX_TILE_SIZE
+/// </summary>
+void TiledExporter::CreateTargets()
+{
+	GLint maxRenderbufferSize = 0;
+	GLint maxViewportSize[2] = { 0, 0 };
+	glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbufferSize);
+	glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewportSize);
+
+	m_tileSize = std::min({ MAX_TILE_SIZE, static_cast<GLsizei>(maxRenderbufferSize),
+		                    static_cast<GLsizei>(maxViewportSize[0]), static_cast<GLsizei>(maxViewportSize[1]) });
+
+	glCreateRenderbuffers(1, &m_colorBuffer);
+	glNamedRenderbufferStorage(m_colorBuffer, GL_RGBA8, m_tileSize, m_tileSize);
+
+	glCreateRenderbuffers(1, &m_depthBuffer);
+	glNamedRenderbufferStorage(m_depthBuffer, GL_DEPTH24_STENCIL8, m_tileSize, m_tileSize);
+
+	glCreateFramebuffers(1, &m_framebuffer);
+	glNamedFramebufferRenderbuffer(m_framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glNamedFramebufferRenderbuffer(m_framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	GLsizeiptr pixelBufferSize = static_cast<GLsizeiptr>(m_tileSize) * m_tileSize * BYTES_PER_PIXEL;
+
+	for (PendingTile& tile : m_pendingTiles)
+	{
+		glCreateBuffers(1, &tile.pixelBuffer);
+		glNamedBufferStorage(tile.pixelBuffer, pixelBufferSize, nullptr, GL_MAP_READ_BIT | GL_CLIENT_STORAGE_BIT);
+		tile.fence = nullptr;
+	}
+}
+
+void TiledExporter::DestroyTargets()
+{
+	for (PendingTile& tile : m_pendingTiles)
+	{
+		if (tile.fence)
+		{
+			glDeleteSync(tile.fence);
+			tile.fence = nullptr;
+		}
+
+		GLState::Instance()->InvalidateBuffer(tile.pixelBuffer);
+		glDeleteBuffers(1, &tile.pixelBuffer);
+		tile.pixelBuffer = 0;
+	}
+
+	glDeleteFramebuffers(1, &m_framebuffer);
+	glDeleteRenderbuffers(1, &m_colorBuffer);
+	glDeleteRenderbuffers(1, &m_depthBuffer);
+
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+}
+
+/// <summary>
+/// renders the part of the image starting at the given pixel, counted from the top left. 
+/// The projection is narrowed to the tile's part of the view, so the tile matches that part of the full image exactly
+/// </summary>
+void TiledExporter::RenderTile(const Camera& camera, const RenderFunction& render, GLsizei x, GLsizei y, GLsizei tileWidth, GLsizei tileHeight)
+{
+	GLfloat left = -1.0f + 2.0f * x / m_width;
+	GLfloat right = -1.0f + 2.0f * (x + tileWidth) / m_width;
+	GLfloat top = 1.0f - 2.0f * y / m_height;
+	GLfloat bottom = 1.0f - 2.0f * (y + tileHeight) / m_height;
+
+	//scales and moves the tile's rectangle in normalized device coordinates onto the whole viewport
+	glm::mat4 crop(1.0f);
+	crop[0][0] = 2.0f / (right - left);
+	crop[1][1] = 2.0f / (top - bottom);
+	crop[3][0] = -(right + left) / (right - left);
+	crop[3][1] = -(top + bottom) / (top - bottom);
+
+	Shader::Instance()->SendUniformData("proj", crop * camera.GetProjection());
+
+	GLState::Instance()->SetViewport(0, 0, tileWidth, tileHeight);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	render();
+}
+
+/// <summary>
+/// copies a tile read back earlier into its band. 
+/// Waits only if the GPU has not finished the tile yet, which the tiles rendered since then usually cover
+/// </summary>
+bool TiledExporter::CollectTile(PendingTile& tile)
+{
+	while (glClientWaitSync(tile.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+	{
+	}
+
+	glDeleteSync(tile.fence);
+	tile.fence = nullptr;
+
+	size_t rowSize = static_cast<size_t>(tile.width) * BYTES_PER_PIXEL;
+	size_t bandPitch = static_cast<size_t>(m_width) * BYTES_PER_PIXEL;
+
+	auto pixels = static_cast<const Uint8*>(glMapNamedBufferRange(tile.pixelBuffer, 0, rowSize * tile.height, GL_MAP_READ_BIT));
+
+	if (!pixels)
+	{
+		std::cout << "Error reading back an exported tile" << std::endl;
+		return false;
+	}
+
+	//OpenGL returns the bottom row first
+	for (GLsizei row = 0; row < tile.height; row++)
+	{
+		std::copy_n(pixels + row * rowSize, rowSize, &m_band[(tile.height - 1 - row) * bandPitch + tile.x * BYTES_PER_PIXEL]);
+	}
+
+	glUnmapNamedBuffer(tile.pixelBuffer);
+
+	return true;
+}
\ No newline at end of file
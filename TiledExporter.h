@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <SDL.h>
+#include "gl.h"
+#include "AsyncTask.h"
+#include "Camera.h"
+#include "PngWriter.h"
+
+//renders the view of a camera into a png file of any size, far above the largest viewport or framebuffer.
+//The projection is split into a grid of sub-frustum tiles, each rendered into an offscreen framebuffer and read back 
+//asynchronously through pixel buffers while the next tiles render. Every finished band of tiles is streamed to the 
+//png encoder, so only one band of the image is ever held in memory. The tiles render on the render thread a band at a time, 
+//between frames, and the bands are encoded on the workers, so the view keeps being drawn during an export.
+class TiledExporter
+{
+
+public:
+
+	using RenderFunction = std::function<void()>;
+
+	TiledExporter();
+
+	AsyncTask<bool> Export(std::string filename, GLsizei width, GLsizei height, const Camera& camera, RenderFunction render);
+
+private:
+
+	struct PendingTile
+	{
+		GLuint pixelBuffer;
+		GLsync fence;
+		GLsizei x;
+		GLsizei width;
+		GLsizei height;
+	};
+
+	TiledExporter(const TiledExporter&);
+
+	void CreateTargets();
+	void DestroyTargets();
+
+	bool RenderBand(const Camera& camera, const RenderFunction& render, GLsizei y, GLsizei tileHeight, GLuint& totalTiles);
+	void RenderTile(const Camera& camera, const RenderFunction& render, GLsizei x, GLsizei y, GLsizei tileWidth, GLsizei tileHeight);
+	bool CollectTile(PendingTile& tile);
+
+	static const GLsizei MAX_TILE_SIZE = 2048;
+	static const GLuint TOTAL_PIXEL_BUFFERS = 2;
+
+	GLsizei m_width;
+	GLsizei m_height;
+	GLsizei m_tileSize;
+
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+
+	PendingTile m_pendingTiles[TOTAL_PIXEL_BUFFERS];
+
+	std::vector<Uint8> m_band;
+	PngWriter m_writer;
+
+};
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "Timer.h"
+
+Timer::Timer()
+{
+	m_startTicks = SDL_GetPerformanceCounter();
+}
+
+void Timer::Start()
+{
+	m_startTicks = SDL_GetPerformanceCounter();
+}
+
+/// <summary>
+/// returns the time passed since the timer was created or last started
+/// </summary>
+/// <returns>elapsed time in milliseconds</returns>
+double Timer::GetElapsedMilliseconds() const
+{
+	Uint64 elapsedTicks = SDL_GetPerformanceCounter() - m_startTicks;
+	return elapsedTicks * 1000.0 / SDL_GetPerformanceFrequency();
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <SDL.h>
+
+class Timer
+{
+
+public:
+
+	Timer();
+
+	void Start();
+	double GetElapsedMilliseconds() const;
+
+private:
+
+	Uint64 m_startTicks;
+
+};
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <future>
+#include <iostream>
+#include "gl.h"
+#include "Screen.h"
+#include "UploadThread.h"
+
+UploadThread* UploadThread::Instance()
+{
+	static UploadThread* uploadThread = new UploadThread;
+	return uploadThread;
+}
+
+UploadThread::UploadThread()
+{
+	m_context = nullptr;
+	m_isStopping = false;
+}
+
+/// <summary>
+/// creates the shared context and starts the thread. Called on the main thread once the screen is initialized, 
+/// and after the GL profiler is installed, as the thread issues GL calls from then on
+/// </summary>
+/// <returns>returns false if the driver cannot share a context, in which case textures are uploaded on the main thread</returns>
+bool UploadThread::Start()
+{
+	if (m_context)
+	{
+		return true;
+	}
+
+	m_context = Screen::Instance()->CreateSharedContext();
+
+	if (!m_context)
+	{
+		return false;
+	}
+
+	std::promise<bool> isCurrent;
+	std::future<bool> isCurrentResult = isCurrent.get_future();
+
+	m_isStopping = false;
+	m_thread = std::thread(&UploadThread::Run, this, std::ref(isCurrent));
+
+	if (!isCurrentResult.get())
+	{
+		std::cout << "Error making the shared OpenGL context current on the upload thread" << std::endl;
+
+		m_thread.join();
+		Screen::Instance()->DestroySharedContext(m_context);
+		m_context = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// resumes the coroutines posted before, then ends the thread and destroys its context. 
+/// Called on the main thread before the screen shuts down, once nothing awaits the upload thread any more
+/// </summary>
+void UploadThread::Stop()
+{
+	if (!m_context)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+
+	m_condition.notify_one();
+	m_thread.join();
+
+	Screen::Instance()->DestroySharedContext(m_context);
+	m_context = nullptr;
+}
+
+bool UploadThread::IsRunning() const
+{
+	return m_context != nullptr;
+}
+
+/// <summary>
+/// queues a coroutine to be resumed on the upload thread, from any thread
+/// </summary>
+void UploadThread::Post(std::coroutine_handle<> handle)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_handles.push_back(handle);
+	}
+
+	m_condition.notify_one();
+}
+
+void UploadThread::Run(std::promise<bool>& isCurrent)
+{
+	if (!Screen::Instance()->MakeCurrent(m_context))
+	{
+		isCurrent.set_value(false);
+		return;
+	}
+
+	isCurrent.set_value(true);
+
+	//the pixel rows of images are tightly packed, as on the main context
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	while (true)
+	{
+		std::coroutine_handle<> handle;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_isStopping || !m_handles.empty(); });
+
+			if (m_handles.empty())
+			{
+				break;
+			}
+
+			handle = m_handles.front();
+			m_handles.pop_front();
+		}
+
+		handle.resume();
+	}
+
+	Screen::Instance()->MakeCurrent(nullptr);
+}
+
+UploadThreadAwaiter ResumeOnUploadThread()
+{
+	return {};
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+//a thread with an OpenGL context of its own, which shares textures, buffers and fences with the screen's. 
+//Textures are uploaded on it, so the transfer of a large image never holds up the frame loop, 
+//and are shown once the fence made after the upload is signalled. Coroutines move to it through ResumeOnUploadThread
+class UploadThread
+{
+
+public:
+
+	static UploadThread* Instance();
+
+	bool Start();
+	void Stop();
+	bool IsRunning() const;
+	void Post(std::coroutine_handle<> handle);
+
+private:
+
+	UploadThread();
+	UploadThread(const UploadThread&);
+
+	void Run(std::promise<bool>& isCurrent);
+
+	void* m_context; //shared with the screen's, and current on the thread while it runs
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<std::coroutine_handle<>> m_handles;
+	bool m_isStopping;
+
+};
+
+//moves the coroutine to the upload thread, where OpenGL calls go to the shared context. 
+//Only awaited while the upload thread is running
+struct UploadThreadAwaiter
+{
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) const { UploadThread::Instance()->Post(handle); }
+	void await_resume() const noexcept {}
+};
+
+UploadThreadAwaiter ResumeOnUploadThread();
\ No newline at end of file
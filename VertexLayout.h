@@ -0,0 +1,74 @@
+#pragma once
+
+#include <glm.hpp>
+#include "gl.h"
+
+//how a C++ type is described to OpenGL as a vertex attribute. 
+//Matrices occupy one attribute location per column.
+template <typename T> struct AttributeFormat;
+
+template <> struct AttributeFormat<GLfloat>   { static const GLint COMPONENTS = 1; static const GLuint COLUMNS = 1; static const GLenum TYPE = GL_FLOAT; };
+template <> struct AttributeFormat<glm::vec2> { static const GLint COMPONENTS = 2; static const GLuint COLUMNS = 1; static const GLenum TYPE = GL_FLOAT; };
+template <> struct AttributeFormat<glm::vec3> { static const GLint COMPONENTS = 3; static const GLuint COLUMNS = 1; static const GLenum TYPE = GL_FLOAT; };
+template <> struct AttributeFormat<glm::vec4> { static const GLint COMPONENTS = 4; static const GLuint COLUMNS = 1; static const GLenum TYPE = GL_FLOAT; };
+template <> struct AttributeFormat<glm::mat4> { static const GLint COMPONENTS = 4; static const GLuint COLUMNS = 4; static const GLenum TYPE = GL_FLOAT; };
+template <> struct AttributeFormat<GLint>     { static const GLint COMPONENTS = 1; static const GLuint COLUMNS = 1; static const GLenum TYPE = GL_INT; };
+template <> struct AttributeFormat<GLuint>    { static const GLint COMPONENTS = 1; static const GLuint COLUMNS = 1; static const GLenum TYPE = GL_UNSIGNED_INT; };
+
+//a single attribute of a vertex: the explicit location it has in the vertex shader, and its C++ type
+template <GLuint Location, typename T>
+struct Attribute
+{
+	using Type = T;
+	static const GLuint LOCATION = Location;
+};
+
+//describes an interleaved vertex, whose attributes follow each other in the order given, without padding. 
+//The stride and the offset of every attribute are computed at compile time, 
+//and Apply sets up the attribute formats of a vertex array object with direct state access.
+//
+//example: VertexLayout<Attribute<0, glm::vec3>, Attribute<1, glm::vec2>> for struct { glm::vec3 position; glm::vec2 uv; }
+template <typename... Attributes>
+struct VertexLayout
+{
+	static constexpr GLsizei STRIDE = (0 + ... + static_cast<GLsizei>(sizeof(typename Attributes::Type)));
+
+	/// <summary>
+	/// sets the format of every attribute of the layout, and sources them all from one vertex buffer binding point
+	/// </summary>
+	/// <param name="VAO">vertex array object to set up</param>
+	/// <param name="bindingIndex">binding point the interleaved buffer is attached to</param>
+	static void Apply(GLuint VAO, GLuint bindingIndex)
+	{
+		GLuint offset = 0;
+		(ApplyAttribute<Attributes>(VAO, bindingIndex, offset), ...);
+	}
+
+private:
+
+	template <typename A>
+	static void ApplyAttribute(GLuint VAO, GLuint bindingIndex, GLuint& offset)
+	{
+		using Format = AttributeFormat<typename A::Type>;
+
+		for (GLuint column = 0; column < Format::COLUMNS; column++)
+		{
+			GLuint location = A::LOCATION + column;
+			GLuint columnOffset = offset + column * static_cast<GLuint>(sizeof(typename A::Type) / Format::COLUMNS);
+
+			if constexpr (Format::TYPE == GL_FLOAT)
+			{
+				glVertexArrayAttribFormat(VAO, location, Format::COMPONENTS, Format::TYPE, GL_FALSE, columnOffset);
+			}
+			else
+			{
+				glVertexArrayAttribIFormat(VAO, location, Format::COMPONENTS, Format::TYPE, columnOffset);
+			}
+
+			glVertexArrayAttribBinding(VAO, location, bindingIndex);
+			glEnableVertexArrayAttrib(VAO, location);
+		}
+
+		offset += static_cast<GLuint>(sizeof(typename A::Type));
+	}
+};
\ No newline at end of file
@@ -0,0 +1,3 @@
+#wraps a GLSL file in a raw string literal for ShaderSources.h. Run with -DINPUT=<shader> -DOUTPUT=<inl> -P EmbedShader.cmake
+file(READ ${INPUT} SOURCE)
+file(WRITE ${OUTPUT} "R\"GLSL(\n${SOURCE}\n)GLSL\"\n")
@@ -14,6 +14,7 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-19: OpenGL: Desktop GL 4.5+ streams vertex/index data through persistently mapped, fenced ring buffers instead of glBufferData() per draw list. Define IMGUI_IMPL_OPENGL_DISABLE_STREAMING_BUFFERS to opt out.
 //  2023-03-23: OpenGL: Properly restoring "no shader program bound" if it was the case prior to running the rendering function. (#6267, #6220, #6224)
 //  2023-03-15: OpenGL: Fixed GL loader crash when GL_VERSION returns NULL. (#6154, #4445, #3530)
 //  2023-03-06: OpenGL: Fixed restoration of a potentially deleted OpenGL program, by calling glIsProgram(). (#6220, #6224)
@@ -191,6 +192,12 @@
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_EXTENSIONS
 #endif
 
+// Desktop GL 4.5+ has persistently mapped buffer storage (4.4) and direct state access (4.5), used for streaming vertex/index data.
+// Define IMGUI_IMPL_OPENGL_DISABLE_STREAMING_BUFFERS to always re-specify the buffers with glBufferData() instead.
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_VERSION_4_5) && !defined(IMGUI_IMPL_OPENGL_DISABLE_STREAMING_BUFFERS)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+#endif
+
 // [Debugging]
 //#define IMGUI_IMPL_OPENGL_DEBUG
 #ifdef IMGUI_IMPL_OPENGL_DEBUG
@@ -217,6 +224,14 @@ struct ImGui_ImplOpenGL3_Data
     GLsizeiptr      IndexBufferSize;
     bool            HasClipOrigin;
     bool            UseBufferSubData;
+    bool            UseStreamingBuffers;     // Persistently mapped ring buffers, see ImGui_ImplOpenGL3_UploadStreamingBuffers()
+    GLuint          StreamVboHandle, StreamElementsHandle;
+    ImDrawVert*     StreamVtxMapped;
+    ImDrawIdx*      StreamIdxMapped;
+    int             StreamVtxCapacity;       // Vertices/indices per frame, the buffers hold ImGui_ImplOpenGL3_StreamFrameCount frames
+    int             StreamIdxCapacity;
+    int             StreamFrameIndex;
+    GLsync          StreamFences[3];
 
     ImGui_ImplOpenGL3_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
@@ -287,6 +302,9 @@ bool    ImGui_ImplOpenGL3_Init(const char* glsl_version)
     bd->GlVersion = (GLuint)(major * 100 + minor * 10);
 
     bd->UseBufferSubData = false;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+    bd->UseStreamingBuffers = (bd->GlVersion >= 450);
+#endif
     /*
     // Query vendor to enable glBufferSubData kludge
 #ifdef _WIN32
@@ -431,8 +449,17 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
 #endif
 
     // Bind vertex/index buffers and setup attributes for ImDrawVert
-    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle));
-    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle));
+    GLuint vbo_handle = bd->VboHandle;
+    GLuint elements_handle = bd->ElementsHandle;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+    if (bd->UseStreamingBuffers)
+    {
+        vbo_handle = bd->StreamVboHandle;
+        elements_handle = bd->StreamElementsHandle;
+    }
+#endif
+    GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, vbo_handle));
+    GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elements_handle));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxPos));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxUV));
     GL_CALL(glEnableVertexAttribArray(bd->AttribLocationVtxColor));
@@ -441,6 +468,88 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     GL_CALL(glVertexAttribPointer(bd->AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col)));
 }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+// Streaming buffers: one persistently mapped vertex buffer and one index buffer, each split into a ring of
+// ImGui_ImplOpenGL3_StreamFrameCount per-frame regions. Draw lists are copied straight into the region of the current frame,
+// and a fence placed after the frame's draws tells us when the GPU is done with that region so it can be written again.
+// When a frame needs more room the buffers grow geometrically, instead of being re-specified every frame with glBufferData().
+static const int ImGui_ImplOpenGL3_StreamFrameCount = 3;
+
+static void ImGui_ImplOpenGL3_WaitStreamFence(ImGui_ImplOpenGL3_Data* bd, int frame_index)
+{
+    GLsync fence = bd->StreamFences[frame_index];
+    if (fence == nullptr)
+        return;
+    GLenum result;
+    do { result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000); } while (result == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(fence);
+    bd->StreamFences[frame_index] = nullptr;
+}
+
+static void ImGui_ImplOpenGL3_DestroyStreamingBuffers(ImGui_ImplOpenGL3_Data* bd)
+{
+    for (int i = 0; i < ImGui_ImplOpenGL3_StreamFrameCount; i++)
+        ImGui_ImplOpenGL3_WaitStreamFence(bd, i);
+    // Deleting a mapped buffer unmaps it
+    if (bd->StreamVboHandle)      { glDeleteBuffers(1, &bd->StreamVboHandle); bd->StreamVboHandle = 0; }
+    if (bd->StreamElementsHandle) { glDeleteBuffers(1, &bd->StreamElementsHandle); bd->StreamElementsHandle = 0; }
+    bd->StreamVtxMapped = nullptr;
+    bd->StreamIdxMapped = nullptr;
+    bd->StreamVtxCapacity = 0;
+    bd->StreamIdxCapacity = 0;
+}
+
+static void* ImGui_ImplOpenGL3_CreateStreamingBuffer(GLuint* handle, GLsizeiptr size)
+{
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GL_CALL(glCreateBuffers(1, handle));
+    GL_CALL(glNamedBufferStorage(*handle, size, nullptr, flags));
+    return glMapNamedBufferRange(*handle, 0, size, flags);
+}
+
+// Copy all draw lists of the frame into the current ring region. Outputs the index of the region's first vertex and first index.
+static bool ImGui_ImplOpenGL3_UploadStreamingBuffers(ImGui_ImplOpenGL3_Data* bd, ImDrawData* draw_data, int* vtx_base, int* idx_base)
+{
+    if (draw_data->TotalVtxCount > bd->StreamVtxCapacity || draw_data->TotalIdxCount > bd->StreamIdxCapacity)
+    {
+        int vtx_capacity = bd->StreamVtxCapacity > 2048 ? bd->StreamVtxCapacity * 2 : 4096;
+        int idx_capacity = bd->StreamIdxCapacity > 4096 ? bd->StreamIdxCapacity * 2 : 8192;
+        if (vtx_capacity < draw_data->TotalVtxCount) vtx_capacity = draw_data->TotalVtxCount;
+        if (idx_capacity < draw_data->TotalIdxCount) idx_capacity = draw_data->TotalIdxCount;
+        ImGui_ImplOpenGL3_DestroyStreamingBuffers(bd);
+        bd->StreamVtxMapped = (ImDrawVert*)ImGui_ImplOpenGL3_CreateStreamingBuffer(&bd->StreamVboHandle, (GLsizeiptr)vtx_capacity * ImGui_ImplOpenGL3_StreamFrameCount * (int)sizeof(ImDrawVert));
+        bd->StreamIdxMapped = (ImDrawIdx*)ImGui_ImplOpenGL3_CreateStreamingBuffer(&bd->StreamElementsHandle, (GLsizeiptr)idx_capacity * ImGui_ImplOpenGL3_StreamFrameCount * (int)sizeof(ImDrawIdx));
+        if (bd->StreamVtxMapped == nullptr || bd->StreamIdxMapped == nullptr)
+        {
+            // Mapping failed: fall back to glBufferData() for the rest of the session
+            ImGui_ImplOpenGL3_DestroyStreamingBuffers(bd);
+            bd->UseStreamingBuffers = false;
+            return false;
+        }
+        bd->StreamVtxCapacity = vtx_capacity;
+        bd->StreamIdxCapacity = idx_capacity;
+        bd->StreamFrameIndex = 0;
+    }
+
+    // Wait until the GPU no longer reads the region written ImGui_ImplOpenGL3_StreamFrameCount frames ago
+    ImGui_ImplOpenGL3_WaitStreamFence(bd, bd->StreamFrameIndex);
+
+    *vtx_base = bd->StreamFrameIndex * bd->StreamVtxCapacity;
+    *idx_base = bd->StreamFrameIndex * bd->StreamIdxCapacity;
+    ImDrawVert* vtx_dst = bd->StreamVtxMapped + *vtx_base;
+    ImDrawIdx* idx_dst = bd->StreamIdxMapped + *idx_base;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        memcpy(vtx_dst, cmd_list->VtxBuffer.Data, (size_t)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+        memcpy(idx_dst, cmd_list->IdxBuffer.Data, (size_t)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+        vtx_dst += cmd_list->VtxBuffer.Size;
+        idx_dst += cmd_list->IdxBuffer.Size;
+    }
+    return true;
+}
+#endif
+
 // OpenGL3 Render function.
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly.
 // This is in order to be able to run within an OpenGL engine that doesn't do so.
@@ -493,6 +602,15 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     GLboolean last_enable_primitive_restart = (bd->GlVersion >= 310) ? glIsEnabled(GL_PRIMITIVE_RESTART) : GL_FALSE;
 #endif
 
+    // Write all draw lists into the streaming buffers up front, so the loop below only issues draws
+    bool use_streaming_buffers = false;
+    int stream_vtx_offset = 0;
+    int stream_idx_offset = 0;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+    if (bd->UseStreamingBuffers)
+        use_streaming_buffers = ImGui_ImplOpenGL3_UploadStreamingBuffers(bd, draw_data, &stream_vtx_offset, &stream_idx_offset);
+#endif
+
     // Setup desired GL state
     // Recreate the VAO every time (this is to easily allow multiple GL contexts to be rendered to. VAO are not shared among GL contexts)
     // The renderer would actually work without any VAO bound, but then our VertexAttrib calls would overwrite the default one currently bound.
@@ -521,7 +639,11 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
         // - See https://github.com/ocornut/imgui/issues/4468 and please report any corruption issues.
         const GLsizeiptr vtx_buffer_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * (int)sizeof(ImDrawVert);
         const GLsizeiptr idx_buffer_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx);
-        if (bd->UseBufferSubData)
+        if (use_streaming_buffers)
+        {
+            // Already written by ImGui_ImplOpenGL3_UploadStreamingBuffers()
+        }
+        else if (bd->UseBufferSubData)
         {
             if (bd->VertexBufferSize < vtx_buffer_size)
             {
@@ -567,6 +689,11 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
 
                 // Bind texture, Draw
                 GL_CALL(glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID()));
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+                if (use_streaming_buffers)
+                    GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)((stream_idx_offset + pcmd->IdxOffset) * sizeof(ImDrawIdx)), (GLint)(stream_vtx_offset + pcmd->VtxOffset)));
+                else
+#endif
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
                 if (bd->GlVersion >= 320)
                     GL_CALL(glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset));
@@ -575,8 +702,19 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
                 GL_CALL(glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx))));
             }
         }
+        stream_vtx_offset += cmd_list->VtxBuffer.Size;
+        stream_idx_offset += cmd_list->IdxBuffer.Size;
     }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+    // Fence the frame's region of the streaming buffers and move on to the next region
+    if (use_streaming_buffers)
+    {
+        bd->StreamFences[bd->StreamFrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        bd->StreamFrameIndex = (bd->StreamFrameIndex + 1) % ImGui_ImplOpenGL3_StreamFrameCount;
+    }
+#endif
+
     // Destroy the temporary VAO
 #ifdef IMGUI_IMPL_OPENGL_USE_VERTEX_ARRAY
     GL_CALL(glDeleteVertexArrays(1, &vertex_array_object));
@@ -896,6 +1034,9 @@ void    ImGui_ImplOpenGL3_DestroyDeviceObjects()
     if (bd->VboHandle)      { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
     if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
     if (bd->ShaderHandle)   { glDeleteProgram(bd->ShaderHandle); bd->ShaderHandle = 0; }
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING_BUFFERS
+    ImGui_ImplOpenGL3_DestroyStreamingBuffers(bd);
+#endif
     ImGui_ImplOpenGL3_DestroyFontsTexture();
 }
 